@@ -378,6 +378,7 @@ struct GXQuat final
 
     GXQuat ();
     GXQuat ( const GXQuat &other );
+    GXQuat& operator = ( const GXQuat &other ) = default;
 
     // constexpr constructor is implicitly inline
     // see https://timsong-cpp.github.io/cppwp/n4140/dcl.constexpr
@@ -669,12 +670,15 @@ class GXProjectionClipPlanes final
         GXVoid From ( const GXMat4 &src );
 
         // Trivial invisibility test.
-        GXBool IsVisible ( const GXAABB &bounds );
+        GXBool IsVisible ( const GXAABB &bounds ) const;
+
+        // Order is left, right, top, bottom, near, far. The planes are not normalized.
+        const GXPlane& GetPlane ( GXUByte index ) const;
 
         GXProjectionClipPlanes& operator = ( const GXProjectionClipPlanes &clipPlanes );
 
     private:
-        GXUByte PlaneTest ( GXFloat x, GXFloat y, GXFloat z );
+        GXUByte PlaneTest ( GXFloat x, GXFloat y, GXFloat z ) const;
 };
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,43 @@
+// version 1.0
+
+#ifndef GX_MATH_BATCH
+#define GX_MATH_BATCH
+
+
+#include "GXMath.h"
+
+
+// Batch versions of the GXMath operations. The arrays are in the usual GXMath layout. The elements are processed in
+// groups of four. Every group is converted to structure of arrays so every SIMD lane holds one element. The last
+// partial group is padded. The per element methods are used if there is no SIMD support. Destination arrays must not
+// overlap the source arrays.
+
+// localToClip[ i ] = localToWorld[ i ] * worldToClip. The shared matrix stays in the registers. So this function
+// works per element without structure of arrays conversion.
+GXVoid GXCALL GXBatchCompose ( GXMat4* localToClip, const GXMat4* localToWorld, const GXMat4 &worldToClip, GXUPointer count );
+
+// localToWorld[ i ] is the same as GXMat4::FromFast ( orientations[ i ], origins[ i ] ) result.
+// localToClip[ i ] = localToWorld[ i ] * worldToClip. The orientations must be normalized.
+GXVoid GXCALL GXBatchCompose ( GXMat4* localToWorld, GXMat4* localToClip, const GXQuat* orientations, const GXVec3* origins, const GXMat4 &worldToClip, GXUPointer count );
+
+// out[ i ] is the same as GXMat4::MultiplyAsPoint result.
+GXVoid GXCALL GXBatchTransformPoints ( GXVec3* out, const GXVec3* points, const GXMat4 &transform, GXUPointer count );
+
+// out[ i ] contains all corners of bounds[ i ] transformed by the affine transform. It is the same volume as
+// GXAABB::Transform result within rounding.
+GXVoid GXCALL GXBatchTransformAABBs ( GXAABB* out, const GXAABB* bounds, const GXMat4 &transform, GXUPointer count );
+GXVoid GXCALL GXBatchTransformAABBs ( GXAABB* out, const GXAABB* bounds, const GXMat4* transforms, GXUPointer count );
+
+// visibility[ i ] is the same as GXProjectionClipPlanes::IsVisible ( bounds[ i ] ) result. The SIMD path tests only
+// the corner which is the farthest along the plane normal. So every box costs six dot products instead of 48.
+// Method returns the number of the visible boxes.
+GXUPointer GXCALL GXBatchCullAABBs ( GXBool* visibility, const GXAABB* bounds, const GXProjectionClipPlanes &clipPlanes, GXUPointer count );
+
+// out[ i ] is the spherical linear interpolation between start[ i ] and finish[ i ] along the shortest arc.
+// The interpolation factors are clamped to [0, 1]. The SIMD path evaluates the polynomial approximation without
+// trigonometric functions. The error is less than 1.0e-6 for the normalized quaternions. The factor 1 gives -finish[ i ]
+// if the quaternions are in the opposite hemispheres. It is the same orientation.
+GXVoid GXCALL GXBatchSlerp ( GXQuat* out, const GXQuat* start, const GXQuat* finish, const GXFloat* interpolationFactors, GXUPointer count );
+
+
+#endif // GX_MATH_BATCH
@@ -1,4 +1,4 @@
-//version 1.2
+//version 1.2 and 2.0
 
 #ifndef GX_NATIVE_MESH
 #define GX_NATIVE_MESH
@@ -7,6 +7,21 @@
 #include "GXMath.h"
 
 
+// Version 2.0 starts with the magic. Version 1.2 has no magic. Note version 1.2 header with such totalVertices value
+// could not pass the file size check.
+#define GX_NATIVE_MESH_V2_MAGIC         0x324D5847u     // "GXM2"
+#define GX_NATIVE_MESH_V2_VERSION       2u
+
+// Version 2.0 chunks are aligned by this value from the beginning of the file.
+#define GX_NATIVE_MESH_V2_ALIGNMENT     16u
+
+enum class eGXNativeMeshChunk : GXUInt
+{
+    Vertices = 0u,
+    Indices = 1u,
+    Meshlets = 2u
+};
+
 #pragma pack ( push )
 #pragma pack ( 1 )
 
@@ -16,6 +31,37 @@ struct GXNativeMeshHeader final
     GXUBigInt       vboOffset;      // VBO element struct: position (GXVec3), uv (GXVec2), normal (GXVec3), tangent (GXVec3), bitangent (GXVec3).
 };
 
+// Version 2.0 content is ready for upload as is. The vertices are deduplicated and reordered, UV is flipped. The header
+// is followed by "totalChunks" GXNativeMeshChunk records. Unknown chunks must be skipped.
+struct GXNativeMeshHeaderV2 final
+{
+    GXUInt          magic;
+    GXUInt          version;
+    GXUInt          vertexLayout;   // 0 - version 1.2 VBO element struct, 1 - packed. See rotating_mesh::eVertexFormat.
+    GXUInt          totalVertices;
+    GXUInt          totalIndices;
+    GXUInt          indexSize;      // 2 or 4 bytes.
+    GXUInt          totalChunks;
+    GXVec3          boundsMin;
+    GXVec3          boundsMax;
+};
+
+struct GXNativeMeshChunk final
+{
+    GXUInt          type;           // see eGXNativeMeshChunk
+    GXUBigInt       offset;         // from the beginning of the file
+    GXUBigInt       size;
+};
+
+// Meshlet is the range of the index buffer. The range is suitable for cluster culling.
+struct GXNativeMeshlet final
+{
+    GXUInt          firstIndex;
+    GXUInt          totalIndices;
+    GXVec3          boundsMin;
+    GXVec3          boundsMax;
+};
+
 #pragma pack ( pop )
 
 struct GXMeshInfo final
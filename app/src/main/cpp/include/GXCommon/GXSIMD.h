@@ -0,0 +1,235 @@
+// version 1.1
+
+#ifndef GX_SIMD
+#define GX_SIMD
+
+
+#include "GXTypes.h"
+#include "GXWarning.h"
+
+
+// The instruction set is selected at compile time. NEON is used by the clang builds for armeabi-v7a and arm64-v8a.
+// SSE2 is the baseline of x86 and x86_64 targets. Define GX_DISABLE_SIMD to force the scalar code. The loads and
+// the stores are unaligned because GXMat4, GXVec4 and GXQuat have 4 byte alignment.
+#if !defined ( GX_DISABLE_SIMD ) && defined ( __ARM_NEON ) && defined ( __clang__ )
+
+#define GX_SIMD_NEON
+#define GX_SIMD_NAME            "NEON"
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <arm_neon.h>
+
+GX_RESTORE_WARNING_STATE
+
+typedef float32x4_t             GXSIMDFloat4;
+
+// Result is ( a[ x ], a[ y ], b[ z ], b[ w ] ). Same semantics as _mm_shuffle_ps.
+#define GXSIMDShuffle(a, b, x, y, z, w)         __builtin_shufflevector ( a, b, x, y, ( z ) + 4, ( w ) + 4 )
+
+inline GXSIMDFloat4 GXSIMDLoad ( const GXFloat* data )
+{
+    return vld1q_f32 ( data );
+}
+
+inline GXVoid GXSIMDStore ( GXFloat* data, GXSIMDFloat4 v )
+{
+    vst1q_f32 ( data, v );
+}
+
+inline GXSIMDFloat4 GXSIMDSplat ( GXFloat value )
+{
+    return vdupq_n_f32 ( value );
+}
+
+inline GXSIMDFloat4 GXSIMDAdd ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vaddq_f32 ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDSub ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vsubq_f32 ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDMul ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vmulq_f32 ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDMin ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vminq_f32 ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDMax ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vmaxq_f32 ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDAnd ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vreinterpretq_f32_u32 ( vandq_u32 ( vreinterpretq_u32_f32 ( a ), vreinterpretq_u32_f32 ( b ) ) );
+}
+
+inline GXSIMDFloat4 GXSIMDXor ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return vreinterpretq_f32_u32 ( veorq_u32 ( vreinterpretq_u32_f32 ( a ), vreinterpretq_u32_f32 ( b ) ) );
+}
+
+inline GXSIMDFloat4 GXSIMDAbs ( GXSIMDFloat4 v )
+{
+    return vabsq_f32 ( v );
+}
+
+inline GXFloat GXSIMDGetX ( GXSIMDFloat4 v )
+{
+    return vgetq_lane_f32 ( v, 0 );
+}
+
+#elif !defined ( GX_DISABLE_SIMD ) && defined ( __SSE2__ )
+
+#define GX_SIMD_SSE
+#define GX_SIMD_NAME            "SSE2"
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <emmintrin.h>
+
+GX_RESTORE_WARNING_STATE
+
+typedef __m128                  GXSIMDFloat4;
+
+// Result is ( a[ x ], a[ y ], b[ z ], b[ w ] ).
+#define GXSIMDShuffle(a, b, x, y, z, w)         _mm_shuffle_ps ( a, b, _MM_SHUFFLE ( w, z, y, x ) )
+
+inline GXSIMDFloat4 GXSIMDLoad ( const GXFloat* data )
+{
+    return _mm_loadu_ps ( data );
+}
+
+inline GXVoid GXSIMDStore ( GXFloat* data, GXSIMDFloat4 v )
+{
+    _mm_storeu_ps ( data, v );
+}
+
+inline GXSIMDFloat4 GXSIMDSplat ( GXFloat value )
+{
+    return _mm_set1_ps ( value );
+}
+
+inline GXSIMDFloat4 GXSIMDAdd ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_add_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDSub ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_sub_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDMul ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_mul_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDMin ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_min_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDMax ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_max_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDAnd ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_and_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDXor ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return _mm_xor_ps ( a, b );
+}
+
+inline GXSIMDFloat4 GXSIMDAbs ( GXSIMDFloat4 v )
+{
+    return _mm_andnot_ps ( _mm_set1_ps ( -0.0f ), v );
+}
+
+inline GXFloat GXSIMDGetX ( GXSIMDFloat4 v )
+{
+    return _mm_cvtss_f32 ( v );
+}
+
+#else
+
+#define GX_SIMD_NAME            "scalar"
+
+#endif
+
+#if defined ( GX_SIMD_NEON ) || defined ( GX_SIMD_SSE )
+
+#define GX_SIMD_ENABLED
+
+// Result is ( v[ i ], v[ i ], v[ i ], v[ i ] ).
+#define GXSIMDSplatLane(v, i)                   GXSIMDShuffle ( v, v, i, i, i, i )
+
+// Rows become columns.
+inline GXVoid GXSIMDTranspose ( GXSIMDFloat4 &r0, GXSIMDFloat4 &r1, GXSIMDFloat4 &r2, GXSIMDFloat4 &r3 )
+{
+    const GXSIMDFloat4 low01 = GXSIMDShuffle ( r0, r1, 0, 1, 0, 1 );
+    const GXSIMDFloat4 low23 = GXSIMDShuffle ( r2, r3, 0, 1, 0, 1 );
+    const GXSIMDFloat4 high01 = GXSIMDShuffle ( r0, r1, 2, 3, 2, 3 );
+    const GXSIMDFloat4 high23 = GXSIMDShuffle ( r2, r3, 2, 3, 2, 3 );
+
+    r0 = GXSIMDShuffle ( low01, low23, 0, 2, 0, 2 );
+    r1 = GXSIMDShuffle ( low01, low23, 1, 3, 1, 3 );
+    r2 = GXSIMDShuffle ( high01, high23, 0, 2, 0, 2 );
+    r3 = GXSIMDShuffle ( high01, high23, 1, 3, 1, 3 );
+}
+
+// Method splits four consecutive GXVec3 to structure of arrays. "data" must have 12 floats.
+inline GXVoid GXSIMDLoad3x4 ( GXSIMDFloat4 &x, GXSIMDFloat4 &y, GXSIMDFloat4 &z, const GXFloat* data )
+{
+    // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    const GXSIMDFloat4 v0 = GXSIMDLoad ( data );
+    const GXSIMDFloat4 v1 = GXSIMDLoad ( data + 4u );
+    const GXSIMDFloat4 v2 = GXSIMDLoad ( data + 8u );
+
+    x = GXSIMDShuffle ( v0, GXSIMDShuffle ( v1, v2, 2, 2, 1, 1 ), 0, 3, 0, 2 );
+    y = GXSIMDShuffle ( GXSIMDShuffle ( v0, v1, 1, 1, 0, 0 ), GXSIMDShuffle ( v1, v2, 3, 3, 2, 2 ), 0, 2, 0, 2 );
+    z = GXSIMDShuffle ( GXSIMDShuffle ( v0, v1, 2, 2, 1, 1 ), GXSIMDShuffle ( v2, v2, 0, 0, 3, 3 ), 0, 2, 0, 2 );
+}
+
+// Method joins structure of arrays to four consecutive GXVec3. "data" must have 12 floats.
+inline GXVoid GXSIMDStore3x4 ( GXFloat* data, GXSIMDFloat4 x, GXSIMDFloat4 y, GXSIMDFloat4 z )
+{
+    const GXSIMDFloat4 x0y0 = GXSIMDShuffle ( x, y, 0, 0, 0, 0 );
+    const GXSIMDFloat4 z0x1 = GXSIMDShuffle ( z, x, 0, 0, 1, 1 );
+    const GXSIMDFloat4 y1z1 = GXSIMDShuffle ( y, z, 1, 1, 1, 1 );
+    const GXSIMDFloat4 x2y2 = GXSIMDShuffle ( x, y, 2, 2, 2, 2 );
+    const GXSIMDFloat4 z2x3 = GXSIMDShuffle ( z, x, 2, 2, 3, 3 );
+    const GXSIMDFloat4 y3z3 = GXSIMDShuffle ( y, z, 3, 3, 3, 3 );
+
+    GXSIMDStore ( data, GXSIMDShuffle ( x0y0, z0x1, 0, 2, 0, 2 ) );
+    GXSIMDStore ( data + 4u, GXSIMDShuffle ( y1z1, x2y2, 0, 2, 0, 2 ) );
+    GXSIMDStore ( data + 8u, GXSIMDShuffle ( z2x3, y3z3, 0, 2, 0, 2 ) );
+}
+
+// Method writes only three components. So it is safe for GXVec3 destination.
+inline GXVoid GXSIMDStore3 ( GXFloat* data, GXSIMDFloat4 v )
+{
+    alignas ( 16u ) GXFloat tmp[ 4u ];
+    GXSIMDStore ( tmp, v );
+
+    data[ 0u ] = tmp[ 0u ];
+    data[ 1u ] = tmp[ 1u ];
+    data[ 2u ] = tmp[ 2u ];
+}
+
+#endif
+
+
+#endif // GX_SIMD
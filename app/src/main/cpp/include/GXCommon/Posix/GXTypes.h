@@ -4,6 +4,7 @@
 #define GX_TYPES_POSIX
 
 
+#include <stddef.h>
 #include <stdint.h>
 
 
@@ -3,11 +3,25 @@
 // Not include this explicitly! Use GXCommon/GXWarnings.h instead.
 
 
+#ifdef __clang__
+
 #define GX_SAVE_WARNING_STATE _Pragma ( "clang diagnostic push" )
 #define GX_RESTORE_WARNING_STATE _Pragma ( "clang diagnostic pop" )
 
 #define GX_WARNING_HELPER0(x) #x
 #define GX_WARNING_HELPER1(x) GX_WARNING_HELPER0 ( clang diagnostic ignored x )
+
+#else
+
+// Note GCC is used by the host builds only.
+#define GX_SAVE_WARNING_STATE _Pragma ( "GCC diagnostic push" )
+#define GX_RESTORE_WARNING_STATE _Pragma ( "GCC diagnostic pop" )
+
+#define GX_WARNING_HELPER0(x) #x
+#define GX_WARNING_HELPER1(x) GX_WARNING_HELPER0 ( GCC diagnostic ignored x )
+
+#endif // __clang__
+
 #define GX_WARNING_HELPER2(x) GX_WARNING_HELPER1 ( #x )
 #define GX_DISABLE_WARNING(x) _Pragma ( GX_WARNING_HELPER2 ( x ) )
 
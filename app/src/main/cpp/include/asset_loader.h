@@ -0,0 +1,98 @@
+#ifndef ANDROID_VULKAN_ASSET_LOADER_H
+#define ANDROID_VULKAN_ASSET_LOADER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include "file.h"
+
+
+namespace android_vulkan {
+
+enum class eAssetPriority : uint8_t
+{
+    Low = 0U,
+    Normal = 1U,
+    High = 2U
+};
+
+// Note the file is nullptr if the file can't be loaded or the request is cancelled.
+using AssetCallback = std::function<void ( const std::shared_ptr<File> &file )>;
+using AssetFuture = std::shared_future<std::shared_ptr<File>>;
+
+// The class maps requested files on the background I/O thread and touches every page of the mapping. So the caller
+// never stalls on page faults later. Requests with higher priority are served first. Requests with equal priority
+// are served in order of arrival. Duplicate requests of the file which is not loaded yet share single load.
+class AssetLoader final
+{
+    private:
+        struct Item final
+        {
+            std::vector<AssetCallback>                                  _callbacks;
+            AssetFuture                                                 _future;
+            size_t                                                      _order;
+            eAssetPriority                                              _priority;
+            std::promise<std::shared_ptr<File>>                         _promise;
+        };
+
+        using Items = std::unordered_map<std::string, std::unique_ptr<Item>>;
+
+    private:
+        std::condition_variable                                         _idleCondition;
+        bool                                                            _isStopped;
+        std::unique_ptr<Item>                                           _loading;
+        std::string                                                     _loadingPath;
+        std::mutex                                                      _mutex;
+        size_t                                                          _nextOrder;
+        Items                                                           _pending;
+        std::thread                                                     _thread;
+        std::condition_variable                                         _wakeCondition;
+
+    public:
+        AssetLoader ();
+        ~AssetLoader () = default;
+
+        AssetLoader ( const AssetLoader &other ) = delete;
+        AssetLoader& operator = ( const AssetLoader &other ) = delete;
+
+        void Init ();
+
+        // Note the method cancels all pending requests.
+        void Destroy ();
+
+        // Method resolves all pending requests with nullptr file. The method blocks until the file which is being
+        // loaded right now is delivered. So no callback is invoked after the method returns.
+        void Cancel ();
+
+        // Note "callback" could be empty. Callbacks are invoked on the I/O thread.
+        // Priority of the duplicate request is raised if needed.
+        AssetFuture Request ( std::string &&path, eAssetPriority priority, AssetCallback &&callback = {} );
+
+    private:
+        void Deliver ( Item &item, const std::shared_ptr<File> &file );
+        void Worker ();
+
+        static void Prefault ( const File &file );
+};
+
+// Note the asset loader is owned by Core. The pointer is valid during whole application life time.
+extern AssetLoader* g_AssetLoader;
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_ASSET_LOADER_H
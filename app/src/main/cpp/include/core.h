@@ -11,25 +11,32 @@ GX_DISABLE_COMMON_WARNINGS
 
 GX_RESTORE_WARNING_STATE
 
+#include "asset_loader.h"
+#include "frame_timing.h"
 #include "game.h"
+#include "job_system.h"
 
 
 namespace android_vulkan {
 
 class Core final
 {
-    using timestamp = std::chrono::time_point<std::chrono::system_clock>;
+    using timestamp = std::chrono::steady_clock::time_point;
 
     private:
         Game&           _game;
 
+        AssetLoader     _assetLoader;
+        FrameTiming     _frameTiming;
+        JobSystem       _jobSystem;
         Renderer        _renderer;
+        size_t          _fpsFrames;
         timestamp       _fpsTimestamp;
         timestamp       _frameTimestamp;
 
     public:
         explicit Core ( android_app &app, Game &game );
-        ~Core () = default;
+        ~Core ();
 
         Core ( const Core &other ) = delete;
         Core& operator = ( const Core &other ) = delete;
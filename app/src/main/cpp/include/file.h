@@ -12,16 +12,34 @@ GX_DISABLE_COMMON_WARNINGS
 GX_RESTORE_WARNING_STATE
 
 
+struct AAsset;
+
 namespace android_vulkan {
 
+// Application wide statistics of File objects.
+struct FileStats final
+{
+    size_t                  _copiedBytes;
+    size_t                  _mappedBytes;
+    double                  _loadTime;      // seconds
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class File final
 {
     private:
         std::string             _filePath;
         std::vector<uint8_t>    _content;
 
+        const uint8_t*          _mappedData;
+        size_t                  _mappedSize;
+
+        // Note the asset is used by Android builds only.
+        AAsset*                 _asset;
+
     public:
-        File () = default;
+        File ();
 
         // note "const std::string &" version is not implemented to distinguish rvalue|lvalue reference.
         explicit File ( std::string &filePath );
@@ -30,13 +48,37 @@ class File final
         File ( File &other ) = delete;
         File& operator = ( const File &other ) = delete;
 
-        ~File () = default;
+        ~File ();
 
         std::vector<uint8_t>& GetContent ();
         [[maybe_unused]] const std::vector<uint8_t>& GetContent () const;
 
+        // Methods return either mapped or loaded content. See File::MapContent and File::LoadContent.
+        const uint8_t* GetData () const;
+        size_t GetSize () const;
+
+        const std::string& GetPath () const;
+
         bool IsContentLoaded () const;
         bool LoadContent ();
+
+        // Method exposes read-only file content without copying it to the heap. The content stays valid until
+        // the File object is destroyed. Use File::GetData and File::GetSize to access the content.
+        // The method returns true if success. Otherwise the method returns false.
+        bool MapContent ();
+
+        static void GetStats ( FileStats &stats );
+
+#ifndef __ANDROID__
+
+        // Host builds have no asset manager. File paths are resolved relative to the "directory" instead.
+        // Note the method must be called before any file is opened.
+        static void SetAssetDirectory ( std::string &&directory );
+
+#endif // __ANDROID__
+
+    private:
+        void Unmap ();
 };
 
 } // namespace android_vulkan
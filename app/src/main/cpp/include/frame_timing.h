@@ -0,0 +1,110 @@
+#ifndef ANDROID_VULKAN_FRAME_TIMING_H
+#define ANDROID_VULKAN_FRAME_TIMING_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+enum class eFrameTimingStage : uint8_t
+{
+    Interval,       // time between starts of the consecutive frames
+    Frame,          // CPU time of Game::OnFrame
+    Record,         // command buffer recording
+    Acquire,        // vkAcquireNextImageKHR
+    FenceWait,      // waiting for the command buffer of the acquired image
+    Present,        // vkQueuePresentKHR
+    GPU             // timestamp queries around the render pass
+};
+
+constexpr static const size_t FRAME_TIMING_STAGES = 7U;
+constexpr static const size_t FRAME_TIMING_SAMPLES = 1024U;
+
+// All values are in milliseconds.
+struct FrameTimingStats final
+{
+    size_t                  _samples;
+    float                   _p50;
+    float                   _p95;
+    float                   _p99;
+    float                   _worst;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// The class keeps the fixed-size ring of the latest frame samples. Recording is several stores per frame. Sorting
+// happens only when the statistics are requested. Note the class is not thread safe. All calls are expected from
+// the main thread.
+class FrameTiming final
+{
+    using Sample = std::array<float, FRAME_TIMING_STAGES>;
+
+    private:
+        Sample                                          _current;
+        size_t                                          _frames;
+        std::array<Sample, FRAME_TIMING_SAMPLES>        _samples;
+
+    public:
+        FrameTiming ();
+        ~FrameTiming () = default;
+
+        FrameTiming ( const FrameTiming &other ) = delete;
+        FrameTiming& operator = ( const FrameTiming &other ) = delete;
+
+        void BeginFrame ();
+        void EndFrame ();
+
+        // Several records of the same stage in one frame are accumulated.
+        void Record ( eFrameTimingStage stage, float milliseconds );
+        void Record ( eFrameTimingStage stage, std::chrono::steady_clock::duration duration );
+
+        // Method drops all samples.
+        void Reset ();
+
+        // The method returns false if there is no sample of the stage. Otherwise the method returns true.
+        bool GetStats ( FrameTimingStats &stats, eFrameTimingStage stage ) const;
+
+        // Method logs percentiles of all stages which have samples.
+        void Report () const;
+
+        // Method logs histogram of the stage with 1 ms buckets.
+        void DumpHistogram ( eFrameTimingStage stage ) const;
+
+    private:
+        size_t GetSampleCount () const;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Helper records the time which is spent inside the scope into g_FrameTiming. The helper does nothing if
+// g_FrameTiming is nullptr.
+class FrameTimingScope final
+{
+    private:
+        eFrameTimingStage                               _stage;
+        std::chrono::steady_clock::time_point           _start;
+
+    public:
+        explicit FrameTimingScope ( eFrameTimingStage stage );
+        ~FrameTimingScope ();
+
+        FrameTimingScope ( const FrameTimingScope &other ) = delete;
+        FrameTimingScope& operator = ( const FrameTimingScope &other ) = delete;
+};
+
+// Note the frame timing is owned by Core. The pointer is valid during whole application life time.
+extern FrameTiming* g_FrameTiming;
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_FRAME_TIMING_H
@@ -0,0 +1,47 @@
+#ifndef ANDROID_VULKAN_GPU_TIMER_H
+#define ANDROID_VULKAN_GPU_TIMER_H
+
+
+#include "renderer.h"
+
+
+namespace android_vulkan {
+
+// The class measures GPU time of the command buffer parts via timestamp queries. Every slot owns a pair of queries.
+// Usually slot is the index of the swapchain image. So the results of the slot are read after the fence of the image
+// is waited. The timer is disabled silently if the queue does not support timestamps.
+class GPUTimer final
+{
+    private:
+        bool                    _isEnabled;
+        float                   _period;
+        VkQueryPool             _queryPool;
+        size_t                  _slots;
+
+    public:
+        GPUTimer ();
+        ~GPUTimer () = default;
+
+        GPUTimer ( const GPUTimer &other ) = delete;
+        GPUTimer& operator = ( const GPUTimer &other ) = delete;
+
+        // The method returns true if success. Otherwise the method returns false.
+        bool Init ( Renderer &renderer, size_t slots );
+        void Destroy ( Renderer &renderer );
+
+        bool IsEnabled () const;
+
+        // Note both methods must be called outside the render pass. The commands are valid for resubmission of
+        // the pre-recorded command buffer because the queries of the slot are reset by GPUTimer::RecordBegin.
+        void RecordBegin ( VkCommandBuffer commandBuffer, size_t slot ) const;
+        void RecordEnd ( VkCommandBuffer commandBuffer, size_t slot ) const;
+
+        // Non blocking read of the slot results. The method returns false if the results are not available.
+        // Otherwise the method returns true.
+        bool Resolve ( float &milliseconds, VkDevice device, size_t slot ) const;
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_GPU_TIMER_H
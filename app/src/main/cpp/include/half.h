@@ -0,0 +1,32 @@
+#ifndef ANDROID_VULKAN_HALF_H
+#define ANDROID_VULKAN_HALF_H
+
+
+#include <cstdint>
+
+
+namespace android_vulkan {
+
+// float16 data type
+class Half final
+{
+    private:
+        uint16_t        data;
+
+    public:
+        Half ();
+        Half ( float value );
+
+        Half ( const Half &other ) = default;
+        ~Half () = default;
+
+        Half& operator = ( const Half &other ) = default;
+
+        // Raw float16 bits.
+        uint16_t GetData () const;
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_HALF_H
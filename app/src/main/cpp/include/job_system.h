@@ -0,0 +1,118 @@
+#ifndef ANDROID_VULKAN_JOB_SYSTEM_H
+#define ANDROID_VULKAN_JOB_SYSTEM_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+using Job = std::function<void ()>;
+using RangeJob = std::function<void ( size_t begin, size_t end )>;
+
+// The counter tracks completion of the group of jobs. Also it is used to express dependency between jobs.
+// Note the counter must outlive all jobs which refer to it. Use JobSystem::Wait before destruction.
+class JobCounter final
+{
+    friend class JobSystem;
+
+    private:
+        struct Task final
+        {
+            Job                                 _job;
+            JobCounter*                         _counter;
+        };
+
+    private:
+        std::vector<Task>                       _dependents;
+        std::mutex                              _mutex;
+        std::atomic<size_t>                     _pending;
+
+    public:
+        JobCounter ();
+        ~JobCounter () = default;
+
+        JobCounter ( const JobCounter &other ) = delete;
+        JobCounter& operator = ( const JobCounter &other ) = delete;
+
+        bool IsDone () const;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Engine-wide pool of worker threads. Every worker owns a deque of tasks. Worker takes tasks from the back of its own
+// deque and steals from the front of other deques when its own deque is empty. The thread which waits for
+// the counter executes pending tasks too. So nested JobSystem::ParallelFor calls do not dead lock.
+class JobSystem final
+{
+    private:
+        using Task = JobCounter::Task;
+
+        struct Queue final
+        {
+            std::deque<Task>                    _tasks;
+            std::mutex                          _mutex;
+        };
+
+    private:
+        bool                                    _isStopped;
+        std::atomic<size_t>                     _nextQueue;
+        std::vector<std::unique_ptr<Queue>>     _queues;
+        std::atomic<size_t>                     _queuedTasks;
+        std::condition_variable                 _sleepCondition;
+        std::mutex                              _sleepMutex;
+        std::vector<std::thread>                _workers;
+
+    public:
+        JobSystem ();
+        ~JobSystem () = default;
+
+        JobSystem ( const JobSystem &other ) = delete;
+        JobSystem& operator = ( const JobSystem &other ) = delete;
+
+        // Method spawns one worker per CPU core except the calling one.
+        void Init ();
+
+        // Note all counters must be done before this call.
+        void Destroy ();
+
+        size_t GetWorkerCount () const;
+
+        // "counter" could be nullptr. Otherwise the counter is done when the job is done.
+        // "dependency" could be nullptr. Otherwise the job is not started until the dependency counter is done.
+        void Run ( Job &&job, JobCounter* counter, JobCounter* dependency = nullptr );
+
+        // Range [0, count) is split into the chunks of "grain" items. Zero "grain" selects chunk size automatically.
+        // The method blocks until all chunks are done. The calling thread executes chunks too.
+        void ParallelFor ( size_t count, size_t grain, const RangeJob &job );
+
+        // The calling thread executes pending tasks until the counter is done.
+        void Wait ( JobCounter &counter );
+
+    private:
+        void Complete ( JobCounter* counter );
+        void Enqueue ( Task &&task );
+        bool TryExecute ( size_t ownQueue );
+        void Worker ( size_t index );
+};
+
+// Note the job system is owned by Core. The pointer is valid during whole application life time.
+extern JobSystem* g_JobSystem;
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_JOB_SYSTEM_H
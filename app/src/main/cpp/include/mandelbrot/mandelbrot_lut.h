@@ -0,0 +1,37 @@
+#ifndef MANDELBROT_LUT_H
+#define MANDELBROT_LUT_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace mandelbrot {
+
+constexpr static const uint32_t LUT_SAMPLE_COUNT = 512U;
+constexpr static const size_t LUT_SAMPLE_SIZE = 4U;
+
+// Hue palette of the Mandelbrot set as R8G8B8A8_UNORM row. The class has no Vulkan dependency so it is built for
+// the host too.
+class MandelbrotLUT final
+{
+    public:
+        MandelbrotLUT () = delete;
+
+        MandelbrotLUT ( const MandelbrotLUT &other ) = delete;
+        MandelbrotLUT& operator = ( const MandelbrotLUT &other ) = delete;
+
+        // Method fills LUT_SAMPLE_COUNT * LUT_SAMPLE_SIZE bytes of "samples" on the job system workers.
+        static void Generate ( uint8_t* samples );
+};
+
+} // namespace mandelbrot
+
+
+#endif // MANDELBROT_LUT_H
@@ -3,6 +3,7 @@
 
 
 #include "mandelbrot_base.h"
+#include <upload_scheduler.h>
 
 
 namespace mandelbrot {
@@ -16,9 +17,11 @@ class MandelbrotLUTColor final : public MandelbrotBase
 
         VkImage                     _lut;
         VkDeviceMemory              _lutDeviceMemory;
+        VkDeviceSize                _lutDeviceMemoryOffset;
         VkImageView                 _lutView;
 
         VkSampler                   _sampler;
+        android_vulkan::UploadScheduler _uploadScheduler;
 
     public:
         MandelbrotLUTColor ();
@@ -29,6 +32,7 @@ class MandelbrotLUTColor final : public MandelbrotBase
 
     private:
         bool OnInit ( android_vulkan::Renderer &renderer ) override;
+        bool OnFrame ( android_vulkan::Renderer &renderer, double deltaTime ) override;
         bool OnDestroy ( android_vulkan::Renderer &renderer ) override;
 
         bool CreatePipelineLayout ( android_vulkan::Renderer &renderer ) override;
@@ -43,7 +47,6 @@ class MandelbrotLUTColor final : public MandelbrotBase
         bool CreateLUT ( android_vulkan::Renderer &renderer );
         void DestroyLUT ( android_vulkan::Renderer &renderer );
 
-        void InitLUTSamples ( uint8_t* samples ) const;
         bool UploadLUTSamples ( android_vulkan::Renderer &renderer );
 };
 
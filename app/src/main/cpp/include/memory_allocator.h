@@ -0,0 +1,104 @@
+#ifndef ANDROID_VULKAN_MEMORY_ALLOCATOR_H
+#define ANDROID_VULKAN_MEMORY_ALLOCATOR_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan_wrapper.h>
+
+GX_RESTORE_WARNING_STATE
+
+#include "memory_chunk.h"
+
+
+namespace android_vulkan {
+
+// The class reserves big VkDeviceMemory blocks per memory type and hands out aligned sub-ranges of them.
+// Requests which are bigger than the half of the block get their own dedicated VkDeviceMemory object. Single empty
+// block per memory type is kept until MemoryAllocator::Destroy.
+// Lazily allocated memory always gets its own VkDeviceMemory object. So every transient attachment is committed
+// independently.
+// Host visible blocks are mapped once and stay mapped while at least one sub-range is mapped by user.
+// The class is thread safe.
+class MemoryAllocator final
+{
+    private:
+        struct Block final
+        {
+            MemoryChunk                 _chunk;
+            bool                        _isDedicated;
+            size_t                      _mapCounter;
+            void*                       _mappedData;
+            VkDeviceMemory              _memory;
+            uint32_t                    _memoryTypeIndex;
+
+            Block () = delete;
+
+            Block ( const Block &other ) = delete;
+            Block& operator = ( const Block &other ) = delete;
+
+            explicit Block ( VkDeviceSize size,
+                VkDeviceSize granularity,
+                bool isDedicated,
+                VkDeviceMemory memory,
+                uint32_t memoryTypeIndex
+            );
+            ~Block () = default;
+        };
+
+        using BlockStorage = std::map<VkDeviceMemory, std::unique_ptr<Block>>;
+
+    private:
+        BlockStorage                    _blocks;
+        VkDeviceSize                    _bufferImageGranularity;
+        uint32_t                        _dedicatedTypes;
+        VkDevice                        _device;
+        mutable std::mutex              _mutex;
+        std::vector<Block*>             _typeBlocks[ VK_MAX_MEMORY_TYPES ];
+
+    public:
+        MemoryAllocator ();
+        ~MemoryAllocator () = default;
+
+        MemoryAllocator ( const MemoryAllocator &other ) = delete;
+        MemoryAllocator& operator = ( const MemoryAllocator &other ) = delete;
+
+        // "bufferImageGranularity" is taken from VkPhysicalDeviceLimits. Linear and optimal resources could share
+        // the same block. So every sub-range is aligned to that value.
+        void Init ( VkDevice device,
+            VkDeviceSize bufferImageGranularity,
+            const VkPhysicalDeviceMemoryProperties &memoryProperties
+        );
+        void Destroy ();
+
+        // Note resource must be bound to "memory" at "offset".
+        VkResult Allocate ( VkDeviceMemory &memory,
+            VkDeviceSize &offset,
+            const VkMemoryRequirements &requirements,
+            uint32_t memoryTypeIndex
+        );
+
+        void Free ( VkDeviceMemory memory, VkDeviceSize offset );
+
+        // Note the memory must be allocated with VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT.
+        // "ptr" points to the beginning of the sub-range.
+        VkResult Map ( void* &ptr, VkDeviceMemory memory, VkDeviceSize offset );
+        void Unmap ( VkDeviceMemory memory );
+
+        void GetStats ( MemoryAllocatorStats &stats ) const;
+
+    private:
+        VkResult CreateBlock ( Block* &block, VkDeviceSize size, bool isDedicated, uint32_t memoryTypeIndex );
+        void DestroyBlock ( Block &block );
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_MEMORY_ALLOCATOR_H
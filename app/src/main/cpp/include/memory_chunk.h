@@ -0,0 +1,99 @@
+#ifndef ANDROID_VULKAN_MEMORY_CHUNK_H
+#define ANDROID_VULKAN_MEMORY_CHUNK_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+// Placement logic of the single memory block. The class knows nothing about Vulkan objects. It just tracks which
+// ranges of the block are occupied. Free ranges are merged with neighbours on release. The sizes are uint64_t which
+// is the same type as VkDeviceSize. So the class is built and tested on the host. See MemoryAllocator.
+class MemoryChunk final
+{
+    private:
+        std::map<uint64_t, uint64_t>    _allocations;
+        std::map<uint64_t, uint64_t>    _freeRanges;
+
+        uint64_t                        _granularity;
+        uint64_t                        _size;
+        uint64_t                        _used;
+
+    public:
+        MemoryChunk () = delete;
+
+        MemoryChunk ( const MemoryChunk &other ) = delete;
+        MemoryChunk& operator = ( const MemoryChunk &other ) = delete;
+
+        // "granularity" must be power of two. Every sub-range is aligned and padded to it. So the neighbours never
+        // share the granularity page. See VkPhysicalDeviceLimits::bufferImageGranularity.
+        MemoryChunk ( uint64_t size, uint64_t granularity );
+        ~MemoryChunk () = default;
+
+        // Method uses best fit strategy. "alignment" must be power of two.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Allocate ( uint64_t &offset, uint64_t size, uint64_t alignment );
+
+        // Note "offset" must be the value which was returned by MemoryChunk::Allocate.
+        void Free ( uint64_t offset );
+
+        size_t GetAllocationCount () const;
+        size_t GetFreeRangeCount () const;
+        uint64_t GetLargestFreeRange () const;
+        uint64_t GetSize () const;
+
+        // Note the padding to the granularity is counted as used.
+        uint64_t GetUsed () const;
+
+        bool IsEmpty () const;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct MemoryAllocatorStats final
+{
+    size_t          _allocations;
+    size_t          _blocks;
+    size_t          _dedicatedBlocks;
+
+    uint64_t        _bytesReserved;
+    uint64_t        _bytesUsed;
+
+    // 0.0 means that all free memory of every block is one contiguous range.
+    // Value close to 1.0 means that free memory is split into many small ranges.
+    float           _fragmentation;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// The class sums the stats of several chunks. The fragmentation is measured over the free bytes of all chunks.
+class MemoryStatsCollector final
+{
+    private:
+        uint64_t                _largestFreeRanges;
+        MemoryAllocatorStats    _stats;
+
+    public:
+        MemoryStatsCollector ();
+        ~MemoryStatsCollector () = default;
+
+        MemoryStatsCollector ( const MemoryStatsCollector &other ) = delete;
+        MemoryStatsCollector& operator = ( const MemoryStatsCollector &other ) = delete;
+
+        void Add ( const MemoryChunk &chunk, bool isDedicated );
+        void GetStats ( MemoryAllocatorStats &stats ) const;
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_MEMORY_CHUNK_H
@@ -0,0 +1,56 @@
+#ifndef ANDROID_VULKAN_PIPELINE_CACHE_FILE_H
+#define ANDROID_VULKAN_PIPELINE_CACHE_FILE_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+// Value of VK_UUID_SIZE. The file format has no Vulkan dependency so the value is repeated here.
+constexpr const size_t PIPELINE_CACHE_UUID_SIZE = 16U;
+
+// The fields of VkPhysicalDeviceProperties which must match the Vulkan pipeline cache header.
+struct PipelineCacheDevice final
+{
+    uint32_t                    _vendorID;
+    uint32_t                    _deviceID;
+    uint8_t                     _pipelineCacheUUID[ PIPELINE_CACHE_UUID_SIZE ];
+};
+
+// File format of the persistent pipeline cache. The file header with the magic, the data size and FNV-1a hash
+// precedes the driver data. It allows to detect truncated or damaged files before the data reaches the driver.
+// The class has no Vulkan dependency so it is built for the host too.
+class PipelineCacheFile final
+{
+    public:
+        PipelineCacheFile () = delete;
+
+        PipelineCacheFile ( const PipelineCacheFile &other ) = delete;
+        PipelineCacheFile& operator = ( const PipelineCacheFile &other ) = delete;
+
+        // Method returns offset of the driver data in the file.
+        static size_t GetDataOffset ();
+
+        // Method writes the file header. The driver data must be in "file" at PipelineCacheFile::GetDataOffset
+        // already.
+        static void WriteHeader ( std::vector<uint8_t> &file );
+
+        // Method checks the file header, the data hash and the Vulkan pipeline cache header. The vendor, the device
+        // and the pipeline cache UUID must match "device".
+        // The method returns true if success. Otherwise the method returns false.
+        static bool Validate ( const std::vector<uint8_t> &file, const PipelineCacheDevice &device );
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_PIPELINE_CACHE_FILE_H
@@ -7,6 +7,7 @@
 GX_DISABLE_COMMON_WARNINGS
 
 #include <map>
+#include <string>
 #include <vector>
 #include <vulkan_wrapper.h>
 #include <android/native_window.h>
@@ -15,6 +16,9 @@ GX_RESTORE_WARNING_STATE
 
 #include <GXCommon/GXMath.h>
 #include "logger.h"
+#include "memory_allocator.h"
+#include "pipeline_cache_file.h"
+#include "sampler_cache.h"
 
 
 namespace android_vulkan {
@@ -45,16 +49,29 @@ class Renderer final
     private:
         VkFormat                                                            _depthStencilImageFormat;
         VkDevice                                                            _device;
+
+        // Note the pointers are nullptr if VK_KHR_draw_indirect_count is not supported.
+        PFN_vkCmdDrawIndexedIndirectCountKHR                                vkCmdDrawIndexedIndirectCountKHR;
+        PFN_vkCmdDrawIndirectCountKHR                                       vkCmdDrawIndirectCountKHR;
+
         VkInstance                                                          _instance;
 
+        bool                                                                _isDescriptorIndexingSupported;
         bool                                                                _isDeviceExtensionChecked;
         bool                                                                _isDeviceExtensionSupported;
+        bool                                                                _isPipelineCacheWarm;
 
+        MemoryAllocator                                                     _memoryAllocator;
         VkPhysicalDevice                                                    _physicalDevice;
 
+        VkPipelineCache                                                     _pipelineCache;
+        std::string                                                         _pipelineCacheFile;
+
         VkQueue                                                             _queue;
         uint32_t                                                            _queueFamilyIndex;
 
+        SamplerCache                                                        _samplerCache;
+
         VkSurfaceKHR                                                        _surface;
         VkFormat                                                            _surfaceFormat;
         VkExtent2D                                                          _surfaceSize;
@@ -79,6 +96,7 @@ class Renderer final
         std::vector<VkPhysicalDeviceGroupProperties>                        _physicalDeviceGroups;
         std::map<VkPhysicalDevice, VulkanPhysicalDeviceInfo>                _physicalDeviceInfo;
         VkPhysicalDeviceMemoryProperties                                    _physicalDeviceMemoryProperties;
+        VkPhysicalDeviceProperties                                          _physicalDeviceProperties;
 
         std::vector<VkSurfaceFormatKHR>                                     _surfaceFormats;
 
@@ -102,6 +120,18 @@ class Renderer final
         Renderer ( const Renderer &other ) = delete;
         Renderer& operator = ( const Renderer &other ) = delete;
 
+        // Method returns the shared sampler with the same state. The samplers are counted by references. So every
+        // successful call must be paired with Renderer::ReleaseSampler. Note "info" must not contain the extension
+        // structures.
+        // The method returns true if success. Otherwise the method returns false.
+        bool AcquireSampler ( VkSampler &sampler,
+            const VkSamplerCreateInfo &info,
+            const char* from,
+            const char* message
+        );
+
+        void ReleaseSampler ( VkSampler sampler );
+
         // Method returns true if swapchain does not change. User code can safely render frames.
         // Otherwise method returns false.
         bool CheckSwapchainStatus ();
@@ -114,9 +144,19 @@ class Renderer final
             const char* errorMessage
         ) const;
 
+        // Note "memory" and "offset" must be the values which were returned by Renderer::TryAllocateMemory.
+        void FreeMemory ( VkDeviceMemory memory, VkDeviceSize offset );
+
         VkFormat GetDefaultDepthStencilFormat () const;
         VkDevice GetDevice () const;
 
+        // Methods return the commands of VK_KHR_draw_indirect_count extension. The extension is enabled if
+        // the device supports it. Otherwise the methods return nullptr.
+        PFN_vkCmdDrawIndexedIndirectCountKHR GetDrawIndexedIndirectCount () const;
+        PFN_vkCmdDrawIndirectCountKHR GetDrawIndirectCount () const;
+
+        void GetMemoryAllocatorStats ( MemoryAllocatorStats &stats ) const;
+
         size_t GetPresentImageCount () const;
         const VkImageView& GetPresentImageView ( size_t imageIndex ) const;
 
@@ -126,6 +166,15 @@ class Renderer final
         // https://github.com/KhronosGroup/Vulkan-Samples/blob/master/samples/performance/surface_rotation/surface_rotation_tutorial.md
         const GXMat4& GetPresentationEngineTransform () const;
 
+        // Limits and features of the physical device which was selected for rendering. Note all supported features
+        // are enabled.
+        const VkPhysicalDeviceFeatures& GetPhysicalDeviceFeatures () const;
+        const VkPhysicalDeviceLimits& GetPhysicalDeviceLimits () const;
+
+        // The cache must be passed to every vkCreate*Pipelines call. Note the result could be VK_NULL_HANDLE if
+        // the cache was not created. It is still valid argument for pipeline creation.
+        VkPipelineCache GetPipelineCache () const;
+
         VkQueue GetQueue () const;
         uint32_t GetQueueFamilyIndex () const;
         VkFormat GetSurfaceFormat () const;
@@ -137,9 +186,33 @@ class Renderer final
         // by Renderer::GetSurfaceSize API.
         const VkExtent2D& GetViewportResolution () const;
 
+        // Method returns true if VK_EXT_descriptor_indexing is enabled with the runtime descriptor arrays and
+        // the partially bound descriptors.
+        bool IsDescriptorIndexingSupported () const;
+
+        // Method checks the optimal tiling features of the format on the selected physical device.
+        bool IsFormatFeatureSupported ( VkFormat format, VkFormatFeatureFlags features ) const;
+
+        // Method returns true if the pipeline cache was populated from the data of the previous run.
+        bool IsPipelineCacheWarm () const;
+
         bool IsReady () const;
 
-        bool OnInit ( ANativeWindow &nativeWindow, bool vSync );
+        // Note the memory must be allocated with VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT. Several resources could share
+        // the same VkDeviceMemory object. So Vulkan mapping API must not be used directly.
+        // The method returns true if success. Otherwise the method returns false.
+        bool MapMemory ( void* &ptr,
+            VkDeviceMemory memory,
+            VkDeviceSize offset,
+            const char* from,
+            const char* message
+        );
+
+        void UnmapMemory ( VkDeviceMemory memory );
+
+        // "dataDirectory" is the application private directory where the pipeline cache is stored between runs.
+        // It could be nullptr. In that case the pipeline cache is not persistent.
+        bool OnInit ( ANativeWindow &nativeWindow, bool vSync, const char* dataDirectory );
         void OnDestroy ();
 
         const char* ResolveVkFormat ( VkFormat format ) const;
@@ -149,12 +222,14 @@ class Renderer final
             VkMemoryPropertyFlags memoryProperties
         ) const;
 
-        // Note method will invoke AV_REGISTER_DEVICE_MEMORY internally if success.
+        // Note the memory is sub-allocated from the bigger block. So the resource must be bound at "offset".
+        // Use Renderer::FreeMemory to release the memory.
         bool TryAllocateMemory ( VkDeviceMemory &memory,
+            VkDeviceSize &offset,
             const VkMemoryRequirements &requirements,
             VkMemoryPropertyFlags memoryProperties,
             const char* errorMessage
-        ) const;
+        );
 
     private:
 
@@ -176,6 +251,12 @@ class Renderer final
         bool DeployInstance ();
         void DestroyInstance ();
 
+        // Note pipeline cache is optional. So the failure is not fatal.
+        void DeployPipelineCache ();
+        void DestroyPipelineCache ();
+        bool LoadPipelineCacheData ( std::vector<uint8_t> &data ) const;
+        void SavePipelineCacheData () const;
+
         bool DeploySurface ( ANativeWindow &nativeWindow );
         void DestroySurface ();
 
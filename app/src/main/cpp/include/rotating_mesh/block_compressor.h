@@ -0,0 +1,68 @@
+#ifndef ROTATING_MESH_BLOCK_COMPRESSOR_H
+#define ROTATING_MESH_BLOCK_COMPRESSOR_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr const uint32_t COMPRESSION_BLOCK_SIDE = 4U;
+constexpr const size_t COMPRESSION_BLOCK_TEXELS = 16U;
+
+enum class eBlockCompression : uint8_t
+{
+    None,
+    BC,
+    ETC2
+};
+
+// Offline encoder of the 4x4 block formats. The opaque images use the 8 byte blocks: BC1 or ETC2 RGB8. Other images
+// use the 16 byte blocks: BC3 or ETC2 RGBA8 with EAC alpha. ETC2 blocks are written in the individual and
+// the differential modes only. So they are decodable by ETC1 hardware too. The class has no Vulkan dependency so it is
+// built for the host too.
+class BlockCompressor final
+{
+    public:
+        BlockCompressor () = delete;
+
+        BlockCompressor ( const BlockCompressor &other ) = delete;
+        BlockCompressor& operator = ( const BlockCompressor &other ) = delete;
+
+        // Method returns the KTX2 format for the image. See KTX2_FORMAT_* constants.
+        static uint32_t SelectFormat ( eBlockCompression compression, bool isSRGB, bool isOpaque );
+
+        // Method compresses the four channel level. The partial blocks repeat the edge texels. The block rows are
+        // compressed on the job system workers. "destination" must have KTX2Parser::GetLevelSize bytes.
+        static void Compress ( uint8_t* destination,
+            const uint8_t* rgba,
+            uint32_t width,
+            uint32_t height,
+            uint32_t format
+        );
+
+        // Method decodes the block to 16 texels in row order. The method supports the modes which are written by
+        // BlockCompressor::Compress only. It is used for the error measurement.
+        static void Decompress ( uint8_t* texels, const uint8_t* block, uint32_t format );
+
+        // Method returns the peak signal to noise ratio of the compressed level in decibels. All four channels are
+        // measured. The method returns infinity for the lossless result.
+        static double ComputePSNR ( const uint8_t* level,
+            const uint8_t* rgba,
+            uint32_t width,
+            uint32_t height,
+            uint32_t format
+        );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_BLOCK_COMPRESSOR_H
@@ -2,23 +2,63 @@
 #define ROTATING_MESH_GAME_H
 
 
+#include <asset_loader.h>
 #include <game.h>
+#include <gpu_timer.h>
+#include <upload_scheduler.h>
 #include <vulkan_utils.h>
 #include <GXCommon/GXMath.h>
 #include "drawcall.h"
+#include "gpu_culling.h"
+#include "material_table.h"
 #include "mesh_geometry.h"
+#include "mipmap_generator.h"
 #include "texture2D.h"
+#include "texture_decoder.h"
 #include "uniform_buffer.h"
 
 
 namespace rotating_mesh {
 
 constexpr const size_t MATERIAL_COUNT = 3U;
+constexpr const size_t STREAMED_TEXTURE_COUNT = 5U;
 
 class Game : public android_vulkan::Game
 {
     private:
-        using CommandContext = std::pair<VkCommandBuffer, VkFence>;
+        using Timestamp = std::chrono::steady_clock::time_point;
+
+        // Textures are streamed in after the first frame. The placeholders are used until then.
+        enum class eStreamingState : uint8_t
+        {
+            Idle,
+            Loading,
+            Decoding,
+            Uploading,
+            Uploaded
+        };
+
+        // Every frame in flight owns its command buffers and synchronization primitives. So CPU records the next
+        // frame while GPU executes the previous one. The command pools are reset as a whole every frame. Every batch
+        // of draws is recorded by its own job. So every batch owns the command pool too.
+        struct FrameInFlight final
+        {
+            VkCommandBuffer                 _commandBuffer;
+            VkCommandPool                   _commandPool;
+            VkFence                         _fence;
+            VkSemaphore                     _renderTargetAcquiredSemaphore;
+
+            std::vector<VkCommandBuffer>    _batchBuffers;
+            std::vector<VkCommandPool>      _batchPools;
+        };
+
+        // Every draw of the scene renders its own range of the instance buffer. So every draw has its own
+        // placement and the culling rejects the draws one by one.
+        struct SceneDraw final
+        {
+            const Drawcall*                 _drawcall;
+            uint32_t                        _firstInstance;
+        };
 
         AV_DX_ALIGNMENT_BEGIN
 
@@ -37,8 +77,18 @@ class Game : public android_vulkan::Game
         VkDescriptorSetLayout           _descriptorSetLayout;
 
         Drawcall                        _drawcalls[ MATERIAL_COUNT ];
+
+        // The table mode replaces the descriptor set per drawcall. See MATERIAL_BINDING.
+        bool                            _isMaterialTable;
+        MaterialTable                   _materialTable;
+
+        MipmapGenerator                 _mipmapGenerator;
         VkPipelineLayout                _pipelineLayout;
+        Texture2D                       _placeholderDiffuse;
+        Texture2D                       _placeholderNormal;
+        TextureDecoder                  _textureDecoder;
         UniformBuffer                   _transformBuffer;
+        android_vulkan::UploadScheduler _uploadScheduler;
 
     private:
         float                           _angle;
@@ -46,33 +96,63 @@ class Game : public android_vulkan::Game
         VkImage                         _depthStencil;
         VkImageView                     _depthStencilView;
         VkDeviceMemory                  _depthStencilMemory;
+        VkDeviceSize                    _depthStencilMemoryOffset;
 
         const char*                     _fragmentShader;
+        const char*                     _fragmentShaderMaterialTable;
         std::vector<VkFramebuffer>      _framebuffers;
+        android_vulkan::GPUTimer        _gpuTimer;
+
+        // GPU mode replaces Game::CullScene and the loop over the scene by the compute pass and single indirect draw
+        // per material. See CULLING_MODE.
+        GPUCulling                      _gpuCulling;
+        size_t                          _gpuCullingFrames;
+        bool                            _isGPUCulling;
 
-        VkPipeline                      _pipeline;
+        // Per instance transforms. Every draw of the scene has INSTANCE_COUNT transforms. See Game::CreateInstances.
+        MeshGeometry                    _instances;
 
+        size_t                          _frameIndex;
+        std::vector<FrameInFlight>      _framesInFlight;
 
+        // Every vertex format has its own pipeline. See eVertexFormat.
+        VkPipeline                      _pipelines[ VERTEX_FORMAT_COUNT ];
+
+        size_t                          _recordBatches;
         VkRenderPass                    _renderPass;
 
-        VkSemaphore                     _renderPassEndSemaphore;
-        VkSemaphore                     _renderTargetAcquiredSemaphore;
+        // Note the semaphores are indexed by the presentation image. The semaphore is waited by vkQueuePresentKHR which
+        // is not tracked by any fence. So it's safe to signal it again only after the image is acquired again.
+        std::vector<VkSemaphore>        _renderPassEndSemaphores;
 
-        VkSampler                       _sampler01Mips;
-        VkSampler                       _sampler09Mips;
-        VkSampler                       _sampler10Mips;
-        VkSampler                       _sampler11Mips;
+        // The sampler is shared by all materials. It serves any mip count. See Renderer::AcquireSampler.
+        VkSampler                       _materialSampler;
 
-        VkShaderModule                  _vertexShaderModule;
-        VkShaderModule                  _fragmentShaderModule;
+        // The list of draws. Every draw has the bounds which include all its instances. The draws outside of
+        // the view volume are culled every frame. Only _visibleScene is recorded. See Game::CullScene.
+        std::vector<SceneDraw>          _scene;
+        std::vector<GXAABB>             _sceneBounds;
+        std::unique_ptr<GXBool[]>       _sceneVisibility;
+        std::vector<SceneDraw>          _visibleScene;
 
-        std::vector<CommandContext>     _commandBuffers;
+        VkShaderModule                  _vertexShaderModules[ VERTEX_FORMAT_COUNT ];
+        VkShaderModule                  _fragmentShaderModule;
 
         GXMat4                          _projectionMatrix;
         Transform                       _transform;
 
+        double                          _uniformBufferStatTime;
+        size_t                          _uniformBufferStatFrames;
+
+        bool                            _isFirstFrame;
+        android_vulkan::AssetFuture     _meshFiles[ MATERIAL_COUNT ];
+        eStreamingState                 _streamingState;
+        Timestamp                       _streamingStart;
+        const char*                     _textureFileNames[ STREAMED_TEXTURE_COUNT ];
+        android_vulkan::AssetFuture     _textureFiles[ STREAMED_TEXTURE_COUNT ];
+
     protected:
-        explicit Game ( const char* fragmentShader );
+        explicit Game ( const char* fragmentShader, const char* fragmentShaderMaterialTable );
 
         Game ( const Game &other ) = delete;
         Game& operator = ( const Game &other ) = delete;
@@ -81,15 +161,28 @@ class Game : public android_vulkan::Game
         virtual bool CreatePipelineLayout ( android_vulkan::Renderer &renderer ) = 0;
         virtual bool LoadGPUContent ( android_vulkan::Renderer &renderer ) = 0;
 
+        // The table mode methods. The subclasses append their bindings to the table and write them.
+        virtual bool CreateMaterialTable ( android_vulkan::Renderer &renderer );
+        virtual bool UpdateMaterialTable ( android_vulkan::Renderer &renderer );
+
         virtual bool CreateSamplers ( android_vulkan::Renderer &renderer );
         virtual void DestroySamplers ( android_vulkan::Renderer &renderer );
         virtual void DestroyTextures ( android_vulkan::Renderer &renderer );
 
-        bool CreateCommonTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer* commandBuffers );
-        bool CreateMeshes ( android_vulkan::Renderer &renderer, VkCommandBuffer* commandBuffers );
+        // Note these methods record upload commands into "commandBuffer" and register release of the transfer
+        // resources in the _uploadScheduler. Common textures are the placeholders and the default normal map.
+        // The real textures are streamed in later. See Game::UpdateStreaming. The meshes include the instance buffer.
+        bool CreateCommonTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer );
+        bool CreateMeshes ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer );
+
+        // Method returns image view of the placeholder while the textures are being streamed.
+        VkImageView ResolveImageView ( const Texture2D &texture, const Texture2D &placeholder ) const;
 
-        static void InitDescriptorPoolSizeCommon ( VkDescriptorPoolSize* features );
-        static void InitDescriptorSetLayoutBindingCommon ( VkDescriptorSetLayoutBinding* bindings );
+        void ReleaseOnUploadComplete ( android_vulkan::Renderer &renderer, MeshGeometry &mesh );
+        void ReleaseOnUploadComplete ( android_vulkan::Renderer &renderer, Texture2D &texture );
+
+        void InitDescriptorPoolSizeCommon ( VkDescriptorPoolSize* features ) const;
+        void InitDescriptorSetLayoutBindingCommon ( VkDescriptorSetLayoutBinding* bindings ) const;
 
     private:
         bool IsReady () override;
@@ -100,6 +193,43 @@ class Game : public android_vulkan::Game
 
         bool BeginFrame ( size_t &imageIndex, android_vulkan::Renderer &renderer );
         bool EndFrame ( uint32_t imageIndex, android_vulkan::Renderer &renderer );
+        bool RecordCommandBuffer ( android_vulkan::Renderer &renderer, size_t imageIndex );
+
+        // Method records _visibleScene as is. Game::RecordCommandBuffer culls the scene before the call.
+        bool RecordScene ( android_vulkan::Renderer &renderer, size_t imageIndex );
+
+        // Method records the synthetic scenes of RECORD_BENCHMARK_DRAWS sizes without submitting them and logs
+        // the average recording time.
+        bool BenchmarkRecording ( android_vulkan::Renderer &renderer );
+
+        // Method updates the staging and the persistent ring buffers UNIFORM_BUFFER_BENCHMARK_UPDATES times each
+        // and logs the submits per frame and the CPU time per update of both modes.
+        bool BenchmarkUniformBuffer ( android_vulkan::Renderer &renderer );
+        bool MeasureUniformBuffer ( UniformBuffer &buffer, double &submitsPerFrame, double &updateTime ) const;
+
+        // Methods record the range [begin, end) of the visible scene. Note the pipeline state is not inherited by
+        // the secondary command buffers. So every range binds all state it needs.
+        bool RecordBatch ( android_vulkan::Renderer &renderer,
+            size_t batch,
+            size_t batchCount,
+            const VkCommandBufferInheritanceInfo &inheritanceInfo
+        );
+
+        // The table mode binds the material table once. Every material is selected by the push constant.
+        void BindDescriptorSet ( VkCommandBuffer commandBuffer,
+            VkDescriptorSet descriptorSet,
+            bool isDynamic,
+            uint32_t dynamicOffset
+        ) const;
+
+        void BindMaterial ( VkCommandBuffer commandBuffer,
+            size_t material,
+            bool isDynamic,
+            uint32_t dynamicOffset
+        ) const;
+
+        void RecordDraws ( VkCommandBuffer commandBuffer, size_t begin, size_t end ) const;
+        void RecordIndirectDraws ( VkCommandBuffer commandBuffer ) const;
 
         bool CreateCommandPool ( android_vulkan::Renderer &renderer );
         void DestroyCommandPool ( android_vulkan::Renderer &renderer );
@@ -113,6 +243,7 @@ class Game : public android_vulkan::Game
         bool CreatePipeline ( android_vulkan::Renderer &renderer );
         void DestroyPipeline ( android_vulkan::Renderer &renderer );
 
+        bool CreateMaterialTablePipelineLayout ( android_vulkan::Renderer &renderer );
         void DestroyPipelineLayout ( android_vulkan::Renderer &renderer );
 
         bool CreateRenderPass ( android_vulkan::Renderer &renderer );
@@ -128,7 +259,29 @@ class Game : public android_vulkan::Game
         void DestroyUniformBuffer ();
 
         bool InitCommandBuffers ( android_vulkan::Renderer &renderer );
-        bool UpdateUniformBuffer ( android_vulkan::Renderer &renderer, double deltaTime );
+        void DestroyCommandBuffers ( android_vulkan::Renderer &renderer );
+
+        bool CreateInstances ( std::vector<GXMat4> &instances,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        );
+
+        bool CreateScene ( android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer,
+            const std::vector<GXMat4> &instances
+        );
+
+        void CullScene ();
+
+        // The block-compressed files are requested if the device supports their formats.
+        void RequestAssets ( android_vulkan::Renderer &renderer );
+
+        bool UpdateStreaming ( android_vulkan::Renderer &renderer );
+        bool UploadStreamedTextures ( android_vulkan::Renderer &renderer );
+        bool SubmitStreamedTextures ();
+        bool SwapStreamedTextures ( android_vulkan::Renderer &renderer );
+        bool UpdateUniformBuffer ( android_vulkan::Renderer &renderer, size_t slice, double deltaTime );
+        void UpdateUniformBufferStatistics ( double deltaTime );
 };
 
 } // namespace rotating_mesh
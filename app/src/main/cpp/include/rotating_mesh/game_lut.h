@@ -25,12 +25,15 @@ class GameLUT final : public Game
         bool CreatePipelineLayout ( android_vulkan::Renderer &renderer ) override;
         bool LoadGPUContent ( android_vulkan::Renderer &renderer ) override;
 
+        bool CreateMaterialTable ( android_vulkan::Renderer &renderer ) override;
+        bool UpdateMaterialTable ( android_vulkan::Renderer &renderer ) override;
+
         bool CreateSamplers ( android_vulkan::Renderer &renderer ) override;
         void DestroySamplers ( android_vulkan::Renderer &renderer ) override;
 
         void DestroyTextures ( android_vulkan::Renderer &renderer ) override;
 
-        bool CreateTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer* commandBuffers );
+        bool CreateTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer );
 
         bool CreateSpecularLUTTexture ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer );
         void DestroySpecularLUTTexture ( android_vulkan::Renderer &renderer );
@@ -0,0 +1,142 @@
+#ifndef ROTATING_MESH_GPU_CULLING_H
+#define ROTATING_MESH_GPU_CULLING_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include <GXCommon/GXMath.h>
+#include "drawcall.h"
+
+
+namespace rotating_mesh {
+
+// The class culls the scene by the compute shader. Every scene draw renders its own range of the instances. So
+// the object is the pair of the draw and the instance. The shader writes the indirect commands which contain only
+// the visible instances. The draws of every material are compacted into the command range of the material. So GPU
+// mode records single indirect draw per material instead of the loop over the scene. See gpu-culling.cs.
+class GPUCulling final
+{
+    private:
+        struct Buffer final
+        {
+            VkBuffer                                _buffer;
+            VkDeviceMemory                          _memory;
+            VkDeviceSize                            _memoryOffset;
+            uint8_t*                                _mappedData;
+        };
+
+        // The commands and the draw counts are host visible. So CPU writes the initial state before the dispatch
+        // and the debug build compares the results against CPU culling.
+        struct Frame final
+        {
+            Buffer                                  _commands;
+            VkDescriptorSet                         _descriptorSet;
+            Buffer                                  _drawCounts;
+            bool                                    _isCulled;
+            GXMat4                                  _localToClip;
+            Buffer                                  _visibleInstances;
+        };
+
+        // Indexed by draw * instance count + instance. The same bounds are in _boundsBuffer.
+        std::vector<GXAABB>                         _bounds;
+        MeshGeometry                                _boundsBuffer;
+
+        std::vector<uint8_t>                        _commandTemplate;
+        VkDescriptorPool                            _descriptorPool;
+        VkDescriptorSetLayout                       _descriptorSetLayout;
+
+        PFN_vkCmdDrawIndexedIndirectCountKHR        _drawIndexedIndirectCount;
+        PFN_vkCmdDrawIndirectCountKHR               _drawIndirectCount;
+
+        // The material per scene draw. See GPUCulling::Verify.
+        std::vector<uint32_t>                       _drawMaterials;
+
+        // ( material, first command of the material ) per scene draw.
+        MeshGeometry                                _draws;
+
+        std::vector<Frame>                          _frames;
+        uint32_t                                    _instanceCount;
+
+        // The first command and the number of the scene draws per material.
+        std::vector<uint32_t>                       _materialCommands;
+        std::vector<uint32_t>                       _materialDraws;
+
+        VkPipeline                                  _pipeline;
+        VkPipelineLayout                            _pipelineLayout;
+        VkShaderModule                              _shaderModule;
+
+    public:
+        GPUCulling ();
+        ~GPUCulling () = default;
+
+        GPUCulling ( const GPUCulling &other ) = delete;
+        GPUCulling& operator = ( const GPUCulling &other ) = delete;
+
+        // GPU mode needs the multi draw indirect with the non-zero first instance. The method returns false if
+        // the physical device does not support it.
+        static bool IsSupported ( android_vulkan::Renderer &renderer, uint32_t maxDrawsPerMaterial );
+
+        // GPUCulling::Destroy must be called if the method fails.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Init ( android_vulkan::Renderer &renderer );
+        void Destroy ( android_vulkan::Renderer &renderer );
+
+        // "instances" must be created with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT. It contains "instanceCount"
+        // transforms per scene draw. "bounds" contains the bounds of every instance of every draw in the scene space.
+        // The material of the draw is the index in "drawcalls". The method records upload commands into
+        // "commandBuffer". Transfer resources must be released by GPUCulling::FreeTransferResources after GPU
+        // completes the commands.
+        // The method returns true if success. Otherwise the method returns false.
+        bool CreateScene ( android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer,
+            const Drawcall* drawcalls,
+            size_t materialCount,
+            const uint32_t* drawMaterials,
+            size_t drawCount,
+            VkBuffer instances,
+            uint32_t instanceCount,
+            const GXAABB* bounds,
+            size_t frameCount
+        );
+
+        void FreeTransferResources ( android_vulkan::Renderer &renderer );
+
+        // Method records the dispatch and the barrier which makes the results visible to the indirect draws and
+        // the vertex input. It must be recorded outside of the render pass. Note the fence of the frame must be
+        // waited because CPU resets the commands of the frame.
+        void Cull ( VkCommandBuffer commandBuffer, size_t frame, const GXMat4 &localToClip );
+
+        // Method records the indirect draw of all visible draws of the material. The pipeline, the descriptor set,
+        // the geometry and GPUCulling::GetVisibleInstances buffer at binding 1 must be bound.
+        void RecordDraw ( VkCommandBuffer commandBuffer, size_t frame, size_t material, bool isIndexed ) const;
+
+        const VkBuffer& GetVisibleInstances ( size_t frame ) const;
+
+        // Method compares the result of the last GPUCulling::Cull of the frame against CPU culling. The mismatches
+        // are logged. Note the fence of the frame must be waited.
+        // The method returns true if the results are the same. Otherwise the method returns false.
+        bool Verify ( size_t frame ) const;
+
+    private:
+        static bool CreateBuffer ( Buffer &buffer,
+            android_vulkan::Renderer &renderer,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags memoryProperties
+        );
+
+        static void DestroyBuffer ( Buffer &buffer, android_vulkan::Renderer &renderer );
+
+        bool CreateDescriptorSets ( android_vulkan::Renderer &renderer, VkBuffer instances );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_GPU_CULLING_H
@@ -0,0 +1,95 @@
+#ifndef ROTATING_MESH_KTX2_PARSER_H
+#define ROTATING_MESH_KTX2_PARSER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+// Values of the VkFormat enumeration. The parser has no Vulkan dependency so the values are repeated here.
+constexpr const uint32_t KTX2_FORMAT_R8G8B8A8_UNORM = 37U;
+constexpr const uint32_t KTX2_FORMAT_R8G8B8A8_SRGB = 43U;
+constexpr const uint32_t KTX2_FORMAT_BC1_RGB_UNORM = 131U;
+constexpr const uint32_t KTX2_FORMAT_BC1_RGB_SRGB = 132U;
+constexpr const uint32_t KTX2_FORMAT_BC3_UNORM = 137U;
+constexpr const uint32_t KTX2_FORMAT_BC3_SRGB = 138U;
+constexpr const uint32_t KTX2_FORMAT_BC7_UNORM = 145U;
+constexpr const uint32_t KTX2_FORMAT_BC7_SRGB = 146U;
+constexpr const uint32_t KTX2_FORMAT_ETC2_R8G8B8_UNORM = 147U;
+constexpr const uint32_t KTX2_FORMAT_ETC2_R8G8B8_SRGB = 148U;
+constexpr const uint32_t KTX2_FORMAT_ETC2_R8G8B8A8_UNORM = 151U;
+constexpr const uint32_t KTX2_FORMAT_ETC2_R8G8B8A8_SRGB = 152U;
+constexpr const uint32_t KTX2_FORMAT_ASTC_4x4_UNORM = 157U;
+constexpr const uint32_t KTX2_FORMAT_ASTC_4x4_SRGB = 158U;
+constexpr const uint32_t KTX2_FORMAT_ASTC_6x6_UNORM = 165U;
+constexpr const uint32_t KTX2_FORMAT_ASTC_6x6_SRGB = 166U;
+constexpr const uint32_t KTX2_FORMAT_ASTC_8x8_UNORM = 171U;
+constexpr const uint32_t KTX2_FORMAT_ASTC_8x8_SRGB = 172U;
+
+constexpr const uint32_t KTX2_MAX_LEVELS = 16U;
+
+struct KTX2Level final
+{
+    const uint8_t*              _data;
+    size_t                      _size;
+};
+
+// Content of the KTX2 file. The level pointers point inside the file content. Level 0 is the base level.
+struct KTX2Image final
+{
+    uint32_t                    _format;
+    uint32_t                    _width;
+    uint32_t                    _height;
+
+    // Note the file without levels contains the base level only. The rest of the chain must be generated.
+    bool                        _isGenerateMipmaps;
+    uint32_t                    _levelCount;
+    KTX2Level                   _levels[ KTX2_MAX_LEVELS ];
+};
+
+// Block layout of the supported formats. Uncompressed formats have 1x1 blocks. Note the block compressed levels
+// are uploaded as is. So their mip maps can't be generated at load time.
+struct KTX2FormatInfo final
+{
+    uint32_t                    _blockWidth;
+    uint32_t                    _blockHeight;
+    uint32_t                    _blockSize;
+};
+
+// Minimal reader of the KTX2 container: single layer 2D textures without supercompression. The class has no Vulkan
+// dependency so it is built for the host too.
+class KTX2Parser final
+{
+    public:
+        KTX2Parser () = delete;
+
+        KTX2Parser ( const KTX2Parser &other ) = delete;
+        KTX2Parser& operator = ( const KTX2Parser &other ) = delete;
+
+        // Method checks the file identifier only. Other content is validated by KTX2Parser::Parse.
+        static bool IsKTX2 ( const uint8_t* content, size_t size );
+
+        // Method validates the header and the level index against the content size. The size of every level must
+        // match its resolution exactly.
+        // The method returns true if success. Otherwise the method returns false.
+        static bool Parse ( KTX2Image &image, const uint8_t* content, size_t size );
+
+        // The method returns false if the format is not supported. Otherwise the method returns true.
+        static bool GetFormatInfo ( KTX2FormatInfo &info, uint32_t format );
+
+        // Method returns byte size of the level with the given resolution. The format must be supported.
+        static size_t GetLevelSize ( const KTX2FormatInfo &info, uint32_t width, uint32_t height );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_KTX2_PARSER_H
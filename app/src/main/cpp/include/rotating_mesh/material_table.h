@@ -0,0 +1,101 @@
+#ifndef ROTATING_MESH_MATERIAL_TABLE_H
+#define ROTATING_MESH_MATERIAL_TABLE_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include <renderer.h>
+#include "uniform_buffer.h"
+
+
+namespace rotating_mesh {
+
+// Transform, materials, textures and samplers. The shader variants could use the bindings after them.
+constexpr const uint32_t MATERIAL_TABLE_BINDING_COUNT = 4U;
+
+// The class replaces the descriptor set per drawcall by single descriptor set. All textures of the scene are in
+// the array of the sampled images. The samplers are in the separate array. The material record contains the indices
+// in these arrays. The draw selects the record by the push constant. So the set is bound once per command buffer.
+// The arrays are partially bound. So the material count grows without the pool resizing. It needs
+// VK_EXT_descriptor_indexing. See blinn-phong-analytic.ps.
+class MaterialTable final
+{
+    private:
+        // See Material structure of blinn-phong-analytic.ps.
+        struct Material final
+        {
+            uint32_t                    _diffuse;
+            uint32_t                    _diffuseSampler;
+            uint32_t                    _normal;
+            uint32_t                    _normalSampler;
+        };
+
+        VkDescriptorPool                _descriptorPool;
+        VkDescriptorSet                 _descriptorSet;
+        VkDescriptorSetLayout           _descriptorSetLayout;
+
+        std::vector<VkImageView>        _images;
+
+        VkBuffer                        _materialBuffer;
+        uint32_t                        _materialCapacity;
+        VkDeviceMemory                  _materialMemory;
+        VkDeviceSize                    _materialMemoryOffset;
+        Material*                       _materials;
+
+        std::vector<VkSampler>          _samplers;
+
+    public:
+        MaterialTable ();
+        ~MaterialTable () = default;
+
+        MaterialTable ( const MaterialTable &other ) = delete;
+        MaterialTable& operator = ( const MaterialTable &other ) = delete;
+
+        // The method returns false if the device does not support the partially bound arrays or the arrays do not
+        // fit into the per stage limits.
+        static bool IsSupported ( android_vulkan::Renderer &renderer );
+
+        // "extraBindings" are appended to the layout. Their numbers must start from MATERIAL_TABLE_BINDING_COUNT.
+        // The caller writes them into MaterialTable::GetDescriptorSet. MaterialTable::Destroy must be called if
+        // the method fails.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Init ( android_vulkan::Renderer &renderer,
+            uint32_t materialCapacity,
+            const UniformBuffer &transformBuffer,
+            const VkDescriptorSetLayoutBinding* extraBindings,
+            uint32_t extraBindingCount
+        );
+
+        void Destroy ( android_vulkan::Renderer &renderer );
+
+        VkDescriptorSet GetDescriptorSet () const;
+        VkDescriptorSetLayout GetDescriptorSetLayout () const;
+
+        // Method forgets all textures and samplers. The materials must be set again. It's used when the images of
+        // the materials are replaced.
+        void Reset ();
+
+        // Method writes the material record. The textures and the samplers are appended to the arrays if they are
+        // not there yet. The arrays are written into the descriptor set by MaterialTable::Commit.
+        // The method returns true if success. Otherwise the method returns false.
+        bool SetMaterial ( uint32_t material,
+            VkImageView diffuse,
+            VkSampler diffuseSampler,
+            VkImageView normal,
+            VkSampler normalSampler
+        );
+
+        // Note the descriptor set must not be used by the command buffers in flight.
+        void Commit ( android_vulkan::Renderer &renderer ) const;
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_MATERIAL_TABLE_H
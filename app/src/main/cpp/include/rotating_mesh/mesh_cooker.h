@@ -0,0 +1,64 @@
+#ifndef ROTATING_MESH_MESH_COOKER_H
+#define ROTATING_MESH_MESH_COOKER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstdint>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include "mesh_optimizer.h"
+#include "vertex_packer.h"
+
+
+namespace rotating_mesh {
+
+// Meshlet limits are the usual limits of the mesh shader hardware. So the meshlets could be reused later.
+constexpr const size_t MESHLET_MAX_VERTICES = 64U;
+constexpr const size_t MESHLET_MAX_TRIANGLES = 124U;
+
+struct MeshCookerStats final
+{
+    size_t                  _sourceVertices;
+    size_t                  _uniqueVertices;
+    size_t                  _meshlets;
+    float                   _originalACMR;
+    float                   _optimizedACMR;
+
+    // Note the error is measured for eTangentMerge::Average only.
+    TangentMergeError       _tangentMergeError;
+
+    // Note the error is measured for eVertexFormat::Packed only.
+    VertexPackingError      _packingError;
+};
+
+// The class converts the triangle soup of the version 1.2 mesh to the version 2.0 content. See GXNativeMeshHeaderV2.
+// The result is ready for upload. So the runtime loader only copies the chunks. The class has no Vulkan dependency
+// so it is built for the host too.
+class MeshCooker final
+{
+    public:
+        MeshCooker () = delete;
+
+        MeshCooker ( const MeshCooker &other ) = delete;
+        MeshCooker& operator = ( const MeshCooker &other ) = delete;
+
+        // Method deduplicates the vertices, optimizes them for the vertex cache and the vertex fetch, flips UV,
+        // builds the meshlets and writes all of it in the "format" layout. "stats" could be nullptr.
+        static void Cook ( std::vector<uint8_t> &content,
+            const VertexInfo* vertices,
+            size_t count,
+            eVertexFormat format,
+            eTangentMerge tangentMerge,
+            MeshCookerStats* stats
+        );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_MESH_COOKER_H
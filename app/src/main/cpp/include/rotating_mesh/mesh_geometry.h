@@ -10,7 +10,9 @@ GX_DISABLE_COMMON_WARNINGS
 
 GX_RESTORE_WARNING_STATE
 
+#include <file.h>
 #include <renderer.h>
+#include "vertex_info.h"
 
 
 namespace rotating_mesh {
@@ -39,13 +41,22 @@ struct BufferSyncItem final
 class MeshGeometry final
 {
     private:
+        GXAABB                                                          _bounds;
         VkBuffer                                                        _buffer;
         VkDeviceMemory                                                  _bufferMemory;
+        VkDeviceSize                                                    _bufferMemoryOffset;
+
+        // Note the indices are stored in the same buffer right after the vertices.
+        uint32_t                                                        _indexCount;
+        VkDeviceSize                                                    _indexOffset;
+        VkIndexType                                                     _indexType;
 
         VkBuffer                                                        _transferBuffer;
         VkDeviceMemory                                                  _transferMemory;
+        VkDeviceSize                                                    _transferMemoryOffset;
 
         uint32_t                                                        _vertexCount;
+        eVertexFormat                                                   _vertexFormat;
 
         std::string                                                     _fileName;
 
@@ -64,16 +75,36 @@ class MeshGeometry final
         void FreeResources ( android_vulkan::Renderer &renderer );
         void FreeTransferResources ( android_vulkan::Renderer &renderer );
 
+        // Note the bounds are in the mesh space.
+        const GXAABB& GetBounds () const;
         const VkBuffer& GetBuffer () const;
         uint32_t GetVertexCount () const;
+        eVertexFormat GetVertexFormat () const;
+
+        // Note the index count is zero if the geometry is not indexed.
+        uint32_t GetIndexCount () const;
+        VkDeviceSize GetIndexOffset () const;
+        VkIndexType GetIndexType () const;
 
+        // Note "commandBuffer" must be in recording state. The methods only record upload commands into it.
+        // Submitting and releasing of the transfer resources are the caller's responsibility.
         bool LoadMesh ( std::string &&fileName,
             VkBufferUsageFlags usage,
             android_vulkan::Renderer &renderer,
             VkCommandBuffer commandBuffer
         );
 
-        [[maybe_unused]] bool LoadMesh ( const uint8_t* data,
+        // Note "file" must be mapped or loaded. See android_vulkan::AssetLoader. The chunks of the version 2.0 file
+        // are copied as is. The file keeps its own vertex layout. The triangle soup of the version 1.2 file is cooked
+        // at load time into the "format" layout. See MeshCooker.
+        bool LoadMesh ( const android_vulkan::File &file,
+            eVertexFormat format,
+            VkBufferUsageFlags usage,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        );
+
+        bool LoadMesh ( const uint8_t* data,
             size_t size,
             uint32_t vertexCount,
             VkBufferUsageFlags usage,
@@ -84,7 +115,8 @@ class MeshGeometry final
     private:
         void FreeResourceInternal ( android_vulkan::Renderer &renderer );
 
-        bool LoadMeshInternal ( const uint8_t* data,
+        // Note "transferData" is the mapped transfer memory. Caller must write vertices into it and unmap it.
+        bool LoadMeshInternal ( uint8_t* &transferData,
             size_t size,
             uint32_t vertexCount,
             VkBufferUsageFlags usage,
@@ -0,0 +1,77 @@
+#ifndef ROTATING_MESH_MESH_OPTIMIZER_H
+#define ROTATING_MESH_MESH_OPTIMIZER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include "vertex_info.h"
+
+
+namespace rotating_mesh {
+
+// Typical size of the post-transform vertex cache on mobile GPU.
+constexpr const size_t VERTEX_CACHE_SIZE = 32U;
+
+enum class eTangentMerge : uint8_t
+{
+    // Only bitwise equal vertices are merged. The result is lossless.
+    None,
+
+    // The vertices with equal position, UV and normal are merged if the dot products of their tangents and their
+    // bitangents are 0.7 at least. The merged vertices get the average tangent frame. So the merge is lossy. See
+    // TangentMergeError. The exported meshes have the tangent frame per face. So the bitwise equal vertices are rare
+    // without it.
+    Average
+};
+
+// Maximum angles in degrees between the source tangent frame and the tangent frame of the deduplicated vertex.
+struct TangentMergeError final
+{
+    float       _tangent;
+    float       _bitangent;
+};
+
+// Conversion of the triangle soup to the indexed geometry. The class has no Vulkan dependency so it is built for
+// the host too.
+class MeshOptimizer final
+{
+    public:
+        MeshOptimizer () = delete;
+
+        MeshOptimizer ( const MeshOptimizer &other ) = delete;
+        MeshOptimizer& operator = ( const MeshOptimizer &other ) = delete;
+
+        // Method merges equal vertices of the triangle soup. See eTangentMerge. "indices" gets one index per source
+        // vertex. "error" could be nullptr. Otherwise it gets the error of eTangentMerge::Average mode.
+        static void Deduplicate ( std::vector<VertexInfo> &vertices,
+            std::vector<uint32_t> &indices,
+            const VertexInfo* source,
+            size_t count,
+            eTangentMerge tangentMerge,
+            TangentMergeError* error
+        );
+
+        // Method reorders triangles for the post-transform vertex cache locality. Tom Forsyth's algorithm is used.
+        // See https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+        static void OptimizeVertexCache ( uint32_t* indices, size_t indexCount, size_t vertexCount );
+
+        // Method reorders vertices in order of the first use by the index list. Unused vertices are dropped.
+        static void OptimizeVertexFetch ( std::vector<VertexInfo> &vertices, uint32_t* indices, size_t indexCount );
+
+        // Method returns average cache miss ratio: transformed vertices per triangle for FIFO cache of "cacheSize"
+        // entries. The best possible value is about 0.5. The triangle soup has 3.0.
+        static float ComputeACMR ( const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t cacheSize );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_MESH_OPTIMIZER_H
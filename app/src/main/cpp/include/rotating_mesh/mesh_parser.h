@@ -0,0 +1,70 @@
+#ifndef ROTATING_MESH_MESH_PARSER_H
+#define ROTATING_MESH_MESH_PARSER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+
+GX_RESTORE_WARNING_STATE
+
+#include <GXCommon/GXNativeMesh.h>
+#include "vertex_info.h"
+
+
+namespace rotating_mesh {
+
+// Content of the version 2.0 mesh file. The pointers point inside the file content. See MeshCooker.
+struct CookedMesh final
+{
+    GXAABB                      _bounds;
+
+    const uint8_t*              _indices;
+    size_t                      _indexDataSize;
+    uint32_t                    _indexCount;
+    uint32_t                    _indexSize;
+
+    // Note meshlets are optional. The pointer is nullptr if the file has no meshlets.
+    const GXNativeMeshlet*      _meshlets;
+    size_t                      _meshletCount;
+
+    const uint8_t*              _vertices;
+    size_t                      _vertexDataSize;
+    uint32_t                    _vertexCount;
+    eVertexFormat               _vertexFormat;
+};
+
+// CPU side of the mesh loading. The class has no Vulkan dependency so it is built for the host too.
+class MeshParser final
+{
+    public:
+        MeshParser () = delete;
+
+        MeshParser ( const MeshParser &other ) = delete;
+        MeshParser& operator = ( const MeshParser &other ) = delete;
+
+        // Method validates the GXNativeMesh header against the content size. "vertices" points to the vertex data
+        // inside the "content".
+        // The method returns true if success. Otherwise the method returns false.
+        static bool Parse ( const VertexInfo* &vertices, uint32_t &vertexCount, const uint8_t* content, size_t size );
+
+        // Method checks the magic only. Other content is validated by MeshParser::ParseCooked.
+        static bool IsCooked ( const uint8_t* content, size_t size );
+
+        // Method validates the version 2.0 header and the chunk table against the content size. No per vertex work
+        // is done. So the index values are not validated.
+        // The method returns true if success. Otherwise the method returns false.
+        static bool ParseCooked ( CookedMesh &mesh, const uint8_t* content, size_t size );
+
+        // Method copies "count" vertices and flips the V texture coordinate on the job system workers.
+        // "destination" is written only. So it could be the mapped write-combined memory.
+        static void ConvertVertices ( VertexInfo* destination, const VertexInfo* source, size_t count );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_MESH_PARSER_H
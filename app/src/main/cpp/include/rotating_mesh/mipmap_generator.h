@@ -0,0 +1,79 @@
+#ifndef ROTATING_MESH_MIPMAP_GENERATOR_H
+#define ROTATING_MESH_MIPMAP_GENERATOR_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include <renderer.h>
+
+
+namespace rotating_mesh {
+
+// Single dispatch writes up to four levels. See mipmap-generator.cs.
+constexpr const uint32_t MIPMAP_LEVELS_PER_PASS = 4U;
+
+// Storage views of every level and descriptor sets of the passes. They are needed until GPU completes the commands.
+struct MipmapResources final
+{
+    VkDescriptorPool            _descriptorPool;
+    std::vector<VkImageView>    _views;
+};
+
+// The class generates mip maps by the compute shader instead of the chain of blits. The levels of the pass are reduced
+// in the shared memory of the thread group. So the barrier is needed once per four levels instead of every level.
+class MipmapGenerator final
+{
+    private:
+        VkDescriptorSetLayout       _descriptorSetLayout;
+        bool                        _isSupported;
+        VkPipeline                  _pipeline;
+        VkPipelineLayout            _pipelineLayout;
+        VkShaderModule              _shaderModule;
+
+    public:
+        MipmapGenerator ();
+        ~MipmapGenerator () = default;
+
+        MipmapGenerator ( const MipmapGenerator &other ) = delete;
+        MipmapGenerator& operator = ( const MipmapGenerator &other ) = delete;
+
+        // Note the method succeeds if the storage images are not supported. MipmapGenerator::IsSupported returns
+        // false for every format in that case. MipmapGenerator::Destroy must be called if the method fails.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Init ( android_vulkan::Renderer &renderer );
+        void Destroy ( android_vulkan::Renderer &renderer );
+
+        bool IsSupported ( VkFormat format ) const;
+
+        // Method records generation of the levels [1, mipLevels). Level 0 must be written by transfer. All levels
+        // must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL. All levels are in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        // after that. The image must be created with VK_IMAGE_USAGE_STORAGE_BIT and the flags which are returned by
+        // MipmapGenerator::GetImageCreateFlags. "resources" must be released by MipmapGenerator::FreeResources after
+        // GPU completes the commands.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Generate ( MipmapResources &resources,
+            VkImage image,
+            VkFormat format,
+            const VkExtent2D &resolution,
+            uint32_t mipLevels,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        ) const;
+
+        // The storage views are UNORM. So sRGB images must allow views of other format. Note the sampled view of such
+        // image must limit its usage via VkImageViewUsageCreateInfo.
+        static VkImageCreateFlags GetImageCreateFlags ( VkFormat format );
+
+        static void FreeResources ( MipmapResources &resources, android_vulkan::Renderer &renderer );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_MIPMAP_GENERATOR_H
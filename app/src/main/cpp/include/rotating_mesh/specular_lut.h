@@ -0,0 +1,39 @@
+#ifndef ROTATING_MESH_SPECULAR_LUT_H
+#define ROTATING_MESH_SPECULAR_LUT_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+
+GX_RESTORE_WARNING_STATE
+
+#include <half.h>
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t SPECULAR_ANGLE_SAMPLES = 512U;
+constexpr static const size_t SPECULAR_EXPONENT_SAMPLES = 150U;
+constexpr static const size_t SPECULAR_LUT_SAMPLES = SPECULAR_ANGLE_SAMPLES * SPECULAR_EXPONENT_SAMPLES;
+
+// Blinn-Phong specular term as R16_SFLOAT texture. Every row of the LUT is single shininess value. Every column is
+// cosine of the angle between normal and half vector.
+class SpecularLUT final
+{
+    public:
+        SpecularLUT () = delete;
+
+        SpecularLUT ( const SpecularLUT &other ) = delete;
+        SpecularLUT& operator = ( const SpecularLUT &other ) = delete;
+
+        // Method fills SPECULAR_LUT_SAMPLES "samples" on the job system workers.
+        static void Generate ( android_vulkan::Half* samples );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_SPECULAR_LUT_H
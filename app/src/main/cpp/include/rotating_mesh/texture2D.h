@@ -6,12 +6,14 @@
 
 GX_DISABLE_COMMON_WARNINGS
 
+#include <memory>
 #include <string>
-#include <vector>
 
 GX_RESTORE_WARNING_STATE
 
+#include "mipmap_generator.h"
 #include "renderer.h"
+#include "texture_decoder.h"
 
 
 namespace rotating_mesh {
@@ -23,15 +25,20 @@ class Texture2D final
 
         VkImage             _image;
         VkDeviceMemory      _imageDeviceMemory;
+        VkDeviceSize        _imageDeviceMemoryOffset;
+        VkDeviceSize        _imageDeviceMemorySize;
         VkImageView         _imageView;
 
         bool                _isGenerateMipmaps;
 
         uint8_t             _mipLevels;
+        MipmapResources     _mipmapResources;
         VkExtent2D          _resolution;
 
         VkBuffer            _transfer;
         VkDeviceMemory      _transferDeviceMemory;
+        VkDeviceSize        _transferDeviceMemoryOffset;
+        uint8_t*            _transferData;
 
         std::string         _fileName;
 
@@ -54,6 +61,11 @@ class Texture2D final
         VkImageView GetImageView () const;
         uint8_t GetMipLevelCount () const;
 
+        // Method returns the device memory size which is occupied by the image. It is zero before the upload.
+        VkDeviceSize GetMemorySize () const;
+
+        // Note "commandBuffer" must be in recording state. The UploadData methods only record upload commands into
+        // it. See android_vulkan::UploadScheduler.
         // Method is used when file name and format are passed via constructor.
         [[maybe_unused]] bool UploadData ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer );
 
@@ -71,6 +83,29 @@ class Texture2D final
             VkCommandBuffer commandBuffer
         );
 
+        // Image is decoded on the worker thread of the "decoder" straight into the transfer memory.
+        // Note TextureDecoder::Wait must be called before "commandBuffer" is submitted.
+        // The mip maps are generated by the compute shader if "mipmapGenerator" supports the format. Otherwise
+        // the blits are used. "mipmapGenerator" could be nullptr.
+        bool UploadData ( std::string &&fileName,
+            VkFormat format,
+            bool isGenerateMipmaps,
+            TextureDecoder &decoder,
+            const MipmapGenerator* mipmapGenerator,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        );
+
+        // Same as above but the file is mapped already. See android_vulkan::AssetLoader.
+        bool UploadData ( std::shared_ptr<android_vulkan::File> &&file,
+            VkFormat format,
+            bool isGenerateMipmaps,
+            TextureDecoder &decoder,
+            const MipmapGenerator* mipmapGenerator,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        );
+
         [[maybe_unused]] bool UploadData ( const uint8_t* data,
             size_t size,
             const VkExtent2D &resolution,
@@ -87,21 +122,48 @@ class Texture2D final
 
         VkFormat PickupFormat ( int channels ) const;
 
-        bool UploadDataInternal ( const uint8_t* data,
+        // "decoder" could be nullptr. In that case the image is decoded on the calling thread.
+        // "file" could be nullptr. In that case the method fails.
+        // KTX2 files are detected by the content. They are never decoded. See Texture2D::UploadKTX2.
+        bool UploadImage ( std::shared_ptr<android_vulkan::File> &&file,
+            VkFormat format,
+            bool isGenerateMipmaps,
+            TextureDecoder* decoder,
+            const MipmapGenerator* mipmapGenerator,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        );
+
+        // The stored levels are copied to the transfer memory as is. The mip maps are generated only if the file
+        // contains the base level only. Block-compressed files are never decoded. The image is created with the format
+        // of the file. The mip maps are never generated for them. The sRGB "format" accepts the sRGB compressed
+        // formats only. The same is true for the UNORM formats.
+        bool UploadKTX2 ( const android_vulkan::File &file,
+            VkFormat format,
+            bool isGenerateMipmaps,
+            const MipmapGenerator* mipmapGenerator,
+            android_vulkan::Renderer &renderer,
+            VkCommandBuffer commandBuffer
+        );
+
+        // Note "transferData" is the mapped transfer memory. It stays valid until Texture2D::FreeTransferResources.
+        // "levelOffsets" contains "levelCount" offsets of the stored levels inside the transfer memory. It could be
+        // nullptr if the single level is stored. "levelCount" must be 1 if "isGenerateMipmaps" is true.
+        bool UploadDataInternal ( uint8_t* &transferData,
             size_t size,
             const VkExtent2D &resolution,
             VkFormat format,
+            const size_t* levelOffsets,
+            uint32_t levelCount,
             bool isGenerateMipmaps,
+            const MipmapGenerator* mipmapGenerator,
             android_vulkan::Renderer &renderer,
             VkCommandBuffer commandBuffer
         );
 
-        static bool LoadImage ( std::vector<uint8_t> &pixelData,
-            const std::string &fileName,
-            int &width,
-            int &height,
-            int &channels
-        );
+        // Note the file content is mapped. It is not copied to the heap.
+        // The method returns nullptr if the file can't be mapped.
+        static std::shared_ptr<android_vulkan::File> MapImage ( const std::string &fileName );
 };
 
 } // namespace rotating_mesh
@@ -0,0 +1,81 @@
+#ifndef ROTATING_MESH_TEXTURE_DECODER_H
+#define ROTATING_MESH_TEXTURE_DECODER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+GX_RESTORE_WARNING_STATE
+
+#include <file.h>
+#include <job_system.h>
+
+
+namespace rotating_mesh {
+
+// The class decodes several images simultaneously on the job system workers. Decoded pixels are written
+// directly into the destination memory which is supposed to be the mapped transfer memory of the texture.
+// Three channel images are expanded to four channels during that write.
+class TextureDecoder final
+{
+    private:
+        android_vulkan::JobCounter              _counter;
+        std::atomic<bool>                       _isFailed;
+
+        std::atomic<size_t>                     _statImages;
+        std::chrono::steady_clock::time_point   _statStart;
+
+    public:
+        TextureDecoder ();
+        ~TextureDecoder () = default;
+
+        TextureDecoder ( const TextureDecoder &other ) = delete;
+        TextureDecoder& operator = ( const TextureDecoder &other ) = delete;
+
+        // Method waits until all enqueued images are decoded.
+        void Destroy ();
+
+        // Method shares ownership of the encoded "file". So the file content stays mapped until the image is decoded.
+        // "destination" must stay valid until TextureDecoder::Wait returns. "width", "height" and "channels" must be
+        // the values which were returned by TextureDecoder::ReadInfo.
+        void Enqueue ( std::shared_ptr<android_vulkan::File> &&file,
+            uint8_t* destination,
+            const std::string &fileName,
+            int width,
+            int height,
+            int channels
+        );
+
+        // Non blocking check. The method returns true if all enqueued images are decoded.
+        bool IsDone () const;
+
+        // Method blocks until all enqueued images are decoded.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Wait ();
+
+        // Synchronous decoding on the calling thread. See TextureDecoder::Enqueue.
+        // The method returns true if success. Otherwise the method returns false.
+        static bool Decode ( uint8_t* destination,
+            const uint8_t* content,
+            size_t size,
+            int width,
+            int height,
+            int channels
+        );
+
+        // Method parses image header only. Note "channels" is the channel count of the decoded pixels. So three
+        // channel images are reported as four channel images.
+        // The method returns true if success. Otherwise the method returns false.
+        static bool ReadInfo ( int &width, int &height, int &channels, const uint8_t* content, size_t size );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_TEXTURE_DECODER_H
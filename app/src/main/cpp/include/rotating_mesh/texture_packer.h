@@ -0,0 +1,43 @@
+#ifndef ROTATING_MESH_TEXTURE_PACKER_H
+#define ROTATING_MESH_TEXTURE_PACKER_H
+
+
+#include <GXCommon/GXWarning.h>
+#include "block_compressor.h"
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstdint>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+// Offline side of the texture loading. The class has no Vulkan dependency so it is built for the host too.
+class TexturePacker final
+{
+    public:
+        TexturePacker () = delete;
+
+        TexturePacker ( const TexturePacker &other ) = delete;
+        TexturePacker& operator = ( const TexturePacker &other ) = delete;
+
+        // Method builds the complete mip chain of the four channel image by the 2x2 box filter and writes it as
+        // the KTX2 file. sRGB images are filtered in linear space. The levels are filtered on the job system workers.
+        // Every level is block-compressed after filtering if "compression" is not eBlockCompression::None.
+        // The format is selected by BlockCompressor::SelectFormat.
+        static void Pack ( std::vector<uint8_t> &content,
+            const uint8_t* rgba,
+            uint32_t width,
+            uint32_t height,
+            bool isSRGB,
+            eBlockCompression compression
+        );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_TEXTURE_PACKER_H
@@ -2,10 +2,28 @@
 #define ROTATING_UNIFORM_BUFFER_H
 
 
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <chrono>
+
+GX_RESTORE_WARNING_STATE
+
 #include <renderer.h>
 
 namespace rotating_mesh {
 
+enum class eUniformBufferMode : uint8_t
+{
+    // Device local buffer. Every update is copied from the transfer buffer by separate queue submit.
+    Staging,
+
+    // Host visible buffer which is persistently mapped. The buffer is split into slices. Every update writes
+    // into the slice directly. The slice must be selected via dynamic offset at descriptor set binding time.
+    PersistentRing
+};
+
 // This class wraps Vulkan creation and update routines of a uniform buffer.
 // The class is supposed to used with single uniform buffer object.
 class UniformBuffer final
@@ -15,16 +33,28 @@ class UniformBuffer final
 
         VkBuffer                        _buffer;
         VkDeviceMemory                  _bufferMemory;
+        VkDeviceSize                    _bufferMemoryOffset;
 
         VkCommandBuffer                 _commandBuffer;
         VkCommandPool                   _commandPool;
 
+        uint8_t*                        _mappedData;
+        eUniformBufferMode              _mode;
+
         android_vulkan::Renderer*       _renderer;
 
+        size_t                          _sliceCount;
+        size_t                          _sliceStride;
+
         VkPipelineStageFlags            _targetStages;
 
         VkBuffer                        _transfer;
         VkDeviceMemory                  _transferMemory;
+        VkDeviceSize                    _transferMemoryOffset;
+
+        size_t                          _statSubmits;
+        size_t                          _statUpdates;
+        std::chrono::nanoseconds        _statUpdateTime;
 
     public:
         UniformBuffer ();
@@ -35,24 +65,50 @@ class UniformBuffer final
 
         void FreeResources ();
         VkBuffer GetBuffer () const;
+
+        // Note the result is the size of single slice. So it should be used as descriptor range.
         size_t GetSize () const;
 
+        // Method returns offset of the slice which must be passed to vkCmdBindDescriptorSets.
+        // The result always equals zero in the eUniformBufferMode::Staging mode.
+        uint32_t GetDynamicOffset ( size_t slice ) const;
+
+        // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC for eUniformBufferMode::PersistentRing mode.
+        // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER otherwise.
+        VkDescriptorType GetDescriptorType () const;
+
+        eUniformBufferMode GetMode () const;
+        size_t GetSliceCount () const;
+
+        // Statistics since the last UniformBuffer::ResetStatistics call.
+        void GetStatistics ( size_t &updates, size_t &submits, std::chrono::nanoseconds &updateTime ) const;
+        void ResetStatistics ();
+
         // Note this method must be invoked before UniformBuffer::Update.
         // This method must be used only once except situation when user invokes UniformBuffer::FreeResources.
         // "targetStages" is a pipeline stage mask when buffer content will be used.
         // The method returns true if success. Otherwise the method returns false.
         bool Init ( android_vulkan::Renderer &renderer, VkCommandPool commandPool, VkPipelineStageFlags targetStages );
 
+        // Alternative to UniformBuffer::Init which selects eUniformBufferMode::PersistentRing mode.
+        // "sliceCount" should be equal to the count of frames which could be processed by GPU simultaneously.
+        // The caller is responsible for the guarantee that the slice is not used by GPU during the update.
+        // The method returns true if success. Otherwise the method returns false.
+        bool InitRing ( android_vulkan::Renderer &renderer, size_t sliceCount );
+
         // Method updates GPU side uniform buffer.
-        // Note the method could be used after UniformBuffer::Init method.
+        // Note the method could be used after UniformBuffer::Init or UniformBuffer::InitRing methods.
+        // "slice" is ignored in the eUniformBufferMode::Staging mode.
         // The method returns true if success. Otherwise the method returns false.
-        bool Update ( const uint8_t* data, size_t size );
+        bool Update ( const uint8_t* data, size_t size, size_t slice = 0U );
 
     private:
         bool InitResources ( size_t size );
+        bool InitRingResources ( size_t size );
+        bool UpdateStaging ( const uint8_t* data, size_t size );
 };
 
 } // namespace rotating_mesh
 
 
-#endif // ROTATING_UNIFORM_BUFFER_H
\ No newline at end of file
+#endif // ROTATING_UNIFORM_BUFFER_H
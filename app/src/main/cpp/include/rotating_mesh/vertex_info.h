@@ -7,6 +7,14 @@
 
 namespace rotating_mesh {
 
+enum class eVertexFormat : uint8_t
+{
+    Full,       // VertexInfo
+    Packed      // PackedVertexInfo
+};
+
+constexpr const size_t VERTEX_FORMAT_COUNT = 2U;
+
 #pragma pack ( push, 1 )
 
 struct VertexInfo final
@@ -37,6 +45,17 @@ struct VertexInfo final
     ~VertexInfo () = default;
 };
 
+// The layout is 24 bytes instead of 56 bytes of VertexInfo. The UV is R16G16_SFLOAT. The normal and the tangent are
+// A2B10G10R10_UNORM_PACK32 which are remapped from [0, 1] to [-1, 1] in the vertex shader. The alpha of the tangent
+// keeps the sign of the bitangent. The bitangent is rebuilt as cross ( normal, tangent ) * sign. See VertexPacker.
+struct PackedVertexInfo final
+{
+    GXVec3      _vertex;
+    uint16_t    _uv[ 2U ];
+    uint32_t    _normal;
+    uint32_t    _tangent;
+};
+
 #pragma pack ( pop )
 
 } // namespace rotating_mesh
@@ -0,0 +1,59 @@
+#ifndef ROTATING_MESH_VERTEX_PACKER_H
+#define ROTATING_MESH_VERTEX_PACKER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstddef>
+
+GX_RESTORE_WARNING_STATE
+
+#include "vertex_info.h"
+
+
+namespace rotating_mesh {
+
+// Maximum errors of the packed vertices. The UV error is in texture coordinate units. Other errors are angles
+// in degrees. The bitangent error is measured against the bitangent which is rebuilt from the source normal and
+// tangent. So it's the quantization error only. The skew is the average angle between the source bitangent and
+// the rebuilt one. It's the cost of dropping the bitangent if the source tangent frames are not orthogonal.
+struct VertexPackingError final
+{
+    float       _uv;
+    float       _normal;
+    float       _tangent;
+    float       _bitangent;
+    float       _averageSkew;
+};
+
+// CPU side of the packed vertex format. The class has no Vulkan dependency so it is built for the host too.
+class VertexPacker final
+{
+    public:
+        VertexPacker () = delete;
+
+        VertexPacker ( const VertexPacker &other ) = delete;
+        VertexPacker& operator = ( const VertexPacker &other ) = delete;
+
+        // Method packs "count" vertices and flips the V texture coordinate on the job system workers. The same as
+        // MeshParser::ConvertVertices does for VertexInfo. "destination" is written only. So it could be the mapped
+        // write-combined memory.
+        static void Pack ( PackedVertexInfo* destination, const VertexInfo* source, size_t count );
+
+        // Method decodes the vertex the same way as the vertex shader does. Note the V flip is not undone.
+        static void Unpack ( VertexInfo &vertex, const PackedVertexInfo &packed );
+
+        // Note "source" must be the data which was passed to VertexPacker::Pack.
+        static void MeasureError ( VertexPackingError &error,
+            const PackedVertexInfo* packed,
+            const VertexInfo* source,
+            size_t count
+        );
+};
+
+} // namespace rotating_mesh
+
+
+#endif // ROTATING_MESH_VERTEX_PACKER_H
@@ -0,0 +1,94 @@
+#ifndef ANDROID_VULKAN_SAMPLER_CACHE_H
+#define ANDROID_VULKAN_SAMPLER_CACHE_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vulkan_wrapper.h>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+// The class shares VkSampler objects between the users which request the same sampler state. The samplers are
+// counted by references. The sampler is destroyed when the last reference is released. The state must not contain
+// the extension structures. Use maxLod VK_LOD_CLAMP_NONE to serve textures with any mip count by one sampler.
+// The class is thread safe.
+class SamplerCache final
+{
+    private:
+        // All fields of VkSamplerCreateInfo except sType and pNext. Every field takes four bytes. So the structure
+        // has no padding and it's hashed as the memory block. The float fields are compared by value. So -0.0F
+        // and 0.0F are the same state. They are stored as 0.0F. So the equal keys have the same bytes and the same
+        // hash.
+        struct Key final
+        {
+            VkSamplerCreateFlags        _flags;
+            VkFilter                    _magFilter;
+            VkFilter                    _minFilter;
+            VkSamplerMipmapMode         _mipmapMode;
+            VkSamplerAddressMode        _addressModeU;
+            VkSamplerAddressMode        _addressModeV;
+            VkSamplerAddressMode        _addressModeW;
+            float                       _mipLodBias;
+            VkBool32                    _anisotropyEnable;
+            float                       _maxAnisotropy;
+            VkBool32                    _compareEnable;
+            VkCompareOp                 _compareOp;
+            float                       _minLod;
+            float                       _maxLod;
+            VkBorderColor               _borderColor;
+            VkBool32                    _unnormalizedCoordinates;
+
+            explicit Key ( const VkSamplerCreateInfo &info );
+
+            bool operator == ( const Key &other ) const;
+        };
+
+        struct KeyHasher final
+        {
+            size_t operator () ( const Key &key ) const;
+        };
+
+        struct Entry final
+        {
+            Key                         _key;
+            size_t                      _references;
+        };
+
+    private:
+        VkDevice                                        _device;
+        std::map<VkSampler, Entry>                      _entries;
+        std::mutex                                      _mutex;
+        std::unordered_map<Key, VkSampler, KeyHasher>   _samplers;
+
+    public:
+        SamplerCache ();
+        ~SamplerCache () = default;
+
+        SamplerCache ( const SamplerCache &other ) = delete;
+        SamplerCache& operator = ( const SamplerCache &other ) = delete;
+
+        void Init ( VkDevice device );
+
+        // Note all samplers must be released before. The remaining samplers are destroyed and reported.
+        void Destroy ();
+
+        // Method returns the shared sampler with the same state. The sampler is created if there is no such sampler.
+        // Every successful call must be paired with SamplerCache::Release.
+        VkResult Acquire ( VkSampler &sampler, const VkSamplerCreateInfo &info );
+
+        // Note "sampler" must be the value which was returned by SamplerCache::Acquire.
+        void Release ( VkSampler sampler );
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_SAMPLER_CACHE_H
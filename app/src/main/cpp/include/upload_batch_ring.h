@@ -0,0 +1,93 @@
+#ifndef ANDROID_VULKAN_UPLOAD_BATCH_RING_H
+#define ANDROID_VULKAN_UPLOAD_BATCH_RING_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+constexpr const size_t NO_UPLOAD_BATCH = SIZE_MAX;
+
+// Bookkeeping of the upload batches without Vulkan objects. UploadScheduler keeps the command buffer and the fence of
+// every batch at the same index. So the batch selection and the release of the transfer resources are tested on
+// the host.
+class UploadBatchRing final
+{
+    public:
+        using ReleaseCallback = std::function<void ()>;
+
+    private:
+        struct Batch final
+        {
+            bool                                            _isSubmitted;
+            std::vector<ReleaseCallback>                    _releaseCallbacks;
+            uint64_t                                        _submitOrder;
+            std::chrono::steady_clock::time_point           _submitTime;
+        };
+
+    private:
+        std::vector<Batch>                                  _batches;
+        uint64_t                                            _nextSubmitOrder;
+        size_t                                              _recording;
+
+    public:
+        UploadBatchRing ();
+        ~UploadBatchRing () = default;
+
+        UploadBatchRing ( const UploadBatchRing &other ) = delete;
+        UploadBatchRing& operator = ( const UploadBatchRing &other ) = delete;
+
+        void Init ( size_t batchCount );
+
+        // Note the method drops all batches without invoking the release callbacks.
+        void Destroy ();
+
+        size_t GetBatchCount () const;
+
+        // Method returns NO_UPLOAD_BATCH if there is no recording batch.
+        size_t GetRecording () const;
+
+        // Method returns the number of the release callbacks of the batch.
+        size_t GetUploads ( size_t batch ) const;
+
+        bool IsSubmitted ( size_t batch ) const;
+
+        // Method returns the first batch which is not submitted. The oldest submitted batch is returned if all
+        // batches are in flight. The caller must wait its fence and call UploadBatchRing::Retire before
+        // UploadBatchRing::BeginRecording.
+        size_t SelectBatch () const;
+
+        // Note the batch must not be submitted.
+        void BeginRecording ( size_t batch );
+
+        // Method forgets the recording batch. It's used when the command buffer can't be started.
+        void CancelRecording ();
+
+        // Callback will be invoked when the recording batch is retired.
+        void AddReleaseCallback ( ReleaseCallback &&callback );
+
+        // Method marks the recording batch as submitted.
+        void Submit ();
+
+        // Method invokes the release callbacks of the submitted batch. The batch becomes free.
+        void Retire ( size_t batch );
+
+        // Method invokes the release callbacks of the recording batch. GPU has never seen its commands. So the
+        // transfer resources could be released right now.
+        void ReleaseRecording ();
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_UPLOAD_BATCH_RING_H
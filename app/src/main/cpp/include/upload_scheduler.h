@@ -0,0 +1,77 @@
+#ifndef ANDROID_VULKAN_UPLOAD_SCHEDULER_H
+#define ANDROID_VULKAN_UPLOAD_SCHEDULER_H
+
+
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include "renderer.h"
+#include "upload_batch_ring.h"
+
+
+namespace android_vulkan {
+
+// The class collects upload commands of many resources into one command buffer and submits them as a single batch
+// with a fence. Transfer resources of the batch are released via callbacks when the fence is signaled. So there is no
+// need to wait for the whole queue. Few batches could be in flight simultaneously. It allows to stream resources
+// while the render loop is running. See UploadBatchRing.
+class UploadScheduler final
+{
+    public:
+        using ReleaseCallback = UploadBatchRing::ReleaseCallback;
+
+    private:
+        std::vector<VkCommandBuffer>                        _commandBuffers;
+        VkCommandPool                                       _commandPool;
+        std::vector<VkFence>                                _fences;
+        Renderer*                                           _renderer;
+        UploadBatchRing                                     _ring;
+
+    public:
+        UploadScheduler ();
+        ~UploadScheduler () = default;
+
+        UploadScheduler ( const UploadScheduler &other ) = delete;
+        UploadScheduler& operator = ( const UploadScheduler &other ) = delete;
+
+        // The method returns true if success. Otherwise the method returns false.
+        bool Init ( Renderer &renderer );
+
+        // Note the method waits all submitted batches and invokes all pending release callbacks.
+        void Destroy ();
+
+        // Method returns command buffer in recording state. Upload commands must be recorded into it.
+        // Successive calls return the same command buffer until UploadScheduler::Submit is invoked.
+        // Note the method stalls only if all batches are in flight.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Begin ( VkCommandBuffer &commandBuffer );
+
+        // Callback will be invoked when GPU completes the batch which is being recorded now.
+        // Note every callback is counted as single upload in the statistics.
+        void AddReleaseCallback ( ReleaseCallback &&callback );
+
+        // Method does nothing if there is no recording batch.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Submit ();
+
+        // Non blocking check of the submitted batches. It is supposed to be called once per frame.
+        // The method returns true if success. Otherwise the method returns false.
+        bool Poll ();
+
+        // The method returns true if success. Otherwise the method returns false.
+        bool WaitIdle ();
+
+    private:
+        bool AcquireBatch ();
+        bool Retire ( size_t batch );
+};
+
+} // namespace android_vulkan
+
+
+#endif // ANDROID_VULKAN_UPLOAD_SCHEDULER_H
@@ -9,26 +9,6 @@
 
 #define AV_VK_FLAG(x) ( static_cast<uint32_t> ( x ) )
 
-namespace android_vulkan {
-
-// float16 data type
-class Half final
-{
-    private:
-        uint16_t        data;
-
-    public:
-        Half ();
-        Half ( float value );
-
-        Half ( const Half &other ) = default;
-        ~Half () = default;
-
-        Half& operator = ( const Half &other ) = default;
-};
-
-} // namespace android_vulkan
-
 // Note there is two types Vulkan handles:
 // VK_DEFINE_HANDLE
 // VK_DEFINE_NON_DISPATCHABLE_HANDLE
@@ -78,9 +58,15 @@ class Half final
 #define AV_REGISTER_PIPELINE(where)
 #define AV_UNREGISTER_PIPELINE(where)
 
+#define AV_REGISTER_PIPELINE_CACHE(where)
+#define AV_UNREGISTER_PIPELINE_CACHE(where)
+
 #define AV_REGISTER_PIPELINE_LAYOUT(where)
 #define AV_UNREGISTER_PIPELINE_LAYOUT(where)
 
+#define AV_REGISTER_QUERY_POOL(where)
+#define AV_UNREGISTER_QUERY_POOL(where)
+
 #define AV_REGISTER_RENDER_PASS(where)
 #define AV_UNREGISTER_RENDER_PASS(where)
 
@@ -146,9 +132,15 @@ GX_RESTORE_WARNING_STATE
 #define AV_REGISTER_PIPELINE(where) android_vulkan::RegisterPipeline ( where );
 #define AV_UNREGISTER_PIPELINE(where) android_vulkan::UnregisterPipeline ( where );
 
+#define AV_REGISTER_PIPELINE_CACHE(where) android_vulkan::RegisterPipelineCache ( where );
+#define AV_UNREGISTER_PIPELINE_CACHE(where) android_vulkan::UnregisterPipelineCache ( where );
+
 #define AV_REGISTER_PIPELINE_LAYOUT(where) android_vulkan::RegisterPipelineLayout ( where );
 #define AV_UNREGISTER_PIPELINE_LAYOUT(where) android_vulkan::UnregisterPipelineLayout ( where );
 
+#define AV_REGISTER_QUERY_POOL(where) android_vulkan::RegisterQueryPool ( where );
+#define AV_UNREGISTER_QUERY_POOL(where) android_vulkan::UnregisterQueryPool ( where );
+
 #define AV_REGISTER_RENDER_PASS(where) android_vulkan::RegisterRenderPass ( where );
 #define AV_UNREGISTER_RENDER_PASS(where) android_vulkan::UnregisterRenderPass ( where );
 
@@ -204,9 +196,15 @@ void UnregisterImageView ( std::string &&where );
 void RegisterPipeline ( std::string &&where );
 void UnregisterPipeline ( std::string &&where );
 
+void RegisterPipelineCache ( std::string &&where );
+void UnregisterPipelineCache ( std::string &&where );
+
 void RegisterPipelineLayout ( std::string &&where );
 void UnregisterPipelineLayout ( std::string &&where );
 
+void RegisterQueryPool ( std::string &&where );
+void UnregisterQueryPool ( std::string &&where );
+
 void RegisterRenderPass ( std::string &&where );
 void UnregisterRenderPass ( std::string &&where );
 
@@ -1,6 +1,7 @@
 ﻿// version 1.56
 
 #include <GXCommon/GXMath.h>
+#include <GXCommon/GXSIMD.h>
 #include <GXCommon/GXWarning.h>
 
 GX_DISABLE_COMMON_WARNINGS
@@ -564,26 +565,51 @@ GXFloat GXVec4::GetW () const
 
 GXVoid GXVec4::Sum ( const GXVec4 &a, const GXVec4 &b )
 {
+#ifdef GX_SIMD_ENABLED
+
+    GXSIMDStore ( _data, GXSIMDAdd ( GXSIMDLoad ( a._data ), GXSIMDLoad ( b._data ) ) );
+
+#else
+
     _data[ 0u ] = a._data[ 0u ] + b._data[ 0u ];
     _data[ 1u ] = a._data[ 1u ] + b._data[ 1u ];
     _data[ 2u ] = a._data[ 2u ] + b._data[ 2u ];
     _data[ 3u ] = a._data[ 3u ] + b._data[ 3u ];
+
+#endif
 }
 
 GXVoid GXVec4::Sum ( const GXVec4 &a, GXFloat bScale, const GXVec4 &b )
 {
+#ifdef GX_SIMD_ENABLED
+
+    const GXSIMDFloat4 scaled = GXSIMDMul ( GXSIMDSplat ( bScale ), GXSIMDLoad ( b._data ) );
+    GXSIMDStore ( _data, GXSIMDAdd ( GXSIMDLoad ( a._data ), scaled ) );
+
+#else
+
     _data[ 0u ] = a._data[ 0u ] + bScale * b._data[ 0u ];
     _data[ 1u ] = a._data[ 1u ] + bScale * b._data[ 1u ];
     _data[ 2u ] = a._data[ 2u ] + bScale * b._data[ 2u ];
     _data[ 3u ] = a._data[ 3u ] + bScale * b._data[ 3u ];
+
+#endif
 }
 
 GXVoid GXVec4::Substract ( const GXVec4 &a, const GXVec4 &b )
 {
+#ifdef GX_SIMD_ENABLED
+
+    GXSIMDStore ( _data, GXSIMDSub ( GXSIMDLoad ( a._data ), GXSIMDLoad ( b._data ) ) );
+
+#else
+
     _data[ 0u ] = a._data[ 0u ] - b._data[ 0u ];
     _data[ 1u ] = a._data[ 1u ] - b._data[ 1u ];
     _data[ 2u ] = a._data[ 2u ] - b._data[ 2u ];
     _data[ 3u ] = a._data[ 3u ] - b._data[ 3u ];
+
+#endif
 }
 
 GXFloat GXVec4::DotProduct ( const GXVec4 &other ) const
@@ -1184,7 +1210,7 @@ GXVoid GXQuat::FromFast ( const GXMat3 &pureRotationMatrix )
     {
         if ( solutionFactorAlpha > solutionFactorGamma )
         {
-            solution = solutionFactorAlpha > solutionFactorYotta ? static_cast<GXUByte> ( SOLUTION_ALPHA ) : solution = static_cast<GXUByte> ( SOLUTION_YOTTA );
+            solution = solutionFactorAlpha > solutionFactorYotta ? static_cast<GXUByte> ( SOLUTION_ALPHA ) : static_cast<GXUByte> ( SOLUTION_YOTTA );
         }
         else if ( solutionFactorGamma > solutionFactorYotta )
         {
@@ -1280,7 +1306,7 @@ GXVoid GXQuat::FromFast ( const GXMat4 &pureRotationMatrix )
     {
         if ( solutionFactorAlpha > solutionFactorGamma )
         {
-            solution = solutionFactorAlpha > solutionFactorYotta ? static_cast<GXUByte> ( SOLUTION_ALPHA ) : solution = static_cast<GXUByte> ( SOLUTION_YOTTA );
+            solution = solutionFactorAlpha > solutionFactorYotta ? static_cast<GXUByte> ( SOLUTION_ALPHA ) : static_cast<GXUByte> ( SOLUTION_YOTTA );
         }
         else if ( solutionFactorGamma > solutionFactorYotta )
         {
@@ -1362,10 +1388,34 @@ GXVoid GXQuat::FromFast ( const GXMat4 &pureRotationMatrix )
 
 GXVoid GXQuat::Multiply ( const GXQuat &a, const GXQuat &b )
 {
+#ifdef GX_SIMD_ENABLED
+
+    // Every component is the sum of four products. The signs are applied to the b permutations. So the summation order
+    // is the same as in the scalar code.
+    alignas ( 16u ) constexpr static const GXFloat signs1[ 4u ] = { -1.0f, 1.0f, -1.0f, 1.0f };
+    alignas ( 16u ) constexpr static const GXFloat signs2[ 4u ] = { -1.0f, 1.0f, 1.0f, -1.0f };
+    alignas ( 16u ) constexpr static const GXFloat signs3[ 4u ] = { -1.0f, -1.0f, 1.0f, 1.0f };
+
+    const GXSIMDFloat4 qa = GXSIMDLoad ( a._data );
+    const GXSIMDFloat4 qb = GXSIMDLoad ( b._data );
+
+    const GXSIMDFloat4 b1 = GXSIMDMul ( GXSIMDShuffle ( qb, qb, 1, 0, 3, 2 ), GXSIMDLoad ( signs1 ) );
+    const GXSIMDFloat4 b2 = GXSIMDMul ( GXSIMDShuffle ( qb, qb, 2, 3, 0, 1 ), GXSIMDLoad ( signs2 ) );
+    const GXSIMDFloat4 b3 = GXSIMDMul ( GXSIMDShuffle ( qb, qb, 3, 2, 1, 0 ), GXSIMDLoad ( signs3 ) );
+
+    GXSIMDFloat4 result = GXSIMDMul ( GXSIMDSplatLane ( qa, 0 ), qb );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( qa, 1 ), b1 ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( qa, 2 ), b2 ) );
+    GXSIMDStore ( _data, GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( qa, 3 ), b3 ) ) );
+
+#else
+
     _data[ 0u ] = a._data[ 0u ] * b._data[ 0u ] - a._data[ 1u ] * b._data[ 1u ] - a._data[ 2u ] * b._data[ 2u ] - a._data[ 3u ] * b._data[ 3u ];
     _data[ 1u ] = a._data[ 0u ] * b._data[ 1u ] + a._data[ 1u ] * b._data[ 0u ] + a._data[ 2u ] * b._data[ 3u ] - a._data[ 3u ] * b._data[ 2u ];
     _data[ 2u ] = a._data[ 0u ] * b._data[ 2u ] - a._data[ 1u ] * b._data[ 3u ] + a._data[ 2u ] * b._data[ 0u ] + a._data[ 3u ] * b._data[ 1u ];
     _data[ 3u ] = a._data[ 0u ] * b._data[ 3u ] + a._data[ 1u ] * b._data[ 2u ] - a._data[ 2u ] * b._data[ 1u ] + a._data[ 3u ] * b._data[ 0u ];
+
+#endif
 }
 
 GXVoid GXQuat::Multiply ( const GXQuat &q, GXFloat scale )
@@ -2249,8 +2299,97 @@ GXVoid GXMat4::ClearScale ( GXVec3 &scale ) const
     scale._data[ 2u ] = alpha.Length ();
 }
 
+#ifdef GX_SIMD_ENABLED
+
+// 2x2 matrix product A * B. The matrices are stored in row order.
+static GXSIMDFloat4 Mat2Multiply ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return GXSIMDAdd ( GXSIMDMul ( a, GXSIMDShuffle ( b, b, 0, 3, 0, 3 ) ),
+        GXSIMDMul ( GXSIMDShuffle ( a, a, 1, 0, 3, 2 ), GXSIMDShuffle ( b, b, 2, 1, 2, 1 ) )
+    );
+}
+
+// 2x2 matrix product A# * B where A# is adjugate of A.
+static GXSIMDFloat4 Mat2AdjugateMultiply ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return GXSIMDSub ( GXSIMDMul ( GXSIMDShuffle ( a, a, 3, 3, 0, 0 ), b ),
+        GXSIMDMul ( GXSIMDShuffle ( a, a, 1, 1, 2, 2 ), GXSIMDShuffle ( b, b, 2, 3, 0, 1 ) )
+    );
+}
+
+// 2x2 matrix product A * B# where B# is adjugate of B.
+static GXSIMDFloat4 Mat2MultiplyAdjugate ( GXSIMDFloat4 a, GXSIMDFloat4 b )
+{
+    return GXSIMDSub ( GXSIMDMul ( a, GXSIMDShuffle ( b, b, 3, 0, 3, 0 ) ),
+        GXSIMDMul ( GXSIMDShuffle ( a, a, 1, 0, 3, 2 ), GXSIMDShuffle ( b, b, 2, 1, 2, 1 ) )
+    );
+}
+
+#endif
+
 GXVoid GXMat4::Inverse ( const GXMat4 &sourceMatrix )
 {
+#ifdef GX_SIMD_ENABLED
+
+    // Block matrix method. Every register holds 2x2 sub-matrix in row order:
+    //     | A B |
+    //     | C D |
+    // The result is ( |D|A - B(D#C), |B|C - D(A#B)#, |C|B - A(D#C)#, |A|D - C(A#B) ) / |M| where X# is adjugate.
+    alignas ( 16u ) constexpr static const GXFloat adjugateSigns[ 4u ] = { 1.0f, -1.0f, -1.0f, 1.0f };
+
+    const GXSIMDFloat4 row0 = GXSIMDLoad ( sourceMatrix._m[ 0u ] );
+    const GXSIMDFloat4 row1 = GXSIMDLoad ( sourceMatrix._m[ 1u ] );
+    const GXSIMDFloat4 row2 = GXSIMDLoad ( sourceMatrix._m[ 2u ] );
+    const GXSIMDFloat4 row3 = GXSIMDLoad ( sourceMatrix._m[ 3u ] );
+
+    const GXSIMDFloat4 a = GXSIMDShuffle ( row0, row1, 0, 1, 0, 1 );
+    const GXSIMDFloat4 b = GXSIMDShuffle ( row0, row1, 2, 3, 2, 3 );
+    const GXSIMDFloat4 c = GXSIMDShuffle ( row2, row3, 0, 1, 0, 1 );
+    const GXSIMDFloat4 d = GXSIMDShuffle ( row2, row3, 2, 3, 2, 3 );
+
+    // ( |A|, |B|, |C|, |D| )
+    const GXSIMDFloat4 determinants = GXSIMDSub (
+        GXSIMDMul ( GXSIMDShuffle ( row0, row2, 0, 2, 0, 2 ), GXSIMDShuffle ( row1, row3, 1, 3, 1, 3 ) ),
+        GXSIMDMul ( GXSIMDShuffle ( row0, row2, 1, 3, 1, 3 ), GXSIMDShuffle ( row1, row3, 0, 2, 0, 2 ) )
+    );
+
+    const GXSIMDFloat4 detA = GXSIMDSplatLane ( determinants, 0 );
+    const GXSIMDFloat4 detB = GXSIMDSplatLane ( determinants, 1 );
+    const GXSIMDFloat4 detC = GXSIMDSplatLane ( determinants, 2 );
+    const GXSIMDFloat4 detD = GXSIMDSplatLane ( determinants, 3 );
+
+    const GXSIMDFloat4 dc = Mat2AdjugateMultiply ( d, c );
+    const GXSIMDFloat4 ab = Mat2AdjugateMultiply ( a, b );
+
+    GXSIMDFloat4 x = GXSIMDSub ( GXSIMDMul ( detD, a ), Mat2Multiply ( b, dc ) );
+    GXSIMDFloat4 y = GXSIMDSub ( GXSIMDMul ( detB, c ), Mat2MultiplyAdjugate ( d, ab ) );
+    GXSIMDFloat4 z = GXSIMDSub ( GXSIMDMul ( detC, b ), Mat2MultiplyAdjugate ( a, dc ) );
+    GXSIMDFloat4 w = GXSIMDSub ( GXSIMDMul ( detA, d ), Mat2Multiply ( c, ab ) );
+
+    // |M| = |A||D| + |B||C| - tr ( ( A#B ) ( D#C ) )
+    GXSIMDFloat4 trace = GXSIMDMul ( ab, GXSIMDShuffle ( dc, dc, 0, 2, 1, 3 ) );
+    trace = GXSIMDAdd ( trace, GXSIMDShuffle ( trace, trace, 2, 3, 0, 1 ) );
+    trace = GXSIMDAdd ( trace, GXSIMDShuffle ( trace, trace, 1, 0, 3, 2 ) );
+
+    const GXFloat determinant = GXSIMDGetX (
+        GXSIMDSub ( GXSIMDAdd ( GXSIMDMul ( detA, detD ), GXSIMDMul ( detB, detC ) ), trace )
+    );
+
+    const GXSIMDFloat4 scale = GXSIMDMul ( GXSIMDLoad ( adjugateSigns ), GXSIMDSplat ( 1.0f / determinant ) );
+
+    x = GXSIMDMul ( x, scale );
+    y = GXSIMDMul ( y, scale );
+    z = GXSIMDMul ( z, scale );
+    w = GXSIMDMul ( w, scale );
+
+    // The adjugate shuffle is combined with the block to row shuffle.
+    GXSIMDStore ( _m[ 0u ], GXSIMDShuffle ( x, y, 3, 1, 3, 1 ) );
+    GXSIMDStore ( _m[ 1u ], GXSIMDShuffle ( x, y, 2, 0, 2, 0 ) );
+    GXSIMDStore ( _m[ 2u ], GXSIMDShuffle ( z, w, 3, 1, 3, 1 ) );
+    GXSIMDStore ( _m[ 3u ], GXSIMDShuffle ( z, w, 2, 0, 2, 0 ) );
+
+#else
+
     // 2x2 sub-determinants required to calculate 4x4 determinant
     GXFloat det2_01_01 = sourceMatrix._m[ 0u ][ 0u ] * sourceMatrix._m[ 1u ][ 1u ] - sourceMatrix._m[ 1u ][ 0u ] * sourceMatrix._m[ 0u ][ 1u ];
     GXFloat det2_01_02 = sourceMatrix._m[ 0u ][ 0u ] * sourceMatrix._m[ 2u ][ 1u ] - sourceMatrix._m[ 2u ][ 0u ] * sourceMatrix._m[ 0u ][ 1u ];
@@ -2317,10 +2456,32 @@ GXVoid GXMat4::Inverse ( const GXMat4 &sourceMatrix )
     _m[ 3u ][ 1u ] = +det3_201_023 * inverseDeterminant;
     _m[ 3u ][ 2u ] = -det3_201_013 * inverseDeterminant;
     _m[ 3u ][ 3u ] = +det3_201_012 * inverseDeterminant;
+
+#endif
 }
 
 GXVoid GXMat4::Multiply ( const GXMat4 &a, const GXMat4 &b )
 {
+#ifdef GX_SIMD_ENABLED
+
+    // Every result row is the sum of b rows scaled by a row components. The summation order is the same as
+    // in the scalar code.
+    const GXSIMDFloat4 b0 = GXSIMDLoad ( b._m[ 0u ] );
+    const GXSIMDFloat4 b1 = GXSIMDLoad ( b._m[ 1u ] );
+    const GXSIMDFloat4 b2 = GXSIMDLoad ( b._m[ 2u ] );
+    const GXSIMDFloat4 b3 = GXSIMDLoad ( b._m[ 3u ] );
+
+    for ( GXUByte i = 0u; i < 4u; ++i )
+    {
+        const GXSIMDFloat4 row = GXSIMDLoad ( a._m[ i ] );
+        GXSIMDFloat4 result = GXSIMDMul ( GXSIMDSplatLane ( row, 0 ), b0 );
+        result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( row, 1 ), b1 ) );
+        result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( row, 2 ), b2 ) );
+        GXSIMDStore ( _m[ i ], GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( row, 3 ), b3 ) ) );
+    }
+
+#else
+
     _m[ 0u ][ 0u ] = a._m[ 0u ][ 0u ] * b._m[ 0u ][ 0u ] + a._m[ 0u ][ 1u ] * b._m[ 1u ][ 0u ] + a._m[ 0u ][ 2u ] * b._m[ 2u ][ 0u ] + a._m[ 0u ][ 3u ] * b._m[ 3u ][ 0u ];
     _m[ 0u ][ 1u ] = a._m[ 0u ][ 0u ] * b._m[ 0u ][ 1u ] + a._m[ 0u ][ 1u ] * b._m[ 1u ][ 1u ] + a._m[ 0u ][ 2u ] * b._m[ 2u ][ 1u ] + a._m[ 0u ][ 3u ] * b._m[ 3u ][ 1u ];
     _m[ 0u ][ 2u ] = a._m[ 0u ][ 0u ] * b._m[ 0u ][ 2u ] + a._m[ 0u ][ 1u ] * b._m[ 1u ][ 2u ] + a._m[ 0u ][ 2u ] * b._m[ 2u ][ 2u ] + a._m[ 0u ][ 3u ] * b._m[ 3u ][ 2u ];
@@ -2340,36 +2501,92 @@ GXVoid GXMat4::Multiply ( const GXMat4 &a, const GXMat4 &b )
     _m[ 3u ][ 1u ] = a._m[ 3u ][ 0u ] * b._m[ 0u ][ 1u ] + a._m[ 3u ][ 1u ] * b._m[ 1u ][ 1u ] + a._m[ 3u ][ 2u ] * b._m[ 2u ][ 1u ] + a._m[ 3u ][ 3u ] * b._m[ 3u ][ 1u ];
     _m[ 3u ][ 2u ] = a._m[ 3u ][ 0u ] * b._m[ 0u ][ 2u ] + a._m[ 3u ][ 1u ] * b._m[ 1u ][ 2u ] + a._m[ 3u ][ 2u ] * b._m[ 2u ][ 2u ] + a._m[ 3u ][ 3u ] * b._m[ 3u ][ 2u ];
     _m[ 3u ][ 3u ] = a._m[ 3u ][ 0u ] * b._m[ 0u ][ 3u ] + a._m[ 3u ][ 1u ] * b._m[ 1u ][ 3u ] + a._m[ 3u ][ 2u ] * b._m[ 2u ][ 3u ] + a._m[ 3u ][ 3u ] * b._m[ 3u ][ 3u ];
+
+#endif
 }
 
 GXVoid GXMat4::MultiplyVectorMatrix ( GXVec4 &out, const GXVec4 &v ) const
 {
+#ifdef GX_SIMD_ENABLED
+
+    const GXSIMDFloat4 vector = GXSIMDLoad ( v._data );
+    GXSIMDFloat4 result = GXSIMDMul ( GXSIMDSplatLane ( vector, 0 ), GXSIMDLoad ( _m[ 0u ] ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( vector, 1 ), GXSIMDLoad ( _m[ 1u ] ) ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( vector, 2 ), GXSIMDLoad ( _m[ 2u ] ) ) );
+    GXSIMDStore ( out._data, GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( vector, 3 ), GXSIMDLoad ( _m[ 3u ] ) ) ) );
+
+#else
+
     out._data[ 0u ] = v._data[ 0u ] * _m[ 0u ][ 0u ] + v._data[ 1u ] * _m[ 1u ][ 0u ] + v._data[ 2u ] * _m[ 2u ][ 0u ] + v._data[ 3u ] * _m[ 3u ][ 0u ];
     out._data[ 1u ] = v._data[ 0u ] * _m[ 0u ][ 1u ] + v._data[ 1u ] * _m[ 1u ][ 1u ] + v._data[ 2u ] * _m[ 2u ][ 1u ] + v._data[ 3u ] * _m[ 3u ][ 1u ];
     out._data[ 2u ] = v._data[ 0u ] * _m[ 0u ][ 2u ] + v._data[ 1u ] * _m[ 1u ][ 2u ] + v._data[ 2u ] * _m[ 2u ][ 2u ] + v._data[ 3u ] * _m[ 3u ][ 2u ];
     out._data[ 3u ] = v._data[ 0u ] * _m[ 0u ][ 3u ] + v._data[ 1u ] * _m[ 1u ][ 3u ] + v._data[ 2u ] * _m[ 2u ][ 3u ] + v._data[ 3u ] * _m[ 3u ][ 3u ];
+
+#endif
 }
 
 GXVoid GXMat4::MultiplyMatrixVector ( GXVec4 &out, const GXVec4 &v ) const
 {
+#ifdef GX_SIMD_ENABLED
+
+    // The columns are gathered by transposition. So it is the same sum of scaled rows as MultiplyVectorMatrix.
+    GXSIMDFloat4 column0 = GXSIMDLoad ( _m[ 0u ] );
+    GXSIMDFloat4 column1 = GXSIMDLoad ( _m[ 1u ] );
+    GXSIMDFloat4 column2 = GXSIMDLoad ( _m[ 2u ] );
+    GXSIMDFloat4 column3 = GXSIMDLoad ( _m[ 3u ] );
+    GXSIMDTranspose ( column0, column1, column2, column3 );
+
+    const GXSIMDFloat4 vector = GXSIMDLoad ( v._data );
+    GXSIMDFloat4 result = GXSIMDMul ( column0, GXSIMDSplatLane ( vector, 0 ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( column1, GXSIMDSplatLane ( vector, 1 ) ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( column2, GXSIMDSplatLane ( vector, 2 ) ) );
+    GXSIMDStore ( out._data, GXSIMDAdd ( result, GXSIMDMul ( column3, GXSIMDSplatLane ( vector, 3 ) ) ) );
+
+#else
+
     out._data[ 0u ] = _m[ 0u ][ 0u ] * v._data[ 0u ] + _m[ 0u ][ 1u ] * v._data[ 1u ] + _m[ 0u ][ 2u ] * v._data[ 2u ] + _m[ 0u ][ 3u ] * v._data[ 3u ];
     out._data[ 1u ] = _m[ 1u ][ 0u ] * v._data[ 0u ] + _m[ 1u ][ 1u ] * v._data[ 1u ] + _m[ 1u ][ 2u ] * v._data[ 2u ] + _m[ 1u ][ 3u ] * v._data[ 3u ];
     out._data[ 2u ] = _m[ 2u ][ 0u ] * v._data[ 0u ] + _m[ 2u ][ 1u ] * v._data[ 1u ] + _m[ 2u ][ 2u ] * v._data[ 2u ] + _m[ 2u ][ 3u ] * v._data[ 3u ];
     out._data[ 3u ] = _m[ 3u ][ 0u ] * v._data[ 0u ] + _m[ 3u ][ 1u ] * v._data[ 1u ] + _m[ 3u ][ 2u ] * v._data[ 2u ] + _m[ 3u ][ 3u ] * v._data[ 3u ];
+
+#endif
 }
 
 GXVoid GXMat4::MultiplyAsNormal ( GXVec3 &out, const GXVec3 &v ) const
 {
+#ifdef GX_SIMD_ENABLED
+
+    // The fourth row component is computed too. It is dropped by the store.
+    GXSIMDFloat4 result = GXSIMDMul ( GXSIMDSplat ( v._data[ 0u ] ), GXSIMDLoad ( _m[ 0u ] ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplat ( v._data[ 1u ] ), GXSIMDLoad ( _m[ 1u ] ) ) );
+    GXSIMDStore3 ( out._data, GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplat ( v._data[ 2u ] ), GXSIMDLoad ( _m[ 2u ] ) ) ) );
+
+#else
+
     out._data[ 0u ] = v._data[ 0u ] * _m[ 0u ][ 0u ] + v._data[ 1u ] * _m[ 1u ][ 0u ] + v._data[ 2u ] * _m[ 2u ][ 0u ];
     out._data[ 1u ] = v._data[ 0u ] * _m[ 0u ][ 1u ] + v._data[ 1u ] * _m[ 1u ][ 1u ] + v._data[ 2u ] * _m[ 2u ][ 1u ];
     out._data[ 2u ] = v._data[ 0u ] * _m[ 0u ][ 2u ] + v._data[ 1u ] * _m[ 1u ][ 2u ] + v._data[ 2u ] * _m[ 2u ][ 2u ];
+
+#endif
 }
 
 GXVoid GXMat4::MultiplyAsPoint ( GXVec3 &out, const GXVec3 &v ) const
 {
+#ifdef GX_SIMD_ENABLED
+
+    // The fourth row component is computed too. It is dropped by the store.
+    GXSIMDFloat4 result = GXSIMDMul ( GXSIMDSplat ( v._data[ 0u ] ), GXSIMDLoad ( _m[ 0u ] ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplat ( v._data[ 1u ] ), GXSIMDLoad ( _m[ 1u ] ) ) );
+    result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplat ( v._data[ 2u ] ), GXSIMDLoad ( _m[ 2u ] ) ) );
+    GXSIMDStore3 ( out._data, GXSIMDAdd ( result, GXSIMDLoad ( _m[ 3u ] ) ) );
+
+#else
+
     out._data[ 0u ] = v._data[ 0u ] * _m[ 0u ][ 0u ] + v._data[ 1u ] * _m[ 1u ][ 0u ] + v._data[ 2u ] * _m[ 2u ][ 0u ] + _m[ 3u ][ 0u ];
     out._data[ 1u ] = v._data[ 0u ] * _m[ 0u ][ 1u ] + v._data[ 1u ] * _m[ 1u ][ 1u ] + v._data[ 2u ] * _m[ 2u ][ 1u ] + _m[ 3u ][ 1u ];
     out._data[ 2u ] = v._data[ 0u ] * _m[ 0u ][ 2u ] + v._data[ 1u ] * _m[ 1u ][ 2u ] + v._data[ 2u ] * _m[ 2u ][ 2u ] + _m[ 3u ][ 2u ];
+
+#endif
 }
 
 GXMat4& GXMat4::operator = ( const GXMat4 &matrix )
@@ -2728,7 +2945,7 @@ GXVoid GXProjectionClipPlanes::From ( const GXMat4 &src )
     _planes[ 5u ]._d = src._m[ 3u ][ 3u ] - src._m[ 3u ][ 2u ];
 }
 
-GXBool GXProjectionClipPlanes::IsVisible ( const GXAABB &bounds )
+GXBool GXProjectionClipPlanes::IsVisible ( const GXAABB &bounds ) const
 {
     GXInt flags = static_cast<GXInt> ( PlaneTest ( bounds._min._data[ 0u ], bounds._min._data[ 1u ], bounds._min._data[ 2u ] ) );
     flags &= static_cast<GXInt> ( PlaneTest ( bounds._min._data[ 0u ], bounds._max._data[ 1u ], bounds._min._data[ 2u ] ) );
@@ -2743,13 +2960,18 @@ GXBool GXProjectionClipPlanes::IsVisible ( const GXAABB &bounds )
     return flags <= 0;
 }
 
+const GXPlane& GXProjectionClipPlanes::GetPlane ( GXUByte index ) const
+{
+    return _planes[ index ];
+}
+
 GXProjectionClipPlanes& GXProjectionClipPlanes::operator = ( const GXProjectionClipPlanes &clipPlanes )
 {
     memcpy ( this, &clipPlanes, sizeof ( GXProjectionClipPlanes ) );
     return *this;
 }
 
-GXUByte GXProjectionClipPlanes::PlaneTest ( GXFloat x, GXFloat y, GXFloat z )
+GXUByte GXProjectionClipPlanes::PlaneTest ( GXFloat x, GXFloat y, GXFloat z ) const
 {
     GXUByte flags = 0u;
 
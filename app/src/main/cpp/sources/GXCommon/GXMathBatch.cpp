@@ -0,0 +1,579 @@
+// version 1.0
+
+#include <GXCommon/GXMathBatch.h>
+#include <GXCommon/GXSIMD.h>
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cfloat>
+#include <cstring>
+
+GX_RESTORE_WARNING_STATE
+
+
+#define GROUP_SIZE                          4u
+
+#define SLERP_TERMS                         16u
+
+#ifdef GX_SIMD_ENABLED
+
+// Series of sin ( t * angle ) / sin ( angle ) in powers of ( cos ( angle ) - 1 ). See D. Eberly "A Fast and Accurate
+// Algorithm for Computing SLERP". The series converges slowly for the right angle. So 16 terms are used. The last term
+// is scaled to balance the truncation error. The error is less than 1.0e-7 before float rounding.
+#define SLERP_CORRECTION                    1.917f
+
+constexpr static const GXFloat g_SlerpU[ SLERP_TERMS ] =
+{
+    1.0f / ( 1.0f * 3.0f ),
+    1.0f / ( 2.0f * 5.0f ),
+    1.0f / ( 3.0f * 7.0f ),
+    1.0f / ( 4.0f * 9.0f ),
+    1.0f / ( 5.0f * 11.0f ),
+    1.0f / ( 6.0f * 13.0f ),
+    1.0f / ( 7.0f * 15.0f ),
+    1.0f / ( 8.0f * 17.0f ),
+    1.0f / ( 9.0f * 19.0f ),
+    1.0f / ( 10.0f * 21.0f ),
+    1.0f / ( 11.0f * 23.0f ),
+    1.0f / ( 12.0f * 25.0f ),
+    1.0f / ( 13.0f * 27.0f ),
+    1.0f / ( 14.0f * 29.0f ),
+    1.0f / ( 15.0f * 31.0f ),
+    SLERP_CORRECTION / ( 16.0f * 33.0f )
+};
+
+constexpr static const GXFloat g_SlerpV[ SLERP_TERMS ] =
+{
+    1.0f / 3.0f,
+    2.0f / 5.0f,
+    3.0f / 7.0f,
+    4.0f / 9.0f,
+    5.0f / 11.0f,
+    6.0f / 13.0f,
+    7.0f / 15.0f,
+    8.0f / 17.0f,
+    9.0f / 19.0f,
+    10.0f / 21.0f,
+    11.0f / 23.0f,
+    12.0f / 25.0f,
+    13.0f / 27.0f,
+    14.0f / 29.0f,
+    15.0f / 31.0f,
+    SLERP_CORRECTION * 16.0f / 33.0f
+};
+
+// Method writes the row of four matrices. Every register holds one row element of four matrices.
+static GXVoid StoreRows ( GXMat4* matrices, GXUByte row, GXSIMDFloat4 e0, GXSIMDFloat4 e1, GXSIMDFloat4 e2, GXSIMDFloat4 e3 )
+{
+    GXSIMDTranspose ( e0, e1, e2, e3 );
+
+    GXSIMDStore ( matrices[ 0u ]._m[ row ], e0 );
+    GXSIMDStore ( matrices[ 1u ]._m[ row ], e1 );
+    GXSIMDStore ( matrices[ 2u ]._m[ row ], e2 );
+    GXSIMDStore ( matrices[ 3u ]._m[ row ], e3 );
+}
+
+// Result registers hold the components of four quaternions in r, a, b, c order.
+static GXVoid LoadQuaternions ( GXSIMDFloat4 &r, GXSIMDFloat4 &a, GXSIMDFloat4 &b, GXSIMDFloat4 &c, const GXQuat* quaternions )
+{
+    r = GXSIMDLoad ( quaternions[ 0u ]._data );
+    a = GXSIMDLoad ( quaternions[ 1u ]._data );
+    b = GXSIMDLoad ( quaternions[ 2u ]._data );
+    c = GXSIMDLoad ( quaternions[ 3u ]._data );
+    GXSIMDTranspose ( r, a, b, c );
+}
+
+// "worldToClip" contains the splatted matrix elements in row order.
+static GXVoid ComposeGroup ( GXMat4* localToWorld, GXMat4* localToClip, const GXQuat* orientations, const GXVec3* origins, const GXSIMDFloat4* worldToClip )
+{
+    GXSIMDFloat4 r;
+    GXSIMDFloat4 a;
+    GXSIMDFloat4 b;
+    GXSIMDFloat4 c;
+    LoadQuaternions ( r, a, b, c, orientations );
+
+    GXSIMDFloat4 world[ 4u ][ 4u ];
+    GXSIMDLoad3x4 ( world[ 3u ][ 0u ], world[ 3u ][ 1u ], world[ 3u ][ 2u ], origins[ 0u ]._data );
+
+    // Same expressions as GXMat4::SetRotationFast.
+    const GXSIMDFloat4 two = GXSIMDSplat ( 2.0f );
+    const GXSIMDFloat4 rr = GXSIMDMul ( r, r );
+    const GXSIMDFloat4 ra2 = GXSIMDMul ( GXSIMDMul ( r, a ), two );
+    const GXSIMDFloat4 rb2 = GXSIMDMul ( GXSIMDMul ( r, b ), two );
+    const GXSIMDFloat4 rc2 = GXSIMDMul ( GXSIMDMul ( r, c ), two );
+    const GXSIMDFloat4 aa = GXSIMDMul ( a, a );
+    const GXSIMDFloat4 ab2 = GXSIMDMul ( GXSIMDMul ( a, b ), two );
+    const GXSIMDFloat4 ac2 = GXSIMDMul ( GXSIMDMul ( a, c ), two );
+    const GXSIMDFloat4 bb = GXSIMDMul ( b, b );
+    const GXSIMDFloat4 bc2 = GXSIMDMul ( GXSIMDMul ( b, c ), two );
+    const GXSIMDFloat4 cc = GXSIMDMul ( c, c );
+
+    const GXSIMDFloat4 zero = GXSIMDSplat ( 0.0f );
+
+    world[ 0u ][ 0u ] = GXSIMDSub ( GXSIMDSub ( GXSIMDAdd ( rr, aa ), bb ), cc );
+    world[ 0u ][ 1u ] = GXSIMDAdd ( rc2, ab2 );
+    world[ 0u ][ 2u ] = GXSIMDSub ( ac2, rb2 );
+    world[ 0u ][ 3u ] = zero;
+
+    world[ 1u ][ 0u ] = GXSIMDSub ( ab2, rc2 );
+    world[ 1u ][ 1u ] = GXSIMDSub ( GXSIMDAdd ( GXSIMDSub ( rr, aa ), bb ), cc );
+    world[ 1u ][ 2u ] = GXSIMDAdd ( ra2, bc2 );
+    world[ 1u ][ 3u ] = zero;
+
+    world[ 2u ][ 0u ] = GXSIMDAdd ( rb2, ac2 );
+    world[ 2u ][ 1u ] = GXSIMDSub ( bc2, ra2 );
+    world[ 2u ][ 2u ] = GXSIMDAdd ( GXSIMDSub ( GXSIMDSub ( rr, aa ), bb ), cc );
+    world[ 2u ][ 3u ] = zero;
+
+    world[ 3u ][ 3u ] = GXSIMDSplat ( 1.0f );
+
+    for ( GXUByte row = 0u; row < 4u; ++row )
+    {
+        const GXSIMDFloat4* w = world[ row ];
+        StoreRows ( localToWorld, row, w[ 0u ], w[ 1u ], w[ 2u ], w[ 3u ] );
+
+        // The last column of the world matrix is ( 0, 0, 0, 1 ). So the fourth product is dropped or added as is.
+        GXSIMDFloat4 clip[ 4u ];
+
+        for ( GXUByte column = 0u; column < 4u; ++column )
+        {
+            GXSIMDFloat4 sum = GXSIMDMul ( w[ 0u ], worldToClip[ column ] );
+            sum = GXSIMDAdd ( sum, GXSIMDMul ( w[ 1u ], worldToClip[ 4u + column ] ) );
+            clip[ column ] = GXSIMDAdd ( sum, GXSIMDMul ( w[ 2u ], worldToClip[ 8u + column ] ) );
+
+            if ( row == 3u )
+                clip[ column ] = GXSIMDAdd ( clip[ column ], worldToClip[ 12u + column ] );
+        }
+
+        StoreRows ( localToClip, row, clip[ 0u ], clip[ 1u ], clip[ 2u ], clip[ 3u ] );
+    }
+}
+
+// "transform" contains the splatted matrix elements in row order.
+static GXVoid TransformPointGroup ( GXVec3* out, const GXVec3* points, const GXSIMDFloat4* transform )
+{
+    GXSIMDFloat4 x;
+    GXSIMDFloat4 y;
+    GXSIMDFloat4 z;
+    GXSIMDLoad3x4 ( x, y, z, points[ 0u ]._data );
+
+    GXSIMDFloat4 result[ 3u ];
+
+    for ( GXUByte column = 0u; column < 3u; ++column )
+    {
+        GXSIMDFloat4 sum = GXSIMDMul ( x, transform[ column ] );
+        sum = GXSIMDAdd ( sum, GXSIMDMul ( y, transform[ 4u + column ] ) );
+        sum = GXSIMDAdd ( sum, GXSIMDMul ( z, transform[ 8u + column ] ) );
+        result[ column ] = GXSIMDAdd ( sum, transform[ 12u + column ] );
+    }
+
+    GXSIMDStore3x4 ( out[ 0u ]._data, result[ 0u ], result[ 1u ], result[ 2u ] );
+}
+
+// Center and extents method. The box corners are never built. "transform" holds the elements of the 3x4 part of
+// the matrices in row order. Every lane is the separate matrix. "lanes" could be less than GROUP_SIZE for the last
+// group.
+static GXVoid TransformAABBGroup ( GXAABB* out, const GXAABB* bounds, const GXSIMDFloat4* transform, GXUPointer lanes )
+{
+    alignas ( 16u ) GXFloat minimum[ 3u ][ GROUP_SIZE ] = {};
+    alignas ( 16u ) GXFloat maximum[ 3u ][ GROUP_SIZE ] = {};
+
+    for ( GXUPointer i = 0u; i < lanes; ++i )
+    {
+        for ( GXUByte axis = 0u; axis < 3u; ++axis )
+        {
+            minimum[ axis ][ i ] = bounds[ i ]._min._data[ axis ];
+            maximum[ axis ][ i ] = bounds[ i ]._max._data[ axis ];
+        }
+    }
+
+    const GXSIMDFloat4 half = GXSIMDSplat ( 0.5f );
+    GXSIMDFloat4 center[ 3u ];
+    GXSIMDFloat4 extent[ 3u ];
+
+    for ( GXUByte axis = 0u; axis < 3u; ++axis )
+    {
+        const GXSIMDFloat4 low = GXSIMDLoad ( minimum[ axis ] );
+        const GXSIMDFloat4 high = GXSIMDLoad ( maximum[ axis ] );
+        center[ axis ] = GXSIMDMul ( GXSIMDAdd ( low, high ), half );
+        extent[ axis ] = GXSIMDMul ( GXSIMDSub ( high, low ), half );
+    }
+
+    for ( GXUByte column = 0u; column < 3u; ++column )
+    {
+        GXSIMDFloat4 c = GXSIMDMul ( center[ 0u ], transform[ column ] );
+        c = GXSIMDAdd ( c, GXSIMDMul ( center[ 1u ], transform[ 4u + column ] ) );
+        c = GXSIMDAdd ( c, GXSIMDMul ( center[ 2u ], transform[ 8u + column ] ) );
+        c = GXSIMDAdd ( c, transform[ 12u + column ] );
+
+        GXSIMDFloat4 e = GXSIMDMul ( extent[ 0u ], GXSIMDAbs ( transform[ column ] ) );
+        e = GXSIMDAdd ( e, GXSIMDMul ( extent[ 1u ], GXSIMDAbs ( transform[ 4u + column ] ) ) );
+        e = GXSIMDAdd ( e, GXSIMDMul ( extent[ 2u ], GXSIMDAbs ( transform[ 8u + column ] ) ) );
+
+        GXSIMDStore ( minimum[ column ], GXSIMDSub ( c, e ) );
+        GXSIMDStore ( maximum[ column ], GXSIMDAdd ( c, e ) );
+    }
+
+    for ( GXUPointer i = 0u; i < lanes; ++i )
+    {
+        GXAABB& result = out[ i ];
+
+        // Same vertex count as GXAABB::Transform gives.
+        result._vertices = 8u;
+        result._min.Init ( minimum[ 0u ][ i ], minimum[ 1u ][ i ], minimum[ 2u ][ i ] );
+        result._max.Init ( maximum[ 0u ][ i ], maximum[ 1u ][ i ], maximum[ 2u ][ i ] );
+    }
+}
+
+static GXVoid SlerpGroup ( GXQuat* out, const GXQuat* start, const GXQuat* finish, const GXFloat* interpolationFactors )
+{
+    GXSIMDFloat4 s[ 4u ];
+    LoadQuaternions ( s[ 0u ], s[ 1u ], s[ 2u ], s[ 3u ], start );
+
+    GXSIMDFloat4 f[ 4u ];
+    LoadQuaternions ( f[ 0u ], f[ 1u ], f[ 2u ], f[ 3u ], finish );
+
+    const GXSIMDFloat4 one = GXSIMDSplat ( 1.0f );
+    const GXSIMDFloat4 t = GXSIMDMin ( GXSIMDMax ( GXSIMDLoad ( interpolationFactors ), GXSIMDSplat ( 0.0f ) ), one );
+
+    GXSIMDFloat4 cosom = GXSIMDMul ( s[ 0u ], f[ 0u ] );
+    cosom = GXSIMDAdd ( cosom, GXSIMDMul ( s[ 1u ], f[ 1u ] ) );
+    cosom = GXSIMDAdd ( cosom, GXSIMDMul ( s[ 2u ], f[ 2u ] ) );
+    cosom = GXSIMDAdd ( cosom, GXSIMDMul ( s[ 3u ], f[ 3u ] ) );
+
+    // The shortest arc is used. So the finish is negated for the negative cosine.
+    const GXSIMDFloat4 sign = GXSIMDAnd ( cosom, GXSIMDSplat ( -0.0f ) );
+    const GXSIMDFloat4 xm1 = GXSIMDSub ( GXSIMDXor ( cosom, sign ), one );
+
+    const GXSIMDFloat4 d = GXSIMDSub ( one, t );
+    const GXSIMDFloat4 sqrT = GXSIMDMul ( t, t );
+    const GXSIMDFloat4 sqrD = GXSIMDMul ( d, d );
+
+    GXSIMDFloat4 scaleT = one;
+    GXSIMDFloat4 scaleD = one;
+
+    for ( GXUByte i = SLERP_TERMS; i > 0u; --i )
+    {
+        const GXSIMDFloat4 u = GXSIMDSplat ( g_SlerpU[ i - 1u ] );
+        const GXSIMDFloat4 v = GXSIMDSplat ( g_SlerpV[ i - 1u ] );
+
+        const GXSIMDFloat4 bT = GXSIMDMul ( GXSIMDSub ( GXSIMDMul ( u, sqrT ), v ), xm1 );
+        const GXSIMDFloat4 bD = GXSIMDMul ( GXSIMDSub ( GXSIMDMul ( u, sqrD ), v ), xm1 );
+
+        scaleT = GXSIMDAdd ( one, GXSIMDMul ( bT, scaleT ) );
+        scaleD = GXSIMDAdd ( one, GXSIMDMul ( bD, scaleD ) );
+    }
+
+    scaleT = GXSIMDXor ( GXSIMDMul ( t, scaleT ), sign );
+    scaleD = GXSIMDMul ( d, scaleD );
+
+    GXSIMDFloat4 result[ 4u ];
+
+    for ( GXUByte i = 0u; i < 4u; ++i )
+        result[ i ] = GXSIMDAdd ( GXSIMDMul ( s[ i ], scaleD ), GXSIMDMul ( f[ i ], scaleT ) );
+
+    GXSIMDTranspose ( result[ 0u ], result[ 1u ], result[ 2u ], result[ 3u ] );
+
+    for ( GXUByte i = 0u; i < 4u; ++i )
+        GXSIMDStore ( out[ i ]._data, result[ i ] );
+}
+
+// The lanes after "lanes" repeat the last box. "planes" contains the splatted plane equations. Method writes
+// the smallest signed distance of the farthest corner over all planes. The box is visible if the distance is not
+// negative. The summation order is the same as GXPlane::ClassifyVertex uses. So the result matches
+// GXProjectionClipPlanes::IsVisible exactly.
+static GXVoid CullGroup ( GXFloat* distances, const GXAABB* bounds, const GXSIMDFloat4* planes, GXUPointer lanes )
+{
+    // Every box is loaded as ( min x, min y, min z, max x ) and ( min z, max x, max y, max z ). Both loads stay
+    // inside GXAABB.
+    GXSIMDFloat4 low[ GROUP_SIZE ];
+    GXSIMDFloat4 high[ GROUP_SIZE ];
+
+    for ( GXUPointer i = 0u; i < GROUP_SIZE; ++i )
+    {
+        const GXAABB& box = bounds[ i < lanes ? i : lanes - 1u ];
+        low[ i ] = GXSIMDLoad ( box._min._data );
+        high[ i ] = GXSIMDLoad ( box._min._data + 2u );
+    }
+
+    GXSIMDTranspose ( low[ 0u ], low[ 1u ], low[ 2u ], low[ 3u ] );
+    GXSIMDTranspose ( high[ 0u ], high[ 1u ], high[ 2u ], high[ 3u ] );
+
+    const GXSIMDFloat4 minimum[ 3u ] = { low[ 0u ], low[ 1u ], low[ 2u ] };
+    const GXSIMDFloat4 maximum[ 3u ] = { low[ 3u ], high[ 2u ], high[ 3u ] };
+    GXSIMDFloat4 nearest = GXSIMDSplat ( FLT_MAX );
+
+    for ( GXUByte i = 0u; i < 6u; ++i )
+    {
+        const GXSIMDFloat4* plane = planes + i * 4u;
+        GXSIMDFloat4 distance = GXSIMDMax ( GXSIMDMul ( plane[ 0u ], minimum[ 0u ] ), GXSIMDMul ( plane[ 0u ], maximum[ 0u ] ) );
+
+        for ( GXUByte axis = 1u; axis < 3u; ++axis )
+            distance = GXSIMDAdd ( distance, GXSIMDMax ( GXSIMDMul ( plane[ axis ], minimum[ axis ] ), GXSIMDMul ( plane[ axis ], maximum[ axis ] ) ) );
+
+        nearest = GXSIMDMin ( nearest, GXSIMDAdd ( distance, plane[ 3u ] ) );
+    }
+
+    GXSIMDStore ( distances, nearest );
+}
+
+static GXVoid SplatMatrix ( GXSIMDFloat4* elements, const GXMat4 &matrix )
+{
+    for ( GXUByte i = 0u; i < 16u; ++i )
+        elements[ i ] = GXSIMDSplat ( matrix._data[ i ] );
+}
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+GXVoid GXCALL GXBatchCompose ( GXMat4* localToClip, const GXMat4* localToWorld, const GXMat4 &worldToClip, GXUPointer count )
+{
+#ifdef GX_SIMD_ENABLED
+
+    // The shared matrix stays in the registers. Transposition to structure of arrays would cost the same shuffles as
+    // the row splats. So every element is processed separately.
+    const GXSIMDFloat4 b0 = GXSIMDLoad ( worldToClip._m[ 0u ] );
+    const GXSIMDFloat4 b1 = GXSIMDLoad ( worldToClip._m[ 1u ] );
+    const GXSIMDFloat4 b2 = GXSIMDLoad ( worldToClip._m[ 2u ] );
+    const GXSIMDFloat4 b3 = GXSIMDLoad ( worldToClip._m[ 3u ] );
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+    {
+        const GXMat4& a = localToWorld[ i ];
+        GXMat4& out = localToClip[ i ];
+
+        for ( GXUByte row = 0u; row < 4u; ++row )
+        {
+            const GXSIMDFloat4 r = GXSIMDLoad ( a._m[ row ] );
+            GXSIMDFloat4 result = GXSIMDMul ( GXSIMDSplatLane ( r, 0 ), b0 );
+            result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( r, 1 ), b1 ) );
+            result = GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( r, 2 ), b2 ) );
+            GXSIMDStore ( out._m[ row ], GXSIMDAdd ( result, GXSIMDMul ( GXSIMDSplatLane ( r, 3 ), b3 ) ) );
+        }
+    }
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+        localToClip[ i ].Multiply ( localToWorld[ i ], worldToClip );
+
+#endif
+}
+
+GXVoid GXCALL GXBatchCompose ( GXMat4* localToWorld, GXMat4* localToClip, const GXQuat* orientations, const GXVec3* origins, const GXMat4 &worldToClip, GXUPointer count )
+{
+#ifdef GX_SIMD_ENABLED
+
+    GXSIMDFloat4 clip[ 16u ];
+    SplatMatrix ( clip, worldToClip );
+
+    GXUPointer i = 0u;
+
+    for ( ; i + GROUP_SIZE <= count; i += GROUP_SIZE )
+        ComposeGroup ( localToWorld + i, localToClip + i, orientations + i, origins + i, clip );
+
+    const GXUPointer rest = count - i;
+
+    if ( rest == 0u )
+        return;
+
+    GXQuat tailOrientations[ GROUP_SIZE ];
+    GXVec3 tailOrigins[ GROUP_SIZE ];
+    memset ( tailOrientations, 0, sizeof ( tailOrientations ) );
+    memset ( tailOrigins, 0, sizeof ( tailOrigins ) );
+    memcpy ( tailOrientations, orientations + i, rest * sizeof ( GXQuat ) );
+    memcpy ( tailOrigins, origins + i, rest * sizeof ( GXVec3 ) );
+
+    GXMat4 tailWorld[ GROUP_SIZE ];
+    GXMat4 tailClip[ GROUP_SIZE ];
+    ComposeGroup ( tailWorld, tailClip, tailOrientations, tailOrigins, clip );
+
+    memcpy ( localToWorld + i, tailWorld, rest * sizeof ( GXMat4 ) );
+    memcpy ( localToClip + i, tailClip, rest * sizeof ( GXMat4 ) );
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+    {
+        localToWorld[ i ].FromFast ( orientations[ i ], origins[ i ] );
+        localToClip[ i ].Multiply ( localToWorld[ i ], worldToClip );
+    }
+
+#endif
+}
+
+GXVoid GXCALL GXBatchTransformPoints ( GXVec3* out, const GXVec3* points, const GXMat4 &transform, GXUPointer count )
+{
+#ifdef GX_SIMD_ENABLED
+
+    GXSIMDFloat4 elements[ 16u ];
+    SplatMatrix ( elements, transform );
+
+    GXUPointer i = 0u;
+
+    for ( ; i + GROUP_SIZE <= count; i += GROUP_SIZE )
+        TransformPointGroup ( out + i, points + i, elements );
+
+    const GXUPointer rest = count - i;
+
+    if ( rest == 0u )
+        return;
+
+    GXVec3 tailPoints[ GROUP_SIZE ];
+    memset ( tailPoints, 0, sizeof ( tailPoints ) );
+    memcpy ( tailPoints, points + i, rest * sizeof ( GXVec3 ) );
+
+    GXVec3 tailOut[ GROUP_SIZE ];
+    TransformPointGroup ( tailOut, tailPoints, elements );
+    memcpy ( out + i, tailOut, rest * sizeof ( GXVec3 ) );
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+        transform.MultiplyAsPoint ( out[ i ], points[ i ] );
+
+#endif
+}
+
+GXVoid GXCALL GXBatchTransformAABBs ( GXAABB* out, const GXAABB* bounds, const GXMat4 &transform, GXUPointer count )
+{
+#ifdef GX_SIMD_ENABLED
+
+    GXSIMDFloat4 elements[ 16u ];
+    SplatMatrix ( elements, transform );
+
+    for ( GXUPointer i = 0u; i < count; i += GROUP_SIZE )
+    {
+        const GXUPointer rest = count - i;
+        TransformAABBGroup ( out + i, bounds + i, elements, rest < GROUP_SIZE ? rest : GROUP_SIZE );
+    }
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+        bounds[ i ].Transform ( out[ i ], transform );
+
+#endif
+}
+
+GXVoid GXCALL GXBatchTransformAABBs ( GXAABB* out, const GXAABB* bounds, const GXMat4* transforms, GXUPointer count )
+{
+#ifdef GX_SIMD_ENABLED
+
+    const GXSIMDFloat4 zero = GXSIMDSplat ( 0.0f );
+
+    for ( GXUPointer i = 0u; i < count; i += GROUP_SIZE )
+    {
+        const GXUPointer rest = count - i;
+        const GXUPointer lanes = rest < GROUP_SIZE ? rest : GROUP_SIZE;
+        const GXMat4* group = transforms + i;
+
+        // Every register gets one matrix element of four matrices.
+        GXSIMDFloat4 elements[ 16u ];
+
+        for ( GXUByte row = 0u; row < 4u; ++row )
+        {
+            GXSIMDFloat4* e = elements + row * 4u;
+
+            for ( GXUPointer lane = 0u; lane < GROUP_SIZE; ++lane )
+                e[ lane ] = lane < lanes ? GXSIMDLoad ( group[ lane ]._m[ row ] ) : zero;
+
+            GXSIMDTranspose ( e[ 0u ], e[ 1u ], e[ 2u ], e[ 3u ] );
+        }
+
+        TransformAABBGroup ( out + i, bounds + i, elements, lanes );
+    }
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+        bounds[ i ].Transform ( out[ i ], transforms[ i ] );
+
+#endif
+}
+
+GXUPointer GXCALL GXBatchCullAABBs ( GXBool* visibility, const GXAABB* bounds, const GXProjectionClipPlanes &clipPlanes, GXUPointer count )
+{
+    GXUPointer visible = 0u;
+
+#ifdef GX_SIMD_ENABLED
+
+    GXSIMDFloat4 planes[ 24u ];
+
+    for ( GXUByte i = 0u; i < 6u; ++i )
+    {
+        const GXPlane& plane = clipPlanes.GetPlane ( i );
+        GXSIMDFloat4* p = planes + i * 4u;
+
+        p[ 0u ] = GXSIMDSplat ( plane._a );
+        p[ 1u ] = GXSIMDSplat ( plane._b );
+        p[ 2u ] = GXSIMDSplat ( plane._c );
+        p[ 3u ] = GXSIMDSplat ( plane._d );
+    }
+
+    alignas ( 16u ) GXFloat distances[ GROUP_SIZE ];
+
+    for ( GXUPointer i = 0u; i < count; i += GROUP_SIZE )
+    {
+        const GXUPointer rest = count - i;
+        const GXUPointer lanes = rest < GROUP_SIZE ? rest : GROUP_SIZE;
+        CullGroup ( distances, bounds + i, planes, lanes );
+
+        for ( GXUPointer lane = 0u; lane < lanes; ++lane )
+        {
+            const GXBool isVisible = distances[ lane ] >= 0.0f;
+            visibility[ i + lane ] = isVisible;
+            visible += isVisible ? 1u : 0u;
+        }
+    }
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+    {
+        const GXBool isVisible = clipPlanes.IsVisible ( bounds[ i ] );
+        visibility[ i ] = isVisible;
+        visible += isVisible ? 1u : 0u;
+    }
+
+#endif
+
+    return visible;
+}
+
+GXVoid GXCALL GXBatchSlerp ( GXQuat* out, const GXQuat* start, const GXQuat* finish, const GXFloat* interpolationFactors, GXUPointer count )
+{
+#ifdef GX_SIMD_ENABLED
+
+    GXUPointer i = 0u;
+
+    for ( ; i + GROUP_SIZE <= count; i += GROUP_SIZE )
+        SlerpGroup ( out + i, start + i, finish + i, interpolationFactors + i );
+
+    const GXUPointer rest = count - i;
+
+    if ( rest == 0u )
+        return;
+
+    GXQuat tailStart[ GROUP_SIZE ];
+    GXQuat tailFinish[ GROUP_SIZE ];
+    GXFloat tailFactors[ GROUP_SIZE ] = {};
+    memset ( tailStart, 0, sizeof ( tailStart ) );
+    memset ( tailFinish, 0, sizeof ( tailFinish ) );
+    memcpy ( tailStart, start + i, rest * sizeof ( GXQuat ) );
+    memcpy ( tailFinish, finish + i, rest * sizeof ( GXQuat ) );
+    memcpy ( tailFactors, interpolationFactors + i, rest * sizeof ( GXFloat ) );
+
+    GXQuat tailOut[ GROUP_SIZE ];
+    SlerpGroup ( tailOut, tailStart, tailFinish, tailFactors );
+    memcpy ( out + i, tailOut, rest * sizeof ( GXQuat ) );
+
+#else
+
+    for ( GXUPointer i = 0u; i < count; ++i )
+        out[ i ].SphericalLinearInterpolation ( start[ i ], finish[ i ], interpolationFactors[ i ] );
+
+#endif
+}
@@ -0,0 +1,192 @@
+#include <asset_loader.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cassert>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+constexpr static const size_t PREFAULT_STRIDE = 4096U;
+
+AssetLoader* g_AssetLoader = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+AssetLoader::AssetLoader ():
+    _idleCondition {},
+    _isStopped ( false ),
+    _loading {},
+    _loadingPath {},
+    _mutex {},
+    _nextOrder ( 0U ),
+    _pending {},
+    _thread {},
+    _wakeCondition {}
+{
+    // NOTHING
+}
+
+void AssetLoader::Init ()
+{
+    assert ( !_thread.joinable () );
+
+    _isStopped = false;
+    _thread = std::thread ( &AssetLoader::Worker, this );
+}
+
+void AssetLoader::Destroy ()
+{
+    if ( !_thread.joinable () )
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock ( _mutex );
+        _isStopped = true;
+    }
+
+    _wakeCondition.notify_one ();
+    _thread.join ();
+    Cancel ();
+}
+
+void AssetLoader::Cancel ()
+{
+    Items cancelled;
+
+    {
+        std::unique_lock<std::mutex> lock ( _mutex );
+        cancelled.swap ( _pending );
+
+        _idleCondition.wait ( lock, [ this ] () -> bool {
+            return !_loading;
+        } );
+    }
+
+    for ( auto& item : cancelled )
+        Deliver ( *item.second, nullptr );
+}
+
+AssetFuture AssetLoader::Request ( std::string &&path, eAssetPriority priority, AssetCallback &&callback )
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+    assert ( _thread.joinable () );
+
+    if ( !_loadingPath.empty () && path == _loadingPath )
+    {
+        if ( callback )
+            _loading->_callbacks.push_back ( std::move ( callback ) );
+
+        return _loading->_future;
+    }
+
+    const auto findResult = _pending.find ( path );
+
+    if ( findResult != _pending.cend () )
+    {
+        Item& item = *findResult->second;
+        item._priority = std::max ( item._priority, priority );
+
+        if ( callback )
+            item._callbacks.push_back ( std::move ( callback ) );
+
+        return item._future;
+    }
+
+    auto item = std::make_unique<Item> ();
+    item->_future = item->_promise.get_future ().share ();
+    item->_order = _nextOrder++;
+    item->_priority = priority;
+
+    if ( callback )
+        item->_callbacks.push_back ( std::move ( callback ) );
+
+    AssetFuture future = item->_future;
+    _pending.emplace ( std::move ( path ), std::move ( item ) );
+    lock.unlock ();
+
+    _wakeCondition.notify_one ();
+    return future;
+}
+
+void AssetLoader::Deliver ( Item &item, const std::shared_ptr<File> &file )
+{
+    item._promise.set_value ( file );
+
+    for ( auto& callback : item._callbacks )
+        callback ( file );
+}
+
+void AssetLoader::Worker ()
+{
+    for ( ; ; )
+    {
+        std::unique_lock<std::mutex> lock ( _mutex );
+
+        _wakeCondition.wait ( lock, [ this ] () -> bool {
+            return _isStopped || !_pending.empty ();
+        } );
+
+        if ( _isStopped )
+            return;
+
+        // Note the queue is short. So linear search is fine.
+        auto selected = _pending.begin ();
+
+        for ( auto it = std::next ( selected ); it != _pending.end (); ++it )
+        {
+            const Item& candidate = *it->second;
+            const Item& best = *selected->second;
+
+            if ( candidate._priority < best._priority )
+                continue;
+
+            if ( candidate._priority > best._priority || candidate._order < best._order )
+                selected = it;
+        }
+
+        _loadingPath = selected->first;
+        _loading = std::move ( selected->second );
+        _pending.erase ( selected );
+        lock.unlock ();
+
+        auto file = std::make_shared<File> ( std::string ( _loadingPath ) );
+
+        if ( file->MapContent () )
+            Prefault ( *file );
+        else
+            file.reset ();
+
+        // Note new duplicate requests must not attach callbacks while the callbacks are being invoked.
+        lock.lock ();
+        _loadingPath.clear ();
+        lock.unlock ();
+
+        Deliver ( *_loading, file );
+
+        lock.lock ();
+        _loading.reset ();
+        lock.unlock ();
+
+        _idleCondition.notify_all ();
+    }
+}
+
+void AssetLoader::Prefault ( const File &file )
+{
+    const uint8_t* data = file.GetData ();
+    const size_t size = file.GetSize ();
+    uint8_t sum = 0U;
+
+    for ( size_t offset = 0U; offset < size; offset += PREFAULT_STRIDE )
+        sum += data[ offset ];
+
+    // Note the volatile store prevents the compiler from removing the loop.
+    volatile uint8_t sink = sum;
+    static_cast<void> ( sink );
+}
+
+} // namespace android_vulkan
@@ -15,16 +15,39 @@ AAssetManager* g_AssetManager = nullptr;
 constexpr static const double FPS_PERIOD = 3.0;
 
 Core::Core ( android_app &app, Game &game ):
-    _game ( game )
+    _game ( game ),
+    _assetLoader {},
+    _frameTiming {},
+    _jobSystem {},
+    _fpsFrames ( 0U )
 {
     // grab asset manager
     g_AssetManager = app.activity->assetManager;
 
+    _jobSystem.Init ();
+    g_JobSystem = &_jobSystem;
+
+    _assetLoader.Init ();
+    g_AssetLoader = &_assetLoader;
+
+    g_FrameTiming = &_frameTiming;
+
     app.onAppCmd = &Core::OnOSCommand;
     app.userData = this;
     ActivateFullScreen ( app );
 }
 
+Core::~Core ()
+{
+    g_FrameTiming = nullptr;
+
+    g_AssetLoader = nullptr;
+    _assetLoader.Destroy ();
+
+    g_JobSystem = nullptr;
+    _jobSystem.Destroy ();
+}
+
 bool Core::IsSuspend () const
 {
     return !_renderer.IsReady ();
@@ -35,20 +58,26 @@ void Core::OnFrame ()
     if ( !_game.IsReady () )
         return;
 
-    const timestamp now = std::chrono::system_clock::now ();
+    const timestamp now = std::chrono::steady_clock::now ();
     const std::chrono::duration<double> delta = now - _frameTimestamp;
 
+    _frameTiming.BeginFrame ();
+    _frameTiming.Record ( eFrameTimingStage::Interval, now - _frameTimestamp );
+
     if ( _renderer.CheckSwapchainStatus () )
+    {
+        const FrameTimingScope scope ( eFrameTimingStage::Frame );
         _game.OnFrame ( _renderer, delta.count () );
+    }
 
+    _frameTiming.EndFrame ();
     _frameTimestamp = now;
     UpdateFPS ( now );
 }
 
 void Core::UpdateFPS ( timestamp now )
 {
-    static uint32_t frameCount = 0U;
-    ++frameCount;
+    ++_fpsFrames;
 
     const std::chrono::duration<double> seconds = now - _fpsTimestamp;
     const double delta = seconds.count ();
@@ -56,9 +85,11 @@ void Core::UpdateFPS ( timestamp now )
     if ( delta < FPS_PERIOD )
         return;
 
-    LogInfo ( "FPS: %g", frameCount / delta );
+    LogInfo ( "FPS: %g", static_cast<double> ( _fpsFrames ) / delta );
+    _frameTiming.Report ();
+
     _fpsTimestamp = now;
-    frameCount = 0U;
+    _fpsFrames = 0U;
 }
 
 void Core::ActivateFullScreen ( android_app &app )
@@ -107,14 +138,21 @@ void Core::OnOSCommand ( android_app* app, int32_t cmd )
     switch ( cmd )
     {
         case APP_CMD_INIT_WINDOW:
-            if ( core._renderer.OnInit ( *app->window, false ) )
+            if ( core._renderer.OnInit ( *app->window, false, app->activity->internalDataPath ) )
                 core._game.OnInit ( core._renderer );
 
-            core._fpsTimestamp = std::chrono::system_clock::now ();
+            core._fpsFrames = 0U;
+            core._fpsTimestamp = std::chrono::steady_clock::now ();
             core._frameTimestamp = core._fpsTimestamp;
+            core._frameTiming.Reset ();
         break;
 
         case APP_CMD_TERM_WINDOW:
+            core._frameTiming.DumpHistogram ( eFrameTimingStage::Interval );
+            core._frameTiming.DumpHistogram ( eFrameTimingStage::GPU );
+
+            // Note the game drops its requests. So nothing must be delivered after the window is destroyed.
+            core._assetLoader.Cancel ();
             core._game.OnDestroy ( core._renderer );
             core._renderer.OnDestroy ();
             AV_CHECK_VULKAN_LEAKS ()
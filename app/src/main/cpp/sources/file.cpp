@@ -2,9 +2,23 @@
 
 GX_DISABLE_COMMON_WARNINGS
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+
+#ifdef __ANDROID__
+
 #include <android/asset_manager.h>
 
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#endif // __ANDROID__
+
 GX_RESTORE_WARNING_STATE
 
 #include <logger.h>
@@ -12,20 +26,91 @@ GX_RESTORE_WARNING_STATE
 
 namespace android_vulkan {
 
+#ifdef __ANDROID__
+
 extern AAssetManager* g_AssetManager;
 
+#else
+
+static std::string g_AssetDirectory {};
+
+static std::string ResolvePath ( const std::string &filePath )
+{
+    if ( g_AssetDirectory.empty () || ( !filePath.empty () && filePath.front () == '/' ) )
+        return filePath;
+
+    return g_AssetDirectory + '/' + filePath;
+}
+
+#endif // __ANDROID__
+
+static std::atomic<size_t> g_CopiedBytes ( 0U );
+static std::atomic<size_t> g_MappedBytes ( 0U );
+static std::atomic<int64_t> g_LoadTime ( 0 );
+
+// Helper accumulates the time which is spent inside the scope.
+class LoadTimer final
+{
+    private:
+        std::chrono::steady_clock::time_point   _start;
+
+    public:
+        LoadTimer ():
+            _start ( std::chrono::steady_clock::now () )
+        {
+            // NOTHING
+        }
+
+        ~LoadTimer ()
+        {
+            const auto delta = std::chrono::duration_cast<std::chrono::nanoseconds> (
+                std::chrono::steady_clock::now () - _start
+            );
+
+            g_LoadTime.fetch_add ( static_cast<int64_t> ( delta.count () ), std::memory_order_relaxed );
+        }
+
+        LoadTimer ( const LoadTimer &other ) = delete;
+        LoadTimer& operator = ( const LoadTimer &other ) = delete;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+File::File ():
+    _filePath {},
+    _content {},
+    _mappedData ( nullptr ),
+    _mappedSize ( 0U ),
+    _asset ( nullptr )
+{
+    // NOTHING
+}
+
 File::File ( std::string &filePath ):
-    _filePath ( filePath )
+    _filePath ( filePath ),
+    _content {},
+    _mappedData ( nullptr ),
+    _mappedSize ( 0U ),
+    _asset ( nullptr )
 {
     // NOTHING
 }
 
 File::File ( std::string &&filePath ):
-    _filePath ( std::move ( filePath ) )
+    _filePath ( std::move ( filePath ) ),
+    _content {},
+    _mappedData ( nullptr ),
+    _mappedSize ( 0U ),
+    _asset ( nullptr )
 {
     // NOTHING
 }
 
+File::~File ()
+{
+    Unmap ();
+}
+
 std::vector<uint8_t>& File::GetContent ()
 {
     return _content;
@@ -36,11 +121,28 @@ const std::vector<uint8_t>& File::GetContent () const
     return _content;
 }
 
+const uint8_t* File::GetData () const
+{
+    return _mappedData ? _mappedData : _content.data ();
+}
+
+size_t File::GetSize () const
+{
+    return _mappedData ? _mappedSize : _content.size ();
+}
+
+const std::string& File::GetPath () const
+{
+    return _filePath;
+}
+
 bool File::IsContentLoaded () const
 {
-    return !_content.empty ();
+    return !_content.empty () || _mappedData;
 }
 
+#ifdef __ANDROID__
+
 bool File::LoadContent ()
 {
     if ( IsContentLoaded () )
@@ -49,6 +151,7 @@ bool File::LoadContent ()
         return true;
     }
 
+    const LoadTimer timer;
     AAsset* asset = AAssetManager_open ( g_AssetManager, _filePath.c_str (), AASSET_MODE_BUFFER );
 
     if ( !asset )
@@ -73,11 +176,194 @@ bool File::LoadContent ()
     AAsset_close ( asset );
 
     if ( size == readBytes )
+    {
+        g_CopiedBytes.fetch_add ( size, std::memory_order_relaxed );
         return true;
+    }
 
     LogError ( "File::LoadContent - Can't load whole file content %s.", _filePath.c_str () );
     assert ( !"File::LoadContent - Can't load whole file content." );
     return false;
 }
 
+bool File::MapContent ()
+{
+    if ( IsContentLoaded () )
+    {
+        LogWarning ( "File::MapContent - File can be loaded only once [%s].", _filePath.c_str () );
+        return true;
+    }
+
+    const LoadTimer timer;
+
+    // Note the uncompressed assets are memory mapped directly from the APK. Compressed assets are inflated into
+    // the buffer which is owned by the asset object. See "noCompress" in app/build.gradle.
+    _asset = AAssetManager_open ( g_AssetManager, _filePath.c_str (), AASSET_MODE_BUFFER );
+
+    if ( !_asset )
+    {
+        LogError ( "File::MapContent - Can't open file %s.", _filePath.c_str () );
+        assert ( !"File::MapContent - Can't open file." );
+        return false;
+    }
+
+    _mappedSize = static_cast<size_t> ( AAsset_getLength ( _asset ) );
+
+    if ( !_mappedSize )
+    {
+        LogWarning ( "File::MapContent - File %s is empty!", _filePath.c_str () );
+        Unmap ();
+        return true;
+    }
+
+    _mappedData = static_cast<const uint8_t*> ( AAsset_getBuffer ( _asset ) );
+
+    if ( !_mappedData )
+    {
+        LogError ( "File::MapContent - Can't map file %s.", _filePath.c_str () );
+        Unmap ();
+        assert ( !"File::MapContent - Can't map file." );
+        return false;
+    }
+
+    if ( AAsset_isAllocated ( _asset ) )
+        g_CopiedBytes.fetch_add ( _mappedSize, std::memory_order_relaxed );
+    else
+        g_MappedBytes.fetch_add ( _mappedSize, std::memory_order_relaxed );
+
+    return true;
+}
+
+void File::Unmap ()
+{
+    _mappedData = nullptr;
+    _mappedSize = 0U;
+
+    if ( !_asset )
+        return;
+
+    AAsset_close ( _asset );
+    _asset = nullptr;
+}
+
+#else
+
+bool File::LoadContent ()
+{
+    if ( IsContentLoaded () )
+    {
+        LogWarning ( "File::LoadContent - File can be loaded only once [%s].", _filePath.c_str () );
+        return true;
+    }
+
+    const LoadTimer timer;
+    const int file = open ( ResolvePath ( _filePath ).c_str (), O_RDONLY );
+
+    if ( file == -1 )
+    {
+        LogError ( "File::LoadContent - Can't open file %s.", _filePath.c_str () );
+        assert ( !"File::LoadContent - Can't open file." );
+        return false;
+    }
+
+    struct stat info {};
+    fstat ( file, &info );
+    const auto size = static_cast<size_t> ( info.st_size );
+
+    if ( !size )
+    {
+        LogWarning ( "File::LoadContent - File %s is empty!", _filePath.c_str () );
+        close ( file );
+        _content.clear ();
+        return true;
+    }
+
+    _content.resize ( size );
+    const auto readBytes = static_cast<size_t> ( read ( file, _content.data (), size ) );
+    close ( file );
+
+    if ( size == readBytes )
+    {
+        g_CopiedBytes.fetch_add ( size, std::memory_order_relaxed );
+        return true;
+    }
+
+    LogError ( "File::LoadContent - Can't load whole file content %s.", _filePath.c_str () );
+    assert ( !"File::LoadContent - Can't load whole file content." );
+    return false;
+}
+
+bool File::MapContent ()
+{
+    if ( IsContentLoaded () )
+    {
+        LogWarning ( "File::MapContent - File can be loaded only once [%s].", _filePath.c_str () );
+        return true;
+    }
+
+    const LoadTimer timer;
+    const int file = open ( ResolvePath ( _filePath ).c_str (), O_RDONLY );
+
+    if ( file == -1 )
+    {
+        LogError ( "File::MapContent - Can't open file %s.", _filePath.c_str () );
+        assert ( !"File::MapContent - Can't open file." );
+        return false;
+    }
+
+    struct stat info {};
+    fstat ( file, &info );
+    const auto size = static_cast<size_t> ( info.st_size );
+
+    if ( !size )
+    {
+        LogWarning ( "File::MapContent - File %s is empty!", _filePath.c_str () );
+        close ( file );
+        return true;
+    }
+
+    void* data = mmap ( nullptr, size, PROT_READ, MAP_PRIVATE, file, 0 );
+
+    // Note the mapping keeps reference to the file. So the descriptor is not needed anymore.
+    close ( file );
+
+    if ( data == MAP_FAILED )
+    {
+        LogError ( "File::MapContent - Can't map file %s.", _filePath.c_str () );
+        assert ( !"File::MapContent - Can't map file." );
+        return false;
+    }
+
+    _mappedData = static_cast<const uint8_t*> ( data );
+    _mappedSize = size;
+    g_MappedBytes.fetch_add ( size, std::memory_order_relaxed );
+    return true;
+}
+
+void File::Unmap ()
+{
+    if ( _mappedData )
+        munmap ( const_cast<uint8_t*> ( _mappedData ), _mappedSize );
+
+    _mappedData = nullptr;
+    _mappedSize = 0U;
+}
+
+void File::SetAssetDirectory ( std::string &&directory )
+{
+    while ( directory.size () > 1U && directory.back () == '/' )
+        directory.pop_back ();
+
+    g_AssetDirectory = std::move ( directory );
+}
+
+#endif // __ANDROID__
+
+void File::GetStats ( FileStats &stats )
+{
+    stats._copiedBytes = g_CopiedBytes.load ( std::memory_order_relaxed );
+    stats._mappedBytes = g_MappedBytes.load ( std::memory_order_relaxed );
+    stats._loadTime = static_cast<double> ( g_LoadTime.load ( std::memory_order_relaxed ) ) * 1.0e-9;
+}
+
 } // namespace android_vulkan
@@ -0,0 +1,200 @@
+#include <frame_timing.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+
+
+namespace android_vulkan {
+
+constexpr static const float NO_SAMPLE = -1.0F;
+
+constexpr static const size_t HISTOGRAM_BUCKETS = 50U;
+constexpr static const size_t HISTOGRAM_BAR_LENGTH = 40U;
+
+constexpr static const char* STAGE_NAMES[ FRAME_TIMING_STAGES ] =
+{
+    "Interval",
+    "Frame",
+    "Record",
+    "Acquire",
+    "Fence wait",
+    "Present",
+    "GPU"
+};
+
+FrameTiming* g_FrameTiming = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FrameTiming::FrameTiming ():
+    _current {},
+    _frames ( 0U ),
+    _samples {}
+{
+    _current.fill ( NO_SAMPLE );
+}
+
+void FrameTiming::BeginFrame ()
+{
+    _current.fill ( NO_SAMPLE );
+}
+
+void FrameTiming::EndFrame ()
+{
+    _samples[ _frames % FRAME_TIMING_SAMPLES ] = _current;
+    ++_frames;
+}
+
+void FrameTiming::Record ( eFrameTimingStage stage, float milliseconds )
+{
+    float& value = _current[ static_cast<size_t> ( stage ) ];
+    value = std::max ( value, 0.0F ) + milliseconds;
+}
+
+void FrameTiming::Record ( eFrameTimingStage stage, std::chrono::steady_clock::duration duration )
+{
+    const std::chrono::duration<float, std::milli> milliseconds = duration;
+    Record ( stage, milliseconds.count () );
+}
+
+void FrameTiming::Reset ()
+{
+    _current.fill ( NO_SAMPLE );
+    _frames = 0U;
+}
+
+bool FrameTiming::GetStats ( FrameTimingStats &stats, eFrameTimingStage stage ) const
+{
+    const size_t count = GetSampleCount ();
+    const auto index = static_cast<size_t> ( stage );
+
+    std::vector<float> values;
+    values.reserve ( count );
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        const float value = _samples[ i ][ index ];
+
+        if ( value >= 0.0F )
+            values.push_back ( value );
+    }
+
+    if ( values.empty () )
+        return false;
+
+    std::sort ( values.begin (), values.end () );
+    const size_t total = values.size ();
+
+    // Nearest-rank method.
+    auto percentile = [ &values, total ] ( float p ) -> float {
+        const auto rank = static_cast<size_t> ( std::ceil ( p * static_cast<float> ( total ) ) );
+        return values[ std::max ( rank, static_cast<size_t> ( 1U ) ) - 1U ];
+    };
+
+    stats._samples = total;
+    stats._p50 = percentile ( 0.5F );
+    stats._p95 = percentile ( 0.95F );
+    stats._p99 = percentile ( 0.99F );
+    stats._worst = values.back ();
+    return true;
+}
+
+void FrameTiming::Report () const
+{
+    FrameTimingStats stats {};
+
+    for ( size_t i = 0U; i < FRAME_TIMING_STAGES; ++i )
+    {
+        if ( !GetStats ( stats, static_cast<eFrameTimingStage> ( i ) ) )
+            continue;
+
+        LogInfo ( "FrameTiming::Report - %-10s p50 %7.3f ms, p95 %7.3f ms, p99 %7.3f ms, worst %7.3f ms (%zu)",
+            STAGE_NAMES[ i ],
+            static_cast<double> ( stats._p50 ),
+            static_cast<double> ( stats._p95 ),
+            static_cast<double> ( stats._p99 ),
+            static_cast<double> ( stats._worst ),
+            stats._samples
+        );
+    }
+}
+
+void FrameTiming::DumpHistogram ( eFrameTimingStage stage ) const
+{
+    const size_t count = GetSampleCount ();
+    const auto index = static_cast<size_t> ( stage );
+
+    // The last bucket collects all samples which are longer than the histogram range.
+    std::array<size_t, HISTOGRAM_BUCKETS + 1U> buckets {};
+    size_t total = 0U;
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        const float value = _samples[ i ][ index ];
+
+        if ( value < 0.0F )
+            continue;
+
+        const auto bucket = std::min ( static_cast<size_t> ( value ), HISTOGRAM_BUCKETS );
+        ++buckets[ bucket ];
+        ++total;
+    }
+
+    LogInfo ( "FrameTiming::DumpHistogram - %s, %zu sample(s):", STAGE_NAMES[ index ], total );
+
+    if ( !total )
+        return;
+
+    const size_t peak = *std::max_element ( buckets.cbegin (), buckets.cend () );
+    std::string bar {};
+
+    for ( size_t i = 0U; i <= HISTOGRAM_BUCKETS; ++i )
+    {
+        const size_t samples = buckets[ i ];
+
+        if ( !samples )
+            continue;
+
+        bar.assign ( std::max ( samples * HISTOGRAM_BAR_LENGTH / peak, static_cast<size_t> ( 1U ) ), '#' );
+
+        if ( i == HISTOGRAM_BUCKETS )
+        {
+            LogInfo ( "    >= %2zu ms %6zu %s", HISTOGRAM_BUCKETS, samples, bar.c_str () );
+            continue;
+        }
+
+        LogInfo ( "    %2zu-%2zu ms %6zu %s", i, i + 1U, samples, bar.c_str () );
+    }
+}
+
+size_t FrameTiming::GetSampleCount () const
+{
+    return std::min ( _frames, FRAME_TIMING_SAMPLES );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FrameTimingScope::FrameTimingScope ( eFrameTimingStage stage ):
+    _stage ( stage ),
+    _start ( std::chrono::steady_clock::now () )
+{
+    // NOTHING
+}
+
+FrameTimingScope::~FrameTimingScope ()
+{
+    if ( !g_FrameTiming )
+        return;
+
+    g_FrameTiming->Record ( _stage, std::chrono::steady_clock::now () - _start );
+}
+
+} // namespace android_vulkan
@@ -0,0 +1,120 @@
+#include <gpu_timer.h>
+#include <vulkan_utils.h>
+
+
+namespace android_vulkan {
+
+constexpr static const uint32_t QUERIES_PER_SLOT = 2U;
+constexpr static const float NANOSECONDS_TO_MILLISECONDS = 1.0e-6F;
+
+GPUTimer::GPUTimer ():
+    _isEnabled ( false ),
+    _period ( 0.0F ),
+    _queryPool ( VK_NULL_HANDLE ),
+    _slots ( 0U )
+{
+    // NOTHING
+}
+
+bool GPUTimer::Init ( Renderer &renderer, size_t slots )
+{
+    const VkPhysicalDeviceLimits& limits = renderer.GetPhysicalDeviceLimits ();
+
+    if ( !limits.timestampComputeAndGraphics )
+    {
+        LogWarning ( "GPUTimer::Init - Timestamps are not supported. GPU time will not be measured." );
+        return true;
+    }
+
+    VkQueryPoolCreateInfo poolInfo;
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.pNext = nullptr;
+    poolInfo.flags = 0U;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = static_cast<uint32_t> ( slots ) * QUERIES_PER_SLOT;
+    poolInfo.pipelineStatistics = 0U;
+
+    const bool result = renderer.CheckVkResult (
+        vkCreateQueryPool ( renderer.GetDevice (), &poolInfo, nullptr, &_queryPool ),
+        "GPUTimer::Init",
+        "Can't create query pool"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_QUERY_POOL ( "GPUTimer::_queryPool" )
+
+    _isEnabled = true;
+    _period = limits.timestampPeriod;
+    _slots = slots;
+    return true;
+}
+
+void GPUTimer::Destroy ( Renderer &renderer )
+{
+    _isEnabled = false;
+    _slots = 0U;
+
+    if ( _queryPool == VK_NULL_HANDLE )
+        return;
+
+    vkDestroyQueryPool ( renderer.GetDevice (), _queryPool, nullptr );
+    _queryPool = VK_NULL_HANDLE;
+    AV_UNREGISTER_QUERY_POOL ( "GPUTimer::_queryPool" )
+}
+
+bool GPUTimer::IsEnabled () const
+{
+    return _isEnabled;
+}
+
+void GPUTimer::RecordBegin ( VkCommandBuffer commandBuffer, size_t slot ) const
+{
+    if ( !_isEnabled )
+        return;
+
+    const auto first = static_cast<uint32_t> ( slot ) * QUERIES_PER_SLOT;
+    vkCmdResetQueryPool ( commandBuffer, _queryPool, first, QUERIES_PER_SLOT );
+    vkCmdWriteTimestamp ( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _queryPool, first );
+}
+
+void GPUTimer::RecordEnd ( VkCommandBuffer commandBuffer, size_t slot ) const
+{
+    if ( !_isEnabled )
+        return;
+
+    vkCmdWriteTimestamp ( commandBuffer,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        _queryPool,
+        static_cast<uint32_t> ( slot ) * QUERIES_PER_SLOT + 1U
+    );
+}
+
+bool GPUTimer::Resolve ( float &milliseconds, VkDevice device, size_t slot ) const
+{
+    if ( !_isEnabled || slot >= _slots )
+        return false;
+
+    // Note the results are not available until the command buffer of the slot is executed first time. So the call
+    // does not wait and VK_NOT_READY is expected.
+    uint64_t timestamps[ QUERIES_PER_SLOT ];
+
+    const VkResult result = vkGetQueryPoolResults ( device,
+        _queryPool,
+        static_cast<uint32_t> ( slot ) * QUERIES_PER_SLOT,
+        QUERIES_PER_SLOT,
+        sizeof ( timestamps ),
+        timestamps,
+        sizeof ( uint64_t ),
+        VK_QUERY_RESULT_64_BIT
+    );
+
+    if ( result != VK_SUCCESS || timestamps[ 1U ] < timestamps[ 0U ] )
+        return false;
+
+    milliseconds = static_cast<float> ( timestamps[ 1U ] - timestamps[ 0U ] ) * _period * NANOSECONDS_TO_MILLISECONDS;
+    return true;
+}
+
+} // namespace android_vulkan
@@ -0,0 +1,287 @@
+#include <job_system.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace android_vulkan {
+
+constexpr static const size_t AUTO_GRAIN_CHUNKS_PER_THREAD = 4U;
+constexpr static const size_t NO_QUEUE = std::numeric_limits<size_t>::max ();
+
+static thread_local size_t t_QueueIndex = NO_QUEUE;
+
+JobSystem* g_JobSystem = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+JobCounter::JobCounter ():
+    _dependents {},
+    _mutex {},
+    _pending ( 0U )
+{
+    // NOTHING
+}
+
+bool JobCounter::IsDone () const
+{
+    return _pending.load ( std::memory_order_acquire ) == 0U;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+JobSystem::JobSystem ():
+    _isStopped ( false ),
+    _nextQueue ( 0U ),
+    _queues {},
+    _queuedTasks ( 0U ),
+    _sleepCondition {},
+    _sleepMutex {},
+    _workers {}
+{
+    // NOTHING
+}
+
+void JobSystem::Init ()
+{
+    assert ( _workers.empty () );
+
+    const size_t cores = std::max ( static_cast<size_t> ( std::thread::hardware_concurrency () ),
+        static_cast<size_t> ( 2U )
+    );
+
+    const size_t workers = cores - 1U;
+    _isStopped = false;
+    _queues.reserve ( workers );
+
+    for ( size_t i = 0U; i < workers; ++i )
+        _queues.push_back ( std::make_unique<Queue> () );
+
+    _workers.reserve ( workers );
+
+    for ( size_t i = 0U; i < workers; ++i )
+        _workers.emplace_back ( &JobSystem::Worker, this, i );
+}
+
+void JobSystem::Destroy ()
+{
+    if ( _workers.empty () )
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock ( _sleepMutex );
+        _isStopped = true;
+    }
+
+    _sleepCondition.notify_all ();
+
+    for ( auto& worker : _workers )
+        worker.join ();
+
+    _workers.clear ();
+
+    assert ( _queuedTasks.load () == 0U );
+    _queues.clear ();
+}
+
+size_t JobSystem::GetWorkerCount () const
+{
+    return _workers.size ();
+}
+
+void JobSystem::Run ( Job &&job, JobCounter* counter, JobCounter* dependency )
+{
+    if ( counter )
+        counter->_pending.fetch_add ( 1U, std::memory_order_acq_rel );
+
+    Task task {
+        ._job = std::move ( job ),
+        ._counter = counter
+    };
+
+    if ( dependency )
+    {
+        std::unique_lock<std::mutex> lock ( dependency->_mutex );
+
+        if ( !dependency->IsDone () )
+        {
+            dependency->_dependents.push_back ( std::move ( task ) );
+            return;
+        }
+    }
+
+    Enqueue ( std::move ( task ) );
+}
+
+void JobSystem::ParallelFor ( size_t count, size_t grain, const RangeJob &job )
+{
+    if ( !count )
+        return;
+
+    if ( !grain )
+    {
+        const size_t chunks = ( _workers.size () + 1U ) * AUTO_GRAIN_CHUNKS_PER_THREAD;
+        grain = std::max ( count / chunks, static_cast<size_t> ( 1U ) );
+    }
+
+    if ( grain >= count )
+    {
+        job ( 0U, count );
+        return;
+    }
+
+    JobCounter counter;
+
+    for ( size_t begin = 0U; begin < count; begin += grain )
+    {
+        const size_t end = std::min ( count, begin + grain );
+
+        Run ( [ &job, begin, end ] () {
+                job ( begin, end );
+            },
+
+            &counter
+        );
+    }
+
+    Wait ( counter );
+}
+
+void JobSystem::Wait ( JobCounter &counter )
+{
+    while ( !counter.IsDone () )
+    {
+        if ( !TryExecute ( t_QueueIndex ) )
+            std::this_thread::yield ();
+    }
+
+    // Note the thread which completes the counter could still hold the counter's lock. The counter must not be
+    // destroyed until that thread releases it.
+    std::unique_lock<std::mutex> lock ( counter._mutex );
+}
+
+void JobSystem::Complete ( JobCounter* counter )
+{
+    if ( !counter )
+        return;
+
+    std::vector<Task> released;
+
+    {
+        std::unique_lock<std::mutex> lock ( counter->_mutex );
+
+        if ( counter->_pending.fetch_sub ( 1U, std::memory_order_acq_rel ) != 1U )
+            return;
+
+        released.swap ( counter->_dependents );
+    }
+
+    for ( auto& task : released )
+        Enqueue ( std::move ( task ) );
+}
+
+void JobSystem::Enqueue ( Task &&task )
+{
+    if ( _queues.empty () )
+    {
+        // There is no worker. Executing in place.
+        task._job ();
+        Complete ( task._counter );
+        return;
+    }
+
+    const size_t queueIndex = t_QueueIndex != NO_QUEUE ?
+        t_QueueIndex :
+        _nextQueue.fetch_add ( 1U, std::memory_order_relaxed ) % _queues.size ();
+
+    Queue& queue = *_queues[ queueIndex ];
+
+    {
+        std::unique_lock<std::mutex> lock ( queue._mutex );
+        queue._tasks.push_back ( std::move ( task ) );
+    }
+
+    _queuedTasks.fetch_add ( 1U, std::memory_order_release );
+
+    {
+        // Note the lock prevents lost wake up of the worker which is going to sleep right now.
+        std::unique_lock<std::mutex> lock ( _sleepMutex );
+    }
+
+    _sleepCondition.notify_one ();
+}
+
+bool JobSystem::TryExecute ( size_t ownQueue )
+{
+    const size_t queueCount = _queues.size ();
+
+    if ( !queueCount || _queuedTasks.load ( std::memory_order_acquire ) == 0U )
+        return false;
+
+    Task task {};
+    bool isFound = false;
+
+    if ( ownQueue != NO_QUEUE )
+    {
+        Queue& queue = *_queues[ ownQueue ];
+        std::unique_lock<std::mutex> lock ( queue._mutex );
+
+        if ( !queue._tasks.empty () )
+        {
+            task = std::move ( queue._tasks.back () );
+            queue._tasks.pop_back ();
+            isFound = true;
+        }
+    }
+
+    const size_t start = ownQueue != NO_QUEUE ? ownQueue + 1U : _nextQueue.load ( std::memory_order_relaxed );
+
+    for ( size_t i = 0U; !isFound && i < queueCount; ++i )
+    {
+        Queue& victim = *_queues[ ( start + i ) % queueCount ];
+        std::unique_lock<std::mutex> lock ( victim._mutex );
+
+        if ( victim._tasks.empty () )
+            continue;
+
+        task = std::move ( victim._tasks.front () );
+        victim._tasks.pop_front ();
+        isFound = true;
+    }
+
+    if ( !isFound )
+        return false;
+
+    _queuedTasks.fetch_sub ( 1U, std::memory_order_acq_rel );
+
+    task._job ();
+    Complete ( task._counter );
+    return true;
+}
+
+void JobSystem::Worker ( size_t index )
+{
+    t_QueueIndex = index;
+
+    for ( ; ; )
+    {
+        if ( TryExecute ( index ) )
+            continue;
+
+        std::unique_lock<std::mutex> lock ( _sleepMutex );
+
+        _sleepCondition.wait ( lock, [ this ] () -> bool {
+            return _isStopped || _queuedTasks.load ( std::memory_order_acquire ) != 0U;
+        } );
+
+        if ( _isStopped )
+            return;
+    }
+}
+
+} // namespace android_vulkan
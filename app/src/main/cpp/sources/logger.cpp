@@ -1,16 +1,63 @@
 #include <logger.h>
+#include <GXCommon/GXWarning.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstdarg>
+
+#ifdef __ANDROID__
+
 #include <android/log.h>
 
+#else
+
+#include <cstdio>
+
+#endif // __ANDROID__
+
+GX_RESTORE_WARNING_STATE
+
 
 namespace android_vulkan {
 
 constexpr static char const* TAG = "android_vulkan::C++";
 
+#ifdef __ANDROID__
+
+constexpr static int LEVEL_DEBUG = ANDROID_LOG_DEBUG;
+constexpr static int LEVEL_ERROR = ANDROID_LOG_ERROR;
+constexpr static int LEVEL_INFO = ANDROID_LOG_INFO;
+constexpr static int LEVEL_WARNING = ANDROID_LOG_ERROR;
+
+static void Print ( int level, const char* format, va_list args )
+{
+    __android_log_vprint ( level, TAG, format, args );
+}
+
+#else
+
+constexpr static int LEVEL_DEBUG = 0;
+constexpr static int LEVEL_ERROR = 1;
+constexpr static int LEVEL_INFO = 2;
+constexpr static int LEVEL_WARNING = 3;
+
+constexpr static const char* LEVEL_NAMES[] = { "D", "E", "I", "W" };
+
+// Host builds have no logcat. The messages go to stderr so they do not mix with the benchmark reports.
+static void Print ( int level, const char* format, va_list args )
+{
+    std::fprintf ( stderr, "%s/%s: ", LEVEL_NAMES[ level ], TAG );
+    std::vfprintf ( stderr, format, args );
+    std::fputc ( '\n', stderr );
+}
+
+#endif // __ANDROID__
+
 void LogDebug ( const char* format, ... )
 {
     va_list args;
     va_start ( args, format );
-    __android_log_vprint ( ANDROID_LOG_DEBUG, TAG, format, args );
+    Print ( LEVEL_DEBUG, format, args );
     va_end ( args );
 }
 
@@ -18,7 +65,7 @@ void LogError ( const char* format, ... )
 {
     va_list args;
     va_start ( args, format );
-    __android_log_vprint ( ANDROID_LOG_ERROR, TAG, format, args );
+    Print ( LEVEL_ERROR, format, args );
     va_end ( args );
 }
 
@@ -26,7 +73,7 @@ void LogInfo ( const char* format, ... )
 {
     va_list args;
     va_start ( args, format );
-    __android_log_vprint ( ANDROID_LOG_INFO, TAG, format, args );
+    Print ( LEVEL_INFO, format, args );
     va_end ( args );
 }
 
@@ -34,7 +81,7 @@ void LogWarning ( const char* format, ... )
 {
     va_list args;
     va_start ( args, format );
-    __android_log_vprint ( ANDROID_LOG_ERROR, TAG, format, args );
+    Print ( LEVEL_WARNING, format, args );
     va_end ( args );
 }
 
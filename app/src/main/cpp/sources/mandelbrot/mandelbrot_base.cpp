@@ -2,11 +2,13 @@
 
 GX_DISABLE_COMMON_WARNINGS
 
+#include <chrono>
 #include <cmath>
 
 GX_RESTORE_WARNING_STATE
 
 #include <file.h>
+#include <frame_timing.h>
 #include <vulkan_utils.h>
 
 
@@ -115,6 +117,8 @@ MandelbrotBase::MandelbrotBase ( const char* fragmentShaderSpirV ):
 
 bool MandelbrotBase::BeginFrame ( uint32_t &presentationImageIndex, android_vulkan::Renderer &renderer )
 {
+    const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Acquire );
+
     return renderer.CheckVkResult (
         vkAcquireNextImageKHR ( renderer.GetDevice (),
             renderer.GetSwapchain (),
@@ -143,6 +147,8 @@ bool MandelbrotBase::EndFrame ( uint32_t presentationImageIndex, android_vulkan:
     presentInfoKHR.pImageIndices = &presentationImageIndex;
     presentInfoKHR.pResults = &presentResult;
 
+    const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Present );
+
     const bool result = renderer.CheckVkResult ( vkQueuePresentKHR ( renderer.GetQueue (), &presentInfoKHR ),
         "MandelbrotBase::EndFrame",
         "Can't present frame"
@@ -468,8 +474,17 @@ bool MandelbrotBase::CreatePipeline ( android_vulkan::Renderer &renderer )
     pipelineInfo.pDynamicState = nullptr;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
+    const auto pipelineBegin = std::chrono::steady_clock::now ();
+
     result = renderer.CheckVkResult (
-        vkCreateGraphicsPipelines ( renderer.GetDevice (), VK_NULL_HANDLE, 1U, &pipelineInfo, nullptr, &_pipeline ),
+        vkCreateGraphicsPipelines ( renderer.GetDevice (),
+            renderer.GetPipelineCache (),
+            1U,
+            &pipelineInfo,
+            nullptr,
+            &_pipeline
+        ),
+
         "MandelbrotBase::CreatePipeline",
         "Can't create pipeline"
     );
@@ -481,6 +496,14 @@ bool MandelbrotBase::CreatePipeline ( android_vulkan::Renderer &renderer )
     }
 
     AV_REGISTER_PIPELINE ( "MandelbrotBase::_pipeline" )
+
+    const std::chrono::duration<double, std::milli> pipelineTime = std::chrono::steady_clock::now () - pipelineBegin;
+
+    android_vulkan::LogInfo ( "MandelbrotBase::CreatePipeline - Pipeline is created in %g ms (%s pipeline cache).",
+        pipelineTime.count (),
+        renderer.IsPipelineCacheWarm () ? "warm" : "cold"
+    );
+
     return true;
 }
 
@@ -0,0 +1,47 @@
+#include <mandelbrot/mandelbrot_lut.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cmath>
+
+GX_RESTORE_WARNING_STATE
+
+#include <job_system.h>
+
+
+namespace mandelbrot {
+
+constexpr static const size_t INIT_GRAIN = 128U;
+
+void MandelbrotLUT::Generate ( uint8_t* samples )
+{
+    auto job = [ samples ] ( size_t startIndex, size_t limit ) {
+        constexpr const float twoPi = 6.28318F;
+        constexpr const float hueOffsetGreen = 2.09439F;
+        constexpr const float hueOffsetBlue = 4.18879F;
+        constexpr const float sampleToAngle = twoPi / static_cast<float> ( LUT_SAMPLE_COUNT );
+
+        auto evaluator = [] ( float angle ) -> uint8_t {
+            const float n = std::sin ( angle ) * 0.5F + 0.5F;
+            return static_cast<uint8_t> ( std::lround ( n * 255.0F ) );
+        };
+
+        uint8_t* write = samples + startIndex * LUT_SAMPLE_SIZE;
+
+        for ( size_t i = startIndex; i < limit; ++i )
+        {
+            const float pivot = static_cast<float> ( i ) * sampleToAngle;
+
+            write[ 0U ] = evaluator ( pivot );
+            write[ 1U ] = evaluator ( pivot + hueOffsetGreen );
+            write[ 2U ] = evaluator ( pivot + hueOffsetBlue );
+            write[ 3U ] = 0xFFU;
+
+            write += LUT_SAMPLE_SIZE;
+        }
+    };
+
+    android_vulkan::g_JobSystem->ParallelFor ( static_cast<size_t> ( LUT_SAMPLE_COUNT ), INIT_GRAIN, job );
+}
+
+} // namespace mandelbrot
@@ -2,23 +2,18 @@
 
 GX_DISABLE_COMMON_WARNINGS
 
-#include <array>
 #include <cassert>
-#include <cmath>
-#include <thread>
 
 GX_RESTORE_WARNING_STATE
 
 #include <vulkan_utils.h>
+#include <mandelbrot/mandelbrot_lut.h>
 
 
 namespace mandelbrot {
 
 constexpr static const char* FRAGMENT_SHADER = "shaders/mandelbrot-lut-color-ps.spv";
-constexpr static const uint32_t LUT_SAMPLE_COUNT = 512U;
-constexpr static const VkDeviceSize LUT_SAMPLE_SIZE = 4U;
 constexpr static const VkDeviceSize LUT_SIZE = LUT_SAMPLE_COUNT * LUT_SAMPLE_SIZE;
-constexpr static const size_t INIT_THREADS = 4U;
 
 MandelbrotLUTColor::MandelbrotLUTColor ():
     MandelbrotBase ( FRAGMENT_SHADER ),
@@ -27,8 +22,10 @@ MandelbrotLUTColor::MandelbrotLUTColor ():
     _descriptorSetLayout ( VK_NULL_HANDLE ),
     _lut ( VK_NULL_HANDLE ),
     _lutDeviceMemory ( VK_NULL_HANDLE ),
+    _lutDeviceMemoryOffset ( 0U ),
     _lutView ( VK_NULL_HANDLE ),
-    _sampler ( VK_NULL_HANDLE )
+    _sampler ( VK_NULL_HANDLE ),
+    _uploadScheduler {}
 {
     // NOTHING
 }
@@ -38,6 +35,12 @@ bool MandelbrotLUTColor::OnInit ( android_vulkan::Renderer &renderer )
     if ( !MandelbrotBase::OnInit ( renderer ) )
         return false;
 
+    if ( !_uploadScheduler.Init ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
     if ( !CreateLUT ( renderer ) )
     {
         OnDestroy ( renderer );
@@ -67,12 +70,21 @@ bool MandelbrotLUTColor::OnDestroy ( android_vulkan::Renderer &renderer )
     if ( !result )
         return false;
 
+    _uploadScheduler.Destroy ();
     DestroyCommandBuffer ( renderer );
     DestroyDescriptorSet ( renderer );
     DestroyLUT ( renderer );
     return MandelbrotBase::OnDestroy ( renderer );
 }
 
+bool MandelbrotLUTColor::OnFrame ( android_vulkan::Renderer &renderer, double deltaTime )
+{
+    if ( !_uploadScheduler.Poll () )
+        return false;
+
+    return MandelbrotBase::OnFrame ( renderer, deltaTime );
+}
+
 bool MandelbrotLUTColor::CreatePipelineLayout ( android_vulkan::Renderer &renderer )
 {
     VkDescriptorSetLayoutBinding binding;
@@ -352,6 +364,7 @@ bool MandelbrotLUTColor::CreateLUT ( android_vulkan::Renderer &renderer )
     vkGetImageMemoryRequirements ( device, _lut, &requirements );
 
     result = renderer.TryAllocateMemory ( _lutDeviceMemory,
+        _lutDeviceMemoryOffset,
         requirements,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         "Can't allocate LUT memory (MandelbrotLUTColor::CreateLUT)"
@@ -365,7 +378,7 @@ bool MandelbrotLUTColor::CreateLUT ( android_vulkan::Renderer &renderer )
 
     AV_REGISTER_DEVICE_MEMORY ( "MandelbrotLUTColor::_lutDeviceMemory" )
 
-    result = renderer.CheckVkResult ( vkBindImageMemory ( device, _lut, _lutDeviceMemory, 0U ),
+    result = renderer.CheckVkResult ( vkBindImageMemory ( device, _lut, _lutDeviceMemory, _lutDeviceMemoryOffset ),
         "MandelbrotLUTColor::_lutDeviceMemory",
         "Can't bind LUT memory to the image"
     );
@@ -415,6 +428,7 @@ bool MandelbrotLUTColor::CreateLUT ( android_vulkan::Renderer &renderer )
     samplerInfo.maxAnisotropy = 1.0F;
     samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
     samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
     samplerInfo.magFilter = VK_FILTER_NEAREST;
     samplerInfo.minFilter = VK_FILTER_NEAREST;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
@@ -422,10 +436,7 @@ bool MandelbrotLUTColor::CreateLUT ( android_vulkan::Renderer &renderer )
     samplerInfo.mipLodBias = 0.0F;
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
 
-    result = renderer.CheckVkResult ( vkCreateSampler ( device, &samplerInfo, nullptr, &_sampler ),
-        "MandelbrotLUTColor::CreateLUT",
-        "Can't create sampler"
-    );
+    result = renderer.AcquireSampler ( _sampler, samplerInfo, "MandelbrotLUTColor::CreateLUT", "Can't acquire sampler" );
 
     if ( !result )
     {
@@ -433,8 +444,6 @@ bool MandelbrotLUTColor::CreateLUT ( android_vulkan::Renderer &renderer )
         return false;
     }
 
-    AV_REGISTER_SAMPLER ( "MandelbrotLUTColor::_sampler" )
-
     if ( UploadLUTSamples ( renderer ) )
         return true;
 
@@ -448,9 +457,8 @@ void MandelbrotLUTColor::DestroyLUT ( android_vulkan::Renderer &renderer )
 
     if ( _sampler != VK_NULL_HANDLE )
     {
-        vkDestroySampler ( device, _sampler, nullptr );
+        renderer.ReleaseSampler ( _sampler );
         _sampler = VK_NULL_HANDLE;
-        AV_UNREGISTER_SAMPLER ( "MandelbrotLUTColor::_sampler" )
     }
 
     if ( _lutView != VK_NULL_HANDLE )
@@ -462,8 +470,9 @@ void MandelbrotLUTColor::DestroyLUT ( android_vulkan::Renderer &renderer )
 
     if ( _lutDeviceMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _lutDeviceMemory, nullptr );
+        renderer.FreeMemory ( _lutDeviceMemory, _lutDeviceMemoryOffset );
         _lutDeviceMemory = VK_NULL_HANDLE;
+        _lutDeviceMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "MandelbrotLUTColor::_lutDeviceMemory" )
     }
 
@@ -475,48 +484,6 @@ void MandelbrotLUTColor::DestroyLUT ( android_vulkan::Renderer &renderer )
     AV_UNREGISTER_IMAGE ( "MandelbrotLUTColor::_lut" )
 }
 
-void MandelbrotLUTColor::InitLUTSamples ( uint8_t* samples ) const
-{
-    constexpr const auto samplePerThread = static_cast<const size_t> ( LUT_SAMPLE_COUNT / INIT_THREADS );
-
-    auto job = [ samples ] ( size_t startIndex ) {
-        constexpr const float twoPi = 6.28318F;
-        constexpr const float hueOffsetGreen = 2.09439F;
-        constexpr const float hueOffsetBlue = 4.18879F;
-        constexpr const float sampleToAngle = twoPi / static_cast<float> ( LUT_SAMPLE_COUNT );
-
-        auto evaluator = [] ( float angle ) -> uint8_t {
-            const float n = std::sinf ( angle ) * 0.5F + 0.5F;
-            return static_cast<uint8_t> ( std::lroundf ( n * 255.0F ) );
-        };
-
-        const size_t limit = startIndex + samplePerThread;
-        uint8_t* write = samples + startIndex * LUT_SAMPLE_SIZE;
-
-        for ( size_t i = startIndex; i < limit; ++i )
-        {
-            const float pivot = i * sampleToAngle;
-
-            write[ 0U ] = evaluator ( pivot );
-            write[ 1U ] = evaluator ( pivot + hueOffsetGreen );
-            write[ 2U ] = evaluator ( pivot + hueOffsetBlue );
-            write[ 3U ] = 0xFFU;
-
-            write += LUT_SAMPLE_SIZE;
-        }
-    };
-
-    std::array<std::thread, INIT_THREADS> threads;
-
-    for ( size_t i = 0U; i < INIT_THREADS; ++i )
-        threads[ i ] = std::thread ( job, i * samplePerThread );
-
-    for ( size_t i = 0U; i < INIT_THREADS; ++i )
-    {
-        threads[ i ].join ();
-    }
-}
-
 bool MandelbrotLUTColor::UploadLUTSamples ( android_vulkan::Renderer &renderer )
 {
     VkDevice device = renderer.GetDevice ();
@@ -547,17 +514,19 @@ bool MandelbrotLUTColor::UploadLUTSamples ( android_vulkan::Renderer &renderer )
     vkGetBufferMemoryRequirements ( device, transfer, &requirements );
 
     VkDeviceMemory transferDeviceMemory = VK_NULL_HANDLE;
+    VkDeviceSize transferDeviceMemoryOffset = 0U;
 
     result = renderer.TryAllocateMemory ( transferDeviceMemory,
+        transferDeviceMemoryOffset,
         requirements,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         "Can't allocate transfer memory (MandelbrotLUTColor::UploadLUTSamples)"
     );
 
-    auto freeTransferResource = [ & ] () {
+    auto freeTransferResource = [ &renderer, device, transfer, transferDeviceMemory, transferDeviceMemoryOffset ] () {
         if ( transferDeviceMemory != VK_NULL_HANDLE )
         {
-            vkFreeMemory ( device, transferDeviceMemory, nullptr );
+            renderer.FreeMemory ( transferDeviceMemory, transferDeviceMemoryOffset );
             AV_UNREGISTER_DEVICE_MEMORY ( "MandelbrotLUTColor::UploadLUTSamples::transferDeviceMemory" )
         }
 
@@ -573,7 +542,8 @@ bool MandelbrotLUTColor::UploadLUTSamples ( android_vulkan::Renderer &renderer )
 
     AV_REGISTER_DEVICE_MEMORY ( "MandelbrotLUTColor::UploadLUTSamples::transferDeviceMemory" )
 
-    result = renderer.CheckVkResult ( vkBindBufferMemory ( device, transfer, transferDeviceMemory, 0U ),
+    result = renderer.CheckVkResult (
+        vkBindBufferMemory ( device, transfer, transferDeviceMemory, transferDeviceMemoryOffset ),
         "MandelbrotLUTColor::CreateLUT",
         "Can't bind memory to the transfer buffer"
     );
@@ -586,7 +556,9 @@ bool MandelbrotLUTColor::UploadLUTSamples ( android_vulkan::Renderer &renderer )
 
     void* data = nullptr;
 
-    result = renderer.CheckVkResult ( vkMapMemory ( device, transferDeviceMemory, 0U, LUT_SIZE, 0U, &data ),
+    result = renderer.MapMemory ( data,
+        transferDeviceMemory,
+        transferDeviceMemoryOffset,
         "MandelbrotLUTColor::CreateLUT",
         "Can't map transfer memory"
     );
@@ -597,42 +569,12 @@ bool MandelbrotLUTColor::UploadLUTSamples ( android_vulkan::Renderer &renderer )
         return false;
     }
 
-    InitLUTSamples ( static_cast<uint8_t*> ( data ) );
-    vkUnmapMemory ( device, transferDeviceMemory );
+    MandelbrotLUT::Generate ( static_cast<uint8_t*> ( data ) );
+    renderer.UnmapMemory ( transferDeviceMemory );
 
     VkCommandBuffer uploadJob = VK_NULL_HANDLE;
 
-    VkCommandBufferAllocateInfo allocateInfoInfo;
-    allocateInfoInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfoInfo.pNext = nullptr;
-    allocateInfoInfo.commandBufferCount = 1U;
-    allocateInfoInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfoInfo.commandPool = _commandPool;
-
-    result = renderer.CheckVkResult (
-        vkAllocateCommandBuffers ( renderer.GetDevice (), &allocateInfoInfo, &uploadJob ),
-        "MandelbrotLUTColor::UploadLUTSamples",
-        "Can't create common buffer"
-    );
-
-    if ( !result )
-    {
-        freeTransferResource ();
-        return false;
-    }
-
-    VkCommandBufferBeginInfo beginInfo;
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.pNext = nullptr;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    beginInfo.pInheritanceInfo = nullptr;
-
-    result = renderer.CheckVkResult ( vkBeginCommandBuffer ( uploadJob, &beginInfo ),
-        "MandelbrotLUTColor::UploadLUTSamples",
-        "Can't begin command buffer"
-    );
-
-    if ( !result )
+    if ( !_uploadScheduler.Begin ( uploadJob ) )
     {
         freeTransferResource ();
         return false;
@@ -704,49 +646,9 @@ bool MandelbrotLUTColor::UploadLUTSamples ( android_vulkan::Renderer &renderer )
         &barrier
     );
 
-    result = renderer.CheckVkResult ( vkEndCommandBuffer ( uploadJob ),
-        "MandelbrotLUTColor::UploadLUTSamples",
-        "Can't finish command buffer"
-    );
-
-    if ( !result )
-    {
-        freeTransferResource ();
-        return false;
-    }
-
-    VkSubmitInfo submitInfo;
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.pNext = nullptr;
-    submitInfo.waitSemaphoreCount = 0U;
-    submitInfo.pWaitSemaphores = nullptr;
-    submitInfo.pWaitDstStageMask = nullptr;
-    submitInfo.commandBufferCount = 1U;
-    submitInfo.pCommandBuffers = &uploadJob;
-    submitInfo.signalSemaphoreCount = 0U;
-    submitInfo.pSignalSemaphores = nullptr;
-
-    VkQueue queue = renderer.GetQueue ();
-
-    result = renderer.CheckVkResult (
-        vkQueueSubmit ( queue, 1U, &submitInfo, VK_NULL_HANDLE ),
-        "MandelbrotLUTColor::UploadLUTSamples",
-        "Can't submit command buffer"
-    );
-
-    if ( !result )
-    {
-        freeTransferResource ();
-        return false;
-    }
-
-    result = renderer.CheckVkResult ( vkQueueWaitIdle ( queue ),
-        "MandelbrotLUTColor::UploadLUTSamples",
-        "Can't commit transfer command"
-    );
-
-    freeTransferResource ();
-    return result;
+    // The transfer buffer will be released when GPU completes the upload. The render loop doesn't wait for it.
+    _uploadScheduler.AddReleaseCallback ( freeTransferResource );
+    return _uploadScheduler.Submit ();
 }
 
 } // namespace mandelbrot
@@ -0,0 +1,301 @@
+#include <memory_allocator.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cassert>
+
+GX_RESTORE_WARNING_STATE
+
+#include "logger.h"
+#include "vulkan_utils.h"
+
+
+namespace android_vulkan {
+
+constexpr static const VkDeviceSize BLOCK_SIZE = 32U * 1024U * 1024U;
+constexpr static const VkDeviceSize DEDICATED_THRESHOLD = BLOCK_SIZE / 2U;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MemoryAllocator::Block::Block ( VkDeviceSize size,
+    VkDeviceSize granularity,
+    bool isDedicated,
+    VkDeviceMemory memory,
+    uint32_t memoryTypeIndex
+):
+    _chunk ( size, granularity ),
+    _isDedicated ( isDedicated ),
+    _mapCounter ( 0U ),
+    _mappedData ( nullptr ),
+    _memory ( memory ),
+    _memoryTypeIndex ( memoryTypeIndex )
+{
+    // NOTHING
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MemoryAllocator::MemoryAllocator ():
+    _blocks {},
+    _bufferImageGranularity ( 1U ),
+    _dedicatedTypes ( 0U ),
+    _device ( VK_NULL_HANDLE ),
+    _mutex {},
+    _typeBlocks {}
+{
+    // NOTHING
+}
+
+void MemoryAllocator::Init ( VkDevice device,
+    VkDeviceSize bufferImageGranularity,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties
+)
+{
+    _device = device;
+    _bufferImageGranularity = std::max ( bufferImageGranularity, static_cast<VkDeviceSize> ( 1U ) );
+    _dedicatedTypes = 0U;
+
+    for ( uint32_t i = 0U; i < memoryProperties.memoryTypeCount; ++i )
+    {
+        if ( memoryProperties.memoryTypes[ i ].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT )
+            _dedicatedTypes |= 1U << i;
+    }
+}
+
+void MemoryAllocator::Destroy ()
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+
+    for ( auto& item : _blocks )
+    {
+        Block& block = *item.second;
+
+        if ( !block._chunk.IsEmpty () )
+        {
+            LogWarning ( "MemoryAllocator::Destroy - Block of memory type %u still has %zu allocation(s).",
+                block._memoryTypeIndex,
+                block._chunk.GetAllocationCount ()
+            );
+        }
+
+        if ( block._mappedData )
+            vkUnmapMemory ( _device, block._memory );
+
+        vkFreeMemory ( _device, block._memory, nullptr );
+        AV_UNREGISTER_DEVICE_MEMORY ( "MemoryAllocator::_blocks" )
+    }
+
+    _blocks.clear ();
+
+    for ( auto& item : _typeBlocks )
+        item.clear ();
+
+    _device = VK_NULL_HANDLE;
+}
+
+VkResult MemoryAllocator::Allocate ( VkDeviceMemory &memory,
+    VkDeviceSize &offset,
+    const VkMemoryRequirements &requirements,
+    uint32_t memoryTypeIndex
+)
+{
+    assert ( memoryTypeIndex < VK_MAX_MEMORY_TYPES );
+
+    const VkDeviceSize size = requirements.size;
+
+    std::unique_lock<std::mutex> lock ( _mutex );
+    Block* block = nullptr;
+
+    if ( size > DEDICATED_THRESHOLD || ( _dedicatedTypes & ( 1U << memoryTypeIndex ) ) )
+    {
+        const VkResult result = CreateBlock ( block, size, true, memoryTypeIndex );
+
+        if ( result != VK_SUCCESS )
+            return result;
+
+        [[maybe_unused]] const bool isAllocated = block->_chunk.Allocate ( offset, size, 1U );
+        assert ( isAllocated );
+
+        memory = block->_memory;
+        return VK_SUCCESS;
+    }
+
+    for ( Block* item : _typeBlocks[ memoryTypeIndex ] )
+    {
+        if ( !item->_chunk.Allocate ( offset, size, requirements.alignment ) )
+            continue;
+
+        memory = item->_memory;
+        return VK_SUCCESS;
+    }
+
+    const VkResult result = CreateBlock ( block, BLOCK_SIZE, false, memoryTypeIndex );
+
+    if ( result != VK_SUCCESS )
+        return result;
+
+    if ( !block->_chunk.Allocate ( offset, size, requirements.alignment ) )
+    {
+        assert ( !"MemoryAllocator::Allocate - Can't allocate from the new block." );
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+
+    memory = block->_memory;
+    return VK_SUCCESS;
+}
+
+void MemoryAllocator::Free ( VkDeviceMemory memory, VkDeviceSize offset )
+{
+    if ( memory == VK_NULL_HANDLE )
+        return;
+
+    std::unique_lock<std::mutex> lock ( _mutex );
+    const auto findResult = _blocks.find ( memory );
+
+    if ( findResult == _blocks.cend () )
+    {
+        LogError ( "MemoryAllocator::Free - Unknown memory object." );
+        assert ( !"MemoryAllocator::Free - Unknown memory object." );
+        return;
+    }
+
+    Block& block = *findResult->second;
+    block._chunk.Free ( offset );
+
+    if ( !block._chunk.IsEmpty () )
+        return;
+
+    if ( block._isDedicated )
+    {
+        DestroyBlock ( block );
+        return;
+    }
+
+    // Single empty block per memory type is kept. So the short living staging resources reuse it instead of
+    // vkAllocateMemory and vkFreeMemory calls for every upload.
+    for ( const Block* item : _typeBlocks[ block._memoryTypeIndex ] )
+    {
+        if ( item == &block || !item->_chunk.IsEmpty () )
+            continue;
+
+        DestroyBlock ( block );
+        return;
+    }
+}
+
+VkResult MemoryAllocator::Map ( void* &ptr, VkDeviceMemory memory, VkDeviceSize offset )
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+    const auto findResult = _blocks.find ( memory );
+
+    if ( findResult == _blocks.cend () )
+    {
+        assert ( !"MemoryAllocator::Map - Unknown memory object." );
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+
+    Block& block = *findResult->second;
+
+    if ( !block._mappedData )
+    {
+        const VkResult result = vkMapMemory ( _device, memory, 0U, VK_WHOLE_SIZE, 0U, &block._mappedData );
+
+        if ( result != VK_SUCCESS )
+            return result;
+    }
+
+    ++block._mapCounter;
+    ptr = static_cast<uint8_t*> ( block._mappedData ) + offset;
+    return VK_SUCCESS;
+}
+
+void MemoryAllocator::Unmap ( VkDeviceMemory memory )
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+    const auto findResult = _blocks.find ( memory );
+
+    if ( findResult == _blocks.cend () )
+    {
+        assert ( !"MemoryAllocator::Unmap - Unknown memory object." );
+        return;
+    }
+
+    Block& block = *findResult->second;
+    assert ( block._mapCounter );
+
+    if ( --block._mapCounter )
+        return;
+
+    vkUnmapMemory ( _device, memory );
+    block._mappedData = nullptr;
+}
+
+void MemoryAllocator::GetStats ( MemoryAllocatorStats &stats ) const
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+
+    MemoryStatsCollector collector;
+
+    for ( const auto& item : _blocks )
+    {
+        const Block& block = *item.second;
+        collector.Add ( block._chunk, block._isDedicated );
+    }
+
+    collector.GetStats ( stats );
+}
+
+VkResult MemoryAllocator::CreateBlock ( Block* &block,
+    VkDeviceSize size,
+    bool isDedicated,
+    uint32_t memoryTypeIndex
+)
+{
+    VkMemoryAllocateInfo allocateInfo;
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.allocationSize = size;
+    allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    const VkResult result = vkAllocateMemory ( _device, &allocateInfo, nullptr, &memory );
+
+    if ( result != VK_SUCCESS )
+        return result;
+
+    AV_REGISTER_DEVICE_MEMORY ( "MemoryAllocator::_blocks" )
+
+    // Note the dedicated block contains single resource. So there is no neighbour to pad against.
+    const VkDeviceSize granularity = isDedicated ? 1U : _bufferImageGranularity;
+    auto newBlock = std::make_unique<Block> ( size, granularity, isDedicated, memory, memoryTypeIndex );
+    block = newBlock.get ();
+    _blocks.emplace ( memory, std::move ( newBlock ) );
+
+    if ( !isDedicated )
+        _typeBlocks[ memoryTypeIndex ].push_back ( block );
+
+    return VK_SUCCESS;
+}
+
+void MemoryAllocator::DestroyBlock ( Block &block )
+{
+    VkDeviceMemory memory = block._memory;
+
+    if ( block._mappedData )
+        vkUnmapMemory ( _device, memory );
+
+    vkFreeMemory ( _device, memory, nullptr );
+    AV_UNREGISTER_DEVICE_MEMORY ( "MemoryAllocator::_blocks" )
+
+    if ( !block._isDedicated )
+    {
+        auto& typeBlocks = _typeBlocks[ block._memoryTypeIndex ];
+        typeBlocks.erase ( std::find ( typeBlocks.begin (), typeBlocks.end (), &block ) );
+    }
+
+    // Note "block" is not valid after this line.
+    _blocks.erase ( memory );
+}
+
+} // namespace android_vulkan
@@ -0,0 +1,195 @@
+#include <memory_chunk.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <iterator>
+
+GX_RESTORE_WARNING_STATE
+
+#include "logger.h"
+
+
+namespace android_vulkan {
+
+static uint64_t AlignUp ( uint64_t value, uint64_t alignment )
+{
+    const uint64_t mask = alignment - 1U;
+    return ( value + mask ) & ~mask;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MemoryChunk::MemoryChunk ( uint64_t size, uint64_t granularity ):
+    _allocations {},
+    _freeRanges {},
+    _granularity ( granularity ),
+    _size ( size ),
+    _used ( 0U )
+{
+    _freeRanges.emplace ( 0U, size );
+}
+
+bool MemoryChunk::Allocate ( uint64_t &offset, uint64_t size, uint64_t alignment )
+{
+    assert ( size );
+    assert ( alignment && !( alignment & ( alignment - 1U ) ) );
+
+    size = AlignUp ( size, _granularity );
+    alignment = std::max ( alignment, _granularity );
+
+    auto best = _freeRanges.end ();
+    uint64_t bestOffset = 0U;
+    uint64_t bestWaste = _size;
+
+    for ( auto it = _freeRanges.begin (); it != _freeRanges.end (); ++it )
+    {
+        const uint64_t aligned = AlignUp ( it->first, alignment );
+
+        if ( aligned + size > it->first + it->second )
+            continue;
+
+        const uint64_t waste = it->second - size;
+
+        if ( best != _freeRanges.end () && waste >= bestWaste )
+            continue;
+
+        best = it;
+        bestOffset = aligned;
+        bestWaste = waste;
+
+        if ( !waste )
+            break;
+    }
+
+    if ( best == _freeRanges.end () )
+        return false;
+
+    const uint64_t rangeOffset = best->first;
+    const uint64_t rangeEnd = rangeOffset + best->second;
+    const uint64_t allocationEnd = bestOffset + size;
+
+    _freeRanges.erase ( best );
+
+    // Note the padding before aligned offset goes back to the free list. It will be merged later.
+    if ( bestOffset > rangeOffset )
+        _freeRanges.emplace ( rangeOffset, bestOffset - rangeOffset );
+
+    if ( allocationEnd < rangeEnd )
+        _freeRanges.emplace ( allocationEnd, rangeEnd - allocationEnd );
+
+    _allocations.emplace ( bestOffset, size );
+    _used += size;
+    offset = bestOffset;
+
+    return true;
+}
+
+void MemoryChunk::Free ( uint64_t offset )
+{
+    const auto findResult = _allocations.find ( offset );
+
+    if ( findResult == _allocations.cend () )
+    {
+        LogError ( "MemoryChunk::Free - Unknown offset %" PRIu64 ".", offset );
+        assert ( !"MemoryChunk::Free - Unknown offset." );
+        return;
+    }
+
+    uint64_t start = offset;
+    uint64_t size = findResult->second;
+
+    _used -= size;
+    _allocations.erase ( findResult );
+
+    auto next = _freeRanges.lower_bound ( start );
+
+    if ( next != _freeRanges.end () && next->first == start + size )
+    {
+        size += next->second;
+        next = _freeRanges.erase ( next );
+    }
+
+    if ( next != _freeRanges.begin () )
+    {
+        auto previous = std::prev ( next );
+
+        if ( previous->first + previous->second == start )
+        {
+            previous->second += size;
+            return;
+        }
+    }
+
+    _freeRanges.emplace_hint ( next, start, size );
+}
+
+size_t MemoryChunk::GetAllocationCount () const
+{
+    return _allocations.size ();
+}
+
+size_t MemoryChunk::GetFreeRangeCount () const
+{
+    return _freeRanges.size ();
+}
+
+uint64_t MemoryChunk::GetLargestFreeRange () const
+{
+    uint64_t result = 0U;
+
+    for ( const auto& item : _freeRanges )
+        result = std::max ( result, item.second );
+
+    return result;
+}
+
+uint64_t MemoryChunk::GetSize () const
+{
+    return _size;
+}
+
+uint64_t MemoryChunk::GetUsed () const
+{
+    return _used;
+}
+
+bool MemoryChunk::IsEmpty () const
+{
+    return _allocations.empty ();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MemoryStatsCollector::MemoryStatsCollector ():
+    _largestFreeRanges ( 0U ),
+    _stats {}
+{
+    // NOTHING
+}
+
+void MemoryStatsCollector::Add ( const MemoryChunk &chunk, bool isDedicated )
+{
+    ++_stats._blocks;
+    _stats._allocations += chunk.GetAllocationCount ();
+    _stats._bytesReserved += chunk.GetSize ();
+    _stats._bytesUsed += chunk.GetUsed ();
+    _largestFreeRanges += chunk.GetLargestFreeRange ();
+
+    if ( isDedicated )
+        ++_stats._dedicatedBlocks;
+}
+
+void MemoryStatsCollector::GetStats ( MemoryAllocatorStats &stats ) const
+{
+    stats = _stats;
+    const uint64_t freeBytes = _stats._bytesReserved - _stats._bytesUsed;
+
+    stats._fragmentation = freeBytes ?
+        1.0F - static_cast<float> ( _largestFreeRanges ) / static_cast<float> ( freeBytes ) :
+        0.0F;
+}
+
+} // namespace android_vulkan
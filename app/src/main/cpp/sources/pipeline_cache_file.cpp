@@ -0,0 +1,111 @@
+#include <pipeline_cache_file.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstring>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+
+
+namespace android_vulkan {
+
+constexpr static const uint32_t PIPELINE_CACHE_MAGIC = 0x43505641U;
+
+// Value of VK_PIPELINE_CACHE_HEADER_VERSION_ONE.
+constexpr static const uint32_t PIPELINE_CACHE_HEADER_VERSION_ONE = 1U;
+
+// See "Layout for pipeline cache header version VK_PIPELINE_CACHE_HEADER_VERSION_ONE" in the Vulkan spec.
+constexpr static const size_t VULKAN_HEADER_SIZE = 4U * sizeof ( uint32_t ) + PIPELINE_CACHE_UUID_SIZE;
+
+struct PipelineCacheFileHeader final
+{
+    uint32_t    _magic;
+    uint32_t    _dataSize;
+    uint32_t    _dataHash;
+};
+
+// FNV-1a
+static uint32_t ComputePipelineCacheHash ( const uint8_t* data, size_t size )
+{
+    uint32_t hash = 2166136261U;
+
+    for ( size_t i = 0U; i < size; ++i )
+    {
+        hash ^= static_cast<uint32_t> ( data[ i ] );
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t PipelineCacheFile::GetDataOffset ()
+{
+    return sizeof ( PipelineCacheFileHeader );
+}
+
+void PipelineCacheFile::WriteHeader ( std::vector<uint8_t> &file )
+{
+    const uint8_t* driverData = file.data () + sizeof ( PipelineCacheFileHeader );
+    const size_t size = file.size () - sizeof ( PipelineCacheFileHeader );
+
+    PipelineCacheFileHeader header;
+    header._magic = PIPELINE_CACHE_MAGIC;
+    header._dataSize = static_cast<uint32_t> ( size );
+    header._dataHash = ComputePipelineCacheHash ( driverData, size );
+    std::memcpy ( file.data (), &header, sizeof ( header ) );
+}
+
+bool PipelineCacheFile::Validate ( const std::vector<uint8_t> &file, const PipelineCacheDevice &device )
+{
+    if ( file.size () < sizeof ( PipelineCacheFileHeader ) + VULKAN_HEADER_SIZE )
+    {
+        LogWarning ( "PipelineCacheFile::Validate - File is truncated. Dropping the cache." );
+        return false;
+    }
+
+    PipelineCacheFileHeader header;
+    std::memcpy ( &header, file.data (), sizeof ( header ) );
+
+    const uint8_t* driverData = file.data () + sizeof ( PipelineCacheFileHeader );
+    const size_t driverDataSize = file.size () - sizeof ( PipelineCacheFileHeader );
+
+    if ( header._magic != PIPELINE_CACHE_MAGIC || header._dataSize != driverDataSize )
+    {
+        LogWarning ( "PipelineCacheFile::Validate - Unknown file format. Dropping the cache." );
+        return false;
+    }
+
+    if ( header._dataHash != ComputePipelineCacheHash ( driverData, driverDataSize ) )
+    {
+        LogWarning ( "PipelineCacheFile::Validate - File is corrupted. Dropping the cache." );
+        return false;
+    }
+
+    uint32_t vulkanHeader[ 4U ];
+    std::memcpy ( vulkanHeader, driverData, sizeof ( vulkanHeader ) );
+
+    const bool isHeaderValid = vulkanHeader[ 0U ] >= VULKAN_HEADER_SIZE &&
+        vulkanHeader[ 1U ] == PIPELINE_CACHE_HEADER_VERSION_ONE;
+
+    if ( !isHeaderValid )
+    {
+        LogWarning ( "PipelineCacheFile::Validate - Unsupported header version. Dropping the cache." );
+        return false;
+    }
+
+    const bool isDeviceMatched = vulkanHeader[ 2U ] == device._vendorID &&
+        vulkanHeader[ 3U ] == device._deviceID &&
+        std::memcmp ( driverData + sizeof ( vulkanHeader ), device._pipelineCacheUUID, PIPELINE_CACHE_UUID_SIZE ) == 0;
+
+    if ( isDeviceMatched )
+        return true;
+
+    LogWarning ( "PipelineCacheFile::Validate - Cache belongs to another device or driver. Dropping the cache." );
+    return false;
+}
+
+} // namespace android_vulkan
@@ -6,6 +6,7 @@ GX_DISABLE_COMMON_WARNINGS
 
 GX_RESTORE_WARNING_STATE
 
+#include <frame_timing.h>
 #include <vulkan_utils.h>
 
 
@@ -61,11 +62,17 @@ bool Rainbow::OnFrame ( android_vulkan::Renderer &renderer, double deltaTime )
 
     const CommandContext& commandContext = _commandBuffers[ static_cast<size_t> ( framebufferIndex ) ];
     VkDevice device = renderer.GetDevice ();
+    bool result;
 
-    bool result = renderer.CheckVkResult ( vkWaitForFences ( device, 1U, &commandContext.second, VK_TRUE, UINT64_MAX ),
-        "Rainbow::OnFrame",
-        "Can't wait command buffer fence"
-    );
+    {
+        const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::FenceWait );
+
+        result = renderer.CheckVkResult (
+            vkWaitForFences ( device, 1U, &commandContext.second, VK_TRUE, UINT64_MAX ),
+            "Rainbow::OnFrame",
+            "Can't wait command buffer fence"
+        );
+    }
 
     if ( !result )
         return false;
@@ -177,6 +184,8 @@ bool Rainbow::OnDestroy ( android_vulkan::Renderer &renderer )
 
 bool Rainbow::BeginFrame ( uint32_t &presentationFramebufferIndex, android_vulkan::Renderer &renderer )
 {
+    const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Acquire );
+
     return renderer.CheckVkResult (
         vkAcquireNextImageKHR ( renderer.GetDevice (),
             renderer.GetSwapchain (),
@@ -205,6 +214,8 @@ bool Rainbow::EndFrame ( uint32_t presentationFramebufferIndex, android_vulkan::
     presentInfoKHR.pImageIndices = &presentationFramebufferIndex;
     presentInfoKHR.pResults = &presentResult;
 
+    const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Present );
+
     const bool result = renderer.CheckVkResult ( vkQueuePresentKHR ( renderer.GetQueue (), &presentInfoKHR ),
         "Rainbow::EndFrame",
         "Can't present frame"
@@ -5,6 +5,8 @@ GX_DISABLE_COMMON_WARNINGS
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <set>
 #include <string>
 
@@ -22,6 +24,7 @@ constexpr static const char* INDENT_1 = "    ";
 constexpr static const char* INDENT_2 = "        ";
 constexpr static const char* INDENT_3 = "            ";
 constexpr static const size_t INITIAL_EXTENSION_STORAGE_SIZE = 64U;
+constexpr static const char* PIPELINE_CACHE_FILE = "pipeline.cache";
 constexpr static const uint32_t TARGET_VULKAN_VERSION = VK_MAKE_VERSION ( 1U, 1U, 108U );
 constexpr static const char* UNKNOWN_RESULT = "UNKNOWN";
 
@@ -673,12 +676,20 @@ const std::map<VkSurfaceTransformFlagsKHR, const char*> Renderer::_vulkanSurface
 Renderer::Renderer ():
     _depthStencilImageFormat ( VK_FORMAT_UNDEFINED ),
     _device ( VK_NULL_HANDLE ),
+    vkCmdDrawIndexedIndirectCountKHR ( nullptr ),
+    vkCmdDrawIndirectCountKHR ( nullptr ),
     _instance ( VK_NULL_HANDLE ),
+    _isDescriptorIndexingSupported ( false ),
     _isDeviceExtensionChecked ( false ),
     _isDeviceExtensionSupported ( false ),
+    _isPipelineCacheWarm ( false ),
+    _memoryAllocator {},
     _physicalDevice ( VK_NULL_HANDLE ),
+    _pipelineCache ( VK_NULL_HANDLE ),
+    _pipelineCacheFile {},
     _queue ( VK_NULL_HANDLE ),
     _queueFamilyIndex ( VK_QUEUE_FAMILY_IGNORED ),
+    _samplerCache {},
     _surface ( VK_NULL_HANDLE ),
     _surfaceFormat ( VK_FORMAT_UNDEFINED ),
     _surfaceSize { .width = 0U, .height = 0U },
@@ -698,6 +709,7 @@ Renderer::Renderer ():
     _physicalDeviceGroups {},
     _physicalDeviceInfo {},
     _physicalDeviceMemoryProperties {},
+    _physicalDeviceProperties {},
     _surfaceFormats {},
     _swapchainImages {},
     _swapchainImageViews {},
@@ -707,6 +719,20 @@ Renderer::Renderer ():
     // NOTHING
 }
 
+bool Renderer::AcquireSampler ( VkSampler &sampler,
+    const VkSamplerCreateInfo &info,
+    const char* from,
+    const char* message
+)
+{
+    return CheckVkResult ( _samplerCache.Acquire ( sampler, info ), from, message );
+}
+
+void Renderer::ReleaseSampler ( VkSampler sampler )
+{
+    _samplerCache.Release ( sampler );
+}
+
 bool Renderer::CheckSwapchainStatus ()
 {
     VkSurfaceCapabilitiesKHR caps;
@@ -764,6 +790,11 @@ bool Renderer::CreateShader ( VkShaderModule &shader,
     );
 }
 
+void Renderer::FreeMemory ( VkDeviceMemory memory, VkDeviceSize offset )
+{
+    _memoryAllocator.Free ( memory, offset );
+}
+
 VkFormat Renderer::GetDefaultDepthStencilFormat () const
 {
     return _depthStencilImageFormat;
@@ -774,6 +805,21 @@ VkDevice Renderer::GetDevice () const
     return _device;
 }
 
+PFN_vkCmdDrawIndexedIndirectCountKHR Renderer::GetDrawIndexedIndirectCount () const
+{
+    return vkCmdDrawIndexedIndirectCountKHR;
+}
+
+PFN_vkCmdDrawIndirectCountKHR Renderer::GetDrawIndirectCount () const
+{
+    return vkCmdDrawIndirectCountKHR;
+}
+
+void Renderer::GetMemoryAllocatorStats ( MemoryAllocatorStats &stats ) const
+{
+    _memoryAllocator.GetStats ( stats );
+}
+
 size_t Renderer::GetPresentImageCount () const
 {
     return _swapchainImageViews.size ();
@@ -789,6 +835,21 @@ const GXMat4& Renderer::GetPresentationEngineTransform () const
     return _presentationEngineTransform;
 }
 
+const VkPhysicalDeviceFeatures& Renderer::GetPhysicalDeviceFeatures () const
+{
+    return _physicalDeviceInfo.at ( _physicalDevice )._features;
+}
+
+const VkPhysicalDeviceLimits& Renderer::GetPhysicalDeviceLimits () const
+{
+    return _physicalDeviceProperties.limits;
+}
+
+VkPipelineCache Renderer::GetPipelineCache () const
+{
+    return _pipelineCache;
+}
+
 VkQueue Renderer::GetQueue () const
 {
     return _queue;
@@ -819,13 +880,50 @@ const VkExtent2D& Renderer::GetViewportResolution () const
     return _viewportResolution;
 }
 
+bool Renderer::IsDescriptorIndexingSupported () const
+{
+    return _isDescriptorIndexingSupported;
+}
+
+bool Renderer::IsFormatFeatureSupported ( VkFormat format, VkFormatFeatureFlags features ) const
+{
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties ( _physicalDevice, format, &props );
+    return ( props.optimalTilingFeatures & features ) == features;
+}
+
+bool Renderer::IsPipelineCacheWarm () const
+{
+    return _isPipelineCacheWarm;
+}
+
 bool Renderer::IsReady () const
 {
     return _swapchain != VK_NULL_HANDLE;
 }
 
-bool Renderer::OnInit ( ANativeWindow &nativeWindow, bool vSync )
+bool Renderer::MapMemory ( void* &ptr,
+    VkDeviceMemory memory,
+    VkDeviceSize offset,
+    const char* from,
+    const char* message
+)
+{
+    return CheckVkResult ( _memoryAllocator.Map ( ptr, memory, offset ), from, message );
+}
+
+void Renderer::UnmapMemory ( VkDeviceMemory memory )
 {
+    _memoryAllocator.Unmap ( memory );
+}
+
+bool Renderer::OnInit ( ANativeWindow &nativeWindow, bool vSync, const char* dataDirectory )
+{
+    if ( dataDirectory )
+        _pipelineCacheFile = std::string ( dataDirectory ) + "/" + PIPELINE_CACHE_FILE;
+    else
+        _pipelineCacheFile.clear ();
+
     if ( !InitVulkan () )
     {
         LogError ( "Renderer::OnInit - Can't init Vulkan backend." );
@@ -1055,25 +1153,18 @@ bool Renderer::SelectTargetMemoryTypeIndex ( uint32_t &targetMemoryTypeIndex,
 }
 
 bool Renderer::TryAllocateMemory ( VkDeviceMemory &memory,
+    VkDeviceSize &offset,
     const VkMemoryRequirements &requirements,
     VkMemoryPropertyFlags memoryProperties,
     const char* errorMessage
-) const
+)
 {
-    VkMemoryAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.allocationSize = requirements.size;
+    uint32_t memoryTypeIndex = UINT32_MAX;
 
-    bool result = SelectTargetMemoryTypeIndex ( allocateInfo.memoryTypeIndex,
-        requirements,
-        memoryProperties
-    );
-
-    if ( !result )
+    if ( !SelectTargetMemoryTypeIndex ( memoryTypeIndex, requirements, memoryProperties ) )
         return false;
 
-    return CheckVkResult ( vkAllocateMemory ( _device, &allocateInfo, nullptr, &memory ),
+    return CheckVkResult ( _memoryAllocator.Allocate ( memory, offset, requirements, memoryTypeIndex ),
         "Renderer::TryAllocateMemory",
         errorMessage
     );
@@ -1196,6 +1287,11 @@ bool Renderer::DeployDevice ()
     if ( !SelectTargetHardware ( _physicalDevice, _queueFamilyIndex ) )
         return false;
 
+    // Note memory properties were written for every enumerated physical device. So it's needed to query them again
+    // for the selected one.
+    vkGetPhysicalDeviceMemoryProperties ( _physicalDevice, &_physicalDeviceMemoryProperties );
+    vkGetPhysicalDeviceProperties ( _physicalDevice, &_physicalDeviceProperties );
+
     deviceQueueCreateInfo.queueFamilyIndex = _queueFamilyIndex;
     const auto& caps = _physicalDeviceInfo[ _physicalDevice ];
 
@@ -1210,9 +1306,60 @@ bool Renderer::DeployDevice ()
     if ( !CheckRequiredDeviceExtensions ( caps._extensions, extensions, extensionCount ) )
         return false;
 
+    std::vector<const char*> enabledExtensions ( extensions, extensions + extensionCount );
+
+    auto isSupported = [ &caps ] ( const char* extension ) -> bool {
+        for ( const char* supported : caps._extensions )
+        {
+            if ( std::strcmp ( supported, extension ) == 0 )
+                return true;
+        }
+
+        return false;
+    };
+
+    // The optional extensions are enabled if the device supports them. The features which depend on them have
+    // the fallback paths.
+    const bool isDrawIndirectCountSupported = isSupported ( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
+
+    if ( isDrawIndirectCountSupported )
+        enabledExtensions.push_back ( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
+
+    LogInfo ( "Renderer::DeployDevice - Optional %s: %s",
+        VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME,
+        isDrawIndirectCountSupported ? "enabled" : "not supported"
+    );
+
+    // Note the features of the extension are queried by the Vulkan 1.1 entry point. All supported features are
+    // enabled.
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures {};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    descriptorIndexingFeatures.pNext = nullptr;
+
+    const bool isDescriptorIndexingSupported = _physicalDeviceProperties.apiVersion >= VK_MAKE_VERSION ( 1U, 1U, 0U ) &&
+        isSupported ( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
+
+    if ( isDescriptorIndexingSupported )
+    {
+        VkPhysicalDeviceFeatures2 features;
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &descriptorIndexingFeatures;
+        vkGetPhysicalDeviceFeatures2 ( _physicalDevice, &features );
+        enabledExtensions.push_back ( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
+    }
+
+    _isDescriptorIndexingSupported = isDescriptorIndexingSupported &&
+        descriptorIndexingFeatures.runtimeDescriptorArray &&
+        descriptorIndexingFeatures.descriptorBindingPartiallyBound;
+
+    LogInfo ( "Renderer::DeployDevice - Optional %s: %s",
+        VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
+        _isDescriptorIndexingSupported ? "enabled" : "not supported"
+    );
+
     VkPhysicalDeviceFloat16Int8FeaturesKHR float16Int8Feature;
     float16Int8Feature.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FLOAT16_INT8_FEATURES_KHR;
-    float16Int8Feature.pNext = nullptr;
+    float16Int8Feature.pNext = isDescriptorIndexingSupported ? &descriptorIndexingFeatures : nullptr;
     float16Int8Feature.shaderFloat16 = VK_TRUE;
     float16Int8Feature.shaderInt8 = VK_FALSE;
 
@@ -1224,8 +1371,8 @@ bool Renderer::DeployDevice ()
     deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
     deviceCreateInfo.enabledLayerCount = 0U;
     deviceCreateInfo.ppEnabledLayerNames = nullptr;
-    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t> ( extensionCount );
-    deviceCreateInfo.ppEnabledExtensionNames = extensions;
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t> ( enabledExtensions.size () );
+    deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data ();
     deviceCreateInfo.pEnabledFeatures = &caps._features;
 
     const bool result = CheckVkResult ( vkCreateDevice ( _physicalDevice, &deviceCreateInfo, nullptr, &_device ),
@@ -1238,6 +1385,24 @@ bool Renderer::DeployDevice ()
 
     AV_REGISTER_DEVICE ( "Renderer::_device" )
     vkGetDeviceQueue ( _device, _queueFamilyIndex, 0U, &_queue );
+
+    if ( isDrawIndirectCountSupported )
+    {
+        vkCmdDrawIndexedIndirectCountKHR = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR> (
+            vkGetDeviceProcAddr ( _device, "vkCmdDrawIndexedIndirectCountKHR" )
+        );
+
+        vkCmdDrawIndirectCountKHR = reinterpret_cast<PFN_vkCmdDrawIndirectCountKHR> (
+            vkGetDeviceProcAddr ( _device, "vkCmdDrawIndirectCountKHR" )
+        );
+    }
+
+    _memoryAllocator.Init ( _device,
+        _physicalDeviceProperties.limits.bufferImageGranularity,
+        _physicalDeviceMemoryProperties
+    );
+    _samplerCache.Init ( _device );
+    DeployPipelineCache ();
     return true;
 }
 
@@ -1246,10 +1411,16 @@ void Renderer::DestroyDevice ()
     if ( !_device )
         return;
 
+    DestroyPipelineCache ();
+    _samplerCache.Destroy ();
+    _memoryAllocator.Destroy ();
     vkDestroyDevice ( _device, nullptr );
     _device = VK_NULL_HANDLE;
     AV_UNREGISTER_DEVICE ( "Renderer::_device" )
 
+    vkCmdDrawIndexedIndirectCountKHR = nullptr;
+    vkCmdDrawIndirectCountKHR = nullptr;
+    _isDescriptorIndexingSupported = false;
     _queue = VK_NULL_HANDLE;
 }
 
@@ -1329,6 +1500,173 @@ void Renderer::DestroyInstance ()
     _instance = VK_NULL_HANDLE;
 }
 
+void Renderer::DeployPipelineCache ()
+{
+    std::vector<uint8_t> data;
+    _isPipelineCacheWarm = LoadPipelineCacheData ( data );
+
+    VkPipelineCacheCreateInfo cacheInfo;
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.pNext = nullptr;
+    cacheInfo.flags = 0U;
+    cacheInfo.initialDataSize = data.size ();
+    cacheInfo.pInitialData = data.empty () ? nullptr : data.data ();
+
+    VkResult result = vkCreatePipelineCache ( _device, &cacheInfo, nullptr, &_pipelineCache );
+
+    if ( result != VK_SUCCESS && _isPipelineCacheWarm )
+    {
+        LogWarning ( "Renderer::DeployPipelineCache - Driver rejected the stored data. Error: %s. Starting cold.",
+            ResolveVkResult ( result )
+        );
+
+        std::remove ( _pipelineCacheFile.c_str () );
+        _isPipelineCacheWarm = false;
+
+        cacheInfo.initialDataSize = 0U;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache ( _device, &cacheInfo, nullptr, &_pipelineCache );
+    }
+
+    if ( result != VK_SUCCESS )
+    {
+        LogWarning ( "Renderer::DeployPipelineCache - Can't create pipeline cache. Error: %s.",
+            ResolveVkResult ( result )
+        );
+
+        _pipelineCache = VK_NULL_HANDLE;
+        _isPipelineCacheWarm = false;
+        return;
+    }
+
+    AV_REGISTER_PIPELINE_CACHE ( "Renderer::_pipelineCache" )
+
+    LogInfo ( "Renderer::DeployPipelineCache - Pipeline cache is %s (%zu bytes).",
+        _isPipelineCacheWarm ? "warm" : "cold",
+        static_cast<size_t> ( cacheInfo.initialDataSize )
+    );
+}
+
+void Renderer::DestroyPipelineCache ()
+{
+    if ( _pipelineCache == VK_NULL_HANDLE )
+        return;
+
+    SavePipelineCacheData ();
+
+    vkDestroyPipelineCache ( _device, _pipelineCache, nullptr );
+    _pipelineCache = VK_NULL_HANDLE;
+    AV_UNREGISTER_PIPELINE_CACHE ( "Renderer::_pipelineCache" )
+
+    _isPipelineCacheWarm = false;
+}
+
+bool Renderer::LoadPipelineCacheData ( std::vector<uint8_t> &data ) const
+{
+    if ( _pipelineCacheFile.empty () )
+        return false;
+
+    FILE* file = std::fopen ( _pipelineCacheFile.c_str (), "rb" );
+
+    if ( !file )
+    {
+        LogInfo ( "Renderer::LoadPipelineCacheData - There is no pipeline cache file yet [%s].",
+            _pipelineCacheFile.c_str ()
+        );
+
+        return false;
+    }
+
+    std::fseek ( file, 0L, SEEK_END );
+    const long size = std::ftell ( file );
+    std::fseek ( file, 0L, SEEK_SET );
+
+    if ( size > 0L )
+    {
+        data.resize ( static_cast<size_t> ( size ) );
+
+        if ( std::fread ( data.data (), 1U, data.size (), file ) != data.size () )
+            data.clear ();
+    }
+
+    std::fclose ( file );
+
+    PipelineCacheDevice device;
+    device._vendorID = _physicalDeviceProperties.vendorID;
+    device._deviceID = _physicalDeviceProperties.deviceID;
+    std::memcpy ( device._pipelineCacheUUID, _physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE );
+
+    if ( PipelineCacheFile::Validate ( data, device ) )
+    {
+        const auto offset = static_cast<ptrdiff_t> ( PipelineCacheFile::GetDataOffset () );
+        data.erase ( data.cbegin (), data.cbegin () + offset );
+        return true;
+    }
+
+    data.clear ();
+    std::remove ( _pipelineCacheFile.c_str () );
+    return false;
+}
+
+void Renderer::SavePipelineCacheData () const
+{
+    if ( _pipelineCacheFile.empty () )
+        return;
+
+    size_t size = 0U;
+
+    bool result = CheckVkResult ( vkGetPipelineCacheData ( _device, _pipelineCache, &size, nullptr ),
+        "Renderer::SavePipelineCacheData",
+        "Can't get pipeline cache size"
+    );
+
+    if ( !result || !size )
+        return;
+
+    std::vector<uint8_t> data ( PipelineCacheFile::GetDataOffset () + size );
+    uint8_t* driverData = data.data () + PipelineCacheFile::GetDataOffset ();
+
+    result = CheckVkResult ( vkGetPipelineCacheData ( _device, _pipelineCache, &size, driverData ),
+        "Renderer::SavePipelineCacheData",
+        "Can't get pipeline cache data"
+    );
+
+    if ( !result )
+        return;
+
+    // Note the driver could return less data than it reported first.
+    data.resize ( PipelineCacheFile::GetDataOffset () + size );
+    PipelineCacheFile::WriteHeader ( data );
+
+    // Note the data is written into the temporary file first. So the interrupted write can't damage previous cache.
+    const std::string tmpFile = _pipelineCacheFile + ".tmp";
+    FILE* file = std::fopen ( tmpFile.c_str (), "wb" );
+
+    if ( !file )
+    {
+        LogWarning ( "Renderer::SavePipelineCacheData - Can't create file %s.", tmpFile.c_str () );
+        return;
+    }
+
+    const bool isWritten = std::fwrite ( data.data (), 1U, data.size (), file ) == data.size ();
+
+    if ( std::fclose ( file ) != 0 || !isWritten )
+    {
+        LogWarning ( "Renderer::SavePipelineCacheData - Can't write file %s.", tmpFile.c_str () );
+        std::remove ( tmpFile.c_str () );
+        return;
+    }
+
+    if ( std::rename ( tmpFile.c_str (), _pipelineCacheFile.c_str () ) != 0 )
+    {
+        LogWarning ( "Renderer::SavePipelineCacheData - Can't replace file %s.", _pipelineCacheFile.c_str () );
+        std::remove ( tmpFile.c_str () );
+        return;
+    }
+
+    LogInfo ( "Renderer::SavePipelineCacheData - Pipeline cache is saved (%zu bytes).", size );
+}
+
 bool Renderer::DeploySurface ( ANativeWindow &nativeWindow )
 {
     VkAndroidSurfaceCreateInfoKHR androidSurfaceCreateInfoKHR;
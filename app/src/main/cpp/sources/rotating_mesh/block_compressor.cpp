@@ -0,0 +1,855 @@
+#include <rotating_mesh/block_compressor.h>
+#include <rotating_mesh/ktx2_parser.h>
+#include <job_system.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t CHANNELS = 4U;
+constexpr static const size_t COLOR_CHANNELS = 3U;
+constexpr static const size_t BLOCK_ROW_GRAIN = 4U;
+constexpr static const size_t HALF_BLOCK_SIZE = 8U;
+
+// Indexed by the pixel index value: small positive, large positive, small negative and large negative modifier.
+constexpr static const int ETC_MODIFIERS[ 8U ][ 4U ] =
+{
+    { 2, 8, -2, -8 },
+    { 5, 17, -5, -17 },
+    { 9, 29, -9, -29 },
+    { 13, 42, -13, -42 },
+    { 18, 60, -18, -60 },
+    { 24, 80, -24, -80 },
+    { 33, 106, -33, -106 },
+    { 47, 183, -47, -183 }
+};
+
+constexpr static const int EAC_MODIFIERS[ 16U ][ 8U ] =
+{
+    { -3, -6, -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 },
+    { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 },
+    { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 },
+    { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },
+    { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },
+    { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },
+    { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },
+    { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+// The table contains zero modifier. So the constant alpha is encoded exactly.
+constexpr static const uint64_t EAC_CONSTANT_TABLE = 13U;
+constexpr static const uint64_t EAC_CONSTANT_INDEX = 4U;
+
+static int Clamp255 ( int value )
+{
+    return value < 0 ? 0 : value > 255 ? 255 : value;
+}
+
+static int Quantize ( float value, int levels )
+{
+    const auto result = static_cast<int> ( value * static_cast<float> ( levels ) / 255.0F + 0.5F );
+    return result < 0 ? 0 : result > levels ? levels : result;
+}
+
+static int Square ( int value )
+{
+    return value * value;
+}
+
+// Note the ETC pixels are indexed in column order. The texels are in row order.
+static size_t GetETCPixel ( size_t x, size_t y )
+{
+    return x * COMPRESSION_BLOCK_SIDE + y;
+}
+
+static bool IsSecondSubblock ( size_t x, size_t y, bool isFlipped )
+{
+    return ( isFlipped ? y : x ) >= 2U;
+}
+
+static void WriteBigEndian ( uint8_t* block, uint64_t value )
+{
+    for ( size_t i = 0U; i < HALF_BLOCK_SIZE; ++i )
+        block[ i ] = static_cast<uint8_t> ( value >> ( 56U - 8U * i ) );
+}
+
+static uint64_t ReadBigEndian ( const uint8_t* block )
+{
+    uint64_t value = 0U;
+
+    for ( size_t i = 0U; i < HALF_BLOCK_SIZE; ++i )
+        value = ( value << 8U ) | static_cast<uint64_t> ( block[ i ] );
+
+    return value;
+}
+
+static void LoadBlock ( uint8_t* texels,
+    const uint8_t* rgba,
+    uint32_t width,
+    uint32_t height,
+    uint32_t column,
+    uint32_t row
+)
+{
+    for ( uint32_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+    {
+        const uint32_t sourceY = std::min ( row * COMPRESSION_BLOCK_SIDE + y, height - 1U );
+
+        for ( uint32_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+        {
+            const uint32_t sourceX = std::min ( column * COMPRESSION_BLOCK_SIDE + x, width - 1U );
+            const uint8_t* source = rgba + ( static_cast<size_t> ( sourceY ) * width + sourceX ) * CHANNELS;
+            uint8_t* target = texels + ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS;
+
+            for ( size_t c = 0U; c < CHANNELS; ++c )
+                target[ c ] = source[ c ];
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static uint32_t Encode565 ( const float* color )
+{
+    const auto r = static_cast<uint32_t> ( Quantize ( color[ 0U ], 31 ) );
+    const auto g = static_cast<uint32_t> ( Quantize ( color[ 1U ], 63 ) );
+    const auto b = static_cast<uint32_t> ( Quantize ( color[ 2U ], 31 ) );
+    return ( r << 11U ) | ( g << 5U ) | b;
+}
+
+static void Decode565 ( int* color, uint32_t value )
+{
+    const uint32_t r = value >> 11U;
+    const uint32_t g = ( value >> 5U ) & 0x3FU;
+    const uint32_t b = value & 0x1FU;
+
+    color[ 0U ] = static_cast<int> ( ( r << 3U ) | ( r >> 2U ) );
+    color[ 1U ] = static_cast<int> ( ( g << 2U ) | ( g >> 4U ) );
+    color[ 2U ] = static_cast<int> ( ( b << 3U ) | ( b >> 2U ) );
+}
+
+// Note the four color mode only. Three color mode is not used because the color block of BC3 ignores it.
+static void MakeBCPalette ( int ( &palette )[ 4U ][ COLOR_CHANNELS ], uint32_t high, uint32_t low )
+{
+    Decode565 ( palette[ 0U ], high );
+    Decode565 ( palette[ 1U ], low );
+
+    for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+    {
+        palette[ 2U ][ c ] = ( 2 * palette[ 0U ][ c ] + palette[ 1U ][ c ] ) / 3;
+        palette[ 3U ][ c ] = ( palette[ 0U ][ c ] + 2 * palette[ 1U ][ c ] ) / 3;
+    }
+}
+
+static int ColorError ( const int* color, const uint8_t* texel )
+{
+    return Square ( color[ 0U ] - texel[ 0U ] ) + Square ( color[ 1U ] - texel[ 1U ] ) +
+        Square ( color[ 2U ] - texel[ 2U ] );
+}
+
+static void CompressColorBC ( uint8_t* block, const uint8_t* texels )
+{
+    float mean[ COLOR_CHANNELS ] = { 0.0F, 0.0F, 0.0F };
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+    {
+        for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+            mean[ c ] += static_cast<float> ( texels[ i * CHANNELS + c ] );
+    }
+
+    for ( float& value : mean )
+        value *= 1.0F / static_cast<float> ( COMPRESSION_BLOCK_TEXELS );
+
+    // The endpoints are the extreme projections of the colors to the principal axis. The axis is found by
+    // the power iteration of the covariance matrix.
+    float covariance[ COLOR_CHANNELS ][ COLOR_CHANNELS ] = {};
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+    {
+        const uint8_t* texel = texels + i * CHANNELS;
+
+        for ( size_t row = 0U; row < COLOR_CHANNELS; ++row )
+        {
+            for ( size_t column = 0U; column < COLOR_CHANNELS; ++column )
+            {
+                covariance[ row ][ column ] += ( static_cast<float> ( texel[ row ] ) - mean[ row ] ) *
+                    ( static_cast<float> ( texel[ column ] ) - mean[ column ] );
+            }
+        }
+    }
+
+    float axis[ COLOR_CHANNELS ] = { 1.0F, 1.0F, 1.0F };
+
+    for ( size_t iteration = 0U; iteration < 8U; ++iteration )
+    {
+        float next[ COLOR_CHANNELS ] = { 0.0F, 0.0F, 0.0F };
+        float length = 0.0F;
+
+        for ( size_t row = 0U; row < COLOR_CHANNELS; ++row )
+        {
+            for ( size_t column = 0U; column < COLOR_CHANNELS; ++column )
+                next[ row ] += covariance[ row ][ column ] * axis[ column ];
+
+            length = std::max ( length, std::fabs ( next[ row ] ) );
+        }
+
+        // Uniform block. Any axis is good.
+        if ( length < 1.0e-6F )
+            break;
+
+        for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+            axis[ c ] = next[ c ] / length;
+    }
+
+    // The projections must be measured along the unit axis.
+    const float norm = 1.0F / std::sqrt ( axis[ 0U ] * axis[ 0U ] + axis[ 1U ] * axis[ 1U ] + axis[ 2U ] * axis[ 2U ] );
+
+    for ( float& value : axis )
+        value *= norm;
+
+    float lowest = 0.0F;
+    float highest = 0.0F;
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+    {
+        float projection = 0.0F;
+
+        for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+            projection += ( static_cast<float> ( texels[ i * CHANNELS + c ] ) - mean[ c ] ) * axis[ c ];
+
+        lowest = std::min ( lowest, projection );
+        highest = std::max ( highest, projection );
+    }
+
+    float low[ COLOR_CHANNELS ];
+    float high[ COLOR_CHANNELS ];
+
+    for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+    {
+        low[ c ] = mean[ c ] + axis[ c ] * lowest;
+        high[ c ] = mean[ c ] + axis[ c ] * highest;
+    }
+
+    uint32_t endpoint0 = Encode565 ( high );
+    uint32_t endpoint1 = Encode565 ( low );
+
+    // The four color mode requires the first endpoint to be greater.
+    if ( endpoint0 < endpoint1 )
+        std::swap ( endpoint0, endpoint1 );
+
+    uint32_t indices = 0U;
+
+    if ( endpoint0 != endpoint1 )
+    {
+        int palette[ 4U ][ COLOR_CHANNELS ];
+        MakeBCPalette ( palette, endpoint0, endpoint1 );
+
+        for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+        {
+            const uint8_t* texel = texels + i * CHANNELS;
+            uint32_t best = 0U;
+            int bestError = ColorError ( palette[ 0U ], texel );
+
+            for ( uint32_t j = 1U; j < 4U; ++j )
+            {
+                const int error = ColorError ( palette[ j ], texel );
+
+                if ( error >= bestError )
+                    continue;
+
+                best = j;
+                bestError = error;
+            }
+
+            indices |= best << ( 2U * i );
+        }
+    }
+
+    block[ 0U ] = static_cast<uint8_t> ( endpoint0 );
+    block[ 1U ] = static_cast<uint8_t> ( endpoint0 >> 8U );
+    block[ 2U ] = static_cast<uint8_t> ( endpoint1 );
+    block[ 3U ] = static_cast<uint8_t> ( endpoint1 >> 8U );
+
+    for ( size_t i = 0U; i < 4U; ++i )
+        block[ 4U + i ] = static_cast<uint8_t> ( indices >> ( 8U * i ) );
+}
+
+static void DecompressColorBC ( uint8_t* texels, const uint8_t* block )
+{
+    const uint32_t endpoint0 = static_cast<uint32_t> ( block[ 0U ] ) | ( static_cast<uint32_t> ( block[ 1U ] ) << 8U );
+    const uint32_t endpoint1 = static_cast<uint32_t> ( block[ 2U ] ) | ( static_cast<uint32_t> ( block[ 3U ] ) << 8U );
+
+    int palette[ 4U ][ COLOR_CHANNELS ];
+    MakeBCPalette ( palette, endpoint0, endpoint1 );
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+    {
+        const uint32_t index = ( block[ 4U + i / 4U ] >> ( 2U * ( i % 4U ) ) ) & 3U;
+        uint8_t* texel = texels + i * CHANNELS;
+
+        for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+            texel[ c ] = static_cast<uint8_t> ( palette[ index ][ c ] );
+
+        texel[ 3U ] = 255U;
+    }
+}
+
+// Eight alpha mode only. The block uses six alpha mode if alpha is constant. That mode decodes the index 0 the same
+// way.
+static void MakeBCAlphaPalette ( int ( &palette )[ 8U ], int high, int low )
+{
+    palette[ 0U ] = high;
+    palette[ 1U ] = low;
+
+    for ( int i = 1; i < 7; ++i )
+        palette[ i + 1 ] = ( ( 7 - i ) * high + i * low ) / 7;
+}
+
+static void CompressAlphaBC ( uint8_t* block, const uint8_t* texels )
+{
+    int low = 255;
+    int high = 0;
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+    {
+        const int alpha = texels[ i * CHANNELS + 3U ];
+        low = std::min ( low, alpha );
+        high = std::max ( high, alpha );
+    }
+
+    uint64_t indices = 0U;
+
+    if ( high != low )
+    {
+        int palette[ 8U ];
+        MakeBCAlphaPalette ( palette, high, low );
+
+        for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+        {
+            const int alpha = texels[ i * CHANNELS + 3U ];
+            uint64_t best = 0U;
+            int bestError = Square ( palette[ 0U ] - alpha );
+
+            for ( uint64_t j = 1U; j < 8U; ++j )
+            {
+                const int error = Square ( palette[ j ] - alpha );
+
+                if ( error >= bestError )
+                    continue;
+
+                best = j;
+                bestError = error;
+            }
+
+            indices |= best << ( 3U * i );
+        }
+    }
+
+    block[ 0U ] = static_cast<uint8_t> ( high );
+    block[ 1U ] = static_cast<uint8_t> ( low );
+
+    for ( size_t i = 0U; i < 6U; ++i )
+        block[ 2U + i ] = static_cast<uint8_t> ( indices >> ( 8U * i ) );
+}
+
+static void DecompressAlphaBC ( uint8_t* texels, const uint8_t* block )
+{
+    int palette[ 8U ];
+    MakeBCAlphaPalette ( palette, block[ 0U ], block[ 1U ] );
+    uint64_t indices = 0U;
+
+    for ( size_t i = 0U; i < 6U; ++i )
+        indices |= static_cast<uint64_t> ( block[ 2U + i ] ) << ( 8U * i );
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+        texels[ i * CHANNELS + 3U ] = static_cast<uint8_t> ( palette[ ( indices >> ( 3U * i ) ) & 7U ] );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Method selects the best table and the pixel indices of the subblock. The method returns the squared error.
+static int FitETCSubblock ( uint64_t &table,
+    uint32_t ( &pixelIndices )[ COMPRESSION_BLOCK_TEXELS ],
+    const uint8_t* texels,
+    const int* base,
+    bool isFlipped,
+    bool isSecond
+)
+{
+    int bestError = INT_MAX;
+
+    for ( uint64_t t = 0U; t < 8U; ++t )
+    {
+        uint32_t candidate[ COMPRESSION_BLOCK_TEXELS ];
+        int error = 0;
+
+        for ( size_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+        {
+            for ( size_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+            {
+                if ( IsSecondSubblock ( x, y, isFlipped ) != isSecond )
+                    continue;
+
+                const uint8_t* texel = texels + ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS;
+                uint32_t best = 0U;
+                int bestTexelError = INT_MAX;
+
+                for ( uint32_t m = 0U; m < 4U; ++m )
+                {
+                    const int modifier = ETC_MODIFIERS[ t ][ m ];
+                    int texelError = 0;
+
+                    for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+                        texelError += Square ( Clamp255 ( base[ c ] + modifier ) - texel[ c ] );
+
+                    if ( texelError >= bestTexelError )
+                        continue;
+
+                    best = m;
+                    bestTexelError = texelError;
+                }
+
+                candidate[ GetETCPixel ( x, y ) ] = best;
+                error += bestTexelError;
+            }
+        }
+
+        if ( error >= bestError )
+            continue;
+
+        bestError = error;
+        table = t;
+
+        for ( size_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+        {
+            for ( size_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+            {
+                if ( IsSecondSubblock ( x, y, isFlipped ) == isSecond )
+                    pixelIndices[ GetETCPixel ( x, y ) ] = candidate[ GetETCPixel ( x, y ) ];
+            }
+        }
+    }
+
+    return bestError;
+}
+
+// The base colors are the averages of the subblocks. The differential mode is used if the averages are close enough.
+// Otherwise the individual mode is used. Note the differential mode never overflows. So the block is never decoded
+// as the T, H or planar mode of ETC2.
+static uint64_t EncodeETCColor ( int &error, const uint8_t* texels, bool isFlipped )
+{
+    float average[ 2U ][ COLOR_CHANNELS ] = {};
+
+    for ( size_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+    {
+        for ( size_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+        {
+            const size_t subblock = IsSecondSubblock ( x, y, isFlipped ) ? 1U : 0U;
+            const uint8_t* texel = texels + ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS;
+
+            for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+                average[ subblock ][ c ] += static_cast<float> ( texel[ c ] ) * 0.125F;
+        }
+    }
+
+    int quantized[ 2U ][ COLOR_CHANNELS ];
+    bool isDifferential = true;
+
+    for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+    {
+        quantized[ 0U ][ c ] = Quantize ( average[ 0U ][ c ], 31 );
+        quantized[ 1U ][ c ] = Quantize ( average[ 1U ][ c ], 31 );
+        const int delta = quantized[ 1U ][ c ] - quantized[ 0U ][ c ];
+        isDifferential = isDifferential && delta >= -4 && delta <= 3;
+    }
+
+    int base[ 2U ][ COLOR_CHANNELS ];
+    uint64_t word = isFlipped ? 1ULL << 32U : 0U;
+
+    for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+    {
+        const auto shift = static_cast<uint32_t> ( 8U * c );
+
+        if ( isDifferential )
+        {
+            const int first = quantized[ 0U ][ c ];
+            const int second = quantized[ 1U ][ c ];
+            base[ 0U ][ c ] = ( first << 3 ) | ( first >> 2 );
+            base[ 1U ][ c ] = ( second << 3 ) | ( second >> 2 );
+
+            word |= static_cast<uint64_t> ( first ) << ( 59U - shift );
+            word |= static_cast<uint64_t> ( ( second - first ) & 7 ) << ( 56U - shift );
+            continue;
+        }
+
+        const int first = Quantize ( average[ 0U ][ c ], 15 );
+        const int second = Quantize ( average[ 1U ][ c ], 15 );
+        base[ 0U ][ c ] = first * 17;
+        base[ 1U ][ c ] = second * 17;
+
+        word |= static_cast<uint64_t> ( first ) << ( 60U - shift );
+        word |= static_cast<uint64_t> ( second ) << ( 56U - shift );
+    }
+
+    if ( isDifferential )
+        word |= 1ULL << 33U;
+
+    uint32_t pixelIndices[ COMPRESSION_BLOCK_TEXELS ] = {};
+    uint64_t firstTable = 0U;
+    uint64_t secondTable = 0U;
+
+    error = FitETCSubblock ( firstTable, pixelIndices, texels, base[ 0U ], isFlipped, false ) +
+        FitETCSubblock ( secondTable, pixelIndices, texels, base[ 1U ], isFlipped, true );
+
+    word |= ( firstTable << 37U ) | ( secondTable << 34U );
+
+    for ( uint32_t p = 0U; p < COMPRESSION_BLOCK_TEXELS; ++p )
+    {
+        const auto index = static_cast<uint64_t> ( pixelIndices[ p ] );
+        word |= ( ( index >> 1U ) << ( p + 16U ) ) | ( ( index & 1U ) << p );
+    }
+
+    return word;
+}
+
+static void CompressColorETC ( uint8_t* block, const uint8_t* texels )
+{
+    int verticalError = 0;
+    int horizontalError = 0;
+    const uint64_t vertical = EncodeETCColor ( verticalError, texels, false );
+    const uint64_t horizontal = EncodeETCColor ( horizontalError, texels, true );
+    WriteBigEndian ( block, horizontalError < verticalError ? horizontal : vertical );
+}
+
+static void DecompressColorETC ( uint8_t* texels, const uint8_t* block )
+{
+    const uint64_t word = ReadBigEndian ( block );
+    const bool isFlipped = ( ( word >> 32U ) & 1U ) != 0U;
+    const bool isDifferential = ( ( word >> 33U ) & 1U ) != 0U;
+
+    int base[ 2U ][ COLOR_CHANNELS ];
+
+    for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+    {
+        const auto shift = static_cast<uint32_t> ( 8U * c );
+
+        if ( isDifferential )
+        {
+            const auto first = static_cast<int> ( ( word >> ( 59U - shift ) ) & 0x1FU );
+            const auto delta = static_cast<int> ( ( word >> ( 56U - shift ) ) & 7U );
+            const int second = first + ( delta > 3 ? delta - 8 : delta );
+            base[ 0U ][ c ] = ( first << 3 ) | ( first >> 2 );
+            base[ 1U ][ c ] = ( second << 3 ) | ( second >> 2 );
+            continue;
+        }
+
+        base[ 0U ][ c ] = static_cast<int> ( ( word >> ( 60U - shift ) ) & 0x0FU ) * 17;
+        base[ 1U ][ c ] = static_cast<int> ( ( word >> ( 56U - shift ) ) & 0x0FU ) * 17;
+    }
+
+    const size_t tables[ 2U ] = { ( word >> 37U ) & 7U, ( word >> 34U ) & 7U };
+
+    for ( size_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+    {
+        for ( size_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+        {
+            const size_t subblock = IsSecondSubblock ( x, y, isFlipped ) ? 1U : 0U;
+            const size_t p = GetETCPixel ( x, y );
+            const size_t index = ( ( ( word >> ( p + 16U ) ) & 1U ) << 1U ) | ( ( word >> p ) & 1U );
+            const int modifier = ETC_MODIFIERS[ tables[ subblock ] ][ index ];
+            uint8_t* texel = texels + ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS;
+
+            for ( size_t c = 0U; c < COLOR_CHANNELS; ++c )
+                texel[ c ] = static_cast<uint8_t> ( Clamp255 ( base[ subblock ][ c ] + modifier ) );
+
+            texel[ 3U ] = 255U;
+        }
+    }
+}
+
+static void CompressAlphaEAC ( uint8_t* block, const uint8_t* texels )
+{
+    int low = 255;
+    int high = 0;
+
+    for ( size_t i = 0U; i < COMPRESSION_BLOCK_TEXELS; ++i )
+    {
+        const int alpha = texels[ i * CHANNELS + 3U ];
+        low = std::min ( low, alpha );
+        high = std::max ( high, alpha );
+    }
+
+    if ( low == high )
+    {
+        uint64_t word = ( static_cast<uint64_t> ( low ) << 56U ) | ( 1ULL << 52U ) | ( EAC_CONSTANT_TABLE << 48U );
+
+        for ( uint32_t p = 0U; p < COMPRESSION_BLOCK_TEXELS; ++p )
+            word |= EAC_CONSTANT_INDEX << ( 45U - 3U * p );
+
+        WriteBigEndian ( block, word );
+        return;
+    }
+
+    // The multiplier is estimated from the alpha range for every table. The neighbour multipliers are tried too.
+    int bestError = INT_MAX;
+    uint64_t bestWord = 0U;
+
+    for ( uint64_t t = 0U; t < 16U; ++t )
+    {
+        const int* modifiers = EAC_MODIFIERS[ t ];
+        const int span = modifiers[ 7U ] - modifiers[ 3U ];
+        const int estimate = ( high - low + span / 2 ) / span;
+
+        for ( int multiplier = estimate - 1; multiplier <= estimate + 1; ++multiplier )
+        {
+            if ( multiplier < 1 || multiplier > 15 )
+                continue;
+
+            const int base = Clamp255 ( ( high + low - ( modifiers[ 7U ] + modifiers[ 3U ] ) * multiplier + 1 ) / 2 );
+            uint64_t indices = 0U;
+            int error = 0;
+
+            for ( size_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+            {
+                for ( size_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+                {
+                    const int alpha = texels[ ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS + 3U ];
+                    uint64_t best = 0U;
+                    int bestTexelError = INT_MAX;
+
+                    for ( uint64_t i = 0U; i < 8U; ++i )
+                    {
+                        const int texelError = Square ( Clamp255 ( base + modifiers[ i ] * multiplier ) - alpha );
+
+                        if ( texelError >= bestTexelError )
+                            continue;
+
+                        best = i;
+                        bestTexelError = texelError;
+                    }
+
+                    indices |= best << ( 45U - 3U * GetETCPixel ( x, y ) );
+                    error += bestTexelError;
+                }
+            }
+
+            if ( error >= bestError )
+                continue;
+
+            bestError = error;
+
+            bestWord = ( static_cast<uint64_t> ( base ) << 56U ) | ( static_cast<uint64_t> ( multiplier ) << 52U ) |
+                ( t << 48U ) | indices;
+        }
+    }
+
+    WriteBigEndian ( block, bestWord );
+}
+
+static void DecompressAlphaEAC ( uint8_t* texels, const uint8_t* block )
+{
+    const uint64_t word = ReadBigEndian ( block );
+    const auto base = static_cast<int> ( word >> 56U );
+    const auto multiplier = static_cast<int> ( ( word >> 52U ) & 0x0FU );
+    const int* modifiers = EAC_MODIFIERS[ ( word >> 48U ) & 0x0FU ];
+
+    for ( size_t y = 0U; y < COMPRESSION_BLOCK_SIDE; ++y )
+    {
+        for ( size_t x = 0U; x < COMPRESSION_BLOCK_SIDE; ++x )
+        {
+            const size_t index = ( word >> ( 45U - 3U * GetETCPixel ( x, y ) ) ) & 7U;
+            const int alpha = Clamp255 ( base + modifiers[ index ] * multiplier );
+            texels[ ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS + 3U ] = static_cast<uint8_t> ( alpha );
+        }
+    }
+}
+
+static void CompressBlock ( uint8_t* block, const uint8_t* texels, uint32_t format )
+{
+    switch ( format )
+    {
+        case KTX2_FORMAT_BC1_RGB_UNORM:
+        case KTX2_FORMAT_BC1_RGB_SRGB:
+            CompressColorBC ( block, texels );
+        break;
+
+        case KTX2_FORMAT_BC3_UNORM:
+        case KTX2_FORMAT_BC3_SRGB:
+            CompressAlphaBC ( block, texels );
+            CompressColorBC ( block + HALF_BLOCK_SIZE, texels );
+        break;
+
+        case KTX2_FORMAT_ETC2_R8G8B8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8_SRGB:
+            CompressColorETC ( block, texels );
+        break;
+
+        case KTX2_FORMAT_ETC2_R8G8B8A8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8A8_SRGB:
+            CompressAlphaEAC ( block, texels );
+            CompressColorETC ( block + HALF_BLOCK_SIZE, texels );
+        break;
+
+        default:
+            // NOTHING
+        break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t BlockCompressor::SelectFormat ( eBlockCompression compression, bool isSRGB, bool isOpaque )
+{
+    switch ( compression )
+    {
+        case eBlockCompression::BC:
+            if ( isOpaque )
+                return isSRGB ? KTX2_FORMAT_BC1_RGB_SRGB : KTX2_FORMAT_BC1_RGB_UNORM;
+
+        return isSRGB ? KTX2_FORMAT_BC3_SRGB : KTX2_FORMAT_BC3_UNORM;
+
+        case eBlockCompression::ETC2:
+            if ( isOpaque )
+                return isSRGB ? KTX2_FORMAT_ETC2_R8G8B8_SRGB : KTX2_FORMAT_ETC2_R8G8B8_UNORM;
+
+        return isSRGB ? KTX2_FORMAT_ETC2_R8G8B8A8_SRGB : KTX2_FORMAT_ETC2_R8G8B8A8_UNORM;
+
+        default:
+        return isSRGB ? KTX2_FORMAT_R8G8B8A8_SRGB : KTX2_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+void BlockCompressor::Compress ( uint8_t* destination,
+    const uint8_t* rgba,
+    uint32_t width,
+    uint32_t height,
+    uint32_t format
+)
+{
+    KTX2FormatInfo info {};
+    KTX2Parser::GetFormatInfo ( info, format );
+
+    const auto blockSize = static_cast<size_t> ( info._blockSize );
+    const uint32_t columns = ( width + COMPRESSION_BLOCK_SIDE - 1U ) / COMPRESSION_BLOCK_SIDE;
+    const uint32_t rows = ( height + COMPRESSION_BLOCK_SIDE - 1U ) / COMPRESSION_BLOCK_SIDE;
+
+    auto compressor = [ & ] ( size_t begin, size_t end ) {
+        uint8_t texels[ COMPRESSION_BLOCK_TEXELS * CHANNELS ];
+
+        for ( size_t row = begin; row < end; ++row )
+        {
+            uint8_t* block = destination + row * columns * blockSize;
+
+            for ( uint32_t column = 0U; column < columns; ++column )
+            {
+                LoadBlock ( texels, rgba, width, height, column, static_cast<uint32_t> ( row ) );
+                CompressBlock ( block, texels, format );
+                block += blockSize;
+            }
+        }
+    };
+
+    android_vulkan::g_JobSystem->ParallelFor ( static_cast<size_t> ( rows ), BLOCK_ROW_GRAIN, compressor );
+}
+
+void BlockCompressor::Decompress ( uint8_t* texels, const uint8_t* block, uint32_t format )
+{
+    switch ( format )
+    {
+        case KTX2_FORMAT_BC1_RGB_UNORM:
+        case KTX2_FORMAT_BC1_RGB_SRGB:
+            DecompressColorBC ( texels, block );
+        break;
+
+        case KTX2_FORMAT_BC3_UNORM:
+        case KTX2_FORMAT_BC3_SRGB:
+            DecompressColorBC ( texels, block + HALF_BLOCK_SIZE );
+            DecompressAlphaBC ( texels, block );
+        break;
+
+        case KTX2_FORMAT_ETC2_R8G8B8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8_SRGB:
+            DecompressColorETC ( texels, block );
+        break;
+
+        case KTX2_FORMAT_ETC2_R8G8B8A8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8A8_SRGB:
+            DecompressColorETC ( texels, block + HALF_BLOCK_SIZE );
+            DecompressAlphaEAC ( texels, block );
+        break;
+
+        default:
+            // NOTHING
+        break;
+    }
+}
+
+double BlockCompressor::ComputePSNR ( const uint8_t* level,
+    const uint8_t* rgba,
+    uint32_t width,
+    uint32_t height,
+    uint32_t format
+)
+{
+    KTX2FormatInfo info {};
+    KTX2Parser::GetFormatInfo ( info, format );
+
+    const auto blockSize = static_cast<size_t> ( info._blockSize );
+    const uint32_t columns = ( width + COMPRESSION_BLOCK_SIDE - 1U ) / COMPRESSION_BLOCK_SIDE;
+    const uint32_t rows = ( height + COMPRESSION_BLOCK_SIDE - 1U ) / COMPRESSION_BLOCK_SIDE;
+
+    uint8_t texels[ COMPRESSION_BLOCK_TEXELS * CHANNELS ];
+    uint64_t sum = 0U;
+
+    for ( uint32_t row = 0U; row < rows; ++row )
+    {
+        for ( uint32_t column = 0U; column < columns; ++column )
+        {
+            Decompress ( texels, level + ( static_cast<size_t> ( row ) * columns + column ) * blockSize, format );
+
+            // The texels of the partial blocks which are outside the image are ignored.
+            const uint32_t blockWidth = std::min ( COMPRESSION_BLOCK_SIDE, width - column * COMPRESSION_BLOCK_SIDE );
+            const uint32_t blockHeight = std::min ( COMPRESSION_BLOCK_SIDE, height - row * COMPRESSION_BLOCK_SIDE );
+
+            for ( uint32_t y = 0U; y < blockHeight; ++y )
+            {
+                const size_t sourceY = row * COMPRESSION_BLOCK_SIDE + y;
+
+                for ( uint32_t x = 0U; x < blockWidth; ++x )
+                {
+                    const size_t sourceX = column * COMPRESSION_BLOCK_SIDE + x;
+                    const uint8_t* source = rgba + ( sourceY * width + sourceX ) * CHANNELS;
+                    const uint8_t* decoded = texels + ( y * COMPRESSION_BLOCK_SIDE + x ) * CHANNELS;
+
+                    for ( size_t c = 0U; c < CHANNELS; ++c )
+                        sum += static_cast<uint64_t> ( Square ( decoded[ c ] - source[ c ] ) );
+                }
+            }
+        }
+    }
+
+    if ( sum == 0U )
+        return std::numeric_limits<double>::infinity ();
+
+    const auto samples = static_cast<double> ( static_cast<size_t> ( width ) * height * CHANNELS );
+    return 10.0 * std::log10 ( 255.0 * 255.0 * samples / static_cast<double> ( sum ) );
+}
+
+} // namespace rotating_mesh
@@ -3,70 +3,348 @@
 GX_DISABLE_COMMON_WARNINGS
 
 #include <array>
-#include <cassert>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <future>
+#include <thread>
 
 GX_RESTORE_WARNING_STATE
 
+#include <file.h>
+#include <frame_timing.h>
+#include <job_system.h>
 #include <vulkan_utils.h>
+#include <GXCommon/GXMathBatch.h>
 #include <rotating_mesh/vertex_info.h>
-#include <thread>
 
 
 namespace rotating_mesh {
 
-constexpr static const char* VERTEX_SHADER = "shaders/static-mesh-vs.spv";
+// Indexed by eVertexFormat.
+constexpr static const char* VERTEX_SHADERS[ VERTEX_FORMAT_COUNT ] =
+{
+    "shaders/static-mesh-vs.spv",
+    "shaders/static-mesh-packed-vs.spv"
+};
+
 constexpr static const char* VERTEX_SHADER_ENTRY_POINT = "VS";
 
 constexpr static const char* FRAGMENT_SHADER_ENTRY_POINT = "PS";
 
 constexpr static const char* MATERIAL_1_DIFFUSE = "textures/rotating_mesh/sonic-material-1-diffuse.png";
-constexpr static const char* MATERIAL_1_MESH = "meshes/rotating_mesh/sonic-material-1.mesh";
+constexpr static const char* MATERIAL_1_DIFFUSE_ETC2 = "textures/rotating_mesh/sonic-material-1-diffuse-etc2.ktx2";
+constexpr static const char* MATERIAL_1_MESH = "meshes/rotating_mesh/sonic-material-1.mesh2";
 
 constexpr static const char* MATERIAL_2_DIFFUSE = "textures/rotating_mesh/sonic-material-2-diffuse.png";
-constexpr static const char* MATERIAL_2_MESH = "meshes/rotating_mesh/sonic-material-2.mesh";
+constexpr static const char* MATERIAL_2_DIFFUSE_ETC2 = "textures/rotating_mesh/sonic-material-2-diffuse-etc2.ktx2";
+constexpr static const char* MATERIAL_2_MESH = "meshes/rotating_mesh/sonic-material-2.mesh2";
 constexpr static const char* MATERIAL_2_NORMAL = "textures/rotating_mesh/sonic-material-2-normal.png";
+constexpr static const char* MATERIAL_2_NORMAL_ETC2 = "textures/rotating_mesh/sonic-material-2-normal-etc2.ktx2";
 
 constexpr static const char* MATERIAL_3_DIFFUSE = "textures/rotating_mesh/sonic-material-3-diffuse.png";
-constexpr static const char* MATERIAL_3_MESH = "meshes/rotating_mesh/sonic-material-3.mesh";
+constexpr static const char* MATERIAL_3_DIFFUSE_ETC2 = "textures/rotating_mesh/sonic-material-3-diffuse-etc2.ktx2";
+constexpr static const char* MATERIAL_3_MESH = "meshes/rotating_mesh/sonic-material-3.mesh2";
 constexpr static const char* MATERIAL_3_NORMAL = "textures/rotating_mesh/sonic-material-3-normal.png";
+constexpr static const char* MATERIAL_3_NORMAL_ETC2 = "textures/rotating_mesh/sonic-material-3-normal-etc2.ktx2";
+
+constexpr static const char* MESH_FILES[ MATERIAL_COUNT ] =
+{
+    MATERIAL_1_MESH,
+    MATERIAL_2_MESH,
+    MATERIAL_3_MESH
+};
+
+// The packed layout takes 24 bytes per vertex instead of 56 bytes. The packed bitangent is rebuilt from the normal
+// and the tangent. The tangent frames of the second mesh are far from orthogonal. So the mesh keeps the full layout
+// to preserve its normal mapping. The first mesh has no normal map. Note the version 2.0 files store their own layout.
+// So the formats are used only if MESH_FILES point to the version 1.2 files. The shipped files are cooked with
+// the same formats by android-vulkan-mesh-cooker. The tangent frames are not merged. See docs/host-build.md.
+constexpr static const eVertexFormat MESH_VERTEX_FORMATS[ MATERIAL_COUNT ] =
+{
+    eVertexFormat::Packed,
+    eVertexFormat::Full,
+    eVertexFormat::Packed
+};
+
+// The compressed file is used if the device samples its format with the linear filter. Otherwise the PNG file is
+// decoded. The compressed files are made by android-vulkan-texture-packer. See docs/host-build.md.
+struct StreamedTexture final
+{
+    const char*     _file;
+    VkFormat        _format;
+    const char*     _compressedFile;
+    VkFormat        _compressedFormat;
+    size_t          _drawcall;
+    bool            _isNormal;
+};
+
+constexpr static const StreamedTexture STREAMED_TEXTURES[ STREAMED_TEXTURE_COUNT ] =
+{
+    {
+        MATERIAL_1_DIFFUSE,
+        VK_FORMAT_R8G8B8A8_SRGB,
+        MATERIAL_1_DIFFUSE_ETC2,
+        VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,
+        0U,
+        false
+    },
+
+    {
+        MATERIAL_2_DIFFUSE,
+        VK_FORMAT_R8G8B8A8_SRGB,
+        MATERIAL_2_DIFFUSE_ETC2,
+        VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,
+        1U,
+        false
+    },
+
+    {
+        MATERIAL_2_NORMAL,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        MATERIAL_2_NORMAL_ETC2,
+        VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+        1U,
+        true
+    },
+
+    {
+        MATERIAL_3_DIFFUSE,
+        VK_FORMAT_R8G8B8A8_SRGB,
+        MATERIAL_3_DIFFUSE_ETC2,
+        VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,
+        2U,
+        false
+    },
+
+    {
+        MATERIAL_3_NORMAL,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        MATERIAL_3_NORMAL_ETC2,
+        VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+        2U,
+        true
+    }
+};
+
+// Set it to false to compare the load time and the memory usage with the PNG files.
+constexpr static const bool USE_COMPRESSED_TEXTURES = true;
 
 constexpr static const float ROTATION_SPEED = GX_MATH_HALF_PI;
 constexpr static const float FIELD_OF_VIEW = 60.0F;
 constexpr static const float Z_NEAR = 0.1F;
 constexpr static const float Z_FAR = 1.0e+3F;
 
+// Use eUniformBufferMode::Staging to compare statistics with the legacy per-frame transfer submit path.
+constexpr static const eUniformBufferMode TRANSFORM_BUFFER_MODE = eUniformBufferMode::PersistentRing;
+constexpr static const double UNIFORM_BUFFER_STAT_PERIOD = 3.0;
+
+// Set it to true to compare both modes of UniformBuffer in one run. Every mode gets UNIFORM_BUFFER_BENCHMARK_UPDATES
+// updates of the transform at init time. One update per frame is emulated. The results are logged side by side.
+constexpr static const bool UNIFORM_BUFFER_BENCHMARK = false;
+constexpr static const size_t UNIFORM_BUFFER_BENCHMARK_UPDATES = 1000U;
+
+// Two frames are enough to overlap CPU recording with GPU execution. Three frames absorb longer GPU spikes at cost
+// of one extra frame of input latency.
+constexpr static const size_t FRAMES_IN_FLIGHT = 2U;
+
+// Number of draws in the scene. The materials are repeated. See "Record" stage of the frame timing report.
+constexpr static const size_t SCENE_DRAW_COUNT = MATERIAL_COUNT;
+
+// Set it to true to measure CPU cost of the command recording. Game::OnInit records the scene of every size
+// RECORD_BENCHMARK_FRAMES times and logs the average time. The scene is not culled and not submitted.
+constexpr static const bool RECORD_BENCHMARK = false;
+constexpr static const size_t RECORD_BENCHMARK_DRAWS[] = { 1U, 100U, 10000U };
+constexpr static const size_t RECORD_BENCHMARK_FRAMES = 100U;
+
+// Small scenes are recorded inline by the main thread. Otherwise the scene is split into batches which are recorded
+// into secondary command buffers in parallel.
+constexpr static const size_t MIN_DRAWS_PER_BATCH = 128U;
+constexpr static const size_t MAX_RECORD_BATCHES = 8U;
+
+// Every draw renders its instances with single vkCmdDraw. The instances are placed on the grid in XZ plane. Increase
+// the count to measure vertex throughput. CPU cost of the frame does not depend on it.
+constexpr static const uint32_t INSTANCE_COUNT = 1U;
+constexpr static const float INSTANCE_SPACING = 2.5F;
+
+enum class eCullingMode : uint8_t
+{
+    // The draws are culled by Game::CullScene. Every visible draw is recorded.
+    CPU,
+
+    // The instances are culled by the compute shader. Single indirect draw per material is recorded. It needs
+    // multiDrawIndirect and drawIndirectFirstInstance features. CPU mode is used otherwise.
+    GPU
+};
+
+// The default scene is too small to benefit from GPU mode. Use it with big SCENE_DRAW_COUNT and INSTANCE_COUNT.
+// The debug build compares GPU results against CPU culling every CULLING_CHECK_PERIOD frames.
+constexpr static const eCullingMode CULLING_MODE = eCullingMode::CPU;
+constexpr static const size_t CULLING_CHECK_PERIOD = 300U;
+
+enum class eMaterialBinding : uint8_t
+{
+    // Every drawcall has its own descriptor set. It's rebound for every material.
+    PerDrawcall,
+
+    // Single descriptor set with all materials is bound per command buffer. The draw selects the material by
+    // the push constant. It needs VK_EXT_descriptor_indexing. PerDrawcall mode is used otherwise. See MaterialTable.
+    MaterialTable
+};
+
+constexpr static const eMaterialBinding MATERIAL_BINDING = eMaterialBinding::MaterialTable;
+
+enum class eDepthStencilMemory : uint8_t
+{
+    // Ordinary image in device local memory.
+    DeviceLocal,
+
+    // Transient attachment in lazily allocated memory. The tile-based GPUs keep it in the tile memory only. So
+    // the memory is never committed. DeviceLocal memory is used if the device has no lazily allocated memory.
+    Transient
+};
+
+constexpr static const eDepthStencilMemory DEPTH_STENCIL_MEMORY = eDepthStencilMemory::Transient;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// The method returns the number of the attributes. Binding 0 is the vertex data. Binding 1 is the instance transform
+// which occupies four locations. One per row.
+static uint32_t InitVertexInput ( VkVertexInputAttributeDescription* attributes,
+    VkVertexInputBindingDescription* bindings,
+    eVertexFormat format
+)
+{
+    uint32_t count = 0U;
+
+    auto append = [ attributes, &count ] ( uint32_t location, uint32_t binding, size_t offset, VkFormat type ) {
+        VkVertexInputAttributeDescription& description = attributes[ count++ ];
+        description.location = location;
+        description.binding = binding;
+        description.offset = static_cast<uint32_t> ( offset );
+        description.format = type;
+    };
+
+    VkVertexInputBindingDescription& vertexBinding = bindings[ 0U ];
+    vertexBinding.binding = 0U;
+    vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    if ( format == eVertexFormat::Packed )
+    {
+        // Note the bitangent is rebuilt by the vertex shader. So location 4 is not used.
+        append ( 0U, 0U, offsetof ( PackedVertexInfo, _vertex ), VK_FORMAT_R32G32B32_SFLOAT );
+        append ( 1U, 0U, offsetof ( PackedVertexInfo, _uv ), VK_FORMAT_R16G16_SFLOAT );
+        append ( 2U, 0U, offsetof ( PackedVertexInfo, _normal ), VK_FORMAT_A2B10G10R10_UNORM_PACK32 );
+        append ( 3U, 0U, offsetof ( PackedVertexInfo, _tangent ), VK_FORMAT_A2B10G10R10_UNORM_PACK32 );
+        vertexBinding.stride = sizeof ( PackedVertexInfo );
+    }
+    else
+    {
+        append ( 0U, 0U, offsetof ( VertexInfo, _vertex ), VK_FORMAT_R32G32B32_SFLOAT );
+        append ( 1U, 0U, offsetof ( VertexInfo, _uv ), VK_FORMAT_R32G32_SFLOAT );
+        append ( 2U, 0U, offsetof ( VertexInfo, _normal ), VK_FORMAT_R32G32B32_SFLOAT );
+        append ( 3U, 0U, offsetof ( VertexInfo, _tangent ), VK_FORMAT_R32G32B32_SFLOAT );
+        append ( 4U, 0U, offsetof ( VertexInfo, _bitangent ), VK_FORMAT_R32G32B32_SFLOAT );
+        vertexBinding.stride = sizeof ( VertexInfo );
+    }
+
+    for ( uint32_t i = 0U; i < 4U; ++i )
+        append ( 5U + i, 1U, i * sizeof ( GXVec4 ), VK_FORMAT_R32G32B32A32_SFLOAT );
+
+    VkVertexInputBindingDescription& instanceBinding = bindings[ 1U ];
+    instanceBinding.binding = 1U;
+    instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    instanceBinding.stride = sizeof ( GXMat4 );
+
+    return count;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
-Game::Game ( const char* fragmentShader ):
+Game::Game ( const char* fragmentShader, const char* fragmentShaderMaterialTable ):
     _commandPool ( VK_NULL_HANDLE ),
     _descriptorPool ( VK_NULL_HANDLE ),
     _descriptorSetLayout ( VK_NULL_HANDLE ),
     _drawcalls {},
+    _isMaterialTable ( false ),
+    _materialTable {},
+    _mipmapGenerator {},
     _pipelineLayout ( VK_NULL_HANDLE ),
+    _placeholderDiffuse {},
+    _placeholderNormal {},
+    _textureDecoder {},
     _transformBuffer {},
+    _uploadScheduler {},
     _angle ( 0.0F ),
     _depthStencil ( VK_NULL_HANDLE ),
     _depthStencilView ( VK_NULL_HANDLE ),
     _depthStencilMemory ( VK_NULL_HANDLE ),
+    _depthStencilMemoryOffset ( 0U ),
     _fragmentShader ( fragmentShader ),
+    _fragmentShaderMaterialTable ( fragmentShaderMaterialTable ),
     _framebuffers {},
-    _pipeline ( VK_NULL_HANDLE ),
+    _gpuTimer {},
+    _gpuCulling {},
+    _gpuCullingFrames ( 0U ),
+    _isGPUCulling ( false ),
+    _instances {},
+    _frameIndex ( 0U ),
+    _framesInFlight {},
+    _pipelines {},
+    _recordBatches ( 0U ),
     _renderPass ( VK_NULL_HANDLE ),
-    _renderPassEndSemaphore ( VK_NULL_HANDLE ),
-    _renderTargetAcquiredSemaphore ( VK_NULL_HANDLE ),
-    _sampler01Mips ( VK_NULL_HANDLE ),
-    _sampler09Mips ( VK_NULL_HANDLE ),
-    _sampler10Mips ( VK_NULL_HANDLE ),
-    _sampler11Mips ( VK_NULL_HANDLE ),
-    _vertexShaderModule ( VK_NULL_HANDLE ),
-    _fragmentShaderModule ( VK_NULL_HANDLE )
+    _renderPassEndSemaphores {},
+    _materialSampler ( VK_NULL_HANDLE ),
+    _scene {},
+    _sceneBounds {},
+    _sceneVisibility {},
+    _visibleScene {},
+    _vertexShaderModules {},
+    _fragmentShaderModule ( VK_NULL_HANDLE ),
+    _uniformBufferStatTime ( 0.0 ),
+    _uniformBufferStatFrames ( 0U ),
+    _isFirstFrame ( false ),
+    _meshFiles {},
+    _streamingState ( eStreamingState::Idle ),
+    _streamingStart {},
+    _textureFileNames {},
+    _textureFiles {}
 {
     // NOTHING
 }
 
+bool Game::CreateMaterialTable ( android_vulkan::Renderer &renderer )
+{
+    return _materialTable.Init ( renderer, static_cast<uint32_t> ( MATERIAL_COUNT ), _transformBuffer, nullptr, 0U );
+}
+
+bool Game::UpdateMaterialTable ( android_vulkan::Renderer &renderer )
+{
+    _materialTable.Reset ();
+
+    for ( size_t i = 0U; i < MATERIAL_COUNT; ++i )
+    {
+        const Drawcall& drawcall = _drawcalls[ i ];
+
+        const bool result = _materialTable.SetMaterial ( static_cast<uint32_t> ( i ),
+            ResolveImageView ( drawcall._diffuse, _placeholderDiffuse ),
+            drawcall._diffuseSampler,
+            ResolveImageView ( drawcall._normal, _placeholderNormal ),
+            drawcall._normalSampler
+        );
+
+        if ( !result )
+            return false;
+    }
+
+    _materialTable.Commit ( renderer );
+    return true;
+}
+
 bool Game::CreateSamplers ( android_vulkan::Renderer &renderer )
 {
+    // Note VK_LOD_CLAMP_NONE allows to sample textures with any mip count by the same sampler. The placeholders
+    // have single texel. So the linear filter returns the texel as is.
     VkSamplerCreateInfo samplerInfo;
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.pNext = nullptr;
@@ -76,7 +354,7 @@ bool Game::CreateSamplers ( android_vulkan::Renderer &renderer )
     samplerInfo.mipLodBias = 0.0F;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.minLod = 0.0F;
-    samplerInfo.maxLod = 8.0F;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
     samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
@@ -87,92 +365,20 @@ bool Game::CreateSamplers ( android_vulkan::Renderer &renderer )
     samplerInfo.compareEnable = VK_FALSE;
     samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 
-    VkDevice device = renderer.GetDevice ();
-
-    bool result = renderer.CheckVkResult (
-        vkCreateSampler ( device, &samplerInfo, nullptr, &_sampler09Mips ),
-        "Game::CreateSamplers",
-        "Can't create sampler with 9 mips"
-    );
-
-    if ( !result )
-        return false;
-
-    AV_REGISTER_SAMPLER ( "Game::_sampler09Mips" )
-
-    samplerInfo.maxLod = 9.0F;
-
-    result = renderer.CheckVkResult (
-        vkCreateSampler ( device, &samplerInfo, nullptr, &_sampler10Mips ),
-        "Game::CreateSamplers",
-        "Can't create sampler with 10 mips"
-    );
-
-    if ( !result )
-        return false;
-
-    AV_REGISTER_SAMPLER ( "Game::_sampler10Mips" )
-
-    samplerInfo.maxLod = 10.0F;
-
-    result = renderer.CheckVkResult (
-        vkCreateSampler ( device, &samplerInfo, nullptr, &_sampler11Mips ),
-        "Game::CreateSamplers",
-        "Can't create sampler with 11 mips"
-    );
-
-    if ( !result )
-        return false;
-
-    AV_REGISTER_SAMPLER ( "Game::_sampler11Mips" )
-
-    samplerInfo.maxLod = 1.0F;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-    samplerInfo.magFilter = VK_FILTER_NEAREST;
-    samplerInfo.minFilter = VK_FILTER_NEAREST;
-
-    result = renderer.CheckVkResult (
-        vkCreateSampler ( device, &samplerInfo, nullptr, &_sampler01Mips ),
+    return renderer.AcquireSampler ( _materialSampler,
+        samplerInfo,
         "Game::CreateSamplers",
-        "Can't create sampler with 1 mip"
+        "Can't acquire material sampler"
     );
-
-    if ( !result )
-        return false;
-
-    AV_REGISTER_SAMPLER ( "Game::_sampler01Mips" )
-    return true;
 }
 
 void Game::DestroySamplers ( android_vulkan::Renderer &renderer )
 {
-    if ( _sampler11Mips != VK_NULL_HANDLE )
-    {
-        vkDestroySampler ( renderer.GetDevice (), _sampler11Mips, nullptr );
-        _sampler11Mips = VK_NULL_HANDLE;
-        AV_UNREGISTER_SAMPLER ( "Game::_sampler11Mips" )
-    }
-
-    if ( _sampler10Mips != VK_NULL_HANDLE )
-    {
-        vkDestroySampler ( renderer.GetDevice (), _sampler10Mips, nullptr );
-        _sampler10Mips = VK_NULL_HANDLE;
-        AV_UNREGISTER_SAMPLER ( "Game::_sampler10Mips" )
-    }
-
-    if ( _sampler09Mips != VK_NULL_HANDLE )
-    {
-        vkDestroySampler ( renderer.GetDevice (), _sampler09Mips, nullptr );
-        _sampler09Mips = VK_NULL_HANDLE;
-        AV_UNREGISTER_SAMPLER ( "Game::_sampler09Mips" )
-    }
-
-    if ( _sampler01Mips == VK_NULL_HANDLE )
+    if ( _materialSampler == VK_NULL_HANDLE )
         return;
 
-    vkDestroySampler ( renderer.GetDevice (), _sampler01Mips, nullptr );
-    _sampler01Mips = VK_NULL_HANDLE;
-    AV_UNREGISTER_SAMPLER ( "Game::_sampler01Mips" )
+    renderer.ReleaseSampler ( _materialSampler );
+    _materialSampler = VK_NULL_HANDLE;
 }
 
 void Game::DestroyTextures ( android_vulkan::Renderer &renderer )
@@ -188,83 +394,46 @@ void Game::DestroyTextures ( android_vulkan::Renderer &renderer )
         item._normal.FreeResources ( renderer );
         item._diffuseSampler = item._normalSampler = VK_NULL_HANDLE;
     }
+
+    _placeholderDiffuse.FreeResources ( renderer );
+    _placeholderNormal.FreeResources ( renderer );
 }
 
-bool Game::CreateCommonTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer* commandBuffers )
+bool Game::CreateCommonTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer )
 {
-    auto selector = [ this ] ( const Texture2D &texture ) -> VkSampler {
-        const uint8_t mips = texture.GetMipLevelCount ();
-
-        if ( mips == 1U )
-            return _sampler01Mips;
-
-        if ( mips == 9U )
-            return _sampler09Mips;
-
-        if ( mips == 10U )
-            return _sampler10Mips;
-
-        if ( mips == 11U )
-            return _sampler11Mips;
-
-        assert ( !"Game::CreateCommonTextures::selector - Can't select sampler" );
-        return VK_NULL_HANDLE;
-    };
-
-    constexpr char const* textureFiles[ MATERIAL_COUNT ] =
-        {
-            MATERIAL_1_DIFFUSE,
-            MATERIAL_2_DIFFUSE,
-            MATERIAL_3_DIFFUSE
-        };
-
-    for ( size_t i = 0U; i < MATERIAL_COUNT; ++i )
-    {
-        auto& drawcall = _drawcalls[ i ];
-
-        bool result = drawcall._diffuse.UploadData ( textureFiles[ i ],
-            VK_FORMAT_R8G8B8A8_SRGB,
-            true,
-            renderer,
-            commandBuffers[ i ]
-        );
-
-        if ( !result )
-            return false;
-
-        drawcall._diffuseSampler = selector ( drawcall._diffuse );
-    }
-
-    Drawcall& secondMaterial = _drawcalls[ 1U ];
+    // Note the streamed textures are replaced by the placeholders until they are uploaded.
+    // See Game::UpdateStreaming.
+    constexpr const uint8_t placeholderDiffuse[] = { 128U, 128U, 128U, 255U };
 
-    bool result = secondMaterial._normal.UploadData ( MATERIAL_2_NORMAL,
-        VK_FORMAT_R8G8B8A8_UNORM,
-        true,
+    bool result = _placeholderDiffuse.UploadData ( placeholderDiffuse,
+        std::size ( placeholderDiffuse ),
+        VkExtent2D { .width = 1U, .height = 1U },
+        VK_FORMAT_R8G8B8A8_SRGB,
+        false,
         renderer,
-        commandBuffers[ 3U ]
+        commandBuffer
     );
 
     if ( !result )
         return false;
 
-    secondMaterial._normalSampler = selector ( secondMaterial._normal );
-
-    Drawcall& thirdMaterial = _drawcalls[ 2U ];
+    ReleaseOnUploadComplete ( renderer, _placeholderDiffuse );
+    constexpr const uint8_t defaultNormal[] = { 128U, 128U, 255U, 128U };
 
-    result = thirdMaterial._normal.UploadData ( MATERIAL_3_NORMAL,
+    result = _placeholderNormal.UploadData ( defaultNormal,
+        std::size ( defaultNormal ),
+        VkExtent2D { .width = 1U, .height = 1U },
         VK_FORMAT_R8G8B8A8_UNORM,
-        true,
+        false,
         renderer,
-        commandBuffers[ 4U ]
+        commandBuffer
     );
 
     if ( !result )
         return false;
 
-    thirdMaterial._normalSampler = selector ( thirdMaterial._normal );
-
+    ReleaseOnUploadComplete ( renderer, _placeholderNormal );
     Drawcall& firstMaterial = _drawcalls[ 0U ];
-    constexpr const uint8_t defaultNormal[] = { 128U, 128U, 255U, 128U };
 
     result = firstMaterial._normal.UploadData ( defaultNormal,
         std::size ( defaultNormal ),
@@ -272,46 +441,80 @@ bool Game::CreateCommonTextures ( android_vulkan::Renderer &renderer, VkCommandB
         VK_FORMAT_R8G8B8A8_UNORM,
         false,
         renderer,
-        commandBuffers[ 5U ]
+        commandBuffer
     );
 
     if ( !result )
         return false;
 
-    firstMaterial._normalSampler = selector ( firstMaterial._normal );
+    ReleaseOnUploadComplete ( renderer, firstMaterial._normal );
+
+    for ( auto& drawcall : _drawcalls )
+        drawcall._diffuseSampler = drawcall._normalSampler = _materialSampler;
+
     return true;
 }
 
-bool Game::CreateMeshes ( android_vulkan::Renderer &renderer, VkCommandBuffer* commandBuffers )
+bool Game::CreateMeshes ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer )
 {
-    constexpr const char* meshFiles[ MATERIAL_COUNT ] =
-        {
-            MATERIAL_1_MESH,
-            MATERIAL_2_MESH,
-            MATERIAL_3_MESH,
-        };
-
     for ( size_t i = 0U; i < MATERIAL_COUNT; ++i )
     {
-        const bool result = _drawcalls[ i ]._mesh.LoadMesh ( meshFiles[ i ],
+        // Note the meshes are requested with high priority. So they are likely mapped already.
+        const std::shared_ptr<android_vulkan::File> file = _meshFiles[ i ].get ();
+        _meshFiles[ i ] = {};
+
+        if ( !file )
+        {
+            android_vulkan::LogError ( "Game::CreateMeshes - Can't load mesh %s.", MESH_FILES[ i ] );
+            return false;
+        }
+
+        MeshGeometry& mesh = _drawcalls[ i ]._mesh;
+
+        const bool result = mesh.LoadMesh ( *file,
+            MESH_VERTEX_FORMATS[ i ],
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            renderer, commandBuffers[ i ]
+            renderer, commandBuffer
         );
 
-        if ( result )
-            continue;
+        if ( !result )
+            return false;
 
-        return false;
+        ReleaseOnUploadComplete ( renderer, mesh );
     }
 
-    return true;
+    std::vector<GXMat4> instances;
+
+    if ( !CreateInstances ( instances, renderer, commandBuffer ) )
+        return false;
+
+    return CreateScene ( renderer, commandBuffer, instances );
+}
+
+void Game::ReleaseOnUploadComplete ( android_vulkan::Renderer &renderer, MeshGeometry &mesh )
+{
+    _uploadScheduler.AddReleaseCallback ( [ &renderer, &mesh ] () {
+        mesh.FreeTransferResources ( renderer );
+    } );
+}
+
+void Game::ReleaseOnUploadComplete ( android_vulkan::Renderer &renderer, Texture2D &texture )
+{
+    _uploadScheduler.AddReleaseCallback ( [ &renderer, &texture ] () {
+        texture.FreeTransferResources ( renderer );
+    } );
+}
+
+VkImageView Game::ResolveImageView ( const Texture2D &texture, const Texture2D &placeholder ) const
+{
+    return _streamingState == eStreamingState::Idle ? texture.GetImageView () : placeholder.GetImageView ();
 }
 
-void Game::InitDescriptorPoolSizeCommon ( VkDescriptorPoolSize* features )
+void Game::InitDescriptorPoolSizeCommon ( VkDescriptorPoolSize* features ) const
 {
     VkDescriptorPoolSize& ubFeature = features[ 0U ];
     ubFeature.descriptorCount = static_cast<uint32_t> ( MATERIAL_COUNT );
-    ubFeature.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    ubFeature.type = _transformBuffer.GetDescriptorType ();
 
     VkDescriptorPoolSize& diffuseTextureFeature = features[ 1U ];
     diffuseTextureFeature.descriptorCount = static_cast<uint32_t> ( MATERIAL_COUNT );
@@ -330,11 +533,11 @@ void Game::InitDescriptorPoolSizeCommon ( VkDescriptorPoolSize* features )
     normalSamplerFeature.type = VK_DESCRIPTOR_TYPE_SAMPLER;
 }
 
-void Game::InitDescriptorSetLayoutBindingCommon ( VkDescriptorSetLayoutBinding* bindings )
+void Game::InitDescriptorSetLayoutBindingCommon ( VkDescriptorSetLayoutBinding* bindings ) const
 {
     VkDescriptorSetLayoutBinding& ubInfo = bindings[ 0U ];
     ubInfo.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    ubInfo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    ubInfo.descriptorType = _transformBuffer.GetDescriptorType ();
     ubInfo.descriptorCount = 1U;
     ubInfo.binding = 0U;
     ubInfo.pImmutableSamplers = nullptr;
@@ -370,11 +573,13 @@ void Game::InitDescriptorSetLayoutBindingCommon ( VkDescriptorSetLayoutBinding*
 
 bool Game::IsReady ()
 {
-    return _pipeline != VK_NULL_HANDLE;
+    return _pipelines[ 0U ] != VK_NULL_HANDLE;
 }
 
 bool Game::OnInit ( android_vulkan::Renderer &renderer )
 {
+    // Note file I/O goes in parallel with creation of the Vulkan objects.
+    RequestAssets ( renderer );
     const VkExtent2D& resolution = renderer.GetViewportResolution ();
 
     _projectionMatrix.Perspective ( GXDegToRad ( FIELD_OF_VIEW ),
@@ -407,19 +612,50 @@ bool Game::OnInit ( android_vulkan::Renderer &renderer )
         return false;
     }
 
-    if ( !CreateUniformBuffer ( renderer ) )
+    if ( !_gpuTimer.Init ( renderer, FRAMES_IN_FLIGHT ) )
     {
         OnDestroy ( renderer );
         return false;
     }
 
-    if ( !CreateSamplers ( renderer ) )
+    if ( !_uploadScheduler.Init ( renderer ) )
     {
         OnDestroy ( renderer );
         return false;
     }
 
-    if ( !LoadGPUContent ( renderer ) )
+    if ( !_mipmapGenerator.Init ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
+    constexpr const auto maxDrawsPerMaterial =
+        static_cast<uint32_t> ( ( SCENE_DRAW_COUNT + MATERIAL_COUNT - 1U ) / MATERIAL_COUNT );
+
+    _isGPUCulling = CULLING_MODE == eCullingMode::GPU && GPUCulling::IsSupported ( renderer, maxDrawsPerMaterial );
+
+    if ( CULLING_MODE == eCullingMode::GPU && !_isGPUCulling )
+        android_vulkan::LogWarning ( "Game::OnInit - GPU culling is not supported. CPU culling is used." );
+
+    if ( _isGPUCulling && !_gpuCulling.Init ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
+    _isMaterialTable = MATERIAL_BINDING == eMaterialBinding::MaterialTable && MaterialTable::IsSupported ( renderer );
+
+    if ( MATERIAL_BINDING == eMaterialBinding::MaterialTable && !_isMaterialTable )
+        android_vulkan::LogWarning ( "Game::OnInit - Material table is not supported. Per drawcall sets are used." );
+
+    if ( !CreateUniformBuffer ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
+    if ( !CreateSamplers ( renderer ) )
     {
         OnDestroy ( renderer );
         return false;
@@ -431,7 +667,11 @@ bool Game::OnInit ( android_vulkan::Renderer &renderer )
         return false;
     }
 
-    if ( !CreatePipelineLayout ( renderer ) )
+    const bool isPipelineLayoutCreated = _isMaterialTable ?
+        CreateMaterialTablePipelineLayout ( renderer ) :
+        CreatePipelineLayout ( renderer );
+
+    if ( !isPipelineLayoutCreated )
     {
         OnDestroy ( renderer );
         return false;
@@ -443,7 +683,31 @@ bool Game::OnInit ( android_vulkan::Renderer &renderer )
         return false;
     }
 
-    if ( !CreateDescriptorSet ( renderer ) )
+#ifdef ANDROID_VULKAN_DEBUG
+
+    const auto uploadBegin = std::chrono::steady_clock::now ();
+
+#endif // ANDROID_VULKAN_DEBUG
+
+    // Note the assets are being mapped by the asset loader since the beginning of the method.
+    if ( !LoadGPUContent ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
+#ifdef ANDROID_VULKAN_DEBUG
+
+    const std::chrono::duration<double, std::milli> uploadTime = std::chrono::steady_clock::now () - uploadBegin;
+    android_vulkan::LogInfo ( "Game::OnInit - GPU content is recorded and submitted in %g ms", uploadTime.count () );
+
+#endif // ANDROID_VULKAN_DEBUG
+
+    const bool isDescriptorSetCreated = _isMaterialTable ?
+        UpdateMaterialTable ( renderer ) :
+        CreateDescriptorSet ( renderer );
+
+    if ( !isDescriptorSetCreated )
     {
         OnDestroy ( renderer );
         return false;
@@ -455,20 +719,72 @@ bool Game::OnInit ( android_vulkan::Renderer &renderer )
         return false;
     }
 
+    if ( RECORD_BENCHMARK && !BenchmarkRecording ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
+    if ( UNIFORM_BUFFER_BENCHMARK && !BenchmarkUniformBuffer ( renderer ) )
+    {
+        OnDestroy ( renderer );
+        return false;
+    }
+
+#ifdef ANDROID_VULKAN_DEBUG
+
+    android_vulkan::MemoryAllocatorStats stats {};
+    renderer.GetMemoryAllocatorStats ( stats );
+
+    constexpr const double toKiB = 1.0 / 1024.0;
+
+    android_vulkan::LogInfo (
+        "Game::OnInit - Device memory: allocations %zu, blocks %zu (dedicated %zu), used %g KiB, "
+        "reserved %g KiB, fragmentation %g",
+        stats._allocations,
+        stats._blocks,
+        stats._dedicatedBlocks,
+        static_cast<double> ( stats._bytesUsed ) * toKiB,
+        static_cast<double> ( stats._bytesReserved ) * toKiB,
+        static_cast<double> ( stats._fragmentation )
+    );
+
+    android_vulkan::FileStats fileStats {};
+    android_vulkan::File::GetStats ( fileStats );
+
+    android_vulkan::LogInfo ( "Game::OnInit - Files: copied %g KiB, mapped %g KiB, load time %g ms",
+        static_cast<double> ( fileStats._copiedBytes ) * toKiB,
+        static_cast<double> ( fileStats._mappedBytes ) * toKiB,
+        fileStats._loadTime * 1.0e+3
+    );
+
+#endif // ANDROID_VULKAN_DEBUG
+
     return true;
 }
 
 bool Game::OnFrame ( android_vulkan::Renderer &renderer, double deltaTime )
 {
-    if ( !UpdateUniformBuffer ( renderer, deltaTime ) )
-        return false;
-
     size_t imageIndex = SIZE_MAX;
 
     if ( !BeginFrame ( imageIndex, renderer ) )
         return false;
 
-    const CommandContext& commandContext = _commandBuffers[ imageIndex ];
+    // Releasing transfer resources of the completed uploads. The call never waits GPU.
+    if ( !_uploadScheduler.Poll () )
+        return false;
+
+    if ( !UpdateStreaming ( renderer ) )
+        return false;
+
+    // Note the fence of the frame has been already waited. So the slice of the transform buffer is not used by GPU.
+    if ( !UpdateUniformBuffer ( renderer, _frameIndex, deltaTime ) )
+        return false;
+
+    if ( !RecordCommandBuffer ( renderer, imageIndex ) )
+        return false;
+
+    const FrameInFlight& frame = _framesInFlight[ _frameIndex ];
 
     constexpr const VkPipelineStageFlags waitStage =
         AV_VK_FLAG ( VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT ) |
@@ -479,15 +795,15 @@ bool Game::OnFrame ( android_vulkan::Renderer &renderer, double deltaTime )
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.pNext = nullptr;
     submitInfo.commandBufferCount = 1U;
-    submitInfo.pCommandBuffers = &commandContext.first;
+    submitInfo.pCommandBuffers = &frame._commandBuffer;
     submitInfo.waitSemaphoreCount = 1U;
     submitInfo.pWaitDstStageMask = &waitStage;
-    submitInfo.pWaitSemaphores = &_renderTargetAcquiredSemaphore;
+    submitInfo.pWaitSemaphores = &frame._renderTargetAcquiredSemaphore;
     submitInfo.signalSemaphoreCount = 1U;
-    submitInfo.pSignalSemaphores = &_renderPassEndSemaphore;
+    submitInfo.pSignalSemaphores = &_renderPassEndSemaphores[ imageIndex ];
 
     const bool result = renderer.CheckVkResult (
-        vkQueueSubmit ( renderer.GetQueue (), 1U, &submitInfo, commandContext.second ),
+        vkQueueSubmit ( renderer.GetQueue (), 1U, &submitInfo, frame._fence ),
         "Game::OnFrame",
         "Can't submit command buffer"
     );
@@ -495,7 +811,20 @@ bool Game::OnFrame ( android_vulkan::Renderer &renderer, double deltaTime )
     if ( !result )
         return false;
 
-    return EndFrame ( static_cast<size_t> ( imageIndex ), renderer );
+#ifdef ANDROID_VULKAN_DEBUG
+
+    if ( _isFirstFrame )
+    {
+        const std::chrono::duration<double, std::milli> delta = std::chrono::steady_clock::now () - _streamingStart;
+        android_vulkan::LogInfo ( "Game::OnFrame - First frame is submitted in %g ms.", delta.count () );
+    }
+
+#endif // ANDROID_VULKAN_DEBUG
+
+    _isFirstFrame = false;
+    UpdateUniformBufferStatistics ( deltaTime );
+    _frameIndex = ( _frameIndex + 1U ) % FRAMES_IN_FLIGHT;
+    return EndFrame ( static_cast<uint32_t> ( imageIndex ), renderer );
 }
 
 bool Game::OnDestroy ( android_vulkan::Renderer &renderer )
@@ -508,55 +837,102 @@ bool Game::OnDestroy ( android_vulkan::Renderer &renderer )
     if ( !result )
         return false;
 
+    // Note the pending requests are cancelled by the asset loader. Results of the completed requests are dropped.
+    for ( auto& item : _meshFiles )
+        item = {};
+
+    for ( auto& item : _textureFiles )
+        item = {};
+
+    // Note decoder jobs write into the transfer memory. So they must be completed before the transfer resources
+    // are released by the upload scheduler.
+    _textureDecoder.Destroy ();
+    _uploadScheduler.Destroy ();
+    _mipmapGenerator.Destroy ( renderer );
+    _gpuCulling.Destroy ( renderer );
     DestroyDescriptorSet ( renderer );
     DestroyPipeline ( renderer );
     DestroyPipelineLayout ( renderer );
+    _materialTable.Destroy ( renderer );
     DestroyShaderModules ( renderer );
     DestroySamplers ( renderer );
     DestroyMeshes ( renderer );
     DestroyTextures ( renderer );
     DestroyUniformBuffer ();
+    DestroyCommandBuffers ( renderer );
     DestroyCommandPool ( renderer );
+    _gpuTimer.Destroy ( renderer );
     DestroySyncPrimitives ( renderer );
     DestroyFramebuffers ( renderer );
     DestroyRenderPass ( renderer );
 
+    _scene.clear ();
+    _sceneBounds.clear ();
+    _sceneVisibility.reset ();
+    _visibleScene.clear ();
+    _streamingState = eStreamingState::Idle;
     return true;
 }
 
 bool Game::BeginFrame ( size_t &imageIndex, android_vulkan::Renderer &renderer )
 {
     VkDevice device = renderer.GetDevice ();
-    uint32_t i = UINT32_MAX;
+    const FrameInFlight& frame = _framesInFlight[ _frameIndex ];
+    bool result;
 
-    bool result = renderer.CheckVkResult (
-        vkAcquireNextImageKHR ( device,
-            renderer.GetSwapchain (),
-            UINT64_MAX,
-            _renderTargetAcquiredSemaphore,
-            VK_NULL_HANDLE,
-            &i
-        ),
+    // Note the fence is waited before the acquire. So the acquire semaphore of the frame is not pending anymore.
+    {
+        const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::FenceWait );
 
-        "Game::BeginFrame",
-        "Can't get presentation image index"
-    );
+        result = renderer.CheckVkResult ( vkWaitForFences ( device, 1U, &frame._fence, VK_TRUE, UINT64_MAX ),
+            "Game::BeginFrame",
+            "Can't wait fence"
+        );
+    }
 
     if ( !result )
         return false;
 
-    imageIndex = static_cast<size_t> ( i );
-    const CommandContext& commandContext = _commandBuffers[ imageIndex ];
+    // Note the GPU time belongs to the previous frame which used the same slot.
+    float gpuTime = 0.0F;
 
-    result = renderer.CheckVkResult ( vkWaitForFences ( device, 1U, &commandContext.second, VK_TRUE, UINT64_MAX ),
-        "Game::BeginFrame",
-        "Can't wait fence"
-    );
+    if ( android_vulkan::g_FrameTiming && _gpuTimer.Resolve ( gpuTime, device, _frameIndex ) )
+        android_vulkan::g_FrameTiming->Record ( android_vulkan::eFrameTimingStage::GPU, gpuTime );
+
+#ifdef ANDROID_VULKAN_DEBUG
+
+    // Note the results belong to the previous frame which used the same slot. Its fence has been waited.
+    if ( _isGPUCulling && ++_gpuCullingFrames % CULLING_CHECK_PERIOD == 0U )
+        _gpuCulling.Verify ( _frameIndex );
+
+#endif // ANDROID_VULKAN_DEBUG
+
+    uint32_t i = UINT32_MAX;
+
+    {
+        const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Acquire );
+
+        result = renderer.CheckVkResult (
+            vkAcquireNextImageKHR ( device,
+                renderer.GetSwapchain (),
+                UINT64_MAX,
+                frame._renderTargetAcquiredSemaphore,
+                VK_NULL_HANDLE,
+                &i
+            ),
+
+            "Game::BeginFrame",
+            "Can't get presentation image index"
+        );
+    }
 
     if ( !result )
         return false;
 
-    return renderer.CheckVkResult ( vkResetFences ( device, 1U, &commandContext.second ),
+    imageIndex = static_cast<size_t> ( i );
+
+    // Note the fence is reset only when the frame is going to be submitted. Otherwise next wait would never end.
+    return renderer.CheckVkResult ( vkResetFences ( device, 1U, &frame._fence ),
         "Game::BeginFrame",
         "Can't reset fence"
     );
@@ -570,12 +946,14 @@ bool Game::EndFrame ( uint32_t presentationImageIndex, android_vulkan::Renderer
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.pNext = nullptr;
     presentInfo.waitSemaphoreCount = 1U;
-    presentInfo.pWaitSemaphores = &_renderPassEndSemaphore;
+    presentInfo.pWaitSemaphores = &_renderPassEndSemaphores[ presentationImageIndex ];
     presentInfo.pResults = &presentResult;
     presentInfo.swapchainCount = 1U;
     presentInfo.pSwapchains = &renderer.GetSwapchain ();
     presentInfo.pImageIndices = &presentationImageIndex;
 
+    const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Present );
+
     const bool result = renderer.CheckVkResult ( vkQueuePresentKHR ( renderer.GetQueue (), &presentInfo ),
         "Game::EndFrame",
         "Can't present frame"
@@ -610,23 +988,10 @@ bool Game::CreateCommandPool ( android_vulkan::Renderer &renderer )
 
 void Game::DestroyCommandPool ( android_vulkan::Renderer &renderer )
 {
-    VkDevice device = renderer.GetDevice ();
-
-    if ( !_commandBuffers.empty () )
-    {
-        for ( const auto& item : _commandBuffers )
-        {
-            vkDestroyFence ( device, item.second, nullptr );
-            AV_UNREGISTER_FENCE ( "Game::_commandBuffers::_fence" )
-        }
-
-        _commandBuffers.clear ();
-    }
-
     if ( _commandPool == VK_NULL_HANDLE )
         return;
 
-    vkDestroyCommandPool ( device, _commandPool, nullptr );
+    vkDestroyCommandPool ( renderer.GetDevice (), _commandPool, nullptr );
     _commandPool = VK_NULL_HANDLE;
     AV_UNREGISTER_COMMAND_POOL ( "Game::_commandPool" )
 }
@@ -647,6 +1012,8 @@ void Game::DestroyMeshes ( android_vulkan::Renderer &renderer )
     {
         item._mesh.FreeResources ( renderer );
     }
+
+    _instances.FreeResources ( renderer );
 }
 
 bool Game::CreateFramebuffers ( android_vulkan::Renderer &renderer )
@@ -660,6 +1027,11 @@ bool Game::CreateFramebuffers ( android_vulkan::Renderer &renderer )
     imageInfo.flags = 0U;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    // The content is never stored. See Game::CreateRenderPass.
+    if ( DEPTH_STENCIL_MEMORY == eDepthStencilMemory::Transient )
+        imageInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
     imageInfo.format = renderer.GetDefaultDepthStencilFormat ();
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -685,9 +1057,32 @@ bool Game::CreateFramebuffers ( android_vulkan::Renderer &renderer )
     VkMemoryRequirements requirements;
     vkGetImageMemoryRequirements ( device, _depthStencil, &requirements );
 
+    constexpr const VkMemoryPropertyFlags lazyMemory =
+        AV_VK_FLAG ( VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT ) |
+        AV_VK_FLAG ( VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT );
+
+    uint32_t memoryTypeIndex = UINT32_MAX;
+    VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    if ( DEPTH_STENCIL_MEMORY == eDepthStencilMemory::Transient )
+    {
+        if ( renderer.SelectTargetMemoryTypeIndex ( memoryTypeIndex, requirements, lazyMemory ) )
+        {
+            memoryProperties = lazyMemory;
+            android_vulkan::LogInfo ( "Game::CreateFramebuffers - Depth stencil uses lazily allocated memory." );
+        }
+        else
+        {
+            android_vulkan::LogInfo ( "Game::CreateFramebuffers - Lazily allocated memory is not available. "
+                "Depth stencil uses device local memory."
+            );
+        }
+    }
+
     result = renderer.TryAllocateMemory ( _depthStencilMemory,
+        _depthStencilMemoryOffset,
         requirements,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        memoryProperties,
         "Can't allocate memory (Game::CreateFramebuffers)"
     );
 
@@ -696,7 +1091,8 @@ bool Game::CreateFramebuffers ( android_vulkan::Renderer &renderer )
 
     AV_REGISTER_DEVICE_MEMORY ( "Game::_depthStencilMemory" )
 
-    result = renderer.CheckVkResult ( vkBindImageMemory ( device, _depthStencil, _depthStencilMemory, 0U ),
+    result = renderer.CheckVkResult (
+        vkBindImageMemory ( device, _depthStencil, _depthStencilMemory, _depthStencilMemoryOffset ),
         "Game::CreateFramebuffers",
         "Can't bind depth stencil memory"
     );
@@ -790,8 +1186,9 @@ void Game::DestroyFramebuffers ( android_vulkan::Renderer &renderer )
 
     if ( _depthStencilMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _depthStencilMemory, nullptr );
+        renderer.FreeMemory ( _depthStencilMemory, _depthStencilMemoryOffset );
         _depthStencilMemory = VK_NULL_HANDLE;
+        _depthStencilMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "Game::_depthStencilMemory" )
     }
 
@@ -805,24 +1202,46 @@ void Game::DestroyFramebuffers ( android_vulkan::Renderer &renderer )
 
 bool Game::CreatePipeline ( android_vulkan::Renderer &renderer )
 {
-    VkPipelineShaderStageCreateInfo stageInfo[ 2U ];
-    VkPipelineShaderStageCreateInfo& vertexStage = stageInfo[ 0U ];
-    vertexStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertexStage.pNext = nullptr;
-    vertexStage.flags = 0U;
-    vertexStage.pSpecializationInfo = nullptr;
-    vertexStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertexStage.module = _vertexShaderModule;
-    vertexStage.pName = VERTEX_SHADER_ENTRY_POINT;
-
-    VkPipelineShaderStageCreateInfo& fragmentStage = stageInfo[ 1U ];
-    fragmentStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragmentStage.pNext = nullptr;
-    fragmentStage.flags = 0U;
-    fragmentStage.pSpecializationInfo = nullptr;
-    fragmentStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragmentStage.module = _fragmentShaderModule;
-    fragmentStage.pName = FRAGMENT_SHADER_ENTRY_POINT;
+    // Every vertex format has its own vertex shader and vertex input state. Other state is shared.
+    VkPipelineShaderStageCreateInfo stageInfo[ VERTEX_FORMAT_COUNT ][ 2U ];
+    VkVertexInputAttributeDescription attributeDescriptions[ VERTEX_FORMAT_COUNT ][ 9U ];
+    VkVertexInputBindingDescription bindingDescriptions[ VERTEX_FORMAT_COUNT ][ 2U ];
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo[ VERTEX_FORMAT_COUNT ];
+
+    for ( size_t i = 0U; i < VERTEX_FORMAT_COUNT; ++i )
+    {
+        VkPipelineShaderStageCreateInfo& vertexStage = stageInfo[ i ][ 0U ];
+        vertexStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertexStage.pNext = nullptr;
+        vertexStage.flags = 0U;
+        vertexStage.pSpecializationInfo = nullptr;
+        vertexStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertexStage.module = _vertexShaderModules[ i ];
+        vertexStage.pName = VERTEX_SHADER_ENTRY_POINT;
+
+        VkPipelineShaderStageCreateInfo& fragmentStage = stageInfo[ i ][ 1U ];
+        fragmentStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragmentStage.pNext = nullptr;
+        fragmentStage.flags = 0U;
+        fragmentStage.pSpecializationInfo = nullptr;
+        fragmentStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragmentStage.module = _fragmentShaderModule;
+        fragmentStage.pName = FRAGMENT_SHADER_ENTRY_POINT;
+
+        VkPipelineVertexInputStateCreateInfo& inputInfo = vertexInputInfo[ i ];
+        inputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        inputInfo.pNext = nullptr;
+        inputInfo.flags = 0U;
+
+        inputInfo.vertexAttributeDescriptionCount = InitVertexInput ( attributeDescriptions[ i ],
+            bindingDescriptions[ i ],
+            static_cast<eVertexFormat> ( i )
+        );
+
+        inputInfo.pVertexAttributeDescriptions = attributeDescriptions[ i ];
+        inputInfo.vertexBindingDescriptionCount = static_cast<uint32_t> ( std::size ( bindingDescriptions[ i ] ) );
+        inputInfo.pVertexBindingDescriptions = bindingDescriptions[ i ];
+    }
 
     VkPipelineInputAssemblyStateCreateInfo assemblyInfo;
     assemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -831,51 +1250,6 @@ bool Game::CreatePipeline ( android_vulkan::Renderer &renderer )
     assemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     assemblyInfo.primitiveRestartEnable = VK_FALSE;
 
-    VkVertexInputAttributeDescription attributeDescriptions[ 5U ];
-    VkVertexInputAttributeDescription& vertexDescription = attributeDescriptions[ 0U ];
-    vertexDescription.location = 0U;
-    vertexDescription.binding = 0U;
-    vertexDescription.offset = static_cast<uint32_t> ( offsetof ( VertexInfo, _vertex ) );
-    vertexDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-
-    VkVertexInputAttributeDescription& uvDescription = attributeDescriptions[ 1U ];
-    uvDescription.location = 1U;
-    uvDescription.binding = 0U;
-    uvDescription.offset = static_cast<uint32_t> ( offsetof ( VertexInfo, _uv ) );
-    uvDescription.format = VK_FORMAT_R32G32_SFLOAT;
-
-    VkVertexInputAttributeDescription& normalDescription = attributeDescriptions[ 2U ];
-    normalDescription.location = 2U;
-    normalDescription.binding = 0U;
-    normalDescription.offset = static_cast<uint32_t> ( offsetof ( VertexInfo, _normal ) );
-    normalDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-
-    VkVertexInputAttributeDescription& tangentDescription = attributeDescriptions[ 3U ];
-    tangentDescription.location = 3U;
-    tangentDescription.binding = 0U;
-    tangentDescription.offset = static_cast<uint32_t> ( offsetof ( VertexInfo, _tangent ) );
-    tangentDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-
-    VkVertexInputAttributeDescription& bitangentDescription = attributeDescriptions[ 4U ];
-    bitangentDescription.location = 4U;
-    bitangentDescription.binding = 0U;
-    bitangentDescription.offset = static_cast<uint32_t> ( offsetof ( VertexInfo, _bitangent ) );
-    bitangentDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-
-    VkVertexInputBindingDescription bindingDescription;
-    bindingDescription.binding = 0U;
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-    bindingDescription.stride = sizeof ( VertexInfo );
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo;
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.pNext = nullptr;
-    vertexInputInfo.flags = 0U;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t> ( std::size ( attributeDescriptions ) );
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
-    vertexInputInfo.vertexBindingDescriptionCount = 1U;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-
     VkPipelineDepthStencilStateCreateInfo depthStencilInfo;
     depthStencilInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencilInfo.pNext = nullptr;
@@ -971,48 +1345,111 @@ bool Game::CreatePipeline ( android_vulkan::Renderer &renderer )
     viewportInfo.scissorCount = 1U;
     viewportInfo.pScissors = &scissor;
 
-    VkGraphicsPipelineCreateInfo pipelineInfo;
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.pNext = nullptr;
-    pipelineInfo.flags = 0U;
-    pipelineInfo.subpass = 0U;
-    pipelineInfo.stageCount = static_cast<uint32_t> ( std::size ( stageInfo ) );
-    pipelineInfo.pStages = stageInfo;
-    pipelineInfo.renderPass = _renderPass;
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = _pipelineLayout;
-    pipelineInfo.basePipelineIndex = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineInfo.pInputAssemblyState = &assemblyInfo;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pTessellationState = nullptr;
-    pipelineInfo.pDepthStencilState = &depthStencilInfo;
-    pipelineInfo.pRasterizationState = &rasterizationInfo;
-    pipelineInfo.pViewportState = &viewportInfo;
-    pipelineInfo.pColorBlendState = &blendInfo;
-    pipelineInfo.pMultisampleState = &multisampleInfo;
+    VkGraphicsPipelineCreateInfo pipelineInfo[ VERTEX_FORMAT_COUNT ];
 
-    const bool result = renderer.CheckVkResult (
-        vkCreateGraphicsPipelines ( renderer.GetDevice (), VK_NULL_HANDLE, 1U, &pipelineInfo, nullptr, &_pipeline ),
-        "Game::CreatePipeline",
-        "Can't create pipeline"
+    for ( size_t i = 0U; i < VERTEX_FORMAT_COUNT; ++i )
+    {
+        VkGraphicsPipelineCreateInfo& info = pipelineInfo[ i ];
+        info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.pNext = nullptr;
+        info.flags = 0U;
+        info.subpass = 0U;
+        info.stageCount = static_cast<uint32_t> ( std::size ( stageInfo[ i ] ) );
+        info.pStages = stageInfo[ i ];
+        info.renderPass = _renderPass;
+        info.pDynamicState = nullptr;
+        info.layout = _pipelineLayout;
+        info.basePipelineIndex = 0;
+        info.basePipelineHandle = VK_NULL_HANDLE;
+        info.pInputAssemblyState = &assemblyInfo;
+        info.pVertexInputState = &vertexInputInfo[ i ];
+        info.pTessellationState = nullptr;
+        info.pDepthStencilState = &depthStencilInfo;
+        info.pRasterizationState = &rasterizationInfo;
+        info.pViewportState = &viewportInfo;
+        info.pColorBlendState = &blendInfo;
+        info.pMultisampleState = &multisampleInfo;
+    }
+
+    const auto pipelineBegin = std::chrono::steady_clock::now ();
+
+    const VkResult vulkanResult = vkCreateGraphicsPipelines ( renderer.GetDevice (),
+        renderer.GetPipelineCache (),
+        static_cast<uint32_t> ( VERTEX_FORMAT_COUNT ),
+        pipelineInfo,
+        nullptr,
+        _pipelines
     );
 
-    if ( !result )
+    // Note some pipelines could be created even if the call fails.
+    for ( VkPipeline pipeline : _pipelines )
+    {
+        if ( pipeline == VK_NULL_HANDLE )
+            continue;
+
+        AV_REGISTER_PIPELINE ( "Game::_pipelines" )
+    }
+
+    if ( !renderer.CheckVkResult ( vulkanResult, "Game::CreatePipeline", "Can't create pipelines" ) )
         return false;
 
-    AV_REGISTER_PIPELINE ( "Game::_pipeline" )
+    const std::chrono::duration<double, std::milli> pipelineTime = std::chrono::steady_clock::now () - pipelineBegin;
+
+    android_vulkan::LogInfo ( "Game::CreatePipeline - Pipelines are created in %g ms (%s pipeline cache).",
+        pipelineTime.count (),
+        renderer.IsPipelineCacheWarm () ? "warm" : "cold"
+    );
+
     return true;
 }
 
 void Game::DestroyPipeline ( android_vulkan::Renderer &renderer )
 {
-    if ( _pipeline == VK_NULL_HANDLE )
-        return;
+    VkDevice device = renderer.GetDevice ();
+
+    for ( VkPipeline& pipeline : _pipelines )
+    {
+        if ( pipeline == VK_NULL_HANDLE )
+            continue;
 
-    vkDestroyPipeline ( renderer.GetDevice (), _pipeline, nullptr );
-    _pipeline = VK_NULL_HANDLE;
-    AV_UNREGISTER_PIPELINE ( "Game::_pipeline" )
+        vkDestroyPipeline ( device, pipeline, nullptr );
+        pipeline = VK_NULL_HANDLE;
+        AV_UNREGISTER_PIPELINE ( "Game::_pipelines" )
+    }
+}
+
+bool Game::CreateMaterialTablePipelineLayout ( android_vulkan::Renderer &renderer )
+{
+    if ( !CreateMaterialTable ( renderer ) )
+        return false;
+
+    VkPushConstantRange pushConstantRange;
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0U;
+    pushConstantRange.size = static_cast<uint32_t> ( sizeof ( uint32_t ) );
+
+    const VkDescriptorSetLayout descriptorSetLayout = _materialTable.GetDescriptorSetLayout ();
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo;
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.pNext = nullptr;
+    pipelineLayoutInfo.flags = 0U;
+    pipelineLayoutInfo.pushConstantRangeCount = 1U;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    pipelineLayoutInfo.setLayoutCount = 1U;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+
+    const bool result = renderer.CheckVkResult (
+        vkCreatePipelineLayout ( renderer.GetDevice (), &pipelineLayoutInfo, nullptr, &_pipelineLayout ),
+        "Game::CreateMaterialTablePipelineLayout",
+        "Can't create pipeline layout"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_PIPELINE_LAYOUT ( "Game::_pipelineLayout" )
+    return true;
 }
 
 void Game::DestroyPipelineLayout ( android_vulkan::Renderer &renderer )
@@ -1055,7 +1492,9 @@ bool Game::CreateRenderPass ( android_vulkan::Renderer &renderer )
     depthStencilAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     depthStencilAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     depthStencilAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    // The depth is not read after the pass. So the tile-based GPUs do not write it into the memory.
+    depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthStencilAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
@@ -1079,14 +1518,34 @@ bool Game::CreateRenderPass ( android_vulkan::Renderer &renderer )
     subpassInfo.pInputAttachments = nullptr;
     subpassInfo.pResolveAttachments = nullptr;
 
+    // Frames in flight share the depth buffer. So the depth clear of the frame must wait depth writes of the previous
+    // frame. The color part covers the layout transition of the acquired image after the semaphore wait.
+    VkSubpassDependency dependency;
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0U;
+
+    dependency.srcStageMask = AV_VK_FLAG ( VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT ) |
+        AV_VK_FLAG ( VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT );
+
+    dependency.dstStageMask = AV_VK_FLAG ( VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT ) |
+        AV_VK_FLAG ( VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT );
+
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    dependency.dstAccessMask = AV_VK_FLAG ( VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT ) |
+        AV_VK_FLAG ( VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT ) |
+        AV_VK_FLAG ( VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT );
+
+    dependency.dependencyFlags = 0U;
+
     VkRenderPassCreateInfo renderPassInfo;
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     renderPassInfo.pNext = nullptr;
     renderPassInfo.flags = 0U;
     renderPassInfo.attachmentCount = static_cast<uint32_t> ( std::size ( attachmentInfo ) );
     renderPassInfo.pAttachments = attachmentInfo;
-    renderPassInfo.dependencyCount = 0U;
-    renderPassInfo.pDependencies = nullptr;
+    renderPassInfo.dependencyCount = 1U;
+    renderPassInfo.pDependencies = &dependency;
     renderPassInfo.subpassCount = 1U;
     renderPassInfo.pSubpasses = &subpassInfo;
 
@@ -1115,18 +1574,21 @@ void Game::DestroyRenderPass ( android_vulkan::Renderer &renderer )
 
 bool Game::CreateShaderModules ( android_vulkan::Renderer &renderer )
 {
-    bool result = renderer.CreateShader ( _vertexShaderModule,
-        VERTEX_SHADER,
-        "Can't create vertex shader (Game::CreateShaderModules)"
-    );
+    for ( size_t i = 0U; i < VERTEX_FORMAT_COUNT; ++i )
+    {
+        const bool result = renderer.CreateShader ( _vertexShaderModules[ i ],
+            VERTEX_SHADERS[ i ],
+            "Can't create vertex shader (Game::CreateShaderModules)"
+        );
 
-    if ( !result )
-        return false;
+        if ( !result )
+            return false;
 
-    AV_REGISTER_SHADER_MODULE ( "Game::_vertexShaderModule" )
+        AV_REGISTER_SHADER_MODULE ( "Game::_vertexShaderModules" )
+    }
 
-    result = renderer.CreateShader ( _fragmentShaderModule,
-        _fragmentShader,
+    const bool result = renderer.CreateShader ( _fragmentShaderModule,
+        _isMaterialTable ? _fragmentShaderMaterialTable : _fragmentShader,
         "Can't create fragment shader (Game::CreateShaderModules)"
     );
 
@@ -1148,12 +1610,15 @@ void Game::DestroyShaderModules ( android_vulkan::Renderer &renderer )
         AV_UNREGISTER_SHADER_MODULE ( "Game::_fragmentShaderModule" )
     }
 
-    if ( _vertexShaderModule == VK_NULL_HANDLE )
-        return;
+    for ( VkShaderModule& module : _vertexShaderModules )
+    {
+        if ( module == VK_NULL_HANDLE )
+            continue;
 
-    vkDestroyShaderModule ( device, _vertexShaderModule, nullptr );
-    _vertexShaderModule = VK_NULL_HANDLE;
-    AV_UNREGISTER_SHADER_MODULE ( "Game::_vertexShaderModule" )
+        vkDestroyShaderModule ( device, module, nullptr );
+        module = VK_NULL_HANDLE;
+        AV_UNREGISTER_SHADER_MODULE ( "Game::_vertexShaderModules" )
+    }
 }
 
 bool Game::CreateSyncPrimitives ( android_vulkan::Renderer &renderer )
@@ -1165,26 +1630,60 @@ bool Game::CreateSyncPrimitives ( android_vulkan::Renderer &renderer )
     semaphoreInfo.pNext = nullptr;
     semaphoreInfo.flags = 0U;
 
-    bool result = renderer.CheckVkResult ( vkCreateSemaphore ( device, &semaphoreInfo, nullptr, &_renderPassEndSemaphore ),
-        "Game::CreateSyncPrimitives",
-        "Can't create render pass end semaphore"
-    );
+    VkFenceCreateInfo fenceInfo;
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.pNext = nullptr;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    if ( !result )
-        return false;
+    _frameIndex = 0U;
+    _framesInFlight.reserve ( FRAMES_IN_FLIGHT );
 
-    AV_REGISTER_SEMAPHORE ( "Game::_renderPassEndSemaphore" )
+    for ( size_t i = 0U; i < FRAMES_IN_FLIGHT; ++i )
+    {
+        // Note value initialization sets all handles to VK_NULL_HANDLE.
+        FrameInFlight& frame = _framesInFlight.emplace_back ();
 
-    result = renderer.CheckVkResult (
-        vkCreateSemaphore ( device, &semaphoreInfo, nullptr, &_renderTargetAcquiredSemaphore ),
-        "Game::CreateSyncPrimitives",
-        "Can't create render target acquired semaphore"
-    );
+        bool result = renderer.CheckVkResult ( vkCreateFence ( device, &fenceInfo, nullptr, &frame._fence ),
+            "Game::CreateSyncPrimitives",
+            "Can't create fence"
+        );
 
-    if ( !result )
-        return false;
+        if ( !result )
+            return false;
+
+        AV_REGISTER_FENCE ( "Game::_framesInFlight::_fence" )
+
+        result = renderer.CheckVkResult (
+            vkCreateSemaphore ( device, &semaphoreInfo, nullptr, &frame._renderTargetAcquiredSemaphore ),
+            "Game::CreateSyncPrimitives",
+            "Can't create render target acquired semaphore"
+        );
+
+        if ( !result )
+            return false;
+
+        AV_REGISTER_SEMAPHORE ( "Game::_framesInFlight::_renderTargetAcquiredSemaphore" )
+    }
+
+    const size_t imageCount = renderer.GetPresentImageCount ();
+    _renderPassEndSemaphores.reserve ( imageCount );
+
+    for ( size_t i = 0U; i < imageCount; ++i )
+    {
+        VkSemaphore& semaphore = _renderPassEndSemaphores.emplace_back ( VK_NULL_HANDLE );
+
+        const bool result = renderer.CheckVkResult (
+            vkCreateSemaphore ( device, &semaphoreInfo, nullptr, &semaphore ),
+            "Game::CreateSyncPrimitives",
+            "Can't create render pass end semaphore"
+        );
+
+        if ( !result )
+            return false;
+
+        AV_REGISTER_SEMAPHORE ( "Game::_renderPassEndSemaphores" )
+    }
 
-    AV_REGISTER_SEMAPHORE ( "Game::_renderTargetAcquiredSemaphore" )
     return true;
 }
 
@@ -1192,28 +1691,65 @@ void Game::DestroySyncPrimitives ( android_vulkan::Renderer &renderer )
 {
     VkDevice device = renderer.GetDevice ();
 
-    if ( _renderTargetAcquiredSemaphore != VK_NULL_HANDLE )
+    for ( auto& frame : _framesInFlight )
     {
-        vkDestroySemaphore ( device, _renderTargetAcquiredSemaphore, nullptr );
-        _renderTargetAcquiredSemaphore = VK_NULL_HANDLE;
-        AV_UNREGISTER_SEMAPHORE ( "Game::_renderTargetAcquiredSemaphore" )
+        if ( frame._renderTargetAcquiredSemaphore != VK_NULL_HANDLE )
+        {
+            vkDestroySemaphore ( device, frame._renderTargetAcquiredSemaphore, nullptr );
+            AV_UNREGISTER_SEMAPHORE ( "Game::_framesInFlight::_renderTargetAcquiredSemaphore" )
+        }
+
+        if ( frame._fence == VK_NULL_HANDLE )
+            continue;
+
+        vkDestroyFence ( device, frame._fence, nullptr );
+        AV_UNREGISTER_FENCE ( "Game::_framesInFlight::_fence" )
     }
 
-    if ( _renderPassEndSemaphore == VK_NULL_HANDLE )
-        return;
+    _framesInFlight.clear ();
+
+    for ( auto semaphore : _renderPassEndSemaphores )
+    {
+        if ( semaphore == VK_NULL_HANDLE )
+            continue;
+
+        vkDestroySemaphore ( device, semaphore, nullptr );
+        AV_UNREGISTER_SEMAPHORE ( "Game::_renderPassEndSemaphores" )
+    }
 
-    vkDestroySemaphore ( device, _renderPassEndSemaphore, nullptr );
-    _renderPassEndSemaphore = VK_NULL_HANDLE;
-    AV_UNREGISTER_SEMAPHORE ( "Game::_renderPassEndSemaphore" )
+    _renderPassEndSemaphores.clear ();
 }
 
 bool Game::CreateUniformBuffer ( android_vulkan::Renderer& renderer )
 {
-    if ( !_transformBuffer.Init ( renderer, _commandPool, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT ) )
+    bool result;
+
+    if constexpr ( TRANSFORM_BUFFER_MODE == eUniformBufferMode::PersistentRing )
+        result = _transformBuffer.InitRing ( renderer, FRAMES_IN_FLIGHT );
+    else
+        result = _transformBuffer.Init ( renderer, _commandPool, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT );
+
+    if ( !result )
         return false;
 
     _transform._transform = renderer.GetPresentationEngineTransform ();
-    return _transformBuffer.Update ( reinterpret_cast<const uint8_t*> ( &_transform ), sizeof ( _transform ) );
+    const size_t sliceCount = _transformBuffer.GetSliceCount ();
+
+    for ( size_t i = 0U; i < sliceCount; ++i )
+    {
+        result = _transformBuffer.Update ( reinterpret_cast<const uint8_t*> ( &_transform ),
+            sizeof ( _transform ),
+            i
+        );
+
+        if ( !result )
+            return false;
+    }
+
+    _transformBuffer.ResetStatistics ();
+    _uniformBufferStatTime = 0.0;
+    _uniformBufferStatFrames = 0U;
+    return true;
 }
 
 void Game::DestroyUniformBuffer ()
@@ -1223,21 +1759,258 @@ void Game::DestroyUniformBuffer ()
 
 bool Game::InitCommandBuffers ( android_vulkan::Renderer &renderer )
 {
-    const size_t framebufferCount = renderer.GetPresentImageCount ();
+    // Note the calling thread records a batch too.
+    _recordBatches = std::min ( MAX_RECORD_BATCHES, android_vulkan::g_JobSystem->GetWorkerCount () + 1U );
+
+    VkCommandPoolCreateInfo poolInfo;
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.pNext = nullptr;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = renderer.GetQueueFamilyIndex ();
 
     VkCommandBufferAllocateInfo allocateInfo;
     allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocateInfo.pNext = nullptr;
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfo.commandBufferCount = static_cast<uint32_t> ( framebufferCount );
-    allocateInfo.commandPool = _commandPool;
+    allocateInfo.commandBufferCount = 1U;
+
+    VkDevice device = renderer.GetDevice ();
+
+    for ( auto& frame : _framesInFlight )
+    {
+        bool result = renderer.CheckVkResult ( vkCreateCommandPool ( device, &poolInfo, nullptr, &frame._commandPool ),
+            "Game::InitCommandBuffers",
+            "Can't create command pool"
+        );
+
+        if ( !result )
+            return false;
+
+        AV_REGISTER_COMMAND_POOL ( "Game::_framesInFlight::_commandPool" )
+
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandPool = frame._commandPool;
+
+        result = renderer.CheckVkResult ( vkAllocateCommandBuffers ( device, &allocateInfo, &frame._commandBuffer ),
+            "Game::InitCommandBuffers",
+            "Can't allocate command buffer"
+        );
+
+        if ( !result )
+            return false;
+
+        frame._batchPools.resize ( _recordBatches, VK_NULL_HANDLE );
+        frame._batchBuffers.resize ( _recordBatches, VK_NULL_HANDLE );
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+        for ( size_t i = 0U; i < _recordBatches; ++i )
+        {
+            VkCommandPool& pool = frame._batchPools[ i ];
+
+            result = renderer.CheckVkResult ( vkCreateCommandPool ( device, &poolInfo, nullptr, &pool ),
+                "Game::InitCommandBuffers",
+                "Can't create batch command pool"
+            );
+
+            if ( !result )
+                return false;
+
+            AV_REGISTER_COMMAND_POOL ( "Game::_framesInFlight::_batchPools" )
+            allocateInfo.commandPool = pool;
+
+            result = renderer.CheckVkResult (
+                vkAllocateCommandBuffers ( device, &allocateInfo, &frame._batchBuffers[ i ] ),
+                "Game::InitCommandBuffers",
+                "Can't allocate batch command buffer"
+            );
+
+            if ( !result )
+                return false;
+        }
+    }
 
+    return true;
+}
+
+void Game::DestroyCommandBuffers ( android_vulkan::Renderer &renderer )
+{
     VkDevice device = renderer.GetDevice ();
-    std::vector<VkCommandBuffer> commandBuffers ( framebufferCount );
 
-    bool result = renderer.CheckVkResult ( vkAllocateCommandBuffers ( device, &allocateInfo, commandBuffers.data () ),
-        "Game::InitCommandBuffers",
-        "Can't allocate command buffers"
+    // Note the command buffers are released together with the pools.
+    for ( auto& frame : _framesInFlight )
+    {
+        for ( auto pool : frame._batchPools )
+        {
+            if ( pool == VK_NULL_HANDLE )
+                continue;
+
+            vkDestroyCommandPool ( device, pool, nullptr );
+            AV_UNREGISTER_COMMAND_POOL ( "Game::_framesInFlight::_batchPools" )
+        }
+
+        frame._batchPools.clear ();
+        frame._batchBuffers.clear ();
+        frame._commandBuffer = VK_NULL_HANDLE;
+
+        if ( frame._commandPool == VK_NULL_HANDLE )
+            continue;
+
+        vkDestroyCommandPool ( device, frame._commandPool, nullptr );
+        frame._commandPool = VK_NULL_HANDLE;
+        AV_UNREGISTER_COMMAND_POOL ( "Game::_framesInFlight::_commandPool" )
+    }
+
+    _recordBatches = 0U;
+}
+
+bool Game::CreateInstances ( std::vector<GXMat4> &instances,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+)
+{
+    // The draws of the same model share the placement. The models are placed on the grid in XZ plane. The instances
+    // of the model fill the cell of the grid. So all instances make single grid with INSTANCE_SPACING step.
+    constexpr size_t modelCount = ( SCENE_DRAW_COUNT + MATERIAL_COUNT - 1U ) / MATERIAL_COUNT;
+    const auto modelSide = static_cast<size_t> ( std::ceil ( std::sqrt ( static_cast<float> ( modelCount ) ) ) );
+    const auto side = static_cast<size_t> ( std::ceil ( std::sqrt ( static_cast<float> ( INSTANCE_COUNT ) ) ) );
+    const float offset = 0.5F * INSTANCE_SPACING * static_cast<float> ( modelSide * side - 1U );
+
+    instances.resize ( SCENE_DRAW_COUNT * static_cast<size_t> ( INSTANCE_COUNT ) );
+
+    // The first row is centered at the mesh origin. Other rows go away from the viewer.
+    for ( size_t i = 0U; i < SCENE_DRAW_COUNT; ++i )
+    {
+        const size_t model = i / MATERIAL_COUNT;
+        const size_t column = side * ( model % modelSide );
+        const size_t row = side * ( model / modelSide );
+
+        for ( size_t j = 0U; j < INSTANCE_COUNT; ++j )
+        {
+            const float x = INSTANCE_SPACING * static_cast<float> ( column + j % side ) - offset;
+            const float z = INSTANCE_SPACING * static_cast<float> ( row + j / side );
+            instances[ i * INSTANCE_COUNT + j ].Translation ( x, 0.0F, z );
+        }
+    }
+
+    // The compute shader of GPU mode reads the instances too.
+    const VkBufferUsageFlags usage = _isGPUCulling ?
+        AV_VK_FLAG ( VK_BUFFER_USAGE_VERTEX_BUFFER_BIT ) | AV_VK_FLAG ( VK_BUFFER_USAGE_STORAGE_BUFFER_BIT ) :
+        AV_VK_FLAG ( VK_BUFFER_USAGE_VERTEX_BUFFER_BIT );
+
+    const bool result = _instances.LoadMesh ( reinterpret_cast<const uint8_t*> ( instances.data () ),
+        instances.size () * sizeof ( GXMat4 ),
+        static_cast<uint32_t> ( instances.size () ),
+        usage,
+        renderer,
+        commandBuffer
+    );
+
+    if ( !result )
+        return false;
+
+    ReleaseOnUploadComplete ( renderer, _instances );
+    return true;
+}
+
+bool Game::CreateScene ( android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer,
+    const std::vector<GXMat4> &instances
+)
+{
+    _scene.reserve ( SCENE_DRAW_COUNT );
+    _sceneBounds.reserve ( SCENE_DRAW_COUNT );
+    _visibleScene.reserve ( SCENE_DRAW_COUNT );
+    _sceneVisibility = std::make_unique<GXBool[]> ( SCENE_DRAW_COUNT );
+
+    // The mesh bounds are transformed by every instance of the draw. GPU mode culls every instance separately. So
+    // it uses the instance bounds as is.
+    std::vector<GXAABB> objectBounds ( instances.size () );
+    std::vector<uint32_t> drawMaterials ( SCENE_DRAW_COUNT );
+
+    for ( size_t i = 0U; i < SCENE_DRAW_COUNT; ++i )
+    {
+        const size_t material = i % MATERIAL_COUNT;
+        const Drawcall* drawcall = &_drawcalls[ material ];
+        const size_t firstInstance = i * INSTANCE_COUNT;
+
+        SceneDraw& draw = _scene.emplace_back ();
+        draw._drawcall = drawcall;
+        draw._firstInstance = static_cast<uint32_t> ( firstInstance );
+
+        drawMaterials[ i ] = static_cast<uint32_t> ( material );
+
+        const GXAABB& mesh = drawcall->_mesh.GetBounds ();
+        GXAABB& bounds = _sceneBounds.emplace_back ();
+
+        for ( size_t j = firstInstance; j < firstInstance + INSTANCE_COUNT; ++j )
+        {
+            GXAABB& instanceBounds = objectBounds[ j ];
+            mesh.Transform ( instanceBounds, instances[ j ] );
+            bounds.AddVertex ( instanceBounds._min );
+            bounds.AddVertex ( instanceBounds._max );
+        }
+    }
+
+    if ( !_isGPUCulling )
+        return true;
+
+    const bool result = _gpuCulling.CreateScene ( renderer,
+        commandBuffer,
+        _drawcalls,
+        MATERIAL_COUNT,
+        drawMaterials.data (),
+        SCENE_DRAW_COUNT,
+        _instances.GetBuffer (),
+        INSTANCE_COUNT,
+        objectBounds.data (),
+        FRAMES_IN_FLIGHT
+    );
+
+    if ( !result )
+        return false;
+
+    _uploadScheduler.AddReleaseCallback ( [ this, &renderer ] () {
+        _gpuCulling.FreeTransferResources ( renderer );
+    } );
+
+    return true;
+}
+
+void Game::CullScene ()
+{
+    // The bounds are in the space of the scene. So the planes are built from the full local to clip transform. It
+    // is the same test as the world bounds against the view projection planes without transforming the boxes every
+    // frame. Note the near plane is z = -w. It is conservative for the Vulkan clip space.
+    const GXProjectionClipPlanes clipPlanes ( _transform._transform );
+    const size_t drawCount = _scene.size ();
+    GXBatchCullAABBs ( _sceneVisibility.get (), _sceneBounds.data (), clipPlanes, drawCount );
+
+    _visibleScene.clear ();
+
+    for ( size_t i = 0U; i < drawCount; ++i )
+    {
+        if ( _sceneVisibility[ i ] )
+            _visibleScene.push_back ( _scene[ i ] );
+    }
+}
+
+bool Game::RecordCommandBuffer ( android_vulkan::Renderer &renderer, size_t imageIndex )
+{
+    const android_vulkan::FrameTimingScope scope ( android_vulkan::eFrameTimingStage::Record );
+
+    if ( !_isGPUCulling )
+        CullScene ();
+
+    return RecordScene ( renderer, imageIndex );
+}
+
+bool Game::RecordScene ( android_vulkan::Renderer &renderer, size_t imageIndex )
+{
+    const FrameInFlight& frame = _framesInFlight[ _frameIndex ];
+
+    // Note the fence of the frame has been already waited. So GPU does not use the command buffers of the frame.
+    bool result = renderer.CheckVkResult ( vkResetCommandPool ( renderer.GetDevice (), frame._commandPool, 0U ),
+        "Game::RecordScene",
+        "Can't reset command pool"
     );
 
     if ( !result )
@@ -1246,9 +2019,19 @@ bool Game::InitCommandBuffers ( android_vulkan::Renderer &renderer )
     VkCommandBufferBeginInfo bufferBeginInfo;
     bufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     bufferBeginInfo.pNext = nullptr;
-    bufferBeginInfo.flags = 0U;
+    bufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     bufferBeginInfo.pInheritanceInfo = nullptr;
 
+    VkCommandBuffer commandBuffer = frame._commandBuffer;
+
+    result = renderer.CheckVkResult ( vkBeginCommandBuffer ( commandBuffer, &bufferBeginInfo ),
+        "Game::RecordScene",
+        "Can't begin command buffer"
+    );
+
+    if ( !result )
+        return false;
+
     VkClearValue clearValues[ 2U ];
     VkClearValue& colorTarget = clearValues[ 0U ];
     memset ( &colorTarget.color, 0, sizeof ( colorTarget.color ) );
@@ -1264,74 +2047,444 @@ bool Game::InitCommandBuffers ( android_vulkan::Renderer &renderer )
     renderPassBeginInfo.renderArea.offset.y = 0;
     renderPassBeginInfo.renderArea.extent = renderer.GetSurfaceSize ();
     renderPassBeginInfo.renderPass = _renderPass;
+    renderPassBeginInfo.framebuffer = _framebuffers[ imageIndex ];
     renderPassBeginInfo.clearValueCount = static_cast<uint32_t> ( std::size ( clearValues ) );
     renderPassBeginInfo.pClearValues = clearValues;
 
-    VkFenceCreateInfo fenceInfo;
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.pNext = nullptr;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    const size_t drawCount = _visibleScene.size ();
+    const size_t batchCount = std::min ( _recordBatches,
+        ( drawCount + MIN_DRAWS_PER_BATCH - 1U ) / MIN_DRAWS_PER_BATCH
+    );
 
-    VkFence fence = VK_NULL_HANDLE;
-    _commandBuffers.reserve ( framebufferCount );
+    _gpuTimer.RecordBegin ( commandBuffer, _frameIndex );
 
-    for ( size_t i = 0U; i < framebufferCount; ++i )
+    if ( _isGPUCulling )
     {
-        result = renderer.CheckVkResult ( vkCreateFence ( device, &fenceInfo, nullptr, &fence ),
-            "Game::InitCommandBuffers",
-            "Can't create fence"
-        );
+        // Note the dispatch is recorded before the render pass. The draw count does not depend on the scene size.
+        _gpuCulling.Cull ( commandBuffer, _frameIndex, _transform._transform );
+        vkCmdBeginRenderPass ( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+        RecordIndirectDraws ( commandBuffer );
+    }
+    else if ( batchCount < 2U )
+    {
+        vkCmdBeginRenderPass ( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+        RecordDraws ( commandBuffer, 0U, drawCount );
+    }
+    else
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo;
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = nullptr;
+        inheritanceInfo.renderPass = _renderPass;
+        inheritanceInfo.subpass = 0U;
+        inheritanceInfo.framebuffer = renderPassBeginInfo.framebuffer;
+        inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+        inheritanceInfo.queryFlags = 0U;
+        inheritanceInfo.pipelineStatistics = 0U;
+
+        std::atomic<bool> isRecorded ( true );
+
+        auto job = [ this, &renderer, &inheritanceInfo, &isRecorded, batchCount ] ( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i )
+            {
+                if ( !RecordBatch ( renderer, i, batchCount, inheritanceInfo ) )
+                    isRecorded = false;
+            }
+        };
 
-        if ( !result )
+        // One chunk per batch. So every batch command pool is used by single thread.
+        android_vulkan::g_JobSystem->ParallelFor ( batchCount, 1U, job );
+
+        if ( !isRecorded )
             return false;
 
-        AV_REGISTER_FENCE ( "Game::_commandBuffers::_fence" )
+        vkCmdBeginRenderPass ( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS );
+        vkCmdExecuteCommands ( commandBuffer, static_cast<uint32_t> ( batchCount ), frame._batchBuffers.data () );
+    }
 
-        VkCommandBuffer commandBuffer = commandBuffers[ i ];
+    vkCmdEndRenderPass ( commandBuffer );
+    _gpuTimer.RecordEnd ( commandBuffer, _frameIndex );
 
-        result = renderer.CheckVkResult ( vkBeginCommandBuffer ( commandBuffer, &bufferBeginInfo ),
-            "Game::InitCommandBuffers",
-            "Can't begin command buffer"
+    return renderer.CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
+        "Game::RecordScene",
+        "Can't end command buffer"
+    );
+}
+
+bool Game::BenchmarkRecording ( android_vulkan::Renderer &renderer )
+{
+    if ( _isGPUCulling )
+    {
+        android_vulkan::LogWarning ( "Game::BenchmarkRecording - GPU culling records the same commands for any "
+            "draw count. Skipped."
         );
 
-        if ( !result )
-            return false;
+        return true;
+    }
 
-        renderPassBeginInfo.framebuffer = _framebuffers[ i ];
-        vkCmdBeginRenderPass ( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+    // Note the frame is not submitted. So the command buffers of the first frame in flight are free.
+    for ( const size_t drawCount : RECORD_BENCHMARK_DRAWS )
+    {
+        _visibleScene.clear ();
+
+        for ( size_t i = 0U; i < drawCount; ++i )
+            _visibleScene.push_back ( _scene[ i % _scene.size () ] );
 
-        vkCmdBindPipeline ( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline );
-        constexpr VkDeviceSize offset = 0U;
+        const auto begin = std::chrono::steady_clock::now ();
 
-        for ( auto& item : _drawcalls )
+        for ( size_t i = 0U; i < RECORD_BENCHMARK_FRAMES; ++i )
         {
-            vkCmdBindDescriptorSets ( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0U, 1U,
-                &item._descriptorSet, 0U, nullptr
-            );
+            if ( !RecordScene ( renderer, 0U ) )
+                return false;
+        }
+
+        const std::chrono::duration<double, std::milli> delta = std::chrono::steady_clock::now () - begin;
+        const double frameTime = delta.count () / static_cast<double> ( RECORD_BENCHMARK_FRAMES );
+
+        android_vulkan::LogInfo ( "Game::BenchmarkRecording - %zu draw(s): %g ms per frame, %g us per draw.",
+            drawCount,
+            frameTime,
+            frameTime * 1.0e+3 / static_cast<double> ( drawCount )
+        );
+    }
+
+    _visibleScene.clear ();
+    return true;
+}
 
-            MeshGeometry& mesh = item._mesh;
+bool Game::RecordBatch ( android_vulkan::Renderer &renderer,
+    size_t batch,
+    size_t batchCount,
+    const VkCommandBufferInheritanceInfo &inheritanceInfo
+)
+{
+    const FrameInFlight& frame = _framesInFlight[ _frameIndex ];
+
+    bool result = renderer.CheckVkResult (
+        vkResetCommandPool ( renderer.GetDevice (), frame._batchPools[ batch ], 0U ),
+        "Game::RecordBatch",
+        "Can't reset command pool"
+    );
+
+    if ( !result )
+        return false;
+
+    VkCommandBufferBeginInfo bufferBeginInfo;
+    bufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    bufferBeginInfo.pNext = nullptr;
+
+    bufferBeginInfo.flags = AV_VK_FLAG ( VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT ) |
+        AV_VK_FLAG ( VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT );
+
+    bufferBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    VkCommandBuffer commandBuffer = frame._batchBuffers[ batch ];
+
+    result = renderer.CheckVkResult ( vkBeginCommandBuffer ( commandBuffer, &bufferBeginInfo ),
+        "Game::RecordBatch",
+        "Can't begin command buffer"
+    );
+
+    if ( !result )
+        return false;
+
+    const size_t drawCount = _visibleScene.size ();
+    RecordDraws ( commandBuffer, drawCount * batch / batchCount, drawCount * ( batch + 1U ) / batchCount );
+
+    return renderer.CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
+        "Game::RecordBatch",
+        "Can't end command buffer"
+    );
+}
+
+void Game::BindDescriptorSet ( VkCommandBuffer commandBuffer,
+    VkDescriptorSet descriptorSet,
+    bool isDynamic,
+    uint32_t dynamicOffset
+) const
+{
+    vkCmdBindDescriptorSets ( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0U, 1U,
+        &descriptorSet, isDynamic ? 1U : 0U, isDynamic ? &dynamicOffset : nullptr
+    );
+}
+
+void Game::BindMaterial ( VkCommandBuffer commandBuffer,
+    size_t material,
+    bool isDynamic,
+    uint32_t dynamicOffset
+) const
+{
+    if ( !_isMaterialTable )
+    {
+        BindDescriptorSet ( commandBuffer, _drawcalls[ material ]._descriptorSet, isDynamic, dynamicOffset );
+        return;
+    }
+
+    const auto index = static_cast<uint32_t> ( material );
+
+    vkCmdPushConstants ( commandBuffer,
+        _pipelineLayout,
+        VK_SHADER_STAGE_FRAGMENT_BIT,
+        0U,
+        static_cast<uint32_t> ( sizeof ( index ) ),
+        &index
+    );
+}
+
+void Game::RecordDraws ( VkCommandBuffer commandBuffer, size_t begin, size_t end ) const
+{
+    constexpr VkDeviceSize offset = 0U;
+    vkCmdBindVertexBuffers ( commandBuffer, 1U, 1U, &_instances.GetBuffer (), &offset );
+
+    const bool isDynamic = _transformBuffer.GetMode () == eUniformBufferMode::PersistentRing;
+    const uint32_t dynamicOffset = isDynamic ? _transformBuffer.GetDynamicOffset ( _frameIndex ) : 0U;
+
+    if ( _isMaterialTable )
+        BindDescriptorSet ( commandBuffer, _materialTable.GetDescriptorSet (), isDynamic, dynamicOffset );
+
+    // Consecutive draws of the same material do not rebind the state. The pipeline is rebound only when the vertex
+    // format changes.
+    const Drawcall* previous = nullptr;
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const SceneDraw& draw = _visibleScene[ i ];
+        const Drawcall* item = draw._drawcall;
+        const MeshGeometry& mesh = item->_mesh;
+
+        const uint32_t indexCount = mesh.GetIndexCount ();
+
+        if ( item != previous )
+        {
+            VkPipeline pipeline = _pipelines[ static_cast<size_t> ( mesh.GetVertexFormat () ) ];
+
+            if ( pipeline != boundPipeline )
+            {
+                vkCmdBindPipeline ( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline );
+                boundPipeline = pipeline;
+            }
 
+            BindMaterial ( commandBuffer, static_cast<size_t> ( item - _drawcalls ), isDynamic, dynamicOffset );
             vkCmdBindVertexBuffers ( commandBuffer, 0U, 1U, &mesh.GetBuffer (), &offset );
-            vkCmdDraw ( commandBuffer, mesh.GetVertexCount (), 1U, 0U, 0U );
+
+            if ( indexCount )
+                vkCmdBindIndexBuffer ( commandBuffer, mesh.GetBuffer (), mesh.GetIndexOffset (), mesh.GetIndexType () );
+
+            previous = item;
         }
 
-        vkCmdEndRenderPass ( commandBuffer );
+        if ( indexCount )
+        {
+            vkCmdDrawIndexed ( commandBuffer, indexCount, INSTANCE_COUNT, 0U, 0, draw._firstInstance );
+            continue;
+        }
 
-        result = renderer.CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
-            "Game::InitCommandBuffers",
-            "Can't end command buffer"
+        vkCmdDraw ( commandBuffer, mesh.GetVertexCount (), INSTANCE_COUNT, 0U, draw._firstInstance );
+    }
+}
+
+void Game::RecordIndirectDraws ( VkCommandBuffer commandBuffer ) const
+{
+    constexpr VkDeviceSize offset = 0U;
+    vkCmdBindVertexBuffers ( commandBuffer, 1U, 1U, &_gpuCulling.GetVisibleInstances ( _frameIndex ), &offset );
+
+    const bool isDynamic = _transformBuffer.GetMode () == eUniformBufferMode::PersistentRing;
+    const uint32_t dynamicOffset = isDynamic ? _transformBuffer.GetDynamicOffset ( _frameIndex ) : 0U;
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+
+    if ( _isMaterialTable )
+        BindDescriptorSet ( commandBuffer, _materialTable.GetDescriptorSet (), isDynamic, dynamicOffset );
+
+    for ( size_t i = 0U; i < MATERIAL_COUNT; ++i )
+    {
+        const Drawcall& item = _drawcalls[ i ];
+        const MeshGeometry& mesh = item._mesh;
+        VkPipeline pipeline = _pipelines[ static_cast<size_t> ( mesh.GetVertexFormat () ) ];
+
+        if ( pipeline != boundPipeline )
+        {
+            vkCmdBindPipeline ( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline );
+            boundPipeline = pipeline;
+        }
+
+        BindMaterial ( commandBuffer, i, isDynamic, dynamicOffset );
+        vkCmdBindVertexBuffers ( commandBuffer, 0U, 1U, &mesh.GetBuffer (), &offset );
+        const bool isIndexed = mesh.GetIndexCount () != 0U;
+
+        if ( isIndexed )
+            vkCmdBindIndexBuffer ( commandBuffer, mesh.GetBuffer (), mesh.GetIndexOffset (), mesh.GetIndexType () );
+
+        _gpuCulling.RecordDraw ( commandBuffer, _frameIndex, i, isIndexed );
+    }
+}
+
+void Game::RequestAssets ( android_vulkan::Renderer &renderer )
+{
+    android_vulkan::AssetLoader& assetLoader = *android_vulkan::g_AssetLoader;
+
+    // Note the meshes are needed for the first frame. The textures are not.
+    for ( size_t i = 0U; i < MATERIAL_COUNT; ++i )
+        _meshFiles[ i ] = assetLoader.Request ( MESH_FILES[ i ], android_vulkan::eAssetPriority::High );
+
+    constexpr VkFormatFeatureFlags features = AV_VK_FLAG ( VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT ) |
+        AV_VK_FLAG ( VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT );
+
+    for ( size_t i = 0U; i < STREAMED_TEXTURE_COUNT; ++i )
+    {
+        const StreamedTexture& info = STREAMED_TEXTURES[ i ];
+
+        const bool isCompressed = USE_COMPRESSED_TEXTURES &&
+            renderer.IsFormatFeatureSupported ( info._compressedFormat, features );
+
+        _textureFileNames[ i ] = isCompressed ? info._compressedFile : info._file;
+        _textureFiles[ i ] = assetLoader.Request ( _textureFileNames[ i ], android_vulkan::eAssetPriority::Normal );
+    }
+
+    _isFirstFrame = true;
+    _streamingState = eStreamingState::Loading;
+    _streamingStart = std::chrono::steady_clock::now ();
+}
+
+bool Game::UpdateStreaming ( android_vulkan::Renderer &renderer )
+{
+    switch ( _streamingState )
+    {
+        case eStreamingState::Loading:
+        return UploadStreamedTextures ( renderer );
+
+        case eStreamingState::Decoding:
+        return SubmitStreamedTextures ();
+
+        case eStreamingState::Uploaded:
+        return SwapStreamedTextures ( renderer );
+
+        default:
+            // NOTHING
+        return true;
+    }
+}
+
+bool Game::UploadStreamedTextures ( android_vulkan::Renderer &renderer )
+{
+    for ( const auto& item : _textureFiles )
+    {
+        if ( item.wait_for ( std::chrono::seconds ( 0 ) ) != std::future_status::ready )
+            return true;
+    }
+
+    // Note the placeholders stay in use if something goes wrong.
+    _streamingState = eStreamingState::Idle;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+    if ( !_uploadScheduler.Begin ( commandBuffer ) )
+        return false;
+
+    for ( size_t i = 0U; i < STREAMED_TEXTURE_COUNT; ++i )
+    {
+        const StreamedTexture& info = STREAMED_TEXTURES[ i ];
+        Drawcall& drawcall = _drawcalls[ info._drawcall ];
+        Texture2D& texture = info._isNormal ? drawcall._normal : drawcall._diffuse;
+
+        std::shared_ptr<android_vulkan::File> file = _textureFiles[ i ].get ();
+        _textureFiles[ i ] = {};
+
+        if ( !file )
+        {
+            android_vulkan::LogError ( "Game::UploadStreamedTextures - Can't load texture %s.",
+                _textureFileNames[ i ]
+            );
+            return false;
+        }
+
+        const bool result = texture.UploadData ( std::move ( file ),
+            info._format,
+            true,
+            _textureDecoder,
+            &_mipmapGenerator,
+            renderer,
+            commandBuffer
         );
 
         if ( !result )
             return false;
 
-        _commandBuffers.emplace_back ( std::make_pair ( commandBuffer, fence ) );
+        ReleaseOnUploadComplete ( renderer, texture );
+    }
+
+    // Images are decoded by the job system while the frames are being rendered.
+    _streamingState = eStreamingState::Decoding;
+    return true;
+}
+
+bool Game::SubmitStreamedTextures ()
+{
+    if ( !_textureDecoder.IsDone () )
+        return true;
+
+    _streamingState = eStreamingState::Idle;
+
+    if ( !_textureDecoder.Wait () )
+        return false;
+
+    _uploadScheduler.AddReleaseCallback ( [ this ] () {
+        _streamingState = eStreamingState::Uploaded;
+    } );
+
+    _streamingState = eStreamingState::Uploading;
+    return _uploadScheduler.Submit ();
+}
+
+bool Game::SwapStreamedTextures ( android_vulkan::Renderer &renderer )
+{
+    // Descriptor sets must not be updated while they are used by the command buffers which are in flight.
+    // It happens once per streaming. So waiting the queue is acceptable.
+    const bool result = renderer.CheckVkResult ( vkQueueWaitIdle ( renderer.GetQueue () ),
+        "Game::SwapStreamedTextures",
+        "Can't wait queue idle"
+    );
+
+    if ( !result )
+        return false;
+
+    _streamingState = eStreamingState::Idle;
+
+    // The table mode rewrites the array elements only. The layout and the pool are kept.
+    if ( _isMaterialTable )
+    {
+        if ( !UpdateMaterialTable ( renderer ) )
+            return false;
+    }
+    else
+    {
+        DestroyDescriptorSet ( renderer );
+
+        if ( !CreateDescriptorSet ( renderer ) )
+            return false;
     }
 
+    _placeholderDiffuse.FreeResources ( renderer );
+    _placeholderNormal.FreeResources ( renderer );
+
+#ifdef ANDROID_VULKAN_DEBUG
+
+    const std::chrono::duration<double, std::milli> delta = std::chrono::steady_clock::now () - _streamingStart;
+    VkDeviceSize memorySize = 0U;
+
+    for ( const auto& drawcall : _drawcalls )
+        memorySize += drawcall._diffuse.GetMemorySize () + drawcall._normal.GetMemorySize ();
+
+    android_vulkan::LogInfo ( "Game::SwapStreamedTextures - Textures are streamed in %g ms. Image memory: %llu KiB.",
+        delta.count (),
+        static_cast<unsigned long long> ( memorySize / 1024U )
+    );
+
+#endif // ANDROID_VULKAN_DEBUG
+
     return true;
 }
 
-bool Game::UpdateUniformBuffer ( android_vulkan::Renderer &renderer, double deltaTime )
+bool Game::UpdateUniformBuffer ( android_vulkan::Renderer &renderer, size_t slice, double deltaTime )
 {
     _angle += static_cast<float> ( deltaTime ) * ROTATION_SPEED;
 
@@ -1342,7 +2495,114 @@ bool Game::UpdateUniformBuffer ( android_vulkan::Renderer &renderer, double delt
     tmp1.Multiply ( _transform._normalTransform, _projectionMatrix );
     _transform._transform.Multiply ( tmp1, renderer.GetPresentationEngineTransform () );
 
-    return _transformBuffer.Update ( reinterpret_cast<const uint8_t*> ( &_transform ), sizeof ( _transform ) );
+    return _transformBuffer.Update ( reinterpret_cast<const uint8_t*> ( &_transform ),
+        sizeof ( _transform ),
+        slice
+    );
+}
+
+bool Game::BenchmarkUniformBuffer ( android_vulkan::Renderer &renderer )
+{
+    // Note the buffers are not _transformBuffer. So both modes are measured whatever TRANSFORM_BUFFER_MODE is.
+    UniformBuffer staging;
+    UniformBuffer ring;
+
+    bool result = staging.Init ( renderer, _commandPool, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT );
+    result = ring.InitRing ( renderer, FRAMES_IN_FLIGHT ) && result;
+
+    double stagingSubmits = 0.0;
+    double stagingTime = 0.0;
+    double ringSubmits = 0.0;
+    double ringTime = 0.0;
+
+    result = result &&
+        MeasureUniformBuffer ( staging, stagingSubmits, stagingTime ) &&
+        MeasureUniformBuffer ( ring, ringSubmits, ringTime );
+
+    // The copies of the staging mode could be still executed by GPU. So the buffers are released after the wait.
+    const bool isIdle = renderer.CheckVkResult ( vkQueueWaitIdle ( renderer.GetQueue () ),
+        "Game::BenchmarkUniformBuffer",
+        "Can't wait queue idle"
+    );
+
+    staging.FreeResources ();
+    ring.FreeResources ();
+
+    if ( !result || !isIdle )
+        return false;
+
+    android_vulkan::LogInfo ( "Game::BenchmarkUniformBuffer - %zu update(s). Staging: submits per frame %g, CPU time "
+        "per Update %g us. Persistent ring: submits per frame %g, CPU time per Update %g us.",
+        UNIFORM_BUFFER_BENCHMARK_UPDATES,
+        stagingSubmits,
+        stagingTime,
+        ringSubmits,
+        ringTime
+    );
+
+    return true;
+}
+
+bool Game::MeasureUniformBuffer ( UniformBuffer &buffer, double &submitsPerFrame, double &updateTime ) const
+{
+    const auto* data = reinterpret_cast<const uint8_t*> ( &_transform );
+
+    // The first update creates the resources. So it's not counted.
+    if ( !buffer.Update ( data, sizeof ( _transform ), 0U ) )
+        return false;
+
+    buffer.ResetStatistics ();
+    const size_t sliceCount = buffer.GetSliceCount ();
+
+    for ( size_t i = 0U; i < UNIFORM_BUFFER_BENCHMARK_UPDATES; ++i )
+    {
+        if ( !buffer.Update ( data, sizeof ( _transform ), i % sliceCount ) )
+            return false;
+    }
+
+    size_t updates = 0U;
+    size_t submits = 0U;
+    std::chrono::nanoseconds time {};
+    buffer.GetStatistics ( updates, submits, time );
+
+    const double frames = static_cast<double> ( updates );
+    const std::chrono::duration<double, std::micro> microseconds = time;
+
+    submitsPerFrame = static_cast<double> ( submits ) / frames;
+    updateTime = microseconds.count () / frames;
+    return true;
+}
+
+void Game::UpdateUniformBufferStatistics ( double deltaTime )
+{
+    ++_uniformBufferStatFrames;
+    _uniformBufferStatTime += deltaTime;
+
+    if ( _uniformBufferStatTime < UNIFORM_BUFFER_STAT_PERIOD )
+        return;
+
+#ifdef ANDROID_VULKAN_DEBUG
+
+    size_t updates = 0U;
+    size_t submits = 0U;
+    std::chrono::nanoseconds updateTime {};
+    _transformBuffer.GetStatistics ( updates, submits, updateTime );
+
+    const double frames = static_cast<double> ( _uniformBufferStatFrames );
+    const std::chrono::duration<double, std::micro> microseconds = updateTime;
+
+    android_vulkan::LogInfo (
+        "Game::UpdateUniformBufferStatistics - %s: submits per frame %g, CPU time per Update %g us",
+        _transformBuffer.GetMode () == eUniformBufferMode::PersistentRing ? "persistent ring" : "staging",
+        static_cast<double> ( submits ) / frames,
+        updates ? microseconds.count () / static_cast<double> ( updates ) : 0.0
+    );
+
+#endif // ANDROID_VULKAN_DEBUG
+
+    _transformBuffer.ResetStatistics ();
+    _uniformBufferStatTime = 0.0;
+    _uniformBufferStatFrames = 0U;
 }
 
 } // namespace rotating_mesh
@@ -4,12 +4,12 @@
 namespace rotating_mesh {
 
 constexpr static const char* FRAGMENT_SHADER = "shaders/blinn-phong-analytic-ps.spv";
-constexpr static const size_t TEXTURE_COMMAND_BUFFERS = 6U;
+constexpr static const char* FRAGMENT_SHADER_MATERIAL_TABLE = "shaders/blinn-phong-analytic-material-table-ps.spv";
 
 //----------------------------------------------------------------------------------------------------------------------
 
 GameAnalytic::GameAnalytic ():
-    Game ( FRAGMENT_SHADER )
+    Game ( FRAGMENT_SHADER, FRAGMENT_SHADER_MATERIAL_TABLE )
 {
     // NOTHING
 }
@@ -78,12 +78,12 @@ bool GameAnalytic::CreateDescriptorSet ( android_vulkan::Renderer &renderer )
 
         VkDescriptorImageInfo& diffuseImage = diffuseInfo[ i ];
         diffuseImage.sampler = drawcall._diffuseSampler;
-        diffuseImage.imageView = drawcall._diffuse.GetImageView ();
+        diffuseImage.imageView = ResolveImageView ( drawcall._diffuse, _placeholderDiffuse );
         diffuseImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkDescriptorImageInfo& normalImage = normalInfo[ i ];
         normalImage.sampler = drawcall._normalSampler;
-        normalImage.imageView = drawcall._normal.GetImageView ();
+        normalImage.imageView = ResolveImageView ( drawcall._normal, _placeholderNormal );
         normalImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         const size_t pivotIndex = i * featureCount;
@@ -92,7 +92,7 @@ bool GameAnalytic::CreateDescriptorSet ( android_vulkan::Renderer &renderer )
         ubWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         ubWriteSet.pNext = nullptr;
         ubWriteSet.dstSet = drawcall._descriptorSet;
-        ubWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        ubWriteSet.descriptorType = _transformBuffer.GetDescriptorType ();
         ubWriteSet.dstBinding = 0U;
         ubWriteSet.dstArrayElement = 0U;
         ubWriteSet.descriptorCount = 1U;
@@ -201,50 +201,18 @@ bool GameAnalytic::CreatePipelineLayout ( android_vulkan::Renderer &renderer )
 
 bool GameAnalytic::LoadGPUContent ( android_vulkan::Renderer &renderer )
 {
-    constexpr const size_t commandBufferCount = TEXTURE_COMMAND_BUFFERS + MATERIAL_COUNT;
-    VkCommandBuffer commandBuffers[ commandBufferCount ] = { VK_NULL_HANDLE };
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
 
-    VkCommandBufferAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.commandPool = _commandPool;
-    allocateInfo.commandBufferCount = static_cast<uint32_t> ( commandBufferCount );
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-
-    VkDevice device = renderer.GetDevice ();
-
-    bool result = renderer.CheckVkResult (
-        vkAllocateCommandBuffers ( renderer.GetDevice (), &allocateInfo, commandBuffers ),
-        "GameLUT::LoadGPUContent",
-        "Can't allocate command buffers"
-    );
-
-    if ( !result )
-        return false;
-
-    if ( !CreateCommonTextures ( renderer, commandBuffers ) )
+    if ( !_uploadScheduler.Begin ( commandBuffer ) )
         return false;
 
-    if ( !CreateMeshes ( renderer, commandBuffers + TEXTURE_COMMAND_BUFFERS ) )
+    if ( !CreateCommonTextures ( renderer, commandBuffer ) )
         return false;
 
-    result = renderer.CheckVkResult ( vkQueueWaitIdle ( renderer.GetQueue () ),
-        "GameLUT::LoadGPUContent",
-        "Can't run upload commands"
-    );
-
-    if ( !result )
+    if ( !CreateMeshes ( renderer, commandBuffer ) )
         return false;
 
-    for ( auto& item : _drawcalls )
-    {
-        item._mesh.FreeTransferResources ( renderer );
-        item._diffuse.FreeTransferResources ( renderer );
-        item._normal.FreeTransferResources ( renderer );
-    }
-
-    vkFreeCommandBuffers ( device, _commandPool, allocateInfo.commandBufferCount, commandBuffers );
-    return true;
+    return _uploadScheduler.Submit ();
 }
 
 } // namespace rotating_mesh
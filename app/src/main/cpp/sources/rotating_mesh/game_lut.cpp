@@ -1,29 +1,20 @@
 #include <rotating_mesh/game_lut.h>
-#include <GXCommon/GXWarning.h>
-
-GX_DISABLE_COMMON_WARNINGS
-
-#include <array>
-#include <cmath>
-#include <thread>
-
-GX_RESTORE_WARNING_STATE
+#include <rotating_mesh/specular_lut.h>
 
 
 namespace rotating_mesh {
 
 constexpr static const char* FRAGMENT_SHADER = "shaders/blinn-phong-lut-ps.spv";
+constexpr static const char* FRAGMENT_SHADER_MATERIAL_TABLE = "shaders/blinn-phong-lut-material-table-ps.spv";
 
-constexpr static const size_t SPECULAR_ANGLE_SAMPLES = 512U;
-constexpr static const size_t SPECULAR_EXPONENT_SAMPLES = 150U;
-constexpr static const size_t SPECULAR_GENERATOR_THREADS = 4U;
-
-constexpr static const size_t TEXTURE_COMMAND_BUFFERS = 7U;
+// The specular LUT image and sampler follow the bindings of the material table.
+constexpr static const uint32_t SPECULAR_LUT_TEXTURE_BINDING = MATERIAL_TABLE_BINDING_COUNT;
+constexpr static const uint32_t SPECULAR_LUT_SAMPLER_BINDING = MATERIAL_TABLE_BINDING_COUNT + 1U;
 
 //----------------------------------------------------------------------------------------------------------------------
 
 GameLUT::GameLUT ():
-    Game ( FRAGMENT_SHADER ),
+    Game ( FRAGMENT_SHADER, FRAGMENT_SHADER_MATERIAL_TABLE ),
     _specularLUTSampler ( VK_NULL_HANDLE ),
     _specularLUTTexture {}
 {
@@ -103,12 +94,12 @@ bool GameLUT::CreateDescriptorSet ( android_vulkan::Renderer &renderer )
 
         VkDescriptorImageInfo& diffuseImage = diffuseInfo[ i ];
         diffuseImage.sampler = drawcall._diffuseSampler;
-        diffuseImage.imageView = drawcall._diffuse.GetImageView ();
+        diffuseImage.imageView = ResolveImageView ( drawcall._diffuse, _placeholderDiffuse );
         diffuseImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkDescriptorImageInfo& normalImage = normalInfo[ i ];
         normalImage.sampler = drawcall._normalSampler;
-        normalImage.imageView = drawcall._normal.GetImageView ();
+        normalImage.imageView = ResolveImageView ( drawcall._normal, _placeholderNormal );
         normalImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkDescriptorImageInfo& specImage = specInfo[ i ];
@@ -122,7 +113,7 @@ bool GameLUT::CreateDescriptorSet ( android_vulkan::Renderer &renderer )
         ubWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         ubWriteSet.pNext = nullptr;
         ubWriteSet.dstSet = drawcall._descriptorSet;
-        ubWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        ubWriteSet.descriptorType = _transformBuffer.GetDescriptorType ();
         ubWriteSet.dstBinding = 0U;
         ubWriteSet.dstArrayElement = 0U;
         ubWriteSet.descriptorCount = 1U;
@@ -269,54 +260,91 @@ bool GameLUT::CreatePipelineLayout ( android_vulkan::Renderer &renderer )
 
 bool GameLUT::LoadGPUContent ( android_vulkan::Renderer &renderer )
 {
-    constexpr const size_t commandBufferCount = TEXTURE_COMMAND_BUFFERS + MATERIAL_COUNT;
-    VkCommandBuffer commandBuffers[ commandBufferCount ] = { VK_NULL_HANDLE };
-
-    VkCommandBufferAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.commandPool = _commandPool;
-    allocateInfo.commandBufferCount = static_cast<uint32_t> ( commandBufferCount );
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-
-    VkDevice device = renderer.GetDevice ();
-
-    bool result = renderer.CheckVkResult (
-        vkAllocateCommandBuffers ( renderer.GetDevice (), &allocateInfo, commandBuffers ),
-        "GameLUT::LoadGPUContent",
-        "Can't allocate command buffers"
-    );
+    // All uploads go to the single command buffer and single submit. Transfer resources are released by
+    // the upload scheduler when GPU completes the batch. So there is no need to wait queue idle here.
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
 
-    if ( !result )
+    if ( !_uploadScheduler.Begin ( commandBuffer ) )
         return false;
 
-    if ( !CreateCommonTextures ( renderer, commandBuffers ) )
+    if ( !CreateTextures ( renderer, commandBuffer ) )
         return false;
 
-    if ( !CreateSpecularLUTTexture ( renderer, commandBuffers[ 6U ] ) )
+    if ( !CreateMeshes ( renderer, commandBuffer ) )
         return false;
 
-    if ( !CreateMeshes ( renderer, commandBuffers + TEXTURE_COMMAND_BUFFERS ) )
-        return false;
+    return _uploadScheduler.Submit ();
+}
 
-    result = renderer.CheckVkResult ( vkQueueWaitIdle ( renderer.GetQueue () ),
-        "GameLUT::LoadGPUContent",
-        "Can't run upload commands"
+bool GameLUT::CreateMaterialTable ( android_vulkan::Renderer &renderer )
+{
+    VkDescriptorSetLayoutBinding bindings[ 2U ];
+
+    VkDescriptorSetLayoutBinding& specLUTImageInfo = bindings[ 0U ];
+    specLUTImageInfo.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    specLUTImageInfo.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    specLUTImageInfo.descriptorCount = 1U;
+    specLUTImageInfo.binding = SPECULAR_LUT_TEXTURE_BINDING;
+    specLUTImageInfo.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding& specLUTSamplerInfo = bindings[ 1U ];
+    specLUTSamplerInfo.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    specLUTSamplerInfo.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    specLUTSamplerInfo.descriptorCount = 1U;
+    specLUTSamplerInfo.binding = SPECULAR_LUT_SAMPLER_BINDING;
+    specLUTSamplerInfo.pImmutableSamplers = nullptr;
+
+    return _materialTable.Init ( renderer,
+        static_cast<uint32_t> ( MATERIAL_COUNT ),
+        _transformBuffer,
+        bindings,
+        static_cast<uint32_t> ( std::size ( bindings ) )
     );
+}
 
-    if ( !result )
+bool GameLUT::UpdateMaterialTable ( android_vulkan::Renderer &renderer )
+{
+    if ( !Game::UpdateMaterialTable ( renderer ) )
         return false;
 
-    for ( auto& item : _drawcalls )
-    {
-        item._mesh.FreeTransferResources ( renderer );
-        item._diffuse.FreeTransferResources ( renderer );
-        item._normal.FreeTransferResources ( renderer );
-    }
-
-    _specularLUTTexture.FreeTransferResources ( renderer );
+    VkDescriptorImageInfo specLUTImage;
+    specLUTImage.sampler = _specularLUTSampler;
+    specLUTImage.imageView = _specularLUTTexture.GetImageView ();
+    specLUTImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet writeSets[ 2U ];
+
+    VkWriteDescriptorSet& specLUTImageWriteSet = writeSets[ 0U ];
+    specLUTImageWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    specLUTImageWriteSet.pNext = nullptr;
+    specLUTImageWriteSet.dstSet = _materialTable.GetDescriptorSet ();
+    specLUTImageWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    specLUTImageWriteSet.dstBinding = SPECULAR_LUT_TEXTURE_BINDING;
+    specLUTImageWriteSet.dstArrayElement = 0U;
+    specLUTImageWriteSet.descriptorCount = 1U;
+    specLUTImageWriteSet.pBufferInfo = nullptr;
+    specLUTImageWriteSet.pImageInfo = &specLUTImage;
+    specLUTImageWriteSet.pTexelBufferView = nullptr;
+
+    VkWriteDescriptorSet& specLUTSamplerWriteSet = writeSets[ 1U ];
+    specLUTSamplerWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    specLUTSamplerWriteSet.pNext = nullptr;
+    specLUTSamplerWriteSet.dstSet = _materialTable.GetDescriptorSet ();
+    specLUTSamplerWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    specLUTSamplerWriteSet.dstBinding = SPECULAR_LUT_SAMPLER_BINDING;
+    specLUTSamplerWriteSet.dstArrayElement = 0U;
+    specLUTSamplerWriteSet.descriptorCount = 1U;
+    specLUTSamplerWriteSet.pBufferInfo = nullptr;
+    specLUTSamplerWriteSet.pImageInfo = &specLUTImage;
+    specLUTSamplerWriteSet.pTexelBufferView = nullptr;
+
+    vkUpdateDescriptorSets ( renderer.GetDevice (),
+        static_cast<uint32_t> ( std::size ( writeSets ) ),
+        writeSets,
+        0U,
+        nullptr
+    );
 
-    vkFreeCommandBuffers ( device, _commandPool, allocateInfo.commandBufferCount, commandBuffers );
     return true;
 }
 
@@ -347,17 +375,11 @@ bool GameLUT::CreateSamplers ( android_vulkan::Renderer &renderer )
     samplerInfo.compareEnable = VK_FALSE;
     samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 
-    result = renderer.CheckVkResult (
-        vkCreateSampler ( renderer.GetDevice (), &samplerInfo, nullptr, &_specularLUTSampler ),
+    return renderer.AcquireSampler ( _specularLUTSampler,
+        samplerInfo,
         "GameLUT::CreateSamplers",
-        "Can't create specular LUT sampler"
+        "Can't acquire specular LUT sampler"
     );
-
-    if ( !result )
-        return false;
-
-    AV_REGISTER_SAMPLER ( "GameLUT::_specularLUTSampler" )
-    return true;
 }
 
 void GameLUT::DestroySamplers ( android_vulkan::Renderer &renderer )
@@ -367,17 +389,16 @@ void GameLUT::DestroySamplers ( android_vulkan::Renderer &renderer )
     if ( _specularLUTSampler == VK_NULL_HANDLE )
         return;
 
-    vkDestroySampler ( renderer.GetDevice (), _specularLUTSampler, nullptr );
+    renderer.ReleaseSampler ( _specularLUTSampler );
     _specularLUTSampler = VK_NULL_HANDLE;
-    AV_UNREGISTER_SAMPLER ( "GameLUT::_specularLUTSampler" )
 }
 
-bool GameLUT::CreateTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer* commandBuffers )
+bool GameLUT::CreateTextures ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer )
 {
-    if ( !CreateCommonTextures ( renderer, commandBuffers ) )
+    if ( !CreateCommonTextures ( renderer, commandBuffer ) )
         return false;
 
-    return CreateSpecularLUTTexture ( renderer, commandBuffers[ 6U ] );
+    return CreateSpecularLUTTexture ( renderer, commandBuffer );
 }
 
 void GameLUT::DestroyTextures ( android_vulkan::Renderer &renderer )
@@ -388,35 +409,10 @@ void GameLUT::DestroyTextures ( android_vulkan::Renderer &renderer )
 
 bool GameLUT::CreateSpecularLUTTexture ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer )
 {
-    constexpr const size_t totalSamples = SPECULAR_ANGLE_SAMPLES * SPECULAR_EXPONENT_SAMPLES;
-
-    std::vector<uint8_t> lutData ( totalSamples * sizeof ( android_vulkan::Half ) );
-    auto* samples = reinterpret_cast<android_vulkan::Half*> ( lutData.data () );
-
-    auto jobThread = [ samples ] ( size_t startIndex, int shininess ) {
-        do
-        {
-            constexpr const auto nextOffset = SPECULAR_GENERATOR_THREADS * SPECULAR_ANGLE_SAMPLES;
-            constexpr const auto convert = 1.0F / static_cast<const float> ( SPECULAR_ANGLE_SAMPLES );
-
-            for ( size_t i = 0U; i < SPECULAR_ANGLE_SAMPLES; ++i )
-                samples[ startIndex + i ] = std::pow ( static_cast<float> ( i ) * convert, shininess );
+    std::vector<uint8_t> lutData ( SPECULAR_LUT_SAMPLES * sizeof ( android_vulkan::Half ) );
+    SpecularLUT::Generate ( reinterpret_cast<android_vulkan::Half*> ( lutData.data () ) );
 
-            shininess += static_cast<int> ( SPECULAR_GENERATOR_THREADS );
-            startIndex += nextOffset;
-        }
-        while ( startIndex < totalSamples );
-    };
-
-    std::array<std::thread, SPECULAR_GENERATOR_THREADS> jobPool;
-
-    for ( size_t i = 0U; i < SPECULAR_GENERATOR_THREADS; ++i )
-        jobPool[ i ] = std::thread ( jobThread, i * SPECULAR_ANGLE_SAMPLES, static_cast<int> ( i ) );
-
-    for ( size_t i = 0U; i < SPECULAR_GENERATOR_THREADS; ++i )
-        jobPool[ i ].join ();
-
-    return _specularLUTTexture.UploadData ( lutData.data (),
+    const bool result = _specularLUTTexture.UploadData ( lutData.data (),
         lutData.size (),
 
         VkExtent2D {
@@ -429,6 +425,12 @@ bool GameLUT::CreateSpecularLUTTexture ( android_vulkan::Renderer &renderer, VkC
         renderer,
         commandBuffer
     );
+
+    if ( !result )
+        return false;
+
+    ReleaseOnUploadComplete ( renderer, _specularLUTTexture );
+    return true;
 }
 
 void GameLUT::DestroySpecularLUTTexture ( android_vulkan::Renderer &renderer )
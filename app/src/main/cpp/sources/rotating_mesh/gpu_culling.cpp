@@ -0,0 +1,787 @@
+#include <rotating_mesh/gpu_culling.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+#include <vulkan_utils.h>
+#include <GXCommon/GXMathBatch.h>
+
+
+namespace rotating_mesh {
+
+constexpr static const char* SHADER = "shaders/gpu-culling-cs.spv";
+constexpr static const char* SHADER_ENTRY_POINT = "CS";
+
+constexpr static const uint32_t THREADS = 64U;
+
+// See gpu-culling.cs.
+constexpr static const uint32_t COMMAND_STRIDE = 20U;
+constexpr static const size_t INSTANCE_COUNT_OFFSET = 4U;
+
+// Bounds, draws, instances, commands, draw counts and visible instances.
+constexpr static const uint32_t BINDING_COUNT = 6U;
+
+struct ObjectBounds final
+{
+    float       _min[ 4U ];
+    float       _max[ 4U ];
+};
+
+struct PushConstants final
+{
+    GXVec4      _planes[ 6U ];
+    uint32_t    _drawCount;
+    uint32_t    _instanceCount;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+GPUCulling::GPUCulling ():
+    _bounds {},
+    _boundsBuffer {},
+    _commandTemplate {},
+    _descriptorPool ( VK_NULL_HANDLE ),
+    _descriptorSetLayout ( VK_NULL_HANDLE ),
+    _drawIndexedIndirectCount ( nullptr ),
+    _drawIndirectCount ( nullptr ),
+    _drawMaterials {},
+    _draws {},
+    _frames {},
+    _instanceCount ( 0U ),
+    _materialCommands {},
+    _materialDraws {},
+    _pipeline ( VK_NULL_HANDLE ),
+    _pipelineLayout ( VK_NULL_HANDLE ),
+    _shaderModule ( VK_NULL_HANDLE )
+{
+    // NOTHING
+}
+
+bool GPUCulling::IsSupported ( android_vulkan::Renderer &renderer, uint32_t maxDrawsPerMaterial )
+{
+    const VkPhysicalDeviceFeatures& features = renderer.GetPhysicalDeviceFeatures ();
+
+    if ( !features.multiDrawIndirect || !features.drawIndirectFirstInstance )
+        return false;
+
+    return maxDrawsPerMaterial <= renderer.GetPhysicalDeviceLimits ().maxDrawIndirectCount;
+}
+
+bool GPUCulling::Init ( android_vulkan::Renderer &renderer )
+{
+    VkDescriptorSetLayoutBinding bindings[ BINDING_COUNT ];
+
+    for ( uint32_t i = 0U; i < BINDING_COUNT; ++i )
+    {
+        VkDescriptorSetLayoutBinding& binding = bindings[ i ];
+        binding.binding = i;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1U;
+        binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        binding.pImmutableSamplers = nullptr;
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetInfo;
+    descriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetInfo.pNext = nullptr;
+    descriptorSetInfo.flags = 0U;
+    descriptorSetInfo.bindingCount = BINDING_COUNT;
+    descriptorSetInfo.pBindings = bindings;
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult (
+        vkCreateDescriptorSetLayout ( device, &descriptorSetInfo, nullptr, &_descriptorSetLayout ),
+        "GPUCulling::Init",
+        "Can't create descriptor set layout"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DESCRIPTOR_SET_LAYOUT ( "GPUCulling::_descriptorSetLayout" )
+
+    VkPushConstantRange pushConstantRange;
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0U;
+    pushConstantRange.size = static_cast<uint32_t> ( sizeof ( PushConstants ) );
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo;
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.pNext = nullptr;
+    pipelineLayoutInfo.flags = 0U;
+    pipelineLayoutInfo.pushConstantRangeCount = 1U;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    pipelineLayoutInfo.setLayoutCount = 1U;
+    pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+
+    result = renderer.CheckVkResult ( vkCreatePipelineLayout ( device, &pipelineLayoutInfo, nullptr, &_pipelineLayout ),
+        "GPUCulling::Init",
+        "Can't create pipeline layout"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_PIPELINE_LAYOUT ( "GPUCulling::_pipelineLayout" )
+
+    result = renderer.CreateShader ( _shaderModule,
+        SHADER,
+        "Can't create compute shader (GPUCulling::Init)"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_SHADER_MODULE ( "GPUCulling::_shaderModule" )
+
+    VkComputePipelineCreateInfo pipelineInfo;
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = nullptr;
+    pipelineInfo.flags = 0U;
+    pipelineInfo.layout = _pipelineLayout;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    VkPipelineShaderStageCreateInfo& stageInfo = pipelineInfo.stage;
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.pNext = nullptr;
+    stageInfo.flags = 0U;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = _shaderModule;
+    stageInfo.pName = SHADER_ENTRY_POINT;
+    stageInfo.pSpecializationInfo = nullptr;
+
+    result = renderer.CheckVkResult (
+        vkCreateComputePipelines ( device, renderer.GetPipelineCache (), 1U, &pipelineInfo, nullptr, &_pipeline ),
+        "GPUCulling::Init",
+        "Can't create pipeline"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_PIPELINE ( "GPUCulling::_pipeline" )
+
+    // Note the commands of the extension are nullptr if the extension is not supported. The fixed size draws are
+    // recorded in that case. The unused commands have zero instances.
+    _drawIndexedIndirectCount = renderer.GetDrawIndexedIndirectCount ();
+    _drawIndirectCount = renderer.GetDrawIndirectCount ();
+    return true;
+}
+
+void GPUCulling::Destroy ( android_vulkan::Renderer &renderer )
+{
+    VkDevice device = renderer.GetDevice ();
+
+    for ( auto& frame : _frames )
+    {
+        DestroyBuffer ( frame._commands, renderer );
+        DestroyBuffer ( frame._drawCounts, renderer );
+        DestroyBuffer ( frame._visibleInstances, renderer );
+    }
+
+    _frames.clear ();
+
+    if ( _descriptorPool != VK_NULL_HANDLE )
+    {
+        // Note the descriptor sets are released with the pool.
+        vkDestroyDescriptorPool ( device, _descriptorPool, nullptr );
+        _descriptorPool = VK_NULL_HANDLE;
+        AV_UNREGISTER_DESCRIPTOR_POOL ( "GPUCulling::_descriptorPool" )
+    }
+
+    _boundsBuffer.FreeResources ( renderer );
+    _draws.FreeResources ( renderer );
+
+    _bounds.clear ();
+    _commandTemplate.clear ();
+    _drawMaterials.clear ();
+    _materialCommands.clear ();
+    _materialDraws.clear ();
+    _instanceCount = 0U;
+
+    _drawIndexedIndirectCount = nullptr;
+    _drawIndirectCount = nullptr;
+
+    if ( _pipeline != VK_NULL_HANDLE )
+    {
+        vkDestroyPipeline ( device, _pipeline, nullptr );
+        _pipeline = VK_NULL_HANDLE;
+        AV_UNREGISTER_PIPELINE ( "GPUCulling::_pipeline" )
+    }
+
+    if ( _shaderModule != VK_NULL_HANDLE )
+    {
+        vkDestroyShaderModule ( device, _shaderModule, nullptr );
+        _shaderModule = VK_NULL_HANDLE;
+        AV_UNREGISTER_SHADER_MODULE ( "GPUCulling::_shaderModule" )
+    }
+
+    if ( _pipelineLayout != VK_NULL_HANDLE )
+    {
+        vkDestroyPipelineLayout ( device, _pipelineLayout, nullptr );
+        _pipelineLayout = VK_NULL_HANDLE;
+        AV_UNREGISTER_PIPELINE_LAYOUT ( "GPUCulling::_pipelineLayout" )
+    }
+
+    if ( _descriptorSetLayout == VK_NULL_HANDLE )
+        return;
+
+    vkDestroyDescriptorSetLayout ( device, _descriptorSetLayout, nullptr );
+    _descriptorSetLayout = VK_NULL_HANDLE;
+    AV_UNREGISTER_DESCRIPTOR_SET_LAYOUT ( "GPUCulling::_descriptorSetLayout" )
+}
+
+bool GPUCulling::CreateScene ( android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer,
+    const Drawcall* drawcalls,
+    size_t materialCount,
+    const uint32_t* drawMaterials,
+    size_t drawCount,
+    VkBuffer instances,
+    uint32_t instanceCount,
+    const GXAABB* bounds,
+    size_t frameCount
+)
+{
+    _instanceCount = instanceCount;
+    _drawMaterials.assign ( drawMaterials, drawMaterials + drawCount );
+    _materialCommands.assign ( materialCount, 0U );
+    _materialDraws.assign ( materialCount, 0U );
+
+    for ( size_t i = 0U; i < drawCount; ++i )
+        ++_materialDraws[ drawMaterials[ i ] ];
+
+    uint32_t first = 0U;
+
+    for ( size_t i = 0U; i < materialCount; ++i )
+    {
+        _materialCommands[ i ] = first;
+        first += _materialDraws[ i ];
+    }
+
+    // Every command of the material draws the whole mesh. The shader writes the instance count only. Note
+    // the visible instances of the command start at command * instance count.
+    _commandTemplate.assign ( drawCount * COMMAND_STRIDE, 0U );
+
+    for ( size_t i = 0U; i < materialCount; ++i )
+    {
+        const MeshGeometry& mesh = drawcalls[ i ]._mesh;
+        const uint32_t indexCount = mesh.GetIndexCount ();
+
+        for ( uint32_t j = 0U; j < _materialDraws[ i ]; ++j )
+        {
+            const uint32_t command = _materialCommands[ i ] + j;
+            uint8_t* record = _commandTemplate.data () + command * COMMAND_STRIDE;
+
+            if ( indexCount )
+            {
+                VkDrawIndexedIndirectCommand draw;
+                draw.indexCount = indexCount;
+                draw.instanceCount = 0U;
+                draw.firstIndex = 0U;
+                draw.vertexOffset = 0;
+                draw.firstInstance = command * instanceCount;
+                std::memcpy ( record, &draw, sizeof ( draw ) );
+                continue;
+            }
+
+            VkDrawIndirectCommand draw;
+            draw.vertexCount = mesh.GetVertexCount ();
+            draw.instanceCount = 0U;
+            draw.firstVertex = 0U;
+            draw.firstInstance = command * instanceCount;
+            std::memcpy ( record, &draw, sizeof ( draw ) );
+        }
+    }
+
+    const size_t objectBounds = drawCount * static_cast<size_t> ( instanceCount );
+    _bounds.assign ( bounds, bounds + objectBounds );
+    std::vector<ObjectBounds> boundsData ( objectBounds );
+
+    for ( size_t i = 0U; i < objectBounds; ++i )
+    {
+        const GXAABB& source = bounds[ i ];
+        ObjectBounds& target = boundsData[ i ];
+        std::memcpy ( target._min, source._min._data, sizeof ( source._min._data ) );
+        target._min[ 3U ] = 1.0F;
+        std::memcpy ( target._max, source._max._data, sizeof ( source._max._data ) );
+        target._max[ 3U ] = 1.0F;
+    }
+
+    bool result = _boundsBuffer.LoadMesh ( reinterpret_cast<const uint8_t*> ( boundsData.data () ),
+        boundsData.size () * sizeof ( ObjectBounds ),
+        static_cast<uint32_t> ( objectBounds ),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        renderer,
+        commandBuffer
+    );
+
+    if ( !result )
+        return false;
+
+    std::vector<uint32_t> drawsData ( drawCount * 2U );
+
+    for ( size_t i = 0U; i < drawCount; ++i )
+    {
+        const uint32_t material = drawMaterials[ i ];
+        drawsData[ i * 2U ] = material;
+        drawsData[ i * 2U + 1U ] = _materialCommands[ material ];
+    }
+
+    result = _draws.LoadMesh ( reinterpret_cast<const uint8_t*> ( drawsData.data () ),
+        drawsData.size () * sizeof ( uint32_t ),
+        static_cast<uint32_t> ( drawCount ),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        renderer,
+        commandBuffer
+    );
+
+    if ( !result )
+        return false;
+
+    _frames.resize ( frameCount );
+
+    constexpr const VkMemoryPropertyFlags hostMemory =
+        AV_VK_FLAG ( VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) | AV_VK_FLAG ( VK_MEMORY_PROPERTY_HOST_COHERENT_BIT );
+
+    constexpr const VkBufferUsageFlags outputUsage =
+        AV_VK_FLAG ( VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT ) | AV_VK_FLAG ( VK_BUFFER_USAGE_STORAGE_BUFFER_BIT );
+
+    constexpr const VkBufferUsageFlags instanceUsage =
+        AV_VK_FLAG ( VK_BUFFER_USAGE_VERTEX_BUFFER_BIT ) | AV_VK_FLAG ( VK_BUFFER_USAGE_STORAGE_BUFFER_BIT );
+
+    const auto commandsSize = static_cast<VkDeviceSize> ( _commandTemplate.size () );
+    const auto drawCountsSize = static_cast<VkDeviceSize> ( materialCount * sizeof ( uint32_t ) );
+
+    const auto visibleInstancesSize = static_cast<VkDeviceSize> (
+        drawCount * static_cast<size_t> ( instanceCount ) * sizeof ( GXMat4 )
+    );
+
+    for ( auto& frame : _frames )
+    {
+        if ( !CreateBuffer ( frame._commands, renderer, commandsSize, outputUsage, hostMemory ) )
+            return false;
+
+        if ( !CreateBuffer ( frame._drawCounts, renderer, drawCountsSize, outputUsage, hostMemory ) )
+            return false;
+
+        result = CreateBuffer ( frame._visibleInstances,
+            renderer,
+            visibleInstancesSize,
+            instanceUsage,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+
+        if ( !result )
+            return false;
+    }
+
+    return CreateDescriptorSets ( renderer, instances );
+}
+
+void GPUCulling::FreeTransferResources ( android_vulkan::Renderer &renderer )
+{
+    _boundsBuffer.FreeTransferResources ( renderer );
+    _draws.FreeTransferResources ( renderer );
+}
+
+void GPUCulling::Cull ( VkCommandBuffer commandBuffer, size_t frame, const GXMat4 &localToClip )
+{
+    Frame& target = _frames[ frame ];
+    target._isCulled = true;
+    target._localToClip = localToClip;
+
+    // Note the host writes are visible to the commands of the next queue submit. So the barrier is not needed.
+    std::memcpy ( target._commands._mappedData, _commandTemplate.data (), _commandTemplate.size () );
+    std::memset ( target._drawCounts._mappedData, 0, _materialDraws.size () * sizeof ( uint32_t ) );
+
+    // The bounds are in the scene space. So the planes are built from the full local to clip transform. See
+    // Game::CullScene.
+    const GXProjectionClipPlanes clipPlanes ( localToClip );
+    PushConstants pushConstants {};
+
+    for ( GXUByte i = 0U; i < 6U; ++i )
+    {
+        const GXPlane& plane = clipPlanes.GetPlane ( i );
+        pushConstants._planes[ i ].Init ( plane._a, plane._b, plane._c, plane._d );
+    }
+
+    const auto drawCount = static_cast<uint32_t> ( _commandTemplate.size () / COMMAND_STRIDE );
+    pushConstants._drawCount = drawCount;
+    pushConstants._instanceCount = _instanceCount;
+
+    vkCmdBindPipeline ( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline );
+
+    vkCmdBindDescriptorSets ( commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        _pipelineLayout,
+        0U,
+        1U,
+        &target._descriptorSet,
+        0U,
+        nullptr
+    );
+
+    vkCmdPushConstants ( commandBuffer,
+        _pipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0U,
+        static_cast<uint32_t> ( sizeof ( pushConstants ) ),
+        &pushConstants
+    );
+
+    vkCmdDispatch ( commandBuffer, ( drawCount + THREADS - 1U ) / THREADS, 1U, 1U );
+
+    // Note the host read is synchronized too. The debug build reads the results after the fence of the frame.
+    VkMemoryBarrier barrierInfo;
+    barrierInfo.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrierInfo.pNext = nullptr;
+    barrierInfo.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+    barrierInfo.dstAccessMask = AV_VK_FLAG ( VK_ACCESS_INDIRECT_COMMAND_READ_BIT ) |
+        AV_VK_FLAG ( VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT ) |
+        AV_VK_FLAG ( VK_ACCESS_HOST_READ_BIT );
+
+    constexpr const VkPipelineStageFlags dstStage = AV_VK_FLAG ( VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT ) |
+        AV_VK_FLAG ( VK_PIPELINE_STAGE_VERTEX_INPUT_BIT ) |
+        AV_VK_FLAG ( VK_PIPELINE_STAGE_HOST_BIT );
+
+    vkCmdPipelineBarrier ( commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        dstStage,
+        0U,
+        1U,
+        &barrierInfo,
+        0U,
+        nullptr,
+        0U,
+        nullptr
+    );
+}
+
+void GPUCulling::RecordDraw ( VkCommandBuffer commandBuffer, size_t frame, size_t material, bool isIndexed ) const
+{
+    const uint32_t maxDraws = _materialDraws[ material ];
+
+    if ( !maxDraws )
+        return;
+
+    const Frame& source = _frames[ frame ];
+    VkBuffer commands = source._commands._buffer;
+    const auto offset = static_cast<VkDeviceSize> ( _materialCommands[ material ] * COMMAND_STRIDE );
+    const auto countOffset = static_cast<VkDeviceSize> ( material * sizeof ( uint32_t ) );
+
+    // The count variants skip the culled commands. Otherwise the culled commands are executed with zero instances.
+    if ( isIndexed )
+    {
+        if ( _drawIndexedIndirectCount )
+        {
+            _drawIndexedIndirectCount ( commandBuffer,
+                commands,
+                offset,
+                source._drawCounts._buffer,
+                countOffset,
+                maxDraws,
+                COMMAND_STRIDE
+            );
+
+            return;
+        }
+
+        vkCmdDrawIndexedIndirect ( commandBuffer, commands, offset, maxDraws, COMMAND_STRIDE );
+        return;
+    }
+
+    if ( _drawIndirectCount )
+    {
+        _drawIndirectCount ( commandBuffer,
+            commands,
+            offset,
+            source._drawCounts._buffer,
+            countOffset,
+            maxDraws,
+            COMMAND_STRIDE
+        );
+
+        return;
+    }
+
+    vkCmdDrawIndirect ( commandBuffer, commands, offset, maxDraws, COMMAND_STRIDE );
+}
+
+const VkBuffer& GPUCulling::GetVisibleInstances ( size_t frame ) const
+{
+    return _frames[ frame ]._visibleInstances._buffer;
+}
+
+bool GPUCulling::Verify ( size_t frame ) const
+{
+    const Frame& source = _frames[ frame ];
+
+    if ( !source._isCulled )
+        return true;
+
+    const GXProjectionClipPlanes clipPlanes ( source._localToClip );
+    const size_t objectCount = _bounds.size ();
+    auto visibility = std::make_unique<GXBool[]> ( objectCount );
+    GXBatchCullAABBs ( visibility.get (), _bounds.data (), clipPlanes, objectCount );
+
+    // The visible instance counts of the draws with at least one visible instance.
+    const size_t materialCount = _materialDraws.size ();
+    std::vector<std::vector<uint32_t>> expected ( materialCount );
+    const size_t drawCount = _drawMaterials.size ();
+
+    for ( size_t i = 0U; i < drawCount; ++i )
+    {
+        uint32_t visible = 0U;
+
+        for ( uint32_t j = 0U; j < _instanceCount; ++j )
+            visible += visibility[ i * _instanceCount + j ] ? 1U : 0U;
+
+        if ( visible )
+            expected[ _drawMaterials[ i ] ].push_back ( visible );
+    }
+
+    const uint8_t* commands = source._commands._mappedData;
+    const auto* drawCounts = reinterpret_cast<const uint32_t*> ( source._drawCounts._mappedData );
+    std::vector<uint32_t> actual {};
+    size_t mismatches = 0U;
+
+    // The visible draws of the material get the commands in the order of the atomic increments. So the instance
+    // counts are compared as sorted lists. The commands after the draw count must stay empty.
+    for ( size_t i = 0U; i < materialCount; ++i )
+    {
+        std::vector<uint32_t>& visibleDraws = expected[ i ];
+        const auto expectedDraws = static_cast<uint32_t> ( visibleDraws.size () );
+        mismatches += drawCounts[ i ] == expectedDraws ? 0U : 1U;
+        actual.clear ();
+
+        for ( uint32_t j = 0U; j < _materialDraws[ i ]; ++j )
+        {
+            const size_t command = _materialCommands[ i ] + j;
+            uint32_t instanceCount;
+
+            std::memcpy ( &instanceCount,
+                commands + command * COMMAND_STRIDE + INSTANCE_COUNT_OFFSET,
+                sizeof ( instanceCount )
+            );
+
+            if ( j < expectedDraws )
+            {
+                actual.push_back ( instanceCount );
+                continue;
+            }
+
+            mismatches += instanceCount == 0U ? 0U : 1U;
+        }
+
+        std::sort ( visibleDraws.begin (), visibleDraws.end () );
+        std::sort ( actual.begin (), actual.end () );
+        mismatches += actual == visibleDraws ? 0U : 1U;
+    }
+
+    if ( mismatches )
+    {
+        // Note the boxes which touch the plane could be classified differently because of the fused multiply-add.
+        android_vulkan::LogWarning ( "GPUCulling::Verify - %zu mismatches against CPU culling.", mismatches );
+        return false;
+    }
+
+    android_vulkan::LogInfo ( "GPUCulling::Verify - Results match CPU culling (%zu objects).", objectCount );
+    return true;
+}
+
+bool GPUCulling::CreateBuffer ( Buffer &buffer,
+    android_vulkan::Renderer &renderer,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags memoryProperties
+)
+{
+    VkBufferCreateInfo bufferInfo;
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = nullptr;
+    bufferInfo.flags = 0U;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = 0U;
+    bufferInfo.pQueueFamilyIndices = nullptr;
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult ( vkCreateBuffer ( device, &bufferInfo, nullptr, &buffer._buffer ),
+        "GPUCulling::CreateBuffer",
+        "Can't create buffer"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_BUFFER ( "GPUCulling::_frames" )
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements ( device, buffer._buffer, &requirements );
+
+    result = renderer.TryAllocateMemory ( buffer._memory,
+        buffer._memoryOffset,
+        requirements,
+        memoryProperties,
+        "Can't allocate buffer memory (GPUCulling::CreateBuffer)"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DEVICE_MEMORY ( "GPUCulling::_frames" )
+
+    result = renderer.CheckVkResult (
+        vkBindBufferMemory ( device, buffer._buffer, buffer._memory, buffer._memoryOffset ),
+        "GPUCulling::CreateBuffer",
+        "Can't bind buffer memory"
+    );
+
+    if ( !result || !( memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) )
+        return result;
+
+    void* data = nullptr;
+
+    result = renderer.MapMemory ( data,
+        buffer._memory,
+        buffer._memoryOffset,
+        "GPUCulling::CreateBuffer",
+        "Can't map buffer memory"
+    );
+
+    if ( !result )
+        return false;
+
+    buffer._mappedData = static_cast<uint8_t*> ( data );
+    return true;
+}
+
+void GPUCulling::DestroyBuffer ( Buffer &buffer, android_vulkan::Renderer &renderer )
+{
+    if ( buffer._mappedData )
+    {
+        renderer.UnmapMemory ( buffer._memory );
+        buffer._mappedData = nullptr;
+    }
+
+    if ( buffer._memory != VK_NULL_HANDLE )
+    {
+        renderer.FreeMemory ( buffer._memory, buffer._memoryOffset );
+        buffer._memory = VK_NULL_HANDLE;
+        buffer._memoryOffset = 0U;
+        AV_UNREGISTER_DEVICE_MEMORY ( "GPUCulling::_frames" )
+    }
+
+    if ( buffer._buffer == VK_NULL_HANDLE )
+        return;
+
+    vkDestroyBuffer ( renderer.GetDevice (), buffer._buffer, nullptr );
+    buffer._buffer = VK_NULL_HANDLE;
+    AV_UNREGISTER_BUFFER ( "GPUCulling::_frames" )
+}
+
+bool GPUCulling::CreateDescriptorSets ( android_vulkan::Renderer &renderer, VkBuffer instances )
+{
+    const auto frameCount = static_cast<uint32_t> ( _frames.size () );
+
+    VkDescriptorPoolSize poolSize;
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = frameCount * BINDING_COUNT;
+
+    VkDescriptorPoolCreateInfo poolInfo;
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.pNext = nullptr;
+    poolInfo.flags = 0U;
+    poolInfo.maxSets = frameCount;
+    poolInfo.poolSizeCount = 1U;
+    poolInfo.pPoolSizes = &poolSize;
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult ( vkCreateDescriptorPool ( device, &poolInfo, nullptr, &_descriptorPool ),
+        "GPUCulling::CreateDescriptorSets",
+        "Can't create descriptor pool"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DESCRIPTOR_POOL ( "GPUCulling::_descriptorPool" )
+
+    const std::vector<VkDescriptorSetLayout> layouts ( frameCount, _descriptorSetLayout );
+    std::vector<VkDescriptorSet> sets ( frameCount, VK_NULL_HANDLE );
+
+    VkDescriptorSetAllocateInfo allocateInfo;
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.descriptorPool = _descriptorPool;
+    allocateInfo.descriptorSetCount = frameCount;
+    allocateInfo.pSetLayouts = layouts.data ();
+
+    result = renderer.CheckVkResult ( vkAllocateDescriptorSets ( device, &allocateInfo, sets.data () ),
+        "GPUCulling::CreateDescriptorSets",
+        "Can't allocate descriptor sets"
+    );
+
+    if ( !result )
+        return false;
+
+    std::vector<VkDescriptorBufferInfo> bufferInfo ( frameCount * BINDING_COUNT );
+    std::vector<VkWriteDescriptorSet> writes ( frameCount * BINDING_COUNT );
+
+    for ( uint32_t i = 0U; i < frameCount; ++i )
+    {
+        Frame& frame = _frames[ i ];
+        frame._descriptorSet = sets[ i ];
+
+        // Indexed by the binding. See gpu-culling.cs.
+        const VkBuffer buffers[ BINDING_COUNT ] =
+        {
+            _boundsBuffer.GetBuffer (),
+            _draws.GetBuffer (),
+            instances,
+            frame._commands._buffer,
+            frame._drawCounts._buffer,
+            frame._visibleInstances._buffer
+        };
+
+        for ( uint32_t binding = 0U; binding < BINDING_COUNT; ++binding )
+        {
+            const uint32_t index = i * BINDING_COUNT + binding;
+
+            VkDescriptorBufferInfo& info = bufferInfo[ index ];
+            info.buffer = buffers[ binding ];
+            info.offset = 0U;
+            info.range = VK_WHOLE_SIZE;
+
+            VkWriteDescriptorSet& write = writes[ index ];
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.pNext = nullptr;
+            write.dstSet = frame._descriptorSet;
+            write.dstBinding = binding;
+            write.dstArrayElement = 0U;
+            write.descriptorCount = 1U;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pImageInfo = nullptr;
+            write.pBufferInfo = &info;
+            write.pTexelBufferView = nullptr;
+        }
+    }
+
+    vkUpdateDescriptorSets ( device, static_cast<uint32_t> ( writes.size () ), writes.data (), 0U, nullptr );
+    return true;
+}
+
+} // namespace rotating_mesh
@@ -0,0 +1,194 @@
+#include <rotating_mesh/ktx2_parser.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstring>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr static const uint8_t IDENTIFIER[] =
+{
+    0xABU, 0x4BU, 0x54U, 0x58U, 0x20U, 0x32U, 0x30U, 0xBBU, 0x0DU, 0x0AU, 0x1AU, 0x0AU
+};
+
+constexpr static const size_t OFFSET_FORMAT = 12U;
+constexpr static const size_t OFFSET_WIDTH = 20U;
+constexpr static const size_t OFFSET_HEIGHT = 24U;
+constexpr static const size_t OFFSET_DEPTH = 28U;
+constexpr static const size_t OFFSET_LAYERS = 32U;
+constexpr static const size_t OFFSET_FACES = 36U;
+constexpr static const size_t OFFSET_LEVELS = 40U;
+constexpr static const size_t OFFSET_SUPERCOMPRESSION = 44U;
+constexpr static const size_t OFFSET_LEVEL_INDEX = 80U;
+
+constexpr static const size_t LEVEL_INDEX_ENTRY_SIZE = 24U;
+
+static uint32_t ReadUInt32 ( const uint8_t* content, size_t offset )
+{
+    uint32_t value;
+    std::memcpy ( &value, content + offset, sizeof ( value ) );
+    return value;
+}
+
+static uint64_t ReadUInt64 ( const uint8_t* content, size_t offset )
+{
+    uint64_t value;
+    std::memcpy ( &value, content + offset, sizeof ( value ) );
+    return value;
+}
+
+static uint32_t CountMipLevels ( uint32_t width, uint32_t height )
+{
+    uint32_t side = width > height ? width : height;
+    uint32_t levels = 1U;
+
+    while ( side > 1U )
+    {
+        side >>= 1U;
+        ++levels;
+    }
+
+    return levels;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool KTX2Parser::IsKTX2 ( const uint8_t* content, size_t size )
+{
+    if ( size < OFFSET_LEVEL_INDEX )
+        return false;
+
+    return std::memcmp ( content, IDENTIFIER, sizeof ( IDENTIFIER ) ) == 0;
+}
+
+bool KTX2Parser::Parse ( KTX2Image &image, const uint8_t* content, size_t size )
+{
+    if ( !IsKTX2 ( content, size ) )
+        return false;
+
+    KTX2FormatInfo info {};
+    const uint32_t format = ReadUInt32 ( content, OFFSET_FORMAT );
+
+    if ( !GetFormatInfo ( info, format ) )
+        return false;
+
+    const uint32_t width = ReadUInt32 ( content, OFFSET_WIDTH );
+    const uint32_t height = ReadUInt32 ( content, OFFSET_HEIGHT );
+
+    if ( width == 0U || height == 0U )
+        return false;
+
+    // Arrays, cube maps, volume textures and supercompressed files are not supported.
+    if ( ReadUInt32 ( content, OFFSET_DEPTH ) != 0U || ReadUInt32 ( content, OFFSET_LAYERS ) != 0U )
+        return false;
+
+    if ( ReadUInt32 ( content, OFFSET_FACES ) != 1U || ReadUInt32 ( content, OFFSET_SUPERCOMPRESSION ) != 0U )
+        return false;
+
+    const uint32_t storedLevels = ReadUInt32 ( content, OFFSET_LEVELS );
+    const uint32_t levelCount = storedLevels == 0U ? 1U : storedLevels;
+
+    if ( levelCount > KTX2_MAX_LEVELS || levelCount > CountMipLevels ( width, height ) )
+        return false;
+
+    if ( static_cast<size_t> ( levelCount ) * LEVEL_INDEX_ENTRY_SIZE > size - OFFSET_LEVEL_INDEX )
+        return false;
+
+    const auto available = static_cast<uint64_t> ( size );
+
+    for ( uint32_t i = 0U; i < levelCount; ++i )
+    {
+        const size_t entry = OFFSET_LEVEL_INDEX + static_cast<size_t> ( i ) * LEVEL_INDEX_ENTRY_SIZE;
+        const uint64_t offset = ReadUInt64 ( content, entry );
+        const uint64_t length = ReadUInt64 ( content, entry + sizeof ( uint64_t ) );
+
+        if ( offset > available || length > available - offset )
+            return false;
+
+        const uint32_t levelWidth = width >> i;
+        const uint32_t levelHeight = height >> i;
+
+        const size_t expected = GetLevelSize ( info,
+            levelWidth > 1U ? levelWidth : 1U,
+            levelHeight > 1U ? levelHeight : 1U
+        );
+
+        if ( static_cast<uint64_t> ( expected ) != length )
+            return false;
+
+        KTX2Level& level = image._levels[ i ];
+        level._data = content + offset;
+        level._size = expected;
+    }
+
+    image._format = format;
+    image._width = width;
+    image._height = height;
+    image._isGenerateMipmaps = storedLevels == 0U;
+    image._levelCount = levelCount;
+    return true;
+}
+
+bool KTX2Parser::GetFormatInfo ( KTX2FormatInfo &info, uint32_t format )
+{
+    switch ( format )
+    {
+        case KTX2_FORMAT_R8G8B8A8_UNORM:
+        case KTX2_FORMAT_R8G8B8A8_SRGB:
+            info._blockWidth = 1U;
+            info._blockHeight = 1U;
+            info._blockSize = 4U;
+        return true;
+
+        case KTX2_FORMAT_BC1_RGB_UNORM:
+        case KTX2_FORMAT_BC1_RGB_SRGB:
+        case KTX2_FORMAT_ETC2_R8G8B8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8_SRGB:
+            info._blockWidth = 4U;
+            info._blockHeight = 4U;
+            info._blockSize = 8U;
+        return true;
+
+        case KTX2_FORMAT_BC3_UNORM:
+        case KTX2_FORMAT_BC3_SRGB:
+        case KTX2_FORMAT_BC7_UNORM:
+        case KTX2_FORMAT_BC7_SRGB:
+        case KTX2_FORMAT_ETC2_R8G8B8A8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8A8_SRGB:
+        case KTX2_FORMAT_ASTC_4x4_UNORM:
+        case KTX2_FORMAT_ASTC_4x4_SRGB:
+            info._blockWidth = 4U;
+            info._blockHeight = 4U;
+            info._blockSize = 16U;
+        return true;
+
+        case KTX2_FORMAT_ASTC_6x6_UNORM:
+        case KTX2_FORMAT_ASTC_6x6_SRGB:
+            info._blockWidth = 6U;
+            info._blockHeight = 6U;
+            info._blockSize = 16U;
+        return true;
+
+        case KTX2_FORMAT_ASTC_8x8_UNORM:
+        case KTX2_FORMAT_ASTC_8x8_SRGB:
+            info._blockWidth = 8U;
+            info._blockHeight = 8U;
+            info._blockSize = 16U;
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+size_t KTX2Parser::GetLevelSize ( const KTX2FormatInfo &info, uint32_t width, uint32_t height )
+{
+    const auto columns = static_cast<size_t> ( ( width + info._blockWidth - 1U ) / info._blockWidth );
+    const auto rows = static_cast<size_t> ( ( height + info._blockHeight - 1U ) / info._blockHeight );
+    return columns * rows * static_cast<size_t> ( info._blockSize );
+}
+
+} // namespace rotating_mesh
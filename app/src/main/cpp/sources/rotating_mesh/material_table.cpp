@@ -0,0 +1,449 @@
+#include <rotating_mesh/material_table.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+#include <vulkan_utils.h>
+
+
+namespace rotating_mesh {
+
+// Note the per stage limits must leave the room for the extra bindings. The minimal limits are 16 sampled images and
+// 16 samplers.
+constexpr static const uint32_t TEXTURE_CAPACITY = 32U;
+constexpr static const uint32_t SAMPLER_CAPACITY = 8U;
+
+constexpr static const uint32_t TRANSFORM_BINDING = 0U;
+constexpr static const uint32_t MATERIAL_BINDING = 1U;
+constexpr static const uint32_t TEXTURE_BINDING = 2U;
+constexpr static const uint32_t SAMPLER_BINDING = 3U;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+static bool FindOrAppend ( uint32_t &index, std::vector<T> &items, T item, uint32_t capacity, const char* what )
+{
+    const auto findResult = std::find ( items.cbegin (), items.cend (), item );
+
+    if ( findResult != items.cend () )
+    {
+        index = static_cast<uint32_t> ( std::distance ( items.cbegin (), findResult ) );
+        return true;
+    }
+
+    if ( items.size () >= static_cast<size_t> ( capacity ) )
+    {
+        android_vulkan::LogError ( "MaterialTable::SetMaterial - Too many %s. Capacity: %u.", what, capacity );
+        return false;
+    }
+
+    index = static_cast<uint32_t> ( items.size () );
+    items.push_back ( item );
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MaterialTable::MaterialTable ():
+    _descriptorPool ( VK_NULL_HANDLE ),
+    _descriptorSet ( VK_NULL_HANDLE ),
+    _descriptorSetLayout ( VK_NULL_HANDLE ),
+    _images {},
+    _materialBuffer ( VK_NULL_HANDLE ),
+    _materialCapacity ( 0U ),
+    _materialMemory ( VK_NULL_HANDLE ),
+    _materialMemoryOffset ( 0U ),
+    _materials ( nullptr ),
+    _samplers {}
+{
+    // NOTHING
+}
+
+bool MaterialTable::IsSupported ( android_vulkan::Renderer &renderer )
+{
+    if ( !renderer.IsDescriptorIndexingSupported () )
+        return false;
+
+    // The material index is the push constant. So the index is dynamically uniform.
+    if ( !renderer.GetPhysicalDeviceFeatures ().shaderSampledImageArrayDynamicIndexing )
+        return false;
+
+    const VkPhysicalDeviceLimits& limits = renderer.GetPhysicalDeviceLimits ();
+
+    return limits.maxPerStageDescriptorSampledImages > TEXTURE_CAPACITY &&
+        limits.maxPerStageDescriptorSamplers > SAMPLER_CAPACITY;
+}
+
+bool MaterialTable::Init ( android_vulkan::Renderer &renderer,
+    uint32_t materialCapacity,
+    const UniformBuffer &transformBuffer,
+    const VkDescriptorSetLayoutBinding* extraBindings,
+    uint32_t extraBindingCount
+)
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings ( MATERIAL_TABLE_BINDING_COUNT );
+
+    VkDescriptorSetLayoutBinding& transformInfo = bindings[ TRANSFORM_BINDING ];
+    transformInfo.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    transformInfo.descriptorType = transformBuffer.GetDescriptorType ();
+    transformInfo.descriptorCount = 1U;
+    transformInfo.binding = TRANSFORM_BINDING;
+    transformInfo.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding& materialInfo = bindings[ MATERIAL_BINDING ];
+    materialInfo.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    materialInfo.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    materialInfo.descriptorCount = 1U;
+    materialInfo.binding = MATERIAL_BINDING;
+    materialInfo.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding& textureInfo = bindings[ TEXTURE_BINDING ];
+    textureInfo.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    textureInfo.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    textureInfo.descriptorCount = TEXTURE_CAPACITY;
+    textureInfo.binding = TEXTURE_BINDING;
+    textureInfo.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding& samplerInfo = bindings[ SAMPLER_BINDING ];
+    samplerInfo.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    samplerInfo.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    samplerInfo.descriptorCount = SAMPLER_CAPACITY;
+    samplerInfo.binding = SAMPLER_BINDING;
+    samplerInfo.pImmutableSamplers = nullptr;
+
+    bindings.insert ( bindings.cend (), extraBindings, extraBindings + extraBindingCount );
+
+    // Only the elements which are used by the materials are written.
+    std::vector<VkDescriptorBindingFlagsEXT> bindingFlags ( bindings.size (), 0U );
+    bindingFlags[ TEXTURE_BINDING ] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+    bindingFlags[ SAMPLER_BINDING ] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo;
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsInfo.pNext = nullptr;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t> ( bindingFlags.size () );
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data ();
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetInfo;
+    descriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetInfo.pNext = &bindingFlagsInfo;
+    descriptorSetInfo.flags = 0U;
+    descriptorSetInfo.bindingCount = static_cast<uint32_t> ( bindings.size () );
+    descriptorSetInfo.pBindings = bindings.data ();
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult (
+        vkCreateDescriptorSetLayout ( device, &descriptorSetInfo, nullptr, &_descriptorSetLayout ),
+        "MaterialTable::Init",
+        "Can't create descriptor set layout"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DESCRIPTOR_SET_LAYOUT ( "MaterialTable::_descriptorSetLayout" )
+
+    // Note the pool sizes of the same type are summed by the implementation.
+    std::vector<VkDescriptorPoolSize> features ( bindings.size () );
+
+    for ( size_t i = 0U; i < bindings.size (); ++i )
+    {
+        const VkDescriptorSetLayoutBinding& binding = bindings[ i ];
+        VkDescriptorPoolSize& feature = features[ i ];
+        feature.type = binding.descriptorType;
+        feature.descriptorCount = binding.descriptorCount;
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo;
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.pNext = nullptr;
+    poolInfo.flags = 0U;
+    poolInfo.maxSets = 1U;
+    poolInfo.poolSizeCount = static_cast<uint32_t> ( features.size () );
+    poolInfo.pPoolSizes = features.data ();
+
+    result = renderer.CheckVkResult ( vkCreateDescriptorPool ( device, &poolInfo, nullptr, &_descriptorPool ),
+        "MaterialTable::Init",
+        "Can't create descriptor pool"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DESCRIPTOR_POOL ( "MaterialTable::_descriptorPool" )
+
+    VkDescriptorSetAllocateInfo setAllocateInfo;
+    setAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    setAllocateInfo.pNext = nullptr;
+    setAllocateInfo.descriptorPool = _descriptorPool;
+    setAllocateInfo.pSetLayouts = &_descriptorSetLayout;
+    setAllocateInfo.descriptorSetCount = 1U;
+
+    result = renderer.CheckVkResult ( vkAllocateDescriptorSets ( device, &setAllocateInfo, &_descriptorSet ),
+        "MaterialTable::Init",
+        "Can't allocate descriptor set"
+    );
+
+    if ( !result )
+        return false;
+
+    // The records are changed only when the queue is idle. So they are written by CPU directly.
+    VkBufferCreateInfo bufferInfo;
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = nullptr;
+    bufferInfo.flags = 0U;
+    bufferInfo.size = static_cast<VkDeviceSize> ( materialCapacity * sizeof ( Material ) );
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = 0U;
+    bufferInfo.pQueueFamilyIndices = nullptr;
+
+    result = renderer.CheckVkResult ( vkCreateBuffer ( device, &bufferInfo, nullptr, &_materialBuffer ),
+        "MaterialTable::Init",
+        "Can't create buffer"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_BUFFER ( "MaterialTable::_materialBuffer" )
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements ( device, _materialBuffer, &requirements );
+
+    result = renderer.TryAllocateMemory ( _materialMemory,
+        _materialMemoryOffset,
+        requirements,
+        AV_VK_FLAG ( VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) | AV_VK_FLAG ( VK_MEMORY_PROPERTY_HOST_COHERENT_BIT ),
+        "Can't allocate buffer memory (MaterialTable::Init)"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DEVICE_MEMORY ( "MaterialTable::_materialMemory" )
+
+    result = renderer.CheckVkResult (
+        vkBindBufferMemory ( device, _materialBuffer, _materialMemory, _materialMemoryOffset ),
+        "MaterialTable::Init",
+        "Can't bind buffer memory"
+    );
+
+    if ( !result )
+        return false;
+
+    void* data = nullptr;
+
+    result = renderer.MapMemory ( data,
+        _materialMemory,
+        _materialMemoryOffset,
+        "MaterialTable::Init",
+        "Can't map buffer memory"
+    );
+
+    if ( !result )
+        return false;
+
+    _materials = static_cast<Material*> ( data );
+    _materialCapacity = materialCapacity;
+
+    VkDescriptorBufferInfo transformBufferInfo;
+    transformBufferInfo.buffer = transformBuffer.GetBuffer ();
+    transformBufferInfo.offset = 0U;
+    transformBufferInfo.range = static_cast<VkDeviceSize> ( transformBuffer.GetSize () );
+
+    VkDescriptorBufferInfo materialBufferInfo;
+    materialBufferInfo.buffer = _materialBuffer;
+    materialBufferInfo.offset = 0U;
+    materialBufferInfo.range = bufferInfo.size;
+
+    VkWriteDescriptorSet writeSets[ 2U ];
+
+    VkWriteDescriptorSet& transformWriteSet = writeSets[ 0U ];
+    transformWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    transformWriteSet.pNext = nullptr;
+    transformWriteSet.dstSet = _descriptorSet;
+    transformWriteSet.descriptorType = transformBuffer.GetDescriptorType ();
+    transformWriteSet.dstBinding = TRANSFORM_BINDING;
+    transformWriteSet.dstArrayElement = 0U;
+    transformWriteSet.descriptorCount = 1U;
+    transformWriteSet.pBufferInfo = &transformBufferInfo;
+    transformWriteSet.pImageInfo = nullptr;
+    transformWriteSet.pTexelBufferView = nullptr;
+
+    VkWriteDescriptorSet& materialWriteSet = writeSets[ 1U ];
+    materialWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    materialWriteSet.pNext = nullptr;
+    materialWriteSet.dstSet = _descriptorSet;
+    materialWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    materialWriteSet.dstBinding = MATERIAL_BINDING;
+    materialWriteSet.dstArrayElement = 0U;
+    materialWriteSet.descriptorCount = 1U;
+    materialWriteSet.pBufferInfo = &materialBufferInfo;
+    materialWriteSet.pImageInfo = nullptr;
+    materialWriteSet.pTexelBufferView = nullptr;
+
+    vkUpdateDescriptorSets ( device, static_cast<uint32_t> ( std::size ( writeSets ) ), writeSets, 0U, nullptr );
+    return true;
+}
+
+void MaterialTable::Destroy ( android_vulkan::Renderer &renderer )
+{
+    VkDevice device = renderer.GetDevice ();
+
+    if ( _materials )
+    {
+        renderer.UnmapMemory ( _materialMemory );
+        _materials = nullptr;
+    }
+
+    if ( _materialMemory != VK_NULL_HANDLE )
+    {
+        renderer.FreeMemory ( _materialMemory, _materialMemoryOffset );
+        _materialMemory = VK_NULL_HANDLE;
+        _materialMemoryOffset = 0U;
+        AV_UNREGISTER_DEVICE_MEMORY ( "MaterialTable::_materialMemory" )
+    }
+
+    if ( _materialBuffer != VK_NULL_HANDLE )
+    {
+        vkDestroyBuffer ( device, _materialBuffer, nullptr );
+        _materialBuffer = VK_NULL_HANDLE;
+        AV_UNREGISTER_BUFFER ( "MaterialTable::_materialBuffer" )
+    }
+
+    _materialCapacity = 0U;
+    Reset ();
+
+    if ( _descriptorPool != VK_NULL_HANDLE )
+    {
+        // Note the descriptor set is released with the pool.
+        vkDestroyDescriptorPool ( device, _descriptorPool, nullptr );
+        _descriptorPool = VK_NULL_HANDLE;
+        _descriptorSet = VK_NULL_HANDLE;
+        AV_UNREGISTER_DESCRIPTOR_POOL ( "MaterialTable::_descriptorPool" )
+    }
+
+    if ( _descriptorSetLayout == VK_NULL_HANDLE )
+        return;
+
+    vkDestroyDescriptorSetLayout ( device, _descriptorSetLayout, nullptr );
+    _descriptorSetLayout = VK_NULL_HANDLE;
+    AV_UNREGISTER_DESCRIPTOR_SET_LAYOUT ( "MaterialTable::_descriptorSetLayout" )
+}
+
+VkDescriptorSet MaterialTable::GetDescriptorSet () const
+{
+    return _descriptorSet;
+}
+
+VkDescriptorSetLayout MaterialTable::GetDescriptorSetLayout () const
+{
+    return _descriptorSetLayout;
+}
+
+void MaterialTable::Reset ()
+{
+    _images.clear ();
+    _samplers.clear ();
+}
+
+bool MaterialTable::SetMaterial ( uint32_t material,
+    VkImageView diffuse,
+    VkSampler diffuseSampler,
+    VkImageView normal,
+    VkSampler normalSampler
+)
+{
+    if ( material >= _materialCapacity )
+    {
+        android_vulkan::LogError ( "MaterialTable::SetMaterial - Material %u is out of capacity %u.",
+            material,
+            _materialCapacity
+        );
+
+        return false;
+    }
+
+    Material record;
+
+    const bool result =
+        FindOrAppend ( record._diffuse, _images, diffuse, TEXTURE_CAPACITY, "textures" ) &&
+        FindOrAppend ( record._diffuseSampler, _samplers, diffuseSampler, SAMPLER_CAPACITY, "samplers" ) &&
+        FindOrAppend ( record._normal, _images, normal, TEXTURE_CAPACITY, "textures" ) &&
+        FindOrAppend ( record._normalSampler, _samplers, normalSampler, SAMPLER_CAPACITY, "samplers" );
+
+    if ( !result )
+        return false;
+
+    _materials[ material ] = record;
+    return true;
+}
+
+void MaterialTable::Commit ( android_vulkan::Renderer &renderer ) const
+{
+    std::vector<VkDescriptorImageInfo> imageInfo ( _images.size () + _samplers.size () );
+    VkDescriptorImageInfo* images = imageInfo.data ();
+    VkDescriptorImageInfo* samplers = images + _images.size ();
+
+    for ( size_t i = 0U; i < _images.size (); ++i )
+    {
+        VkDescriptorImageInfo& info = images[ i ];
+        info.sampler = VK_NULL_HANDLE;
+        info.imageView = _images[ i ];
+        info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    for ( size_t i = 0U; i < _samplers.size (); ++i )
+    {
+        VkDescriptorImageInfo& info = samplers[ i ];
+        info.sampler = _samplers[ i ];
+        info.imageView = VK_NULL_HANDLE;
+        info.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    VkWriteDescriptorSet writeSets[ 2U ];
+    uint32_t writeSetCount = 0U;
+
+    if ( !_images.empty () )
+    {
+        VkWriteDescriptorSet& textureWriteSet = writeSets[ writeSetCount++ ];
+        textureWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        textureWriteSet.pNext = nullptr;
+        textureWriteSet.dstSet = _descriptorSet;
+        textureWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        textureWriteSet.dstBinding = TEXTURE_BINDING;
+        textureWriteSet.dstArrayElement = 0U;
+        textureWriteSet.descriptorCount = static_cast<uint32_t> ( _images.size () );
+        textureWriteSet.pBufferInfo = nullptr;
+        textureWriteSet.pImageInfo = images;
+        textureWriteSet.pTexelBufferView = nullptr;
+    }
+
+    if ( !_samplers.empty () )
+    {
+        VkWriteDescriptorSet& samplerWriteSet = writeSets[ writeSetCount++ ];
+        samplerWriteSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        samplerWriteSet.pNext = nullptr;
+        samplerWriteSet.dstSet = _descriptorSet;
+        samplerWriteSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        samplerWriteSet.dstBinding = SAMPLER_BINDING;
+        samplerWriteSet.dstArrayElement = 0U;
+        samplerWriteSet.descriptorCount = static_cast<uint32_t> ( _samplers.size () );
+        samplerWriteSet.pBufferInfo = nullptr;
+        samplerWriteSet.pImageInfo = samplers;
+        samplerWriteSet.pTexelBufferView = nullptr;
+    }
+
+    if ( writeSetCount == 0U )
+        return;
+
+    vkUpdateDescriptorSets ( renderer.GetDevice (), writeSetCount, writeSets, 0U, nullptr );
+}
+
+} // namespace rotating_mesh
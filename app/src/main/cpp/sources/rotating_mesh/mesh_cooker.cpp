@@ -0,0 +1,210 @@
+#include <rotating_mesh/mesh_cooker.h>
+#include <rotating_mesh/mesh_optimizer.h>
+#include <rotating_mesh/mesh_parser.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstring>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr static const GXUInt CHUNK_COUNT = 3U;
+constexpr static const uint32_t NO_MESHLET = UINT32_MAX;
+
+static size_t AlignChunk ( size_t offset )
+{
+    constexpr const size_t mask = static_cast<size_t> ( GX_NATIVE_MESH_V2_ALIGNMENT ) - 1U;
+    return ( offset + mask ) & ~mask;
+}
+
+static void BuildMeshlets ( std::vector<GXNativeMeshlet> &meshlets,
+    const std::vector<VertexInfo> &vertices,
+    const std::vector<uint32_t> &indices
+)
+{
+    // The meshlets follow the cache optimized triangle order. So the triangles of the meshlet are close to each other.
+    std::vector<uint32_t> owners ( vertices.size (), NO_MESHLET );
+    meshlets.clear ();
+
+    GXAABB bounds {};
+    uint32_t meshlet = 0U;
+    size_t meshletVertices = 0U;
+    size_t meshletTriangles = 0U;
+    size_t firstIndex = 0U;
+
+    auto flush = [ & ] ( size_t end ) {
+        GXNativeMeshlet& item = meshlets.emplace_back ();
+        item.firstIndex = static_cast<GXUInt> ( firstIndex );
+        item.totalIndices = static_cast<GXUInt> ( end - firstIndex );
+        item.boundsMin = bounds._min;
+        item.boundsMax = bounds._max;
+
+        bounds.Empty ();
+        ++meshlet;
+        meshletVertices = 0U;
+        meshletTriangles = 0U;
+        firstIndex = end;
+    };
+
+    for ( size_t i = 0U; i < indices.size (); i += 3U )
+    {
+        size_t added = 0U;
+
+        for ( size_t j = 0U; j < 3U; ++j )
+        {
+            if ( owners[ indices[ i + j ] ] != meshlet )
+                ++added;
+        }
+
+        if ( meshletVertices + added > MESHLET_MAX_VERTICES || meshletTriangles == MESHLET_MAX_TRIANGLES )
+            flush ( i );
+
+        for ( size_t j = 0U; j < 3U; ++j )
+        {
+            const uint32_t index = indices[ i + j ];
+
+            if ( owners[ index ] == meshlet )
+                continue;
+
+            owners[ index ] = meshlet;
+            bounds.AddVertex ( vertices[ index ]._vertex );
+            ++meshletVertices;
+        }
+
+        ++meshletTriangles;
+    }
+
+    if ( meshletTriangles )
+        flush ( indices.size () );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void MeshCooker::Cook ( std::vector<uint8_t> &content,
+    const VertexInfo* vertices,
+    size_t count,
+    eVertexFormat format,
+    eTangentMerge tangentMerge,
+    MeshCookerStats* stats
+)
+{
+    std::vector<VertexInfo> unique;
+    std::vector<uint32_t> indices;
+
+    MeshOptimizer::Deduplicate ( unique,
+        indices,
+        vertices,
+        count,
+        tangentMerge,
+        stats ? &stats->_tangentMergeError : nullptr
+    );
+
+    const size_t uniqueCount = unique.size ();
+    const size_t indexCount = indices.size ();
+
+    if ( stats )
+    {
+        stats->_sourceVertices = count;
+        stats->_uniqueVertices = uniqueCount;
+
+        stats->_originalACMR = MeshOptimizer::ComputeACMR ( indices.data (),
+            indexCount,
+            uniqueCount,
+            VERTEX_CACHE_SIZE
+        );
+
+        stats->_packingError = {};
+    }
+
+    MeshOptimizer::OptimizeVertexCache ( indices.data (), indexCount, uniqueCount );
+    MeshOptimizer::OptimizeVertexFetch ( unique, indices.data (), indexCount );
+
+    std::vector<GXNativeMeshlet> meshlets;
+    BuildMeshlets ( meshlets, unique, indices );
+
+    GXAABB bounds {};
+
+    for ( const VertexInfo& vertex : unique )
+        bounds.AddVertex ( vertex._vertex );
+
+    const bool isPacked = format == eVertexFormat::Packed;
+    const bool isShortIndex = uniqueCount <= static_cast<size_t> ( UINT16_MAX ) + 1U;
+    const size_t vertexSize = isPacked ? sizeof ( PackedVertexInfo ) : sizeof ( VertexInfo );
+    const size_t indexSize = isShortIndex ? sizeof ( uint16_t ) : sizeof ( uint32_t );
+
+    const size_t tableSize = static_cast<size_t> ( CHUNK_COUNT ) * sizeof ( GXNativeMeshChunk );
+    const size_t vertexOffset = AlignChunk ( sizeof ( GXNativeMeshHeaderV2 ) + tableSize );
+    const size_t vertexDataSize = uniqueCount * vertexSize;
+    const size_t indexOffset = AlignChunk ( vertexOffset + vertexDataSize );
+    const size_t indexDataSize = indexCount * indexSize;
+    const size_t meshletOffset = AlignChunk ( indexOffset + indexDataSize );
+    const size_t meshletDataSize = meshlets.size () * sizeof ( GXNativeMeshlet );
+
+    content.assign ( meshletOffset + meshletDataSize, 0U );
+    uint8_t* data = content.data ();
+
+    GXNativeMeshHeaderV2 header {};
+    header.magic = GX_NATIVE_MESH_V2_MAGIC;
+    header.version = GX_NATIVE_MESH_V2_VERSION;
+    header.vertexLayout = static_cast<GXUInt> ( format );
+    header.totalVertices = static_cast<GXUInt> ( uniqueCount );
+    header.totalIndices = static_cast<GXUInt> ( indexCount );
+    header.indexSize = static_cast<GXUInt> ( indexSize );
+    header.totalChunks = CHUNK_COUNT;
+    header.boundsMin = bounds._min;
+    header.boundsMax = bounds._max;
+    std::memcpy ( data, &header, sizeof ( header ) );
+
+    const GXNativeMeshChunk chunks[ CHUNK_COUNT ] =
+    {
+        { static_cast<GXUInt> ( eGXNativeMeshChunk::Vertices ), vertexOffset, vertexDataSize },
+        { static_cast<GXUInt> ( eGXNativeMeshChunk::Indices ), indexOffset, indexDataSize },
+        { static_cast<GXUInt> ( eGXNativeMeshChunk::Meshlets ), meshletOffset, meshletDataSize }
+    };
+
+    std::memcpy ( data + sizeof ( header ), chunks, sizeof ( chunks ) );
+
+    if ( isPacked )
+    {
+        auto* packed = reinterpret_cast<PackedVertexInfo*> ( data + vertexOffset );
+        VertexPacker::Pack ( packed, unique.data (), uniqueCount );
+
+        if ( stats )
+            VertexPacker::MeasureError ( stats->_packingError, packed, unique.data (), uniqueCount );
+    }
+    else
+    {
+        auto* converted = reinterpret_cast<VertexInfo*> ( data + vertexOffset );
+        MeshParser::ConvertVertices ( converted, unique.data (), uniqueCount );
+    }
+
+    if ( isShortIndex )
+    {
+        auto* destination = reinterpret_cast<uint16_t*> ( data + indexOffset );
+
+        for ( size_t i = 0U; i < indexCount; ++i )
+            destination[ i ] = static_cast<uint16_t> ( indices[ i ] );
+    }
+    else
+    {
+        std::memcpy ( data + indexOffset, indices.data (), indexDataSize );
+    }
+
+    std::memcpy ( data + meshletOffset, meshlets.data (), meshletDataSize );
+
+    if ( !stats )
+        return;
+
+    stats->_meshlets = meshlets.size ();
+
+    stats->_optimizedACMR = MeshOptimizer::ComputeACMR ( indices.data (),
+        indexCount,
+        uniqueCount,
+        VERTEX_CACHE_SIZE
+    );
+}
+
+} // namespace rotating_mesh
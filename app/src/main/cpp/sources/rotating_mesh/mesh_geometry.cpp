@@ -2,25 +2,33 @@
 
 GX_DISABLE_COMMON_WARNINGS
 
-#include <array>
 #include <cassert>
-#include <thread>
+#include <cstring>
+#include <vector>
 
 GX_RESTORE_WARNING_STATE
 
 #include <file.h>
 #include <logger.h>
 #include <vulkan_utils.h>
-#include <GXCommon/GXNativeMesh.h>
-#include <rotating_mesh/vertex_info.h>
+#include <rotating_mesh/mesh_cooker.h>
+#include <rotating_mesh/mesh_parser.h>
 
 
 namespace rotating_mesh {
 
-constexpr static const size_t UV_THREADS = 4U;
-
 const std::map<VkBufferUsageFlags, BufferSyncItem> MeshGeometry::_accessMapper =
 {
+    {
+        AV_VK_FLAG ( VK_BUFFER_USAGE_INDEX_BUFFER_BIT ) | AV_VK_FLAG ( VK_BUFFER_USAGE_VERTEX_BUFFER_BIT ),
+
+        BufferSyncItem ( VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            AV_VK_FLAG ( VK_ACCESS_INDEX_READ_BIT ) | AV_VK_FLAG ( VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT ),
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+        )
+    },
+
     {
         VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 
@@ -39,15 +47,42 @@ const std::map<VkBufferUsageFlags, BufferSyncItem> MeshGeometry::_accessMapper =
             VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
         )
+    },
+
+    {
+        AV_VK_FLAG ( VK_BUFFER_USAGE_VERTEX_BUFFER_BIT ) | AV_VK_FLAG ( VK_BUFFER_USAGE_STORAGE_BUFFER_BIT ),
+
+        BufferSyncItem ( VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            AV_VK_FLAG ( VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT ) | AV_VK_FLAG ( VK_ACCESS_SHADER_READ_BIT ),
+            AV_VK_FLAG ( VK_PIPELINE_STAGE_VERTEX_INPUT_BIT ) | AV_VK_FLAG ( VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT )
+        )
+    },
+
+    {
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+
+        BufferSyncItem ( VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+        )
     }
 };
 
 MeshGeometry::MeshGeometry ():
+    _bounds {},
     _buffer ( VK_NULL_HANDLE ),
     _bufferMemory ( VK_NULL_HANDLE ),
+    _bufferMemoryOffset ( 0U ),
+    _indexCount ( 0U ),
+    _indexOffset ( 0U ),
+    _indexType ( VK_INDEX_TYPE_UINT32 ),
     _transferBuffer ( VK_NULL_HANDLE ),
     _transferMemory ( VK_NULL_HANDLE ),
-    _vertexCount ( 0U )
+    _transferMemoryOffset ( 0U ),
+    _vertexCount ( 0U ),
+    _vertexFormat ( eVertexFormat::Full )
 {
     // NOTHING
 
@@ -68,8 +103,9 @@ void MeshGeometry::FreeTransferResources ( android_vulkan::Renderer &renderer )
 
     if ( _transferMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _transferMemory, nullptr );
+        renderer.FreeMemory ( _transferMemory, _transferMemoryOffset );
         _transferMemory = VK_NULL_HANDLE;
+        _transferMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "MeshGeometry::_transferMemory" )
     }
 
@@ -81,6 +117,11 @@ void MeshGeometry::FreeTransferResources ( android_vulkan::Renderer &renderer )
     AV_UNREGISTER_BUFFER ( "MeshGeometry::_transferBuffer" )
 }
 
+const GXAABB& MeshGeometry::GetBounds () const
+{
+    return _bounds;
+}
+
 const VkBuffer& MeshGeometry::GetBuffer () const
 {
     return _buffer;
@@ -91,6 +132,26 @@ uint32_t MeshGeometry::GetVertexCount () const
     return _vertexCount;
 }
 
+eVertexFormat MeshGeometry::GetVertexFormat () const
+{
+    return _vertexFormat;
+}
+
+uint32_t MeshGeometry::GetIndexCount () const
+{
+    return _indexCount;
+}
+
+VkDeviceSize MeshGeometry::GetIndexOffset () const
+{
+    return _indexOffset;
+}
+
+VkIndexType MeshGeometry::GetIndexType () const
+{
+    return _indexType;
+}
+
 bool MeshGeometry::LoadMesh ( std::string &&fileName,
     VkBufferUsageFlags usage,
     android_vulkan::Renderer &renderer,
@@ -103,62 +164,106 @@ bool MeshGeometry::LoadMesh ( std::string &&fileName,
         return false;
     }
 
+    android_vulkan::File file ( std::move ( fileName ) );
+
+    if ( !file.MapContent () )
+        return false;
+
+    return LoadMesh ( file, eVertexFormat::Full, usage, renderer, commandBuffer );
+}
+
+bool MeshGeometry::LoadMesh ( const android_vulkan::File &file,
+    eVertexFormat format,
+    VkBufferUsageFlags usage,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+)
+{
     FreeResourceInternal ( renderer );
 
-    android_vulkan::File file ( fileName );
+    const uint8_t* content = file.GetData ();
+    size_t size = file.GetSize ();
+    std::vector<uint8_t> cooked;
 
-    if ( !file.LoadContent () )
-        return false;
+    if ( !MeshParser::IsCooked ( content, size ) )
+    {
+        // Version 1.2 fallback. The mesh is cooked at load time. Use the host mesh cooker to do it offline.
+        const VertexInfo* vertices = nullptr;
+        uint32_t vertexCount = 0U;
 
-    std::vector<uint8_t>& content = file.GetContent ();
-    const auto& header = *reinterpret_cast<const GXNativeMeshHeader*> ( content.data () );
-
-    constexpr size_t skipFactor = UV_THREADS - 1U;
-    const size_t verticesPerBatch = static_cast<size_t> ( header.totalVertices ) / UV_THREADS;
-    const size_t toNextBatch = verticesPerBatch * skipFactor;
-    const auto lastIndex = static_cast<const size_t> ( header.totalVertices - 1U );
-    auto* vertices = reinterpret_cast<VertexInfo*> ( content.data () + header.vboOffset );
-
-    auto converter = [ & ] ( VertexInfo* vertices,
-        size_t currentIndex,
-        size_t lastIndex,
-        size_t toNextBatch,
-        size_t verticesPerBatch
-    ) {
-        while ( currentIndex <= lastIndex )
+        if ( !MeshParser::Parse ( vertices, vertexCount, content, size ) )
         {
-            const size_t limit = std::min ( lastIndex, currentIndex + verticesPerBatch );
+            android_vulkan::LogError ( "MeshGeometry::LoadMesh - File %s is corrupted.", file.GetPath ().c_str () );
+            return false;
+        }
+
+#ifdef ANDROID_VULKAN_DEBUG
 
-            for ( ; currentIndex < limit; ++currentIndex )
-            {
-                GXVec2& uv = vertices[ currentIndex ]._uv;
-                uv._data[ 1U ] = 1.0F - uv._data[ 1U ];
-            }
+        MeshCookerStats stats {};
+        MeshCooker::Cook ( cooked,
+            vertices,
+            static_cast<size_t> ( vertexCount ),
+            format,
+            eTangentMerge::None,
+            &stats
+        );
 
-            currentIndex += toNextBatch;
+        android_vulkan::LogInfo ( "MeshGeometry::LoadMesh - %s is cooked at load time: vertices %zu -> %zu, "
+            "ACMR %g -> %g, %zu meshlet(s).",
+            file.GetPath ().c_str (),
+            stats._sourceVertices,
+            stats._uniqueVertices,
+            static_cast<double> ( stats._originalACMR ),
+            static_cast<double> ( stats._optimizedACMR ),
+            stats._meshlets
+        );
+
+        if ( format == eVertexFormat::Packed )
+        {
+            const VertexPackingError& error = stats._packingError;
+
+            android_vulkan::LogInfo ( "MeshGeometry::LoadMesh - %s packing error: UV %g, normal %g, tangent %g, "
+                "bitangent %g deg, average skew %g deg.",
+                file.GetPath ().c_str (),
+                static_cast<double> ( error._uv ),
+                static_cast<double> ( error._normal ),
+                static_cast<double> ( error._tangent ),
+                static_cast<double> ( error._bitangent ),
+                static_cast<double> ( error._averageSkew )
+            );
         }
-    };
 
-    std::array<std::thread, UV_THREADS> converters;
+#else
 
-    for ( size_t i = 0U; i < UV_THREADS; ++i )
-    {
-        converters[ i ] = std::thread ( converter,
+        MeshCooker::Cook ( cooked,
             vertices,
-            i * verticesPerBatch,
-            lastIndex,
-            toNextBatch,
-            verticesPerBatch
+            static_cast<size_t> ( vertexCount ),
+            format,
+            eTangentMerge::None,
+            nullptr
         );
+
+#endif // ANDROID_VULKAN_DEBUG
+
+        content = cooked.data ();
+        size = cooked.size ();
+    }
+
+    CookedMesh mesh {};
+
+    if ( !MeshParser::ParseCooked ( mesh, content, size ) )
+    {
+        android_vulkan::LogError ( "MeshGeometry::LoadMesh - File %s is corrupted.", file.GetPath ().c_str () );
+        return false;
     }
 
-    for ( auto& item : converters )
-        item.join ();
+    // Note the index offset is aligned by 4 bytes because the sizes of both vertex layouts are multiple of 4.
+    uint8_t* transferData = nullptr;
 
-    const bool result = LoadMeshInternal ( reinterpret_cast<const uint8_t*> ( vertices ),
-        header.totalVertices * sizeof ( VertexInfo ),
-        header.totalVertices,
-        usage,
+    const bool result = LoadMeshInternal ( transferData,
+        mesh._vertexDataSize + mesh._indexDataSize,
+        mesh._vertexCount,
+        usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
         renderer,
         commandBuffer
     );
@@ -166,7 +271,17 @@ bool MeshGeometry::LoadMesh ( std::string &&fileName,
     if ( !result )
         return false;
 
-    _fileName = std::move ( fileName );
+    // The chunks are ready for upload. So there is no per vertex work.
+    std::memcpy ( transferData, mesh._vertices, mesh._vertexDataSize );
+    std::memcpy ( transferData + mesh._vertexDataSize, mesh._indices, mesh._indexDataSize );
+    renderer.UnmapMemory ( _transferMemory );
+
+    _bounds = mesh._bounds;
+    _indexCount = mesh._indexCount;
+    _indexOffset = static_cast<VkDeviceSize> ( mesh._vertexDataSize );
+    _indexType = mesh._indexSize == sizeof ( uint16_t ) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    _vertexFormat = mesh._vertexFormat;
+    _fileName = file.GetPath ();
     return true;
 }
 
@@ -179,18 +294,31 @@ bool MeshGeometry::LoadMesh ( const uint8_t* data,
 )
 {
     FreeResources ( renderer );
-    return LoadMeshInternal ( data, size, vertexCount, usage, renderer, commandBuffer );
+    uint8_t* transferData = nullptr;
+
+    if ( !LoadMeshInternal ( transferData, size, vertexCount, usage, renderer, commandBuffer ) )
+        return false;
+
+    memcpy ( transferData, data, size );
+    renderer.UnmapMemory ( _transferMemory );
+    return true;
 }
 
 void MeshGeometry::FreeResourceInternal ( android_vulkan::Renderer &renderer )
 {
     _vertexCount = 0U;
+    _indexCount = 0U;
+    _indexOffset = 0U;
+    _indexType = VK_INDEX_TYPE_UINT32;
+    _vertexFormat = eVertexFormat::Full;
+    _bounds.Empty ();
     VkDevice device = renderer.GetDevice ();
 
     if ( _bufferMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _bufferMemory, nullptr );
+        renderer.FreeMemory ( _bufferMemory, _bufferMemoryOffset );
         _bufferMemory = VK_NULL_HANDLE;
+        _bufferMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "MeshGeometry::_bufferMemory" )
     }
 
@@ -202,7 +330,7 @@ void MeshGeometry::FreeResourceInternal ( android_vulkan::Renderer &renderer )
     AV_UNREGISTER_BUFFER ( "MeshGeometry::_buffer" )
 }
 
-bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
+bool MeshGeometry::LoadMeshInternal ( uint8_t* &transferData,
     size_t size,
     uint32_t vertexCount,
     VkBufferUsageFlags usage,
@@ -236,6 +364,7 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
     vkGetBufferMemoryRequirements ( device, _buffer, &memoryRequirements );
 
     result = renderer.TryAllocateMemory ( _bufferMemory,
+        _bufferMemoryOffset,
         memoryRequirements,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         "Can't allocate buffer memory (MeshGeometry::LoadMeshInternal)"
@@ -249,7 +378,7 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
 
     AV_REGISTER_DEVICE_MEMORY ( "MeshGeometry::_bufferMemory" )
 
-    result = renderer.CheckVkResult ( vkBindBufferMemory ( device, _buffer, _bufferMemory, 0U ),
+    result = renderer.CheckVkResult ( vkBindBufferMemory ( device, _buffer, _bufferMemory, _bufferMemoryOffset ),
         "MeshGeometry::LoadMeshInternal",
         "Can't bind buffer memory"
     );
@@ -275,6 +404,7 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
     vkGetBufferMemoryRequirements ( device, _transferBuffer, &memoryRequirements );
 
     result = renderer.TryAllocateMemory ( _transferMemory,
+        _transferMemoryOffset,
         memoryRequirements,
         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
         "Can't allocate transfer memory (MeshGeometry::LoadMeshInternal)"
@@ -288,7 +418,8 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
 
     AV_REGISTER_DEVICE_MEMORY ( "MeshGeometry::_transferMemory" )
 
-    result = renderer.CheckVkResult ( vkBindBufferMemory ( device, _transferBuffer, _transferMemory, 0U ),
+    result = renderer.CheckVkResult (
+        vkBindBufferMemory ( device, _transferBuffer, _transferMemory, _transferMemoryOffset ),
         "MeshGeometry::LoadMeshInternal",
         "Can't bind transfer memory"
     );
@@ -299,9 +430,11 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
         return false;
     }
 
-    void* transferData = nullptr;
+    void* destination = nullptr;
 
-    result = renderer.CheckVkResult ( vkMapMemory ( device, _transferMemory, 0U, size, 0U, &transferData ),
+    result = renderer.MapMemory ( destination,
+        _transferMemory,
+        _transferMemoryOffset,
         "MeshGeometry::LoadMeshInternal",
         "Can't map data"
     );
@@ -312,42 +445,28 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
         return false;
     }
 
-    memcpy ( transferData, data, size );
-    vkUnmapMemory ( device, _transferMemory );
-
-    VkCommandBufferBeginInfo commandBufferBeginInfo;
-    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    commandBufferBeginInfo.pNext = nullptr;
-    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    commandBufferBeginInfo.pInheritanceInfo = nullptr;
-
-    result = renderer.CheckVkResult ( vkBeginCommandBuffer ( commandBuffer, &commandBufferBeginInfo ),
-        "MeshGeometry::LoadMeshInternal",
-        "Can't begin command buffer"
-    );
+    // Note the command buffer is shared with other uploads. So nothing must be recorded if the upload could fail.
+    const auto findResult = _accessMapper.find ( usage );
 
-    if ( !result )
+    if ( findResult == _accessMapper.cend () )
     {
+        android_vulkan::LogError ( "MeshGeometry::LoadMeshInternal - Unexpected usage 0x%08X", usage );
+        renderer.UnmapMemory ( _transferMemory );
         FreeResources ( renderer );
         return false;
     }
 
+    // The vertices are written by caller. The copy commands read them only at the submit moment.
+    transferData = static_cast<uint8_t*> ( destination );
+
+    const BufferSyncItem& syncItem = findResult->second;
+
     VkBufferCopy copyInfo;
     copyInfo.size = size;
     copyInfo.srcOffset = copyInfo.dstOffset = 0U;
 
     vkCmdCopyBuffer ( commandBuffer, _transferBuffer, _buffer, 1U, &copyInfo );
 
-    const auto findResult = _accessMapper.find ( usage );
-
-    if ( findResult == _accessMapper.cend () )
-    {
-        android_vulkan::LogError ( "MeshGeometry::LoadMeshInternal - Unexpected usage 0x%08X", usage );
-        return false;
-    }
-
-    const BufferSyncItem& syncItem = findResult->second;
-
     VkBufferMemoryBarrier barrierInfo;
     barrierInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     barrierInfo.pNext = nullptr;
@@ -370,41 +489,8 @@ bool MeshGeometry::LoadMeshInternal ( const uint8_t* data,
         nullptr
     );
 
-    result = renderer.CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
-        "MeshGeometry::LoadMeshInternal",
-        "Can't end command buffer"
-    );
-
-    if ( !result )
-    {
-        FreeResources ( renderer );
-        return false;
-    }
-
-    VkSubmitInfo submitInfo;
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.pNext = nullptr;
-    submitInfo.commandBufferCount = 1U;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    submitInfo.waitSemaphoreCount = 0U;
-    submitInfo.pWaitSemaphores = nullptr;
-    submitInfo.signalSemaphoreCount = 0U;
-    submitInfo.pSignalSemaphores = nullptr;
-    submitInfo.pWaitDstStageMask = nullptr;
-
-    result = renderer.CheckVkResult ( vkQueueSubmit ( renderer.GetQueue (), 1U, &submitInfo, VK_NULL_HANDLE ),
-        "MeshGeometry::LoadMeshInternal",
-        "Can't submit command"
-    );
-
-    if ( result )
-    {
-        _vertexCount = vertexCount;
-        return true;
-    }
-
-    FreeResources ( renderer );
-    return false;
+    _vertexCount = vertexCount;
+    return true;
 }
 
 } // namespace rotating_mesh
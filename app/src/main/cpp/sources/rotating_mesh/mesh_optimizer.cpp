@@ -0,0 +1,402 @@
+#include <rotating_mesh/mesh_optimizer.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <unordered_map>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr static const float CACHE_DECAY_POWER = 1.5F;
+constexpr static const float LAST_TRIANGLE_SCORE = 0.75F;
+constexpr static const float VALENCE_BOOST_SCALE = 2.0F;
+constexpr static const float VALENCE_BOOST_POWER = -0.5F;
+
+constexpr static const uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325U;
+constexpr static const uint64_t FNV_PRIME = 0x00000100000001B3U;
+
+// The key of the vertex is the whole record. eTangentMerge::Average mode drops the tangent frame from the key. The
+// vertices with the equal key are merged if their tangents and bitangents are close. Note the merged frame is
+// the average. So the error against the source frame is not bounded by the threshold. See TangentMergeError.
+constexpr static const size_t VERTEX_KEY_SIZE = sizeof ( VertexInfo );
+constexpr static const size_t MERGE_VERTEX_KEY_SIZE = offsetof ( VertexInfo, _tangent );
+constexpr static const float TANGENT_MERGE_THRESHOLD = 0.7F;
+
+constexpr static const uint32_t NO_VERTEX = UINT32_MAX;
+
+struct VertexKeyHasher final
+{
+    size_t      _keySize;
+
+    size_t operator () ( const VertexInfo* vertex ) const
+    {
+        // FNV-1a over the packed record.
+        const auto* bytes = reinterpret_cast<const uint8_t*> ( vertex );
+        uint64_t hash = FNV_OFFSET_BASIS;
+
+        for ( size_t i = 0U; i < _keySize; ++i )
+        {
+            hash ^= static_cast<uint64_t> ( bytes[ i ] );
+            hash *= FNV_PRIME;
+        }
+
+        return static_cast<size_t> ( hash );
+    }
+};
+
+struct VertexKeyEqual final
+{
+    size_t      _keySize;
+
+    bool operator () ( const VertexInfo* a, const VertexInfo* b ) const
+    {
+        return std::memcmp ( a, b, _keySize ) == 0;
+    }
+};
+
+static bool IsTangentFrameCompatible ( const VertexInfo &a, const VertexInfo &b )
+{
+    return a._tangent.DotProduct ( b._tangent ) >= TANGENT_MERGE_THRESHOLD &&
+        a._bitangent.DotProduct ( b._bitangent ) >= TANGENT_MERGE_THRESHOLD;
+}
+
+// Note the zero vectors have zero angle. The meshes without the normal map could have them.
+static float ComputeAngle ( const GXVec3 &a, const GXVec3 &b )
+{
+    const float lengths = std::sqrt ( a.SquaredLength () * b.SquaredLength () );
+
+    if ( lengths == 0.0F )
+        return 0.0F;
+
+    return GXRadToDeg ( std::acos ( std::clamp ( a.DotProduct ( b ) / lengths, -1.0F, 1.0F ) ) );
+}
+
+// Note the vertex score is negative if the vertex has no remaining triangles.
+static float ComputeVertexScore ( int32_t cachePosition, uint32_t valence )
+{
+    if ( !valence )
+        return -1.0F;
+
+    float score = 0.0F;
+
+    if ( cachePosition >= 0 )
+    {
+        // Vertices of the last triangle get fixed score. So the algorithm does not prefer the same triangle edge.
+        if ( cachePosition < 3 )
+        {
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            constexpr const float scale = 1.0F / static_cast<float> ( VERTEX_CACHE_SIZE - 3U );
+            score = std::pow ( 1.0F - static_cast<float> ( cachePosition - 3 ) * scale, CACHE_DECAY_POWER );
+        }
+    }
+
+    // Vertices with few remaining triangles get the boost. It helps to finish the areas instead of leaving holes.
+    return score + VALENCE_BOOST_SCALE * std::pow ( static_cast<float> ( valence ), VALENCE_BOOST_POWER );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void MeshOptimizer::Deduplicate ( std::vector<VertexInfo> &vertices,
+    std::vector<uint32_t> &indices,
+    const VertexInfo* source,
+    size_t count,
+    eTangentMerge tangentMerge,
+    TangentMergeError* error
+)
+{
+    const bool isMerging = tangentMerge == eTangentMerge::Average;
+    const size_t keySize = isMerging ? MERGE_VERTEX_KEY_SIZE : VERTEX_KEY_SIZE;
+
+    // The value is the first unique vertex with the key. Other unique vertices with the same key are linked by "next".
+    std::unordered_map<const VertexInfo*, uint32_t, VertexKeyHasher, VertexKeyEqual> keys ( count,
+        VertexKeyHasher { keySize },
+        VertexKeyEqual { keySize }
+    );
+
+    // Note the compatibility is checked against the original tangent frame of the first merged vertex.
+    std::vector<const VertexInfo*> originals;
+    originals.reserve ( count );
+
+    std::vector<uint32_t> next;
+    next.reserve ( count );
+
+    std::vector<uint8_t> isMerged;
+    isMerged.reserve ( count );
+
+    vertices.clear ();
+    vertices.reserve ( count );
+
+    indices.clear ();
+    indices.reserve ( count );
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        const VertexInfo* vertex = source + i;
+        const auto unique = static_cast<uint32_t> ( vertices.size () );
+        const auto result = keys.emplace ( vertex, unique );
+        const uint32_t first = result.first->second;
+        uint32_t index = NO_VERTEX;
+
+        if ( !result.second )
+        {
+            // Note the whole record is the key without the merge. So the first vertex with the key is equal.
+            for ( uint32_t candidate = first; candidate != NO_VERTEX; candidate = next[ candidate ] )
+            {
+                if ( isMerging && !IsTangentFrameCompatible ( *originals[ candidate ], *vertex ) )
+                    continue;
+
+                index = candidate;
+                break;
+            }
+        }
+
+        if ( index == NO_VERTEX )
+        {
+            vertices.push_back ( *vertex );
+            originals.push_back ( vertex );
+            next.push_back ( NO_VERTEX );
+            isMerged.push_back ( 0U );
+
+            if ( first != unique )
+            {
+                next[ unique ] = next[ first ];
+                next[ first ] = unique;
+            }
+
+            indices.push_back ( unique );
+            continue;
+        }
+
+        indices.push_back ( index );
+
+        if ( !isMerging )
+            continue;
+
+        VertexInfo& merged = vertices[ index ];
+        merged._tangent.Sum ( merged._tangent, vertex->_tangent );
+        merged._bitangent.Sum ( merged._bitangent, vertex->_bitangent );
+        isMerged[ index ] = 1U;
+    }
+
+    // The merged vertices get the average tangent frame. Other vertices stay bitwise equal to the source.
+    for ( size_t i = 0U; i < vertices.size (); ++i )
+    {
+        if ( !isMerged[ i ] )
+            continue;
+
+        vertices[ i ]._tangent.Normalize ();
+        vertices[ i ]._bitangent.Normalize ();
+    }
+
+    vertices.shrink_to_fit ();
+
+    if ( !error )
+        return;
+
+    *error = {};
+
+    if ( !isMerging )
+        return;
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        const VertexInfo& vertex = vertices[ indices[ i ] ];
+        error->_tangent = std::max ( error->_tangent, ComputeAngle ( vertex._tangent, source[ i ]._tangent ) );
+        error->_bitangent = std::max ( error->_bitangent, ComputeAngle ( vertex._bitangent, source[ i ]._bitangent ) );
+    }
+}
+
+void MeshOptimizer::OptimizeVertexCache ( uint32_t* indices, size_t indexCount, size_t vertexCount )
+{
+    const size_t triangleCount = indexCount / 3U;
+
+    if ( triangleCount < 2U )
+        return;
+
+    std::vector<uint32_t> valences ( vertexCount, 0U );
+
+    for ( size_t i = 0U; i < indexCount; ++i )
+        ++valences[ indices[ i ] ];
+
+    // Remaining triangles of every vertex. The lists are packed into the single array.
+    std::vector<uint32_t> offsets ( vertexCount + 1U, 0U );
+
+    for ( size_t i = 0U; i < vertexCount; ++i )
+        offsets[ i + 1U ] = offsets[ i ] + valences[ i ];
+
+    std::vector<uint32_t> vertexTriangles ( indexCount );
+    std::vector<uint32_t> fill ( offsets.cbegin (), offsets.cend () - 1 );
+
+    for ( size_t i = 0U; i < indexCount; ++i )
+        vertexTriangles[ fill[ indices[ i ] ]++ ] = static_cast<uint32_t> ( i / 3U );
+
+    std::vector<float> vertexScores ( vertexCount );
+
+    for ( size_t i = 0U; i < vertexCount; ++i )
+        vertexScores[ i ] = ComputeVertexScore ( -1, valences[ i ] );
+
+    auto triangleScore = [ &vertexScores, indices ] ( size_t triangle ) -> float {
+        const uint32_t* v = indices + triangle * 3U;
+        return vertexScores[ v[ 0U ] ] + vertexScores[ v[ 1U ] ] + vertexScores[ v[ 2U ] ];
+    };
+
+    size_t best = 0U;
+    float bestScore = triangleScore ( 0U );
+
+    for ( size_t i = 1U; i < triangleCount; ++i )
+    {
+        const float score = triangleScore ( i );
+
+        if ( score <= bestScore )
+            continue;
+
+        bestScore = score;
+        best = i;
+    }
+
+    std::vector<uint8_t> isAdded ( triangleCount, 0U );
+    std::vector<uint32_t> result ( indexCount );
+
+    // Three extra entries hold the vertices of the new triangle before the oldest entries are pushed out.
+    std::array<uint32_t, VERTEX_CACHE_SIZE + 3U> cache {};
+    std::array<uint32_t, VERTEX_CACHE_SIZE + 3U> newCache {};
+    size_t cacheSize = 0U;
+    size_t cursor = 0U;
+
+    for ( size_t output = 0U; output < triangleCount; ++output )
+    {
+        // Cache has no vertices with remaining triangles. The next triangle in the original order is taken.
+        if ( best == SIZE_MAX )
+        {
+            while ( isAdded[ cursor ] )
+                ++cursor;
+
+            best = cursor;
+        }
+
+        const uint32_t* triangle = indices + best * 3U;
+        std::memcpy ( result.data () + output * 3U, triangle, 3U * sizeof ( uint32_t ) );
+        isAdded[ best ] = 1U;
+
+        size_t newCacheSize = 0U;
+
+        for ( size_t i = 0U; i < 3U; ++i )
+        {
+            const uint32_t vertex = triangle[ i ];
+            auto* end = newCache.data () + newCacheSize;
+
+            if ( std::find ( newCache.data (), end, vertex ) == end )
+                newCache[ newCacheSize++ ] = vertex;
+
+            // Removing the triangle from the remaining triangles of the vertex.
+            uint32_t* first = vertexTriangles.data () + offsets[ vertex ];
+            uint32_t* last = first + valences[ vertex ];
+            *std::find ( first, last, static_cast<uint32_t> ( best ) ) = *( last - 1 );
+            --valences[ vertex ];
+        }
+
+        for ( size_t i = 0U; i < cacheSize; ++i )
+        {
+            const uint32_t vertex = cache[ i ];
+
+            if ( vertex != triangle[ 0U ] && vertex != triangle[ 1U ] && vertex != triangle[ 2U ] )
+                newCache[ newCacheSize++ ] = vertex;
+        }
+
+        cacheSize = std::min ( newCacheSize, VERTEX_CACHE_SIZE );
+
+        for ( size_t i = 0U; i < newCacheSize; ++i )
+        {
+            const uint32_t vertex = newCache[ i ];
+            const int32_t position = i < cacheSize ? static_cast<int32_t> ( i ) : -1;
+
+            vertexScores[ vertex ] = ComputeVertexScore ( position, valences[ vertex ] );
+        }
+
+        // Only triangles of the touched vertices change the score. The best of them is the next triangle.
+        best = SIZE_MAX;
+        bestScore = -1.0F;
+
+        for ( size_t i = 0U; i < newCacheSize; ++i )
+        {
+            const uint32_t vertex = newCache[ i ];
+            const uint32_t* first = vertexTriangles.data () + offsets[ vertex ];
+            const uint32_t* last = first + valences[ vertex ];
+
+            for ( const uint32_t* t = first; t < last; ++t )
+            {
+                const float score = triangleScore ( *t );
+
+                if ( score <= bestScore )
+                    continue;
+
+                bestScore = score;
+                best = *t;
+            }
+        }
+
+        std::memcpy ( cache.data (), newCache.data (), cacheSize * sizeof ( uint32_t ) );
+    }
+
+    std::memcpy ( indices, result.data (), indexCount * sizeof ( uint32_t ) );
+}
+
+void MeshOptimizer::OptimizeVertexFetch ( std::vector<VertexInfo> &vertices, uint32_t* indices, size_t indexCount )
+{
+    std::vector<uint32_t> remap ( vertices.size (), UINT32_MAX );
+    std::vector<VertexInfo> ordered;
+    ordered.reserve ( vertices.size () );
+
+    for ( size_t i = 0U; i < indexCount; ++i )
+    {
+        uint32_t& index = remap[ indices[ i ] ];
+
+        if ( index == UINT32_MAX )
+        {
+            index = static_cast<uint32_t> ( ordered.size () );
+            ordered.push_back ( vertices[ indices[ i ] ] );
+        }
+
+        indices[ i ] = index;
+    }
+
+    vertices.swap ( ordered );
+}
+
+float MeshOptimizer::ComputeACMR ( const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t cacheSize )
+{
+    const size_t triangleCount = indexCount / 3U;
+
+    if ( !triangleCount )
+        return 0.0F;
+
+    // The vertex is in FIFO cache if less than "cacheSize" vertices are inserted after it.
+    std::vector<size_t> timestamps ( vertexCount, 0U );
+    size_t time = cacheSize + 1U;
+    size_t misses = 0U;
+
+    for ( size_t i = 0U; i < indexCount; ++i )
+    {
+        size_t& timestamp = timestamps[ indices[ i ] ];
+
+        if ( time - timestamp <= cacheSize )
+            continue;
+
+        timestamp = time++;
+        ++misses;
+    }
+
+    return static_cast<float> ( misses ) / static_cast<float> ( triangleCount );
+}
+
+} // namespace rotating_mesh
@@ -0,0 +1,164 @@
+#include <rotating_mesh/mesh_parser.h>
+#include <job_system.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstring>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t UV_GRAIN = 4096U;
+
+// The method returns false if the chunk does not fit into the content. Otherwise the method returns true.
+static bool IsChunkValid ( const GXNativeMeshChunk &chunk, size_t size )
+{
+    const auto available = static_cast<GXUBigInt> ( size );
+    return chunk.offset <= available && chunk.size <= available - chunk.offset;
+}
+
+bool MeshParser::Parse ( const VertexInfo* &vertices, uint32_t &vertexCount, const uint8_t* content, size_t size )
+{
+    if ( size < sizeof ( GXNativeMeshHeader ) )
+        return false;
+
+    const auto& header = *reinterpret_cast<const GXNativeMeshHeader*> ( content );
+
+    if ( header.vboOffset > size )
+        return false;
+
+    const size_t available = ( size - static_cast<size_t> ( header.vboOffset ) ) / sizeof ( VertexInfo );
+
+    if ( static_cast<size_t> ( header.totalVertices ) > available )
+        return false;
+
+    vertices = reinterpret_cast<const VertexInfo*> ( content + header.vboOffset );
+    vertexCount = header.totalVertices;
+    return true;
+}
+
+bool MeshParser::IsCooked ( const uint8_t* content, size_t size )
+{
+    if ( size < sizeof ( GXNativeMeshHeaderV2 ) )
+        return false;
+
+    GXUInt magic;
+    std::memcpy ( &magic, content, sizeof ( magic ) );
+    return magic == GX_NATIVE_MESH_V2_MAGIC;
+}
+
+bool MeshParser::ParseCooked ( CookedMesh &mesh, const uint8_t* content, size_t size )
+{
+    if ( !IsCooked ( content, size ) )
+        return false;
+
+    const auto& header = *reinterpret_cast<const GXNativeMeshHeaderV2*> ( content );
+
+    if ( header.version != GX_NATIVE_MESH_V2_VERSION || header.vertexLayout >= VERTEX_FORMAT_COUNT )
+        return false;
+
+    if ( header.indexSize != sizeof ( uint16_t ) && header.indexSize != sizeof ( uint32_t ) )
+        return false;
+
+    if ( header.totalIndices % 3U )
+        return false;
+
+    const size_t tableSize = static_cast<size_t> ( header.totalChunks ) * sizeof ( GXNativeMeshChunk );
+
+    if ( tableSize > size - sizeof ( GXNativeMeshHeaderV2 ) )
+        return false;
+
+    mesh._vertexFormat = static_cast<eVertexFormat> ( header.vertexLayout );
+    mesh._vertexCount = header.totalVertices;
+    mesh._indexCount = header.totalIndices;
+    mesh._indexSize = header.indexSize;
+    mesh._vertices = nullptr;
+    mesh._indices = nullptr;
+    mesh._meshlets = nullptr;
+    mesh._meshletCount = 0U;
+
+    mesh._bounds.Empty ();
+    mesh._bounds.AddVertex ( header.boundsMin );
+    mesh._bounds.AddVertex ( header.boundsMax );
+
+    const size_t vertexSize = mesh._vertexFormat == eVertexFormat::Packed ?
+        sizeof ( PackedVertexInfo ) :
+        sizeof ( VertexInfo );
+
+    mesh._vertexDataSize = static_cast<size_t> ( mesh._vertexCount ) * vertexSize;
+    mesh._indexDataSize = static_cast<size_t> ( mesh._indexCount ) * static_cast<size_t> ( mesh._indexSize );
+
+    const auto* chunks = reinterpret_cast<const GXNativeMeshChunk*> ( content + sizeof ( GXNativeMeshHeaderV2 ) );
+
+    for ( GXUInt i = 0U; i < header.totalChunks; ++i )
+    {
+        const GXNativeMeshChunk& chunk = chunks[ i ];
+
+        if ( !IsChunkValid ( chunk, size ) )
+            return false;
+
+        const uint8_t* data = content + chunk.offset;
+        const auto chunkSize = static_cast<size_t> ( chunk.size );
+
+        switch ( static_cast<eGXNativeMeshChunk> ( chunk.type ) )
+        {
+            case eGXNativeMeshChunk::Vertices:
+                if ( chunkSize != mesh._vertexDataSize )
+                    return false;
+
+                mesh._vertices = data;
+            break;
+
+            case eGXNativeMeshChunk::Indices:
+                if ( chunkSize != mesh._indexDataSize )
+                    return false;
+
+                mesh._indices = data;
+            break;
+
+            case eGXNativeMeshChunk::Meshlets:
+                if ( chunkSize % sizeof ( GXNativeMeshlet ) )
+                    return false;
+
+                mesh._meshlets = reinterpret_cast<const GXNativeMeshlet*> ( data );
+                mesh._meshletCount = chunkSize / sizeof ( GXNativeMeshlet );
+            break;
+
+            default:
+                // NOTHING
+            break;
+        }
+    }
+
+    if ( !mesh._vertices || !mesh._indices )
+        return false;
+
+    for ( size_t i = 0U; i < mesh._meshletCount; ++i )
+    {
+        const GXNativeMeshlet& meshlet = mesh._meshlets[ i ];
+
+        if ( meshlet.firstIndex > mesh._indexCount || meshlet.totalIndices > mesh._indexCount - meshlet.firstIndex )
+            return false;
+    }
+
+    return true;
+}
+
+void MeshParser::ConvertVertices ( VertexInfo* destination, const VertexInfo* source, size_t count )
+{
+    // The destination memory is never read back because it could be write-combined.
+    auto converter = [ destination, source ] ( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+        {
+            VertexInfo vertex = source[ i ];
+            vertex._uv._data[ 1U ] = 1.0F - vertex._uv._data[ 1U ];
+            destination[ i ] = vertex;
+        }
+    };
+
+    android_vulkan::g_JobSystem->ParallelFor ( count, UV_GRAIN, converter );
+}
+
+} // namespace rotating_mesh
@@ -0,0 +1,457 @@
+#include <rotating_mesh/mipmap_generator.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+#include <vulkan_utils.h>
+
+
+namespace rotating_mesh {
+
+constexpr static const char* SHADER = "shaders/mipmap-generator-cs.spv";
+constexpr static const char* SHADER_ENTRY_POINT = "CS";
+
+constexpr static const VkFormat STORAGE_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+constexpr static const uint32_t THREADS = 8U;
+
+// Source level and the levels of the pass.
+constexpr static const uint32_t DESCRIPTORS_PER_PASS = MIPMAP_LEVELS_PER_PASS + 1U;
+
+struct PushConstants final
+{
+    uint32_t    _levels;
+    uint32_t    _isSRGB;
+};
+
+static uint32_t CountPasses ( uint32_t mipLevels )
+{
+    return ( mipLevels - 1U + MIPMAP_LEVELS_PER_PASS - 1U ) / MIPMAP_LEVELS_PER_PASS;
+}
+
+static void RecordBarrier ( VkCommandBuffer commandBuffer,
+    VkImageMemoryBarrier &barrierInfo,
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage
+)
+{
+    vkCmdPipelineBarrier ( commandBuffer,
+        srcStage,
+        dstStage,
+        0U,
+        0U,
+        nullptr,
+        0U,
+        nullptr,
+        1U,
+        &barrierInfo
+    );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MipmapGenerator::MipmapGenerator ():
+    _descriptorSetLayout ( VK_NULL_HANDLE ),
+    _isSupported ( false ),
+    _pipeline ( VK_NULL_HANDLE ),
+    _pipelineLayout ( VK_NULL_HANDLE ),
+    _shaderModule ( VK_NULL_HANDLE )
+{
+    // NOTHING
+}
+
+bool MipmapGenerator::Init ( android_vulkan::Renderer &renderer )
+{
+    if ( !renderer.IsFormatFeatureSupported ( STORAGE_FORMAT, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT ) )
+    {
+        android_vulkan::LogWarning ( "MipmapGenerator::Init - Storage images are not supported. "
+            "Mip maps will be generated by blits."
+        );
+
+        return true;
+    }
+
+    VkDescriptorSetLayoutBinding bindings[ 2U ];
+    VkDescriptorSetLayoutBinding& sourceBinding = bindings[ 0U ];
+    sourceBinding.binding = 0U;
+    sourceBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    sourceBinding.descriptorCount = 1U;
+    sourceBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    sourceBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding& levelBinding = bindings[ 1U ];
+    levelBinding.binding = 1U;
+    levelBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    levelBinding.descriptorCount = MIPMAP_LEVELS_PER_PASS;
+    levelBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    levelBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetInfo;
+    descriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetInfo.pNext = nullptr;
+    descriptorSetInfo.flags = 0U;
+    descriptorSetInfo.bindingCount = static_cast<uint32_t> ( std::size ( bindings ) );
+    descriptorSetInfo.pBindings = bindings;
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult (
+        vkCreateDescriptorSetLayout ( device, &descriptorSetInfo, nullptr, &_descriptorSetLayout ),
+        "MipmapGenerator::Init",
+        "Can't create descriptor set layout"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DESCRIPTOR_SET_LAYOUT ( "MipmapGenerator::_descriptorSetLayout" )
+
+    VkPushConstantRange pushConstantRange;
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0U;
+    pushConstantRange.size = static_cast<uint32_t> ( sizeof ( PushConstants ) );
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo;
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.pNext = nullptr;
+    pipelineLayoutInfo.flags = 0U;
+    pipelineLayoutInfo.pushConstantRangeCount = 1U;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    pipelineLayoutInfo.setLayoutCount = 1U;
+    pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+
+    result = renderer.CheckVkResult ( vkCreatePipelineLayout ( device, &pipelineLayoutInfo, nullptr, &_pipelineLayout ),
+        "MipmapGenerator::Init",
+        "Can't create pipeline layout"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_PIPELINE_LAYOUT ( "MipmapGenerator::_pipelineLayout" )
+
+    result = renderer.CreateShader ( _shaderModule,
+        SHADER,
+        "Can't create compute shader (MipmapGenerator::Init)"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_SHADER_MODULE ( "MipmapGenerator::_shaderModule" )
+
+    VkComputePipelineCreateInfo pipelineInfo;
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = nullptr;
+    pipelineInfo.flags = 0U;
+    pipelineInfo.layout = _pipelineLayout;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    VkPipelineShaderStageCreateInfo& stageInfo = pipelineInfo.stage;
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.pNext = nullptr;
+    stageInfo.flags = 0U;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = _shaderModule;
+    stageInfo.pName = SHADER_ENTRY_POINT;
+    stageInfo.pSpecializationInfo = nullptr;
+
+    result = renderer.CheckVkResult (
+        vkCreateComputePipelines ( device, renderer.GetPipelineCache (), 1U, &pipelineInfo, nullptr, &_pipeline ),
+        "MipmapGenerator::Init",
+        "Can't create pipeline"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_PIPELINE ( "MipmapGenerator::_pipeline" )
+    _isSupported = true;
+    return true;
+}
+
+void MipmapGenerator::Destroy ( android_vulkan::Renderer &renderer )
+{
+    _isSupported = false;
+    VkDevice device = renderer.GetDevice ();
+
+    if ( _pipeline != VK_NULL_HANDLE )
+    {
+        vkDestroyPipeline ( device, _pipeline, nullptr );
+        _pipeline = VK_NULL_HANDLE;
+        AV_UNREGISTER_PIPELINE ( "MipmapGenerator::_pipeline" )
+    }
+
+    if ( _shaderModule != VK_NULL_HANDLE )
+    {
+        vkDestroyShaderModule ( device, _shaderModule, nullptr );
+        _shaderModule = VK_NULL_HANDLE;
+        AV_UNREGISTER_SHADER_MODULE ( "MipmapGenerator::_shaderModule" )
+    }
+
+    if ( _pipelineLayout != VK_NULL_HANDLE )
+    {
+        vkDestroyPipelineLayout ( device, _pipelineLayout, nullptr );
+        _pipelineLayout = VK_NULL_HANDLE;
+        AV_UNREGISTER_PIPELINE_LAYOUT ( "MipmapGenerator::_pipelineLayout" )
+    }
+
+    if ( _descriptorSetLayout == VK_NULL_HANDLE )
+        return;
+
+    vkDestroyDescriptorSetLayout ( device, _descriptorSetLayout, nullptr );
+    _descriptorSetLayout = VK_NULL_HANDLE;
+    AV_UNREGISTER_DESCRIPTOR_SET_LAYOUT ( "MipmapGenerator::_descriptorSetLayout" )
+}
+
+bool MipmapGenerator::IsSupported ( VkFormat format ) const
+{
+    return _isSupported && ( format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB );
+}
+
+bool MipmapGenerator::Generate ( MipmapResources &resources,
+    VkImage image,
+    VkFormat format,
+    const VkExtent2D &resolution,
+    uint32_t mipLevels,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+) const
+{
+    const uint32_t passes = CountPasses ( mipLevels );
+
+    VkDescriptorPoolSize poolSize;
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSize.descriptorCount = passes * DESCRIPTORS_PER_PASS;
+
+    VkDescriptorPoolCreateInfo poolInfo;
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.pNext = nullptr;
+    poolInfo.flags = 0U;
+    poolInfo.maxSets = passes;
+    poolInfo.poolSizeCount = 1U;
+    poolInfo.pPoolSizes = &poolSize;
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult (
+        vkCreateDescriptorPool ( device, &poolInfo, nullptr, &resources._descriptorPool ),
+        "MipmapGenerator::Generate",
+        "Can't create descriptor pool"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_DESCRIPTOR_POOL ( "MipmapResources::_descriptorPool" )
+
+    VkImageViewCreateInfo viewInfo;
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.pNext = nullptr;
+    viewInfo.flags = 0U;
+    viewInfo.image = image;
+    viewInfo.format = STORAGE_FORMAT;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.subresourceRange.baseArrayLayer = 0U;
+    viewInfo.subresourceRange.layerCount = 1U;
+    viewInfo.subresourceRange.levelCount = 1U;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+    std::vector<VkImageView>& views = resources._views;
+    views.reserve ( mipLevels );
+
+    for ( uint32_t i = 0U; i < mipLevels; ++i )
+    {
+        viewInfo.subresourceRange.baseMipLevel = i;
+        VkImageView view = VK_NULL_HANDLE;
+
+        result = renderer.CheckVkResult ( vkCreateImageView ( device, &viewInfo, nullptr, &view ),
+            "MipmapGenerator::Generate",
+            "Can't create storage view"
+        );
+
+        if ( !result )
+            return false;
+
+        views.push_back ( view );
+        AV_REGISTER_IMAGE_VIEW ( "MipmapResources::_views" )
+    }
+
+    const std::vector<VkDescriptorSetLayout> layouts ( passes, _descriptorSetLayout );
+    std::vector<VkDescriptorSet> sets ( passes, VK_NULL_HANDLE );
+
+    VkDescriptorSetAllocateInfo allocateInfo;
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.descriptorPool = resources._descriptorPool;
+    allocateInfo.descriptorSetCount = passes;
+    allocateInfo.pSetLayouts = layouts.data ();
+
+    result = renderer.CheckVkResult ( vkAllocateDescriptorSets ( device, &allocateInfo, sets.data () ),
+        "MipmapGenerator::Generate",
+        "Can't allocate descriptor sets"
+    );
+
+    if ( !result )
+        return false;
+
+    std::vector<VkDescriptorImageInfo> imageInfo ( passes * DESCRIPTORS_PER_PASS );
+    std::vector<VkWriteDescriptorSet> writes ( passes * 2U );
+
+    for ( uint32_t pass = 0U; pass < passes; ++pass )
+    {
+        const uint32_t source = pass * MIPMAP_LEVELS_PER_PASS;
+        VkDescriptorImageInfo* passImages = imageInfo.data () + pass * DESCRIPTORS_PER_PASS;
+
+        // Note the unused levels of the last pass repeat the last level. The shader never writes them.
+        for ( uint32_t i = 0U; i < DESCRIPTORS_PER_PASS; ++i )
+        {
+            VkDescriptorImageInfo& info = passImages[ i ];
+            info.sampler = VK_NULL_HANDLE;
+            info.imageView = views[ std::min ( source + i, mipLevels - 1U ) ];
+            info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        VkWriteDescriptorSet& sourceWrite = writes[ pass * 2U ];
+        sourceWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        sourceWrite.pNext = nullptr;
+        sourceWrite.dstSet = sets[ pass ];
+        sourceWrite.dstBinding = 0U;
+        sourceWrite.dstArrayElement = 0U;
+        sourceWrite.descriptorCount = 1U;
+        sourceWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        sourceWrite.pImageInfo = passImages;
+        sourceWrite.pBufferInfo = nullptr;
+        sourceWrite.pTexelBufferView = nullptr;
+
+        VkWriteDescriptorSet& levelWrite = writes[ pass * 2U + 1U ];
+        levelWrite = sourceWrite;
+        levelWrite.dstBinding = 1U;
+        levelWrite.descriptorCount = MIPMAP_LEVELS_PER_PASS;
+        levelWrite.pImageInfo = passImages + 1U;
+    }
+
+    vkUpdateDescriptorSets ( device, static_cast<uint32_t> ( writes.size () ), writes.data (), 0U, nullptr );
+
+    VkImageMemoryBarrier barrierInfo;
+    barrierInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrierInfo.pNext = nullptr;
+    barrierInfo.image = image;
+    barrierInfo.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrierInfo.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrierInfo.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrierInfo.dstAccessMask = AV_VK_FLAG ( VK_ACCESS_SHADER_READ_BIT ) | AV_VK_FLAG ( VK_ACCESS_SHADER_WRITE_BIT );
+    barrierInfo.srcQueueFamilyIndex = barrierInfo.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrierInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrierInfo.subresourceRange.baseArrayLayer = 0U;
+    barrierInfo.subresourceRange.layerCount = 1U;
+    barrierInfo.subresourceRange.baseMipLevel = 0U;
+    barrierInfo.subresourceRange.levelCount = mipLevels;
+
+    RecordBarrier ( commandBuffer, barrierInfo, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT );
+    vkCmdBindPipeline ( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline );
+
+    PushConstants pushConstants {};
+    pushConstants._isSRGB = format == VK_FORMAT_R8G8B8A8_SRGB ? 1U : 0U;
+
+    // The source level of the next pass is the last level of the previous pass. Only that level must be synchronized.
+    barrierInfo.oldLayout = barrierInfo.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrierInfo.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrierInfo.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrierInfo.subresourceRange.levelCount = 1U;
+
+    for ( uint32_t pass = 0U; pass < passes; ++pass )
+    {
+        const uint32_t source = pass * MIPMAP_LEVELS_PER_PASS;
+
+        if ( pass )
+        {
+            barrierInfo.subresourceRange.baseMipLevel = source;
+
+            RecordBarrier ( commandBuffer,
+                barrierInfo,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            );
+        }
+
+        pushConstants._levels = std::min ( MIPMAP_LEVELS_PER_PASS, mipLevels - 1U - source );
+
+        vkCmdBindDescriptorSets ( commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            _pipelineLayout,
+            0U,
+            1U,
+            &sets[ pass ],
+            0U,
+            nullptr
+        );
+
+        vkCmdPushConstants ( commandBuffer,
+            _pipelineLayout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0U,
+            static_cast<uint32_t> ( sizeof ( pushConstants ) ),
+            &pushConstants
+        );
+
+        // Every thread writes single texel of the first level of the pass.
+        const uint32_t width = std::max ( resolution.width >> ( source + 1U ), 1U );
+        const uint32_t height = std::max ( resolution.height >> ( source + 1U ), 1U );
+        vkCmdDispatch ( commandBuffer, ( width + THREADS - 1U ) / THREADS, ( height + THREADS - 1U ) / THREADS, 1U );
+    }
+
+    barrierInfo.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrierInfo.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrierInfo.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrierInfo.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrierInfo.subresourceRange.baseMipLevel = 0U;
+    barrierInfo.subresourceRange.levelCount = mipLevels;
+
+    RecordBarrier ( commandBuffer,
+        barrierInfo,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+    );
+
+    return true;
+}
+
+VkImageCreateFlags MipmapGenerator::GetImageCreateFlags ( VkFormat format )
+{
+    if ( format == STORAGE_FORMAT )
+        return 0U;
+
+    return AV_VK_FLAG ( VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT ) | AV_VK_FLAG ( VK_IMAGE_CREATE_EXTENDED_USAGE_BIT );
+}
+
+void MipmapGenerator::FreeResources ( MipmapResources &resources, android_vulkan::Renderer &renderer )
+{
+    VkDevice device = renderer.GetDevice ();
+
+    for ( VkImageView view : resources._views )
+    {
+        vkDestroyImageView ( device, view, nullptr );
+        AV_UNREGISTER_IMAGE_VIEW ( "MipmapResources::_views" )
+    }
+
+    resources._views.clear ();
+
+    if ( resources._descriptorPool == VK_NULL_HANDLE )
+        return;
+
+    // Note the descriptor sets are released with the pool.
+    vkDestroyDescriptorPool ( device, resources._descriptorPool, nullptr );
+    resources._descriptorPool = VK_NULL_HANDLE;
+    AV_UNREGISTER_DESCRIPTOR_POOL ( "MipmapResources::_descriptorPool" )
+}
+
+} // namespace rotating_mesh
@@ -0,0 +1,34 @@
+#include <rotating_mesh/specular_lut.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cmath>
+
+GX_RESTORE_WARNING_STATE
+
+#include <job_system.h>
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t SPECULAR_GENERATOR_GRAIN = 8U;
+
+void SpecularLUT::Generate ( android_vulkan::Half* samples )
+{
+    auto job = [ samples ] ( size_t beginRow, size_t endRow ) {
+        constexpr const auto convert = 1.0F / static_cast<float> ( SPECULAR_ANGLE_SAMPLES );
+
+        for ( size_t row = beginRow; row < endRow; ++row )
+        {
+            android_vulkan::Half* rowSamples = samples + row * SPECULAR_ANGLE_SAMPLES;
+            const auto shininess = static_cast<int> ( row );
+
+            for ( size_t i = 0U; i < SPECULAR_ANGLE_SAMPLES; ++i )
+                rowSamples[ i ] = std::pow ( static_cast<float> ( i ) * convert, shininess );
+        }
+    };
+
+    android_vulkan::g_JobSystem->ParallelFor ( SPECULAR_EXPONENT_SAMPLES, SPECULAR_GENERATOR_GRAIN, job );
+}
+
+} // namespace rotating_mesh
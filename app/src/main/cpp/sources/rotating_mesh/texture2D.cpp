@@ -2,40 +2,37 @@
 
 GX_DISABLE_COMMON_WARNINGS
 
-#include <array>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <set>
-#include <thread>
-
-#define STBI_NO_FAILURE_STRINGS
-#define STBI_ONLY_JPEG
-#define STBI_ONLY_PNG
-#define STBI_ONLY_BMP
-#define STBI_ONLY_TGA
-#define STBI_ONLY_HDR
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb/stb_image.h>
+#include <vector>
 
 GX_RESTORE_WARNING_STATE
 
 #include <file.h>
 #include <logger.h>
+#include <rotating_mesh/ktx2_parser.h>
 #include <vulkan_utils.h>
 
 
 namespace rotating_mesh {
 
-constexpr static const size_t EXPANDER_THREADS = 4U;
-constexpr static const size_t RGB_BYTES_PER_PIXEL = 3U;
-constexpr static const size_t RGBA_BYTES_PER_PIXEL = 4U;
-
 static const std::map<VkFormat, std::set<VkFormat>> g_CompatibleFormats =
 {
     {
         VK_FORMAT_R8G8B8A8_SRGB,
 
         {
-            VK_FORMAT_R8G8B8A8_UNORM
+            VK_FORMAT_R8G8B8A8_UNORM,
+            VK_FORMAT_BC1_RGB_SRGB_BLOCK,
+            VK_FORMAT_BC3_SRGB_BLOCK,
+            VK_FORMAT_BC7_SRGB_BLOCK,
+            VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,
+            VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,
+            VK_FORMAT_ASTC_4x4_SRGB_BLOCK,
+            VK_FORMAT_ASTC_6x6_SRGB_BLOCK,
+            VK_FORMAT_ASTC_8x8_SRGB_BLOCK
         }
     },
 
@@ -43,7 +40,15 @@ static const std::map<VkFormat, std::set<VkFormat>> g_CompatibleFormats =
         VK_FORMAT_R8G8B8A8_UNORM,
 
         {
-            VK_FORMAT_R8G8B8A8_SRGB
+            VK_FORMAT_R8G8B8A8_SRGB,
+            VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+            VK_FORMAT_BC3_UNORM_BLOCK,
+            VK_FORMAT_BC7_UNORM_BLOCK,
+            VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+            VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+            VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+            VK_FORMAT_ASTC_6x6_UNORM_BLOCK,
+            VK_FORMAT_ASTC_8x8_UNORM_BLOCK
         }
     }
 };
@@ -54,11 +59,16 @@ Texture2D::Texture2D ():
     _format ( VK_FORMAT_UNDEFINED ),
     _image ( VK_NULL_HANDLE ),
     _imageDeviceMemory ( VK_NULL_HANDLE ),
+    _imageDeviceMemoryOffset ( 0U ),
+    _imageDeviceMemorySize ( 0U ),
     _imageView ( VK_NULL_HANDLE ),
     _mipLevels ( 0U ),
+    _mipmapResources {},
     _resolution { .width = 0U, .height = 0U },
     _transfer ( VK_NULL_HANDLE ),
-    _transferDeviceMemory ( VK_NULL_HANDLE )
+    _transferDeviceMemory ( VK_NULL_HANDLE ),
+    _transferDeviceMemoryOffset ( 0U ),
+    _transferData ( nullptr )
 {
     // NOTHING
 }
@@ -67,11 +77,16 @@ Texture2D::Texture2D ( std::string &fileName, VkFormat format, bool isGenerateMi
     _format ( format ),
     _image ( VK_NULL_HANDLE ),
     _imageDeviceMemory ( VK_NULL_HANDLE ),
+    _imageDeviceMemoryOffset ( 0U ),
+    _imageDeviceMemorySize ( 0U ),
     _imageView ( VK_NULL_HANDLE ),
     _isGenerateMipmaps ( isGenerateMipmaps ),
+    _mipmapResources {},
     _resolution { .width = 0U, .height = 0U },
     _transfer ( VK_NULL_HANDLE ),
     _transferDeviceMemory ( VK_NULL_HANDLE ),
+    _transferDeviceMemoryOffset ( 0U ),
+    _transferData ( nullptr ),
     _fileName ( fileName )
 {
     // NOTHING
@@ -81,11 +96,16 @@ Texture2D::Texture2D ( std::string &&fileName, VkFormat format, bool isGenerateM
     _format ( format ),
     _image ( VK_NULL_HANDLE ),
     _imageDeviceMemory ( VK_NULL_HANDLE ),
+    _imageDeviceMemoryOffset ( 0U ),
+    _imageDeviceMemorySize ( 0U ),
     _imageView ( VK_NULL_HANDLE ),
     _isGenerateMipmaps ( isGenerateMipmaps ),
+    _mipmapResources {},
     _resolution { .width = 0U, .height = 0U },
     _transfer ( VK_NULL_HANDLE ),
     _transferDeviceMemory ( VK_NULL_HANDLE ),
+    _transferDeviceMemoryOffset ( 0U ),
+    _transferData ( nullptr ),
     _fileName ( std::move ( fileName ) )
 {
     // NOTHING
@@ -103,12 +123,20 @@ void Texture2D::FreeResources ( android_vulkan::Renderer &renderer )
 
 void Texture2D::FreeTransferResources ( android_vulkan::Renderer &renderer )
 {
+    MipmapGenerator::FreeResources ( _mipmapResources, renderer );
     VkDevice device = renderer.GetDevice ();
 
+    if ( _transferData )
+    {
+        renderer.UnmapMemory ( _transferDeviceMemory );
+        _transferData = nullptr;
+    }
+
     if ( _transferDeviceMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _transferDeviceMemory, nullptr );
+        renderer.FreeMemory ( _transferDeviceMemory, _transferDeviceMemoryOffset );
         _transferDeviceMemory = VK_NULL_HANDLE;
+        _transferDeviceMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "Texture2D::_transferDeviceMemory" )
     }
 
@@ -130,6 +158,11 @@ uint8_t Texture2D::GetMipLevelCount () const
     return _mipLevels;
 }
 
+VkDeviceSize Texture2D::GetMemorySize () const
+{
+    return _imageDeviceMemorySize;
+}
+
 bool Texture2D::UploadData ( android_vulkan::Renderer &renderer, VkCommandBuffer commandBuffer )
 {
     if ( _imageView != VK_NULL_HANDLE )
@@ -144,25 +177,11 @@ bool Texture2D::UploadData ( android_vulkan::Renderer &renderer, VkCommandBuffer
         return false;
     }
 
-    std::vector<uint8_t> pixelData;
-
-    int width = 0;
-    int height = 0;
-    int channels = 0;
-
-    if ( !LoadImage ( pixelData, _fileName, width, height, channels ) )
-        return false;
-
-    const VkFormat actualFormat = PickupFormat ( channels );
-
-    if ( !IsFormatCompatible ( _format, actualFormat, renderer ) )
-        return false;
-
-    return UploadDataInternal ( pixelData.data (),
-        pixelData.size (),
-        VkExtent2D { .width = static_cast<uint32_t> ( width ), .height = static_cast<uint32_t> ( height ) },
+    return UploadImage ( MapImage ( _fileName ),
         _format,
         _isGenerateMipmaps,
+        nullptr,
+        nullptr,
         renderer,
         commandBuffer
     );
@@ -182,39 +201,41 @@ bool Texture2D::UploadData ( std::string &fileName,
     }
 
     FreeResourceInternal ( renderer );
-    std::vector<uint8_t> pixelData;
 
-    int width = 0;
-    int height = 0;
-    int channels = 0;
-
-    if ( !LoadImage ( pixelData, fileName, width, height, channels ) )
+    if ( !UploadImage ( MapImage ( fileName ), format, isGenerateMipmaps, nullptr, nullptr, renderer, commandBuffer ) )
         return false;
 
-    const VkFormat actualFormat = PickupFormat ( channels );
+    _fileName = fileName;
+    return true;
+}
 
-    if ( !IsFormatCompatible ( format, actualFormat, renderer ) )
+bool Texture2D::UploadData ( std::string &&fileName,
+    VkFormat format,
+    bool isGenerateMipmaps,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+)
+{
+    if ( fileName.empty () )
+    {
+        android_vulkan::LogError ( "Texture2D::UploadData - Can't upload data. Filename is empty." );
         return false;
+    }
 
-    const bool result = UploadDataInternal ( pixelData.data (),
-        pixelData.size (),
-        VkExtent2D { .width = static_cast<uint32_t> ( width ), .height = static_cast<uint32_t> ( height ) },
-        format,
-        isGenerateMipmaps,
-        renderer,
-        commandBuffer
-    );
+    FreeResourceInternal ( renderer );
 
-    if ( !result )
+    if ( !UploadImage ( MapImage ( fileName ), format, isGenerateMipmaps, nullptr, nullptr, renderer, commandBuffer ) )
         return false;
 
-    _fileName = fileName;
+    _fileName = std::move ( fileName );
     return true;
 }
 
 bool Texture2D::UploadData ( std::string &&fileName,
     VkFormat format,
     bool isGenerateMipmaps,
+    TextureDecoder &decoder,
+    const MipmapGenerator* mipmapGenerator,
     android_vulkan::Renderer &renderer,
     VkCommandBuffer commandBuffer
 )
@@ -226,25 +247,46 @@ bool Texture2D::UploadData ( std::string &&fileName,
     }
 
     FreeResourceInternal ( renderer );
-    std::vector<uint8_t> pixelData;
 
-    int width = 0;
-    int height = 0;
-    int channels = 0;
+    const bool result = UploadImage ( MapImage ( fileName ),
+        format,
+        isGenerateMipmaps,
+        &decoder,
+        mipmapGenerator,
+        renderer,
+        commandBuffer
+    );
 
-    if ( !LoadImage ( pixelData, fileName, width, height, channels ) )
+    if ( !result )
         return false;
 
-    const VkFormat actualFormat = PickupFormat ( channels );
+    _fileName = std::move ( fileName );
+    return true;
+}
 
-    if ( !IsFormatCompatible ( format, actualFormat, renderer ) )
+bool Texture2D::UploadData ( std::shared_ptr<android_vulkan::File> &&file,
+    VkFormat format,
+    bool isGenerateMipmaps,
+    TextureDecoder &decoder,
+    const MipmapGenerator* mipmapGenerator,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+)
+{
+    if ( !file )
+    {
+        android_vulkan::LogError ( "Texture2D::UploadData - Can't upload data. File is not loaded." );
         return false;
+    }
 
-    const bool result = UploadDataInternal ( pixelData.data (),
-        pixelData.size (),
-        VkExtent2D { .width = static_cast<uint32_t> ( width ), .height = static_cast<uint32_t> ( height ) },
+    FreeResourceInternal ( renderer );
+    std::string fileName = file->GetPath ();
+
+    const bool result = UploadImage ( std::move ( file ),
         format,
         isGenerateMipmaps,
+        &decoder,
+        mipmapGenerator,
         renderer,
         commandBuffer
     );
@@ -266,7 +308,25 @@ bool Texture2D::UploadData ( const uint8_t* data,
 )
 {
     FreeResources ( renderer );
-    return UploadDataInternal ( data, size, resolution, format, isGenerateMipmaps, renderer, commandBuffer );
+    uint8_t* transferData = nullptr;
+
+    const bool result = UploadDataInternal ( transferData,
+        size,
+        resolution,
+        format,
+        nullptr,
+        1U,
+        isGenerateMipmaps,
+        nullptr,
+        renderer,
+        commandBuffer
+    );
+
+    if ( !result )
+        return false;
+
+    memcpy ( transferData, data, size );
+    return true;
 }
 
 uint32_t Texture2D::CountMipLevels ( const VkExtent2D &resolution ) const
@@ -297,8 +357,10 @@ void Texture2D::FreeResourceInternal ( android_vulkan::Renderer &renderer )
 
     if ( _imageDeviceMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _imageDeviceMemory, nullptr );
+        renderer.FreeMemory ( _imageDeviceMemory, _imageDeviceMemoryOffset );
         _imageDeviceMemory = VK_NULL_HANDLE;
+        _imageDeviceMemoryOffset = 0U;
+        _imageDeviceMemorySize = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "Texture2D::_imageDeviceMemory" )
     }
 
@@ -368,11 +430,140 @@ VkFormat Texture2D::PickupFormat ( int channels ) const
     }
 }
 
-bool Texture2D::UploadDataInternal ( const uint8_t* data,
+bool Texture2D::UploadImage ( std::shared_ptr<android_vulkan::File> &&file,
+    VkFormat format,
+    bool isGenerateMipmaps,
+    TextureDecoder* decoder,
+    const MipmapGenerator* mipmapGenerator,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+)
+{
+    if ( !file )
+        return false;
+
+    if ( KTX2Parser::IsKTX2 ( file->GetData (), file->GetSize () ) )
+        return UploadKTX2 ( *file, format, isGenerateMipmaps, mipmapGenerator, renderer, commandBuffer );
+
+    const std::string& fileName = file->GetPath ();
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    if ( !TextureDecoder::ReadInfo ( width, height, channels, file->GetData (), file->GetSize () ) )
+    {
+        android_vulkan::LogError ( "Texture2D::UploadImage - Can't parse image header %s.", fileName.c_str () );
+        return false;
+    }
+
+    const VkFormat actualFormat = PickupFormat ( channels );
+
+    if ( !IsFormatCompatible ( format, actualFormat, renderer ) )
+        return false;
+
+    uint8_t* transferData = nullptr;
+
+    const bool result = UploadDataInternal ( transferData,
+        static_cast<size_t> ( width ) * static_cast<size_t> ( height ) * static_cast<size_t> ( channels ),
+        VkExtent2D { .width = static_cast<uint32_t> ( width ), .height = static_cast<uint32_t> ( height ) },
+        format,
+        nullptr,
+        1U,
+        isGenerateMipmaps,
+        mipmapGenerator,
+        renderer,
+        commandBuffer
+    );
+
+    if ( !result )
+        return false;
+
+    // Note the copy commands are recorded already. But the pixels are needed only at the submit moment.
+    if ( decoder )
+    {
+        decoder->Enqueue ( std::move ( file ), transferData, fileName, width, height, channels );
+        return true;
+    }
+
+    if ( TextureDecoder::Decode ( transferData, file->GetData (), file->GetSize (), width, height, channels ) )
+        return true;
+
+    android_vulkan::LogError ( "Texture2D::UploadImage - Can't decode image %s.", fileName.c_str () );
+    FreeResources ( renderer );
+    return false;
+}
+
+bool Texture2D::UploadKTX2 ( const android_vulkan::File &file,
+    VkFormat format,
+    bool isGenerateMipmaps,
+    const MipmapGenerator* mipmapGenerator,
+    android_vulkan::Renderer &renderer,
+    VkCommandBuffer commandBuffer
+)
+{
+    KTX2Image image {};
+
+    if ( !KTX2Parser::Parse ( image, file.GetData (), file.GetSize () ) )
+    {
+        android_vulkan::LogError ( "Texture2D::UploadKTX2 - Can't parse KTX2 file %s.", file.GetPath ().c_str () );
+        return false;
+    }
+
+    const auto fileFormat = static_cast<VkFormat> ( image._format );
+
+    if ( !IsFormatCompatible ( format, fileFormat, renderer ) )
+        return false;
+
+    KTX2FormatInfo info {};
+    KTX2Parser::GetFormatInfo ( info, image._format );
+
+    // The compressed blocks can't be reinterpreted. So the file format is used as is. The levels can't be generated
+    // because neither the blits nor the compute shader write the compressed blocks.
+    const bool isCompressed = info._blockWidth > 1U;
+
+    size_t offsets[ KTX2_MAX_LEVELS ];
+    size_t size = 0U;
+
+    for ( uint32_t i = 0U; i < image._levelCount; ++i )
+    {
+        offsets[ i ] = size;
+        size += image._levels[ i ]._size;
+    }
+
+    uint8_t* transferData = nullptr;
+
+    // Note the stored levels are used as is. The generation request is ignored for such files.
+    const bool result = UploadDataInternal ( transferData,
+        size,
+        VkExtent2D { .width = image._width, .height = image._height },
+        isCompressed ? fileFormat : format,
+        offsets,
+        image._levelCount,
+        isGenerateMipmaps && image._isGenerateMipmaps && !isCompressed,
+        mipmapGenerator,
+        renderer,
+        commandBuffer
+    );
+
+    if ( !result )
+        return false;
+
+    // The level data is ready to use. So there is nothing to decode.
+    for ( uint32_t i = 0U; i < image._levelCount; ++i )
+        memcpy ( transferData + offsets[ i ], image._levels[ i ]._data, image._levels[ i ]._size );
+
+    return true;
+}
+
+bool Texture2D::UploadDataInternal ( uint8_t* &transferData,
     size_t size,
     const VkExtent2D &resolution,
     VkFormat format,
+    const size_t* levelOffsets,
+    uint32_t levelCount,
     bool isGenerateMipmaps,
+    const MipmapGenerator* mipmapGenerator,
     android_vulkan::Renderer &renderer,
     VkCommandBuffer commandBuffer
 )
@@ -380,26 +571,35 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
     _format = format;
     _resolution = resolution;
 
+    const uint32_t mipLevels = isGenerateMipmaps ? CountMipLevels ( _resolution ) : levelCount;
+
+    const bool isCompute = isGenerateMipmaps && mipLevels > 1U && mipmapGenerator &&
+        mipmapGenerator->IsSupported ( _format );
+
     VkImageCreateInfo imageInfo;
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.pNext = nullptr;
-    imageInfo.flags = 0U;
+    imageInfo.flags = isCompute ? MipmapGenerator::GetImageCreateFlags ( _format ) : 0U;
     imageInfo.format = _format;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 
-    imageInfo.usage =
-        AV_VK_FLAG ( VK_IMAGE_USAGE_SAMPLED_BIT ) |
-        AV_VK_FLAG ( VK_IMAGE_USAGE_TRANSFER_DST_BIT ) |
-        AV_VK_FLAG ( VK_IMAGE_USAGE_TRANSFER_SRC_BIT );
+    imageInfo.usage = AV_VK_FLAG ( VK_IMAGE_USAGE_SAMPLED_BIT ) | AV_VK_FLAG ( VK_IMAGE_USAGE_TRANSFER_DST_BIT );
+
+    // The blits need the transfer source usage. The compute generator writes the levels via the storage views.
+    // The stored levels need nothing else. It matters for the block-compressed formats.
+    if ( isCompute )
+        imageInfo.usage |= AV_VK_FLAG ( VK_IMAGE_USAGE_STORAGE_BIT );
+    else if ( isGenerateMipmaps )
+        imageInfo.usage |= AV_VK_FLAG ( VK_IMAGE_USAGE_TRANSFER_SRC_BIT );
 
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageInfo.extent.width = _resolution.width;
     imageInfo.extent.height = _resolution.height;
     imageInfo.extent.depth = 1U;
-    imageInfo.mipLevels = isGenerateMipmaps ? CountMipLevels ( _resolution ) : 1U;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1U;
     imageInfo.queueFamilyIndexCount = 0U;
     imageInfo.pQueueFamilyIndices = nullptr;
@@ -420,6 +620,7 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
     vkGetImageMemoryRequirements ( device, _image, &memoryRequirements );
 
     result = renderer.TryAllocateMemory ( _imageDeviceMemory,
+        _imageDeviceMemoryOffset,
         memoryRequirements,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         "Can't allocate image memory (Texture2D::UploadDataInternal)"
@@ -432,8 +633,10 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
     }
 
     AV_REGISTER_DEVICE_MEMORY ( "Texture2D::_imageDeviceMemory" )
+    _imageDeviceMemorySize = memoryRequirements.size;
 
-    result = renderer.CheckVkResult ( vkBindImageMemory ( device, _image, _imageDeviceMemory, 0U ),
+    result = renderer.CheckVkResult (
+        vkBindImageMemory ( device, _image, _imageDeviceMemory, _imageDeviceMemoryOffset ),
         "Texture2D::UploadDataInternal",
         "Can't bind image memory"
     );
@@ -444,9 +647,16 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
         return false;
     }
 
+    // The storage usage is not supported by every format which is compatible with the sRGB one. So the sampled view
+    // must exclude it.
+    VkImageViewUsageCreateInfo usageInfo;
+    usageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO;
+    usageInfo.pNext = nullptr;
+    usageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+
     VkImageViewCreateInfo viewInfo;
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.pNext = nullptr;
+    viewInfo.pNext = imageInfo.flags & VK_IMAGE_CREATE_EXTENDED_USAGE_BIT ? &usageInfo : nullptr;
     viewInfo.flags = 0U;
     viewInfo.image = _image;
     viewInfo.format = _format;
@@ -499,6 +709,7 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
     vkGetBufferMemoryRequirements ( device, _transfer, &memoryRequirements );
 
     result = renderer.TryAllocateMemory ( _transferDeviceMemory,
+        _transferDeviceMemoryOffset,
         memoryRequirements,
         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
         "Can't allocate transfer device memory (Texture2D::UploadDataInternal)"
@@ -512,7 +723,8 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
 
     AV_REGISTER_DEVICE_MEMORY ( "Texture2D::_transferDeviceMemory" )
 
-    result = renderer.CheckVkResult ( vkBindBufferMemory ( device, _transfer, _transferDeviceMemory, 0U ),
+    result = renderer.CheckVkResult (
+        vkBindBufferMemory ( device, _transfer, _transferDeviceMemory, _transferDeviceMemoryOffset ),
         "Texture2D::UploadDataInternal",
         "Can't bind transfer memory"
     );
@@ -525,8 +737,9 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
 
     void* destination = nullptr;
 
-    result = renderer.CheckVkResult (
-        vkMapMemory ( device, _transferDeviceMemory, 0U, bufferInfo.size, 0U, &destination ),
+    result = renderer.MapMemory ( destination,
+        _transferDeviceMemory,
+        _transferDeviceMemoryOffset,
         "Texture2D::UploadDataInternal",
         "Can't map transfer memory"
     );
@@ -537,25 +750,9 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
         return false;
     }
 
-    memcpy ( destination, data, static_cast<size_t> ( bufferInfo.size ) );
-    vkUnmapMemory ( device, _transferDeviceMemory );
-
-    VkCommandBufferBeginInfo beginInfo;
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.pNext = nullptr;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    beginInfo.pInheritanceInfo = nullptr;
-
-    result = renderer.CheckVkResult ( vkBeginCommandBuffer ( commandBuffer, &beginInfo ),
-        "Texture2D::UploadDataInternal",
-        "Can't begin command buffer"
-    );
-
-    if ( !result )
-    {
-        FreeResources ( renderer );
-        return false;
-    }
+    // Note the memory stays mapped until Texture2D::FreeTransferResources. So the pixels could be written later.
+    _transferData = static_cast<uint8_t*> ( destination );
+    transferData = _transferData;
 
     VkImageMemoryBarrier barrierInfo;
     barrierInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -584,24 +781,39 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
         &barrierInfo
     );
 
-    VkBufferImageCopy copyRegion;
-    copyRegion.imageOffset.x = 0;
-    copyRegion.imageOffset.y = 0;
-    copyRegion.imageOffset.z = 0;
-    copyRegion.imageExtent = imageInfo.extent;
-    copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copyRegion.imageSubresource.layerCount = 1U;
-    copyRegion.imageSubresource.baseArrayLayer = 0U;
-    copyRegion.imageSubresource.mipLevel = 0U;
-    copyRegion.bufferRowLength = imageInfo.extent.width;
-    copyRegion.bufferImageHeight = imageInfo.extent.height;
-    copyRegion.bufferOffset = 0U;
-
-    vkCmdCopyBufferToImage ( commandBuffer, _transfer, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1U, &copyRegion );
-
-    if ( !isGenerateMipmaps )
+    // Every stored level is copied. The generated levels are written later by the blits or by the compute shader.
+    const uint32_t storedLevels = isGenerateMipmaps ? 1U : levelCount;
+    std::vector<VkBufferImageCopy> copyRegions ( storedLevels );
+
+    for ( uint32_t i = 0U; i < storedLevels; ++i )
+    {
+        VkBufferImageCopy& copyRegion = copyRegions[ i ];
+        copyRegion.imageOffset.x = 0;
+        copyRegion.imageOffset.y = 0;
+        copyRegion.imageOffset.z = 0;
+        copyRegion.imageExtent.width = std::max ( imageInfo.extent.width >> i, 1U );
+        copyRegion.imageExtent.height = std::max ( imageInfo.extent.height >> i, 1U );
+        copyRegion.imageExtent.depth = 1U;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.layerCount = 1U;
+        copyRegion.imageSubresource.baseArrayLayer = 0U;
+        copyRegion.imageSubresource.mipLevel = i;
+        copyRegion.bufferRowLength = 0U;
+        copyRegion.bufferImageHeight = 0U;
+        copyRegion.bufferOffset = levelOffsets ? static_cast<VkDeviceSize> ( levelOffsets[ i ] ) : 0U;
+    }
+
+    vkCmdCopyBufferToImage ( commandBuffer,
+        _transfer,
+        _image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        storedLevels,
+        copyRegions.data ()
+    );
+
+    if ( !isGenerateMipmaps || mipLevels == 1U )
     {
-        barrierInfo.subresourceRange.levelCount = 1U;
+        barrierInfo.subresourceRange.levelCount = mipLevels;
         barrierInfo.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         barrierInfo.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         barrierInfo.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -619,31 +831,19 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
             &barrierInfo
         );
 
-        result = renderer.CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
-            "Texture2D::UploadDataInternal",
-            "Can't end command buffer"
-        );
-
-        if ( !result )
-        {
-            FreeResources ( renderer );
-            return false;
-        }
+        _mipLevels = static_cast<uint8_t> ( imageInfo.mipLevels );
+        return true;
+    }
 
-        VkSubmitInfo submitInfo;
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.pNext = nullptr;
-        submitInfo.commandBufferCount = 1U;
-        submitInfo.pCommandBuffers = &commandBuffer;
-        submitInfo.waitSemaphoreCount = 0U;
-        submitInfo.pWaitSemaphores = nullptr;
-        submitInfo.signalSemaphoreCount = 0U;
-        submitInfo.pSignalSemaphores = nullptr;
-        submitInfo.pWaitDstStageMask = nullptr;
-
-        result = renderer.CheckVkResult ( vkQueueSubmit ( renderer.GetQueue (), 1U, &submitInfo, VK_NULL_HANDLE ),
-            "Texture2D::UploadDataInternal",
-            "Can't submit command"
+    if ( isCompute )
+    {
+        result = mipmapGenerator->Generate ( _mipmapResources,
+            _image,
+            _format,
+            _resolution,
+            mipLevels,
+            renderer,
+            commandBuffer
         );
 
         if ( !result )
@@ -652,7 +852,7 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
             return false;
         }
 
-        _mipLevels = static_cast<uint8_t> ( imageInfo.mipLevels );
+        _mipLevels = static_cast<uint8_t> ( mipLevels );
         return true;
     }
 
@@ -768,136 +968,18 @@ bool Texture2D::UploadDataInternal ( const uint8_t* data,
         &barrierInfo
     );
 
-    result = renderer.CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
-        "Texture2D::UploadDataInternal",
-        "Can't end command buffer"
-    );
-
-    if ( !result )
-    {
-        FreeResources ( renderer );
-        return false;
-    }
-
-    VkSubmitInfo submitInfo;
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.pNext = nullptr;
-    submitInfo.commandBufferCount = 1U;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    submitInfo.waitSemaphoreCount = 0U;
-    submitInfo.pWaitSemaphores = nullptr;
-    submitInfo.signalSemaphoreCount = 0U;
-    submitInfo.pSignalSemaphores = nullptr;
-    submitInfo.pWaitDstStageMask = nullptr;
-
-    result = renderer.CheckVkResult ( vkQueueSubmit ( renderer.GetQueue (), 1U, &submitInfo, VK_NULL_HANDLE ),
-        "Texture2D::UploadDataInternal",
-        "Can't submit command"
-    );
-
-    if ( !result )
-    {
-        FreeResources ( renderer );
-        return false;
-    }
-
     _mipLevels = static_cast<uint8_t> ( imageInfo.mipLevels );
     return true;
 }
 
-bool Texture2D::LoadImage ( std::vector<uint8_t> &pixelData,
-    const std::string& fileName,
-    int &width,
-    int &height,
-    int &channels
-)
+std::shared_ptr<android_vulkan::File> Texture2D::MapImage ( const std::string &fileName )
 {
-    android_vulkan::File file ( const_cast<std::string&> ( fileName ) );
-
-    if ( !file.LoadContent () )
-        return false;
-
-    const std::vector<uint8_t>& imageContent = file.GetContent ();
-    const stbi_uc* stbInData = imageContent.data ();
-    const auto stbInSize = static_cast<const int> ( imageContent.size () );
-
-    auto* imagePixels = stbi_load_from_memory ( stbInData, stbInSize, &width, &height, &channels, 0 );
-
-    if ( channels != 3 )
-    {
-        const auto size = static_cast<const size_t> ( width * height * channels );
-        pixelData.resize ( size );
-        memcpy ( pixelData.data (), imagePixels, size );
-        free ( imagePixels );
+    auto file = std::make_shared<android_vulkan::File> ( const_cast<std::string&> ( fileName ) );
 
-        return true;
-    }
+    if ( file->MapContent () )
+        return file;
 
-    // We don't support 24bit per pixel mode.
-    // Expanding up to 32bit per pixel mode...
-
-    const auto size = static_cast<const size_t> ( RGBA_BYTES_PER_PIXEL * width * height );
-    pixelData.resize ( size );
-    uint8_t* dst = pixelData.data ();
-
-    auto expander = [] ( uint32_t* dst,
-        size_t dstRowSkipPixels,
-        const uint32_t* nonDstMemory,
-        const uint8_t* src,
-        size_t srcRowSkipPixels,
-        size_t rowPixelCount,
-        uint32_t oneAlphaMask
-    ) {
-        while ( dst < nonDstMemory )
-        {
-            for ( size_t i = 0U; i < rowPixelCount; ++i )
-            {
-                *dst = *reinterpret_cast<const uint32_t*> ( src );
-                *dst |= oneAlphaMask;
-
-                ++dst;
-                src += RGB_BYTES_PER_PIXEL;
-            }
-
-            src += srcRowSkipPixels;
-            dst += dstRowSkipPixels;
-        }
-    };
-
-    constexpr const size_t SKIP_ROWS = EXPANDER_THREADS - 1U;
-
-    const auto rowPixelCount = static_cast<const size_t> ( width );
-    const auto srcRowSize = RGB_BYTES_PER_PIXEL * rowPixelCount;
-    const auto srcRowSkipPixels = SKIP_ROWS * srcRowSize;
-    const auto dstRowSize = RGBA_BYTES_PER_PIXEL * rowPixelCount;
-    const auto dstRowSkipPixels = SKIP_ROWS * rowPixelCount;
-    const auto* nonDstMemory = reinterpret_cast<uint32_t*> ( dst + size );
-
-    constexpr const uint8_t oneAlphaRaw[ RGBA_BYTES_PER_PIXEL ] = { 0x00U, 0x00U, 0x00U, 0xFFU };
-    const uint32_t oneAlphaMask = *reinterpret_cast<const uint32_t*> ( oneAlphaRaw );
-
-    std::array<std::thread, EXPANDER_THREADS> expanders;
-
-    for ( size_t i = 0U; i < EXPANDER_THREADS; ++i )
-    {
-        expanders[ i ] = std::thread ( expander,
-            reinterpret_cast<uint32_t*> ( dst + i * dstRowSize ),
-            dstRowSkipPixels,
-            nonDstMemory,
-            imagePixels + i * srcRowSize,
-            srcRowSkipPixels,
-            rowPixelCount,
-            oneAlphaMask
-        );
-    }
-
-    for ( size_t i = 0U; i < EXPANDER_THREADS; ++i )
-        expanders[ i ].join ();
-
-    free ( imagePixels );
-    channels = static_cast<int> ( RGBA_BYTES_PER_PIXEL );
-
-    return true;
+    return nullptr;
 }
 
 } // namespace rotating_mesh
@@ -0,0 +1,186 @@
+#include <rotating_mesh/texture_decoder.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstring>
+#include <sys/resource.h>
+
+#define STBI_NO_FAILURE_STRINGS
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_PNG
+#define STBI_ONLY_BMP
+#define STBI_ONLY_TGA
+#define STBI_ONLY_HDR
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t RGB_BYTES_PER_PIXEL = 3U;
+constexpr static const size_t RGBA_BYTES_PER_PIXEL = 4U;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TextureDecoder::TextureDecoder ():
+    _counter {},
+    _isFailed ( false ),
+    _statImages ( 0U ),
+    _statStart {}
+{
+    // NOTHING
+}
+
+void TextureDecoder::Destroy ()
+{
+    android_vulkan::g_JobSystem->Wait ( _counter );
+    _isFailed = false;
+    _statImages = 0U;
+}
+
+void TextureDecoder::Enqueue ( std::shared_ptr<android_vulkan::File> &&file,
+    uint8_t* destination,
+    const std::string &fileName,
+    int width,
+    int height,
+    int channels
+)
+{
+    if ( _counter.IsDone () )
+    {
+        _statImages = 0U;
+        _statStart = std::chrono::steady_clock::now ();
+    }
+
+    auto job = [ this, file = std::move ( file ), destination, fileName, width, height, channels ] () {
+        if ( Decode ( destination, file->GetData (), file->GetSize (), width, height, channels ) )
+        {
+            ++_statImages;
+            return;
+        }
+
+        android_vulkan::LogError ( "TextureDecoder::Enqueue - Can't decode image %s.", fileName.c_str () );
+        _isFailed = true;
+    };
+
+    android_vulkan::g_JobSystem->Run ( std::move ( job ), &_counter );
+}
+
+bool TextureDecoder::IsDone () const
+{
+    return _counter.IsDone ();
+}
+
+bool TextureDecoder::Wait ()
+{
+    android_vulkan::JobSystem& jobSystem = *android_vulkan::g_JobSystem;
+    jobSystem.Wait ( _counter );
+
+    const bool result = !_isFailed.exchange ( false );
+    const size_t images = _statImages.exchange ( 0U );
+
+    if ( !images )
+        return result;
+
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now () - _statStart;
+
+    rusage usage {};
+    getrusage ( RUSAGE_SELF, &usage );
+
+    android_vulkan::LogInfo ( "TextureDecoder::Wait - %zu image(s) in %g ms (%g images/s) on %zu worker(s). "
+        "Peak RSS: %ld KiB.",
+        images,
+        seconds.count () * 1.0e+3,
+        static_cast<double> ( images ) / seconds.count (),
+        jobSystem.GetWorkerCount (),
+        usage.ru_maxrss
+    );
+
+    return result;
+}
+
+bool TextureDecoder::Decode ( uint8_t* destination,
+    const uint8_t* content,
+    size_t size,
+    int width,
+    int height,
+    int channels
+)
+{
+    int w = 0;
+    int h = 0;
+    int c = 0;
+
+    stbi_uc* pixels = stbi_load_from_memory ( content,
+        static_cast<int> ( size ),
+        &w,
+        &h,
+        &c,
+        0
+    );
+
+    if ( !pixels )
+        return false;
+
+    if ( w != width || h != height )
+    {
+        stbi_image_free ( pixels );
+        return false;
+    }
+
+    const auto pixelCount = static_cast<size_t> ( width ) * static_cast<size_t> ( height );
+
+    if ( c == channels )
+    {
+        std::memcpy ( destination, pixels, pixelCount * static_cast<size_t> ( channels ) );
+        stbi_image_free ( pixels );
+        return true;
+    }
+
+    if ( c != static_cast<int> ( RGB_BYTES_PER_PIXEL ) || channels != static_cast<int> ( RGBA_BYTES_PER_PIXEL ) )
+    {
+        stbi_image_free ( pixels );
+        return false;
+    }
+
+    // We don't support 24bit per pixel mode. Expanding up to 32bit per pixel mode...
+    const uint8_t* src = pixels;
+
+    for ( size_t i = 0U; i < pixelCount; ++i )
+    {
+        destination[ 0U ] = src[ 0U ];
+        destination[ 1U ] = src[ 1U ];
+        destination[ 2U ] = src[ 2U ];
+        destination[ 3U ] = 0xFFU;
+
+        src += RGB_BYTES_PER_PIXEL;
+        destination += RGBA_BYTES_PER_PIXEL;
+    }
+
+    stbi_image_free ( pixels );
+    return true;
+}
+
+bool TextureDecoder::ReadInfo ( int &width, int &height, int &channels, const uint8_t* content, size_t size )
+{
+    const int result = stbi_info_from_memory ( content,
+        static_cast<int> ( size ),
+        &width,
+        &height,
+        &channels
+    );
+
+    if ( !result )
+        return false;
+
+    if ( channels == static_cast<int> ( RGB_BYTES_PER_PIXEL ) )
+        channels = static_cast<int> ( RGBA_BYTES_PER_PIXEL );
+
+    return true;
+}
+
+} // namespace rotating_mesh
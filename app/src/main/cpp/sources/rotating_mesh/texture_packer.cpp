@@ -0,0 +1,326 @@
+#include <rotating_mesh/texture_packer.h>
+#include <rotating_mesh/ktx2_parser.h>
+#include <job_system.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cmath>
+#include <cstring>
+
+GX_RESTORE_WARNING_STATE
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t CHANNELS = 4U;
+constexpr static const size_t ROW_GRAIN = 16U;
+
+constexpr static const size_t HEADER_SIZE = 80U;
+constexpr static const size_t LEVEL_INDEX_ENTRY_SIZE = 24U;
+constexpr static const uint32_t DFD_HEADER_SIZE = 28U;
+constexpr static const uint32_t DFD_SAMPLE_SIZE = 16U;
+constexpr static const uint32_t DFD_VERSION = 2U;
+constexpr static const uint32_t DFD_COLOR_MODEL_RGBSDA = 1U;
+constexpr static const uint32_t DFD_COLOR_MODEL_BC1A = 128U;
+constexpr static const uint32_t DFD_COLOR_MODEL_BC3 = 130U;
+constexpr static const uint32_t DFD_COLOR_MODEL_ETC2 = 161U;
+constexpr static const uint32_t DFD_PRIMARIES_BT709 = 1U;
+constexpr static const uint32_t DFD_TRANSFER_LINEAR = 1U;
+constexpr static const uint32_t DFD_TRANSFER_SRGB = 2U;
+constexpr static const uint32_t DFD_CHANNEL_BC_COLOR = 0U;
+constexpr static const uint32_t DFD_CHANNEL_ETC2_COLOR = 2U;
+constexpr static const uint32_t DFD_CHANNEL_ALPHA = 15U;
+constexpr static const uint32_t DFD_QUALIFIER_LINEAR = 0x10U;
+
+constexpr static const uint8_t IDENTIFIER[] =
+{
+    0xABU, 0x4BU, 0x54U, 0x58U, 0x20U, 0x32U, 0x30U, 0xBBU, 0x0DU, 0x0AU, 0x1AU, 0x0AU
+};
+
+// The sample of the compressed format covers the whole 64 bit half of the block.
+constexpr static const uint32_t DFD_HALF_BLOCK_BIT_LENGTH = 63U;
+constexpr static const uint32_t DFD_HALF_BLOCK_UPPER = 0xFFFFFFFFU;
+
+struct Level final
+{
+    uint32_t                _width;
+    uint32_t                _height;
+    std::vector<uint8_t>    _pixels;
+};
+
+struct Sample final
+{
+    uint32_t    _bitOffset;
+    uint32_t    _bitLength;
+    uint32_t    _channel;
+    uint32_t    _upper;
+};
+
+static float ToLinear ( uint8_t value )
+{
+    const float c = static_cast<float> ( value ) * ( 1.0F / 255.0F );
+    return c <= 0.04045F ? c * ( 1.0F / 12.92F ) : std::pow ( ( c + 0.055F ) * ( 1.0F / 1.055F ), 2.4F );
+}
+
+static uint8_t ToUNORM ( float value )
+{
+    const float c = value < 0.0F ? 0.0F : value > 1.0F ? 1.0F : value;
+    return static_cast<uint8_t> ( c * 255.0F + 0.5F );
+}
+
+static uint8_t ToSRGB ( float value )
+{
+    const float c = value <= 0.0031308F ? value * 12.92F : 1.055F * std::pow ( value, 1.0F / 2.4F ) - 0.055F;
+    return ToUNORM ( c );
+}
+
+static void Downsample ( Level &target, const Level &source, const float* toLinear, bool isSRGB )
+{
+    const uint32_t sourceWidth = source._width;
+    const uint32_t sourceHeight = source._height;
+    const uint32_t width = sourceWidth > 1U ? sourceWidth >> 1U : 1U;
+    const uint32_t height = sourceHeight > 1U ? sourceHeight >> 1U : 1U;
+
+    target._width = width;
+    target._height = height;
+    target._pixels.resize ( static_cast<size_t> ( width ) * static_cast<size_t> ( height ) * CHANNELS );
+
+    const uint8_t* src = source._pixels.data ();
+    uint8_t* dst = target._pixels.data ();
+
+    // The edge texels are repeated for odd resolutions. The same is done by the compute shader.
+    auto filter = [ & ] ( size_t begin, size_t end ) {
+        for ( size_t y = begin; y < end; ++y )
+        {
+            const auto y0 = static_cast<uint32_t> ( y * 2U );
+            const uint32_t y1 = y0 + 1U < sourceHeight ? y0 + 1U : sourceHeight - 1U;
+            const size_t rows[ 2U ] = { y0, y1 };
+
+            for ( uint32_t x = 0U; x < width; ++x )
+            {
+                const uint32_t x0 = x * 2U;
+                const uint32_t x1 = x0 + 1U < sourceWidth ? x0 + 1U : sourceWidth - 1U;
+                const size_t columns[ 2U ] = { x0, x1 };
+                float sum[ CHANNELS ] = { 0.0F, 0.0F, 0.0F, 0.0F };
+
+                for ( size_t row : rows )
+                {
+                    for ( size_t column : columns )
+                    {
+                        const uint8_t* texel = src + ( row * sourceWidth + column ) * CHANNELS;
+
+                        for ( size_t c = 0U; c < CHANNELS; ++c )
+                        {
+                            const bool isColor = isSRGB && c < CHANNELS - 1U;
+                            sum[ c ] += isColor ? toLinear[ texel[ c ] ] : static_cast<float> ( texel[ c ] ) / 255.0F;
+                        }
+                    }
+                }
+
+                uint8_t* out = dst + ( y * width + x ) * CHANNELS;
+
+                for ( size_t c = 0U; c < CHANNELS; ++c )
+                {
+                    const float average = 0.25F * sum[ c ];
+                    out[ c ] = isSRGB && c < CHANNELS - 1U ? ToSRGB ( average ) : ToUNORM ( average );
+                }
+            }
+        }
+    };
+
+    android_vulkan::g_JobSystem->ParallelFor ( static_cast<size_t> ( height ), ROW_GRAIN, filter );
+}
+
+static void WriteUInt32 ( uint8_t* data, size_t offset, uint32_t value )
+{
+    std::memcpy ( data + offset, &value, sizeof ( value ) );
+}
+
+static void WriteUInt64 ( uint8_t* data, size_t offset, uint64_t value )
+{
+    std::memcpy ( data + offset, &value, sizeof ( value ) );
+}
+
+static uint32_t CollectSamples ( Sample ( &samples )[ CHANNELS ], uint32_t &colorModel, uint32_t format, bool isSRGB )
+{
+    // Alpha is always linear. The color channels follow the transfer function.
+    const uint32_t alpha = DFD_CHANNEL_ALPHA | ( isSRGB ? DFD_QUALIFIER_LINEAR : 0U );
+
+    switch ( format )
+    {
+        case KTX2_FORMAT_BC1_RGB_UNORM:
+        case KTX2_FORMAT_BC1_RGB_SRGB:
+            colorModel = DFD_COLOR_MODEL_BC1A;
+            samples[ 0U ] = { 0U, DFD_HALF_BLOCK_BIT_LENGTH, DFD_CHANNEL_BC_COLOR, DFD_HALF_BLOCK_UPPER };
+        return 1U;
+
+        case KTX2_FORMAT_BC3_UNORM:
+        case KTX2_FORMAT_BC3_SRGB:
+            colorModel = DFD_COLOR_MODEL_BC3;
+            samples[ 0U ] = { 0U, DFD_HALF_BLOCK_BIT_LENGTH, alpha, DFD_HALF_BLOCK_UPPER };
+            samples[ 1U ] = { 64U, DFD_HALF_BLOCK_BIT_LENGTH, DFD_CHANNEL_BC_COLOR, DFD_HALF_BLOCK_UPPER };
+        return 2U;
+
+        case KTX2_FORMAT_ETC2_R8G8B8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8_SRGB:
+            colorModel = DFD_COLOR_MODEL_ETC2;
+            samples[ 0U ] = { 0U, DFD_HALF_BLOCK_BIT_LENGTH, DFD_CHANNEL_ETC2_COLOR, DFD_HALF_BLOCK_UPPER };
+        return 1U;
+
+        case KTX2_FORMAT_ETC2_R8G8B8A8_UNORM:
+        case KTX2_FORMAT_ETC2_R8G8B8A8_SRGB:
+            colorModel = DFD_COLOR_MODEL_ETC2;
+            samples[ 0U ] = { 0U, DFD_HALF_BLOCK_BIT_LENGTH, alpha, DFD_HALF_BLOCK_UPPER };
+            samples[ 1U ] = { 64U, DFD_HALF_BLOCK_BIT_LENGTH, DFD_CHANNEL_ETC2_COLOR, DFD_HALF_BLOCK_UPPER };
+        return 2U;
+
+        default:
+            colorModel = DFD_COLOR_MODEL_RGBSDA;
+            samples[ 0U ] = { 0U, 7U, 0U, 255U };
+            samples[ 1U ] = { 8U, 7U, 1U, 255U };
+            samples[ 2U ] = { 16U, 7U, 2U, 255U };
+            samples[ 3U ] = { 24U, 7U, alpha, 255U };
+        return 4U;
+    }
+}
+
+static uint32_t GetDFDSize ( uint32_t format )
+{
+    Sample samples[ CHANNELS ];
+    uint32_t colorModel;
+    return DFD_HEADER_SIZE + CollectSamples ( samples, colorModel, format, false ) * DFD_SAMPLE_SIZE;
+}
+
+static void WriteDFD ( uint8_t* data, size_t offset, const KTX2FormatInfo &info, uint32_t format, bool isSRGB )
+{
+    Sample samples[ CHANNELS ];
+    uint32_t colorModel;
+    const uint32_t sampleCount = CollectSamples ( samples, colorModel, format, isSRGB );
+    const uint32_t blockSize = DFD_HEADER_SIZE - sizeof ( uint32_t ) + sampleCount * DFD_SAMPLE_SIZE;
+    const uint32_t transfer = isSRGB ? DFD_TRANSFER_SRGB : DFD_TRANSFER_LINEAR;
+
+    const uint32_t header[] =
+    {
+        blockSize + static_cast<uint32_t> ( sizeof ( uint32_t ) ),
+        0U,
+        DFD_VERSION | ( blockSize << 16U ),
+        colorModel | ( DFD_PRIMARIES_BT709 << 8U ) | ( transfer << 16U ),
+        ( info._blockWidth - 1U ) | ( ( info._blockHeight - 1U ) << 8U ),
+        info._blockSize,
+        0U
+    };
+
+    std::memcpy ( data + offset, header, sizeof ( header ) );
+    offset += sizeof ( header );
+
+    for ( uint32_t i = 0U; i < sampleCount; ++i )
+    {
+        const Sample& s = samples[ i ];
+        const uint32_t sample[] = { s._bitOffset | ( s._bitLength << 16U ) | ( s._channel << 24U ), 0U, 0U, s._upper };
+        std::memcpy ( data + offset, sample, sizeof ( sample ) );
+        offset += sizeof ( sample );
+    }
+}
+
+static bool IsOpaque ( const Level &level )
+{
+    const std::vector<uint8_t>& pixels = level._pixels;
+    const size_t size = pixels.size ();
+
+    for ( size_t i = CHANNELS - 1U; i < size; i += CHANNELS )
+    {
+        if ( pixels[ i ] != 255U )
+            return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TexturePacker::Pack ( std::vector<uint8_t> &content,
+    const uint8_t* rgba,
+    uint32_t width,
+    uint32_t height,
+    bool isSRGB,
+    eBlockCompression compression
+)
+{
+    float toLinear[ 256U ];
+
+    for ( uint32_t i = 0U; i < 256U; ++i )
+        toLinear[ i ] = ToLinear ( static_cast<uint8_t> ( i ) );
+
+    std::vector<Level> levels ( 1U );
+    Level& base = levels.front ();
+    base._width = width;
+    base._height = height;
+    base._pixels.assign ( rgba, rgba + static_cast<size_t> ( width ) * static_cast<size_t> ( height ) * CHANNELS );
+
+    while ( levels.back ()._width > 1U || levels.back ()._height > 1U )
+    {
+        Level next {};
+        Downsample ( next, levels.back (), toLinear, isSRGB );
+        levels.push_back ( std::move ( next ) );
+    }
+
+    const uint32_t format = BlockCompressor::SelectFormat ( compression, isSRGB, IsOpaque ( levels.front () ) );
+    KTX2FormatInfo info {};
+    KTX2Parser::GetFormatInfo ( info, format );
+
+    const size_t levelCount = levels.size ();
+    const size_t dfdOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE;
+    const uint32_t dfdSize = GetDFDSize ( format );
+
+    // The smallest level goes first in the file. KTX2 requires every level to be aligned to the texel block size.
+    // It is enough to align the first level because the level sizes are multiple of the block size.
+    const auto alignment = static_cast<size_t> ( info._blockSize );
+    size_t total = ( dfdOffset + static_cast<size_t> ( dfdSize ) + alignment - 1U ) / alignment * alignment;
+    std::vector<size_t> offsets ( levelCount );
+    std::vector<size_t> sizes ( levelCount );
+
+    for ( size_t i = levelCount; i > 0U; --i )
+    {
+        const Level& level = levels[ i - 1U ];
+        sizes[ i - 1U ] = KTX2Parser::GetLevelSize ( info, level._width, level._height );
+        offsets[ i - 1U ] = total;
+        total += sizes[ i - 1U ];
+    }
+
+    content.assign ( total, 0U );
+    uint8_t* data = content.data ();
+
+    std::memcpy ( data, IDENTIFIER, sizeof ( IDENTIFIER ) );
+    WriteUInt32 ( data, 12U, format );
+    WriteUInt32 ( data, 16U, 1U );
+    WriteUInt32 ( data, 20U, width );
+    WriteUInt32 ( data, 24U, height );
+    WriteUInt32 ( data, 36U, 1U );
+    WriteUInt32 ( data, 40U, static_cast<uint32_t> ( levelCount ) );
+    WriteUInt32 ( data, 48U, static_cast<uint32_t> ( dfdOffset ) );
+    WriteUInt32 ( data, 52U, dfdSize );
+
+    for ( size_t i = 0U; i < levelCount; ++i )
+    {
+        const size_t entry = HEADER_SIZE + i * LEVEL_INDEX_ENTRY_SIZE;
+        const auto size = static_cast<uint64_t> ( sizes[ i ] );
+
+        WriteUInt64 ( data, entry, static_cast<uint64_t> ( offsets[ i ] ) );
+        WriteUInt64 ( data, entry + 8U, size );
+        WriteUInt64 ( data, entry + 16U, size );
+
+        const Level& level = levels[ i ];
+
+        if ( info._blockWidth == 1U )
+        {
+            std::memcpy ( data + offsets[ i ], level._pixels.data (), sizes[ i ] );
+            continue;
+        }
+
+        BlockCompressor::Compress ( data + offsets[ i ], level._pixels.data (), level._width, level._height, format );
+    }
+
+    WriteDFD ( data, dfdOffset, info, format, isSRGB );
+}
+
+} // namespace rotating_mesh
@@ -15,12 +15,21 @@ UniformBuffer::UniformBuffer ():
     _size ( 0U ),
     _buffer ( VK_NULL_HANDLE ),
     _bufferMemory ( VK_NULL_HANDLE ),
+    _bufferMemoryOffset ( 0U ),
     _commandBuffer ( VK_NULL_HANDLE ),
     _commandPool  ( VK_NULL_HANDLE ),
+    _mappedData ( nullptr ),
+    _mode ( eUniformBufferMode::Staging ),
     _renderer ( nullptr ),
+    _sliceCount ( 1U ),
+    _sliceStride ( 0U ),
     _targetStages ( VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT ),
     _transfer ( VK_NULL_HANDLE ),
-    _transferMemory ( VK_NULL_HANDLE )
+    _transferMemory ( VK_NULL_HANDLE ),
+    _transferMemoryOffset ( 0U ),
+    _statSubmits ( 0U ),
+    _statUpdates ( 0U ),
+    _statUpdateTime ( 0 )
 {
     // NOTHING
 }
@@ -31,8 +40,9 @@ void UniformBuffer::FreeResources ()
 
     if ( _transferMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _transferMemory, nullptr );
+        _renderer->FreeMemory ( _transferMemory, _transferMemoryOffset );
         _transferMemory = VK_NULL_HANDLE;
+        _transferMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "UniformBuffer::_transferMemory" )
     }
 
@@ -43,10 +53,17 @@ void UniformBuffer::FreeResources ()
         AV_UNREGISTER_BUFFER ( "UniformBuffer::_transfer" )
     }
 
+    if ( _mappedData )
+    {
+        _renderer->UnmapMemory ( _bufferMemory );
+        _mappedData = nullptr;
+    }
+
     if ( _bufferMemory != VK_NULL_HANDLE )
     {
-        vkFreeMemory ( device, _bufferMemory, nullptr );
+        _renderer->FreeMemory ( _bufferMemory, _bufferMemoryOffset );
         _bufferMemory = VK_NULL_HANDLE;
+        _bufferMemoryOffset = 0U;
         AV_UNREGISTER_DEVICE_MEMORY ( "UniformBuffer::_bufferMemory" )
     }
 
@@ -65,6 +82,9 @@ void UniformBuffer::FreeResources ()
 
     _size = 0U;
     _commandPool = VK_NULL_HANDLE;
+    _mode = eUniformBufferMode::Staging;
+    _sliceCount = 1U;
+    _sliceStride = 0U;
     _targetStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
     _renderer = nullptr;
 }
@@ -79,6 +99,43 @@ size_t UniformBuffer::GetSize () const
     return _size;
 }
 
+uint32_t UniformBuffer::GetDynamicOffset ( size_t slice ) const
+{
+    assert ( slice < _sliceCount );
+    return static_cast<uint32_t> ( slice * _sliceStride );
+}
+
+VkDescriptorType UniformBuffer::GetDescriptorType () const
+{
+    return _mode == eUniformBufferMode::PersistentRing ?
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC :
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+}
+
+eUniformBufferMode UniformBuffer::GetMode () const
+{
+    return _mode;
+}
+
+size_t UniformBuffer::GetSliceCount () const
+{
+    return _sliceCount;
+}
+
+void UniformBuffer::GetStatistics ( size_t &updates, size_t &submits, std::chrono::nanoseconds &updateTime ) const
+{
+    updates = _statUpdates;
+    submits = _statSubmits;
+    updateTime = _statUpdateTime;
+}
+
+void UniformBuffer::ResetStatistics ()
+{
+    _statUpdates = 0U;
+    _statSubmits = 0U;
+    _statUpdateTime = std::chrono::nanoseconds::zero ();
+}
+
 bool UniformBuffer::Init ( android_vulkan::Renderer &renderer,
     VkCommandPool commandPool,
     VkPipelineStageFlags targetStages
@@ -105,45 +162,43 @@ bool UniformBuffer::Init ( android_vulkan::Renderer &renderer,
     );
 }
 
-bool UniformBuffer::Update ( const uint8_t* data, size_t size )
+bool UniformBuffer::InitRing ( android_vulkan::Renderer &renderer, size_t sliceCount )
+{
+    assert ( sliceCount );
+
+    if ( _renderer )
+        return true;
+
+    _renderer = &renderer;
+    _mode = eUniformBufferMode::PersistentRing;
+    _sliceCount = sliceCount;
+    return true;
+}
+
+bool UniformBuffer::Update ( const uint8_t* data, size_t size, size_t slice )
 {
     assert ( size );
 
-    if ( !_size && !InitResources ( size ) )
+    if ( _mode == eUniformBufferMode::Staging )
+        return UpdateStaging ( data, size );
+
+    if ( !_size && !InitRingResources ( size ) )
         return false;
 
     if ( !data )
         return true;
 
-    VkDevice device = _renderer->GetDevice ();
-    void* dst = nullptr;
-
-    bool result = _renderer->CheckVkResult ( vkMapMemory ( device, _transferMemory, 0U, size, 0U, &dst ),
-        "UniformBuffer::Update",
-        "Can't map transfer memory"
-    );
-
-    if ( !result )
-        return false;
+    assert ( size <= _size );
+    assert ( slice < _sliceCount );
 
-    memcpy ( dst, data, size );
-    vkUnmapMemory ( device, _transferMemory );
+    const auto start = std::chrono::steady_clock::now ();
 
-    VkSubmitInfo submitInfo;
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.pNext = nullptr;
-    submitInfo.commandBufferCount = 1U;
-    submitInfo.pCommandBuffers = &_commandBuffer;
-    submitInfo.waitSemaphoreCount = 0U;
-    submitInfo.pWaitSemaphores = nullptr;
-    submitInfo.pWaitDstStageMask = nullptr;
-    submitInfo.signalSemaphoreCount = 0U;
-    submitInfo.pSignalSemaphores = nullptr;
+    // Note memory is host coherent. So there is no need to flush anything.
+    memcpy ( _mappedData + slice * _sliceStride, data, size );
 
-    return _renderer->CheckVkResult ( vkQueueSubmit ( _renderer->GetQueue (), 1U, &submitInfo, VK_NULL_HANDLE ),
-        "UniformBuffer::Update",
-        "Can't submit upload command"
-    );
+    _statUpdateTime += std::chrono::steady_clock::now () - start;
+    ++_statUpdates;
+    return true;
 }
 
 bool UniformBuffer::InitResources ( size_t size )
@@ -174,6 +229,7 @@ bool UniformBuffer::InitResources ( size_t size )
     vkGetBufferMemoryRequirements ( device, _buffer, &requirements );
 
     result = _renderer->TryAllocateMemory ( _bufferMemory,
+        _bufferMemoryOffset,
         requirements,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         "Can't allocate buffer memory (UniformBuffer::InitResources)"
@@ -187,7 +243,7 @@ bool UniformBuffer::InitResources ( size_t size )
 
     AV_REGISTER_DEVICE_MEMORY ( "UniformBuffer::_bufferMemory" )
 
-    result = _renderer->CheckVkResult ( vkBindBufferMemory ( device, _buffer, _bufferMemory, 0U ),
+    result = _renderer->CheckVkResult ( vkBindBufferMemory ( device, _buffer, _bufferMemory, _bufferMemoryOffset ),
         "UniformBuffer::InitResources",
         "Can't bind buffer memory"
     );
@@ -212,6 +268,7 @@ bool UniformBuffer::InitResources ( size_t size )
     vkGetBufferMemoryRequirements ( device, _transfer, &requirements );
 
     result = _renderer->TryAllocateMemory ( _transferMemory,
+        _transferMemoryOffset,
         requirements,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         "Can't allocate transfer memory (UniformBuffer::InitResources)"
@@ -225,7 +282,8 @@ bool UniformBuffer::InitResources ( size_t size )
 
     AV_REGISTER_DEVICE_MEMORY ( "UniformBuffer::_transferMemory" )
 
-    result = _renderer->CheckVkResult ( vkBindBufferMemory ( device, _transfer, _transferMemory, 0U ),
+    result = _renderer->CheckVkResult (
+        vkBindBufferMemory ( device, _transfer, _transferMemory, _transferMemoryOffset ),
         "UniformBuffer::InitResources",
         "Can't bind transfer memory"
     );
@@ -311,4 +369,129 @@ bool UniformBuffer::InitResources ( size_t size )
     return false;
 }
 
+bool UniformBuffer::UpdateStaging ( const uint8_t* data, size_t size )
+{
+    assert ( size );
+
+    if ( !_size && !InitResources ( size ) )
+        return false;
+
+    if ( !data )
+        return true;
+
+    const auto start = std::chrono::steady_clock::now ();
+    void* dst = nullptr;
+
+    bool result = _renderer->MapMemory ( dst,
+        _transferMemory,
+        _transferMemoryOffset,
+        "UniformBuffer::UpdateStaging",
+        "Can't map transfer memory"
+    );
+
+    if ( !result )
+        return false;
+
+    memcpy ( dst, data, size );
+    _renderer->UnmapMemory ( _transferMemory );
+
+    VkSubmitInfo submitInfo;
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = nullptr;
+    submitInfo.commandBufferCount = 1U;
+    submitInfo.pCommandBuffers = &_commandBuffer;
+    submitInfo.waitSemaphoreCount = 0U;
+    submitInfo.pWaitSemaphores = nullptr;
+    submitInfo.pWaitDstStageMask = nullptr;
+    submitInfo.signalSemaphoreCount = 0U;
+    submitInfo.pSignalSemaphores = nullptr;
+
+    result = _renderer->CheckVkResult ( vkQueueSubmit ( _renderer->GetQueue (), 1U, &submitInfo, VK_NULL_HANDLE ),
+        "UniformBuffer::UpdateStaging",
+        "Can't submit upload command"
+    );
+
+    _statUpdateTime += std::chrono::steady_clock::now () - start;
+    ++_statUpdates;
+    ++_statSubmits;
+    return result;
+}
+
+bool UniformBuffer::InitRingResources ( size_t size )
+{
+    const VkDeviceSize alignment = _renderer->GetPhysicalDeviceLimits ().minUniformBufferOffsetAlignment;
+    const size_t stride = alignment > 1U ? ( ( size + alignment - 1U ) / alignment ) * alignment : size;
+
+    VkDevice device = _renderer->GetDevice ();
+
+    VkBufferCreateInfo bufferInfo;
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = nullptr;
+    bufferInfo.flags = 0U;
+    bufferInfo.size = static_cast<VkDeviceSize> ( stride * _sliceCount );
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = 0U;
+    bufferInfo.pQueueFamilyIndices = nullptr;
+
+    bool result = _renderer->CheckVkResult ( vkCreateBuffer ( device, &bufferInfo, nullptr, &_buffer ),
+        "UniformBuffer::InitRingResources",
+        "Can't create buffer"
+    );
+
+    if ( !result )
+        return false;
+
+    AV_REGISTER_BUFFER ( "UniformBuffer::_buffer" )
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements ( device, _buffer, &requirements );
+
+    result = _renderer->TryAllocateMemory ( _bufferMemory,
+        _bufferMemoryOffset,
+        requirements,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        "Can't allocate buffer memory (UniformBuffer::InitRingResources)"
+    );
+
+    if ( !result )
+    {
+        FreeResources ();
+        return false;
+    }
+
+    AV_REGISTER_DEVICE_MEMORY ( "UniformBuffer::_bufferMemory" )
+
+    result = _renderer->CheckVkResult ( vkBindBufferMemory ( device, _buffer, _bufferMemory, _bufferMemoryOffset ),
+        "UniformBuffer::InitRingResources",
+        "Can't bind buffer memory"
+    );
+
+    if ( !result )
+    {
+        FreeResources ();
+        return false;
+    }
+
+    void* data = nullptr;
+
+    result = _renderer->MapMemory ( data,
+        _bufferMemory,
+        _bufferMemoryOffset,
+        "UniformBuffer::InitRingResources",
+        "Can't map buffer memory"
+    );
+
+    if ( !result )
+    {
+        FreeResources ();
+        return false;
+    }
+
+    _mappedData = static_cast<uint8_t*> ( data );
+    _sliceStride = stride;
+    _size = size;
+    return true;
+}
+
 } // namespace rotating_mesh
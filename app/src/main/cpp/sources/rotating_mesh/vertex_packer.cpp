@@ -0,0 +1,237 @@
+#include <rotating_mesh/vertex_packer.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined ( __ARM_NEON )
+
+#include <arm_neon.h>
+
+#elif defined ( __SSE2__ )
+
+#include <emmintrin.h>
+
+#endif
+
+GX_RESTORE_WARNING_STATE
+
+#include <half.h>
+#include <job_system.h>
+
+
+namespace rotating_mesh {
+
+constexpr static const size_t PACK_GRAIN = 4096U;
+
+// A2B10G10R10_UNORM_PACK32 components from the low bits to the high bits. The value v from [-1, 1] is stored as
+// trunc ( v * scale + bias ). It's rounding to nearest of ( v * 0.5 + 0.5 ) * ( 2 ^ bits - 1 ).
+alignas ( 16U ) constexpr static const float PACK_SCALE[ 4U ] = { 511.5F, 511.5F, 511.5F, 1.5F };
+alignas ( 16U ) constexpr static const float PACK_BIAS[ 4U ] = { 512.0F, 512.0F, 512.0F, 2.0F };
+alignas ( 16U ) constexpr static const int32_t PACK_SHIFT[ 4U ] = { 0, 10, 20, 30 };
+
+constexpr static const uint32_t UNORM10_MASK = 0x000003FFU;
+constexpr static const float UNORM10_TO_SNORM = 2.0F / 1023.0F;
+
+// The bitangent sign is stored in 2 bits: -1 becomes 0 and 1 becomes 3.
+constexpr static const uint32_t BITANGENT_SIGN_SHIFT = 30U;
+constexpr static const uint32_t BITANGENT_SIGN_POSITIVE = 2U;
+
+static uint32_t PackUnorm1010102 ( float x, float y, float z, float w )
+{
+
+#if defined ( __ARM_NEON )
+
+    const float lanes[ 4U ] = { x, y, z, w };
+    float32x4_t v = vminq_f32 ( vmaxq_f32 ( vld1q_f32 ( lanes ), vdupq_n_f32 ( -1.0F ) ), vdupq_n_f32 ( 1.0F ) );
+    v = vaddq_f32 ( vmulq_f32 ( v, vld1q_f32 ( PACK_SCALE ) ), vld1q_f32 ( PACK_BIAS ) );
+
+    const uint32x4_t shifted = vshlq_u32 ( vcvtq_u32_f32 ( v ), vld1q_s32 ( PACK_SHIFT ) );
+    const uint32x2_t merged = vorr_u32 ( vget_low_u32 ( shifted ), vget_high_u32 ( shifted ) );
+    return vget_lane_u32 ( merged, 0 ) | vget_lane_u32 ( merged, 1 );
+
+#elif defined ( __SSE2__ )
+
+    // Note SSE2 has no per lane shifts. So only the bit assembly is scalar.
+    __m128 v = _mm_min_ps ( _mm_max_ps ( _mm_setr_ps ( x, y, z, w ), _mm_set1_ps ( -1.0F ) ), _mm_set1_ps ( 1.0F ) );
+    v = _mm_add_ps ( _mm_mul_ps ( v, _mm_load_ps ( PACK_SCALE ) ), _mm_load_ps ( PACK_BIAS ) );
+
+    alignas ( 16U ) uint32_t q[ 4U ];
+    _mm_store_si128 ( reinterpret_cast<__m128i*> ( q ), _mm_cvttps_epi32 ( v ) );
+    return q[ 0U ] | ( q[ 1U ] << 10U ) | ( q[ 2U ] << 20U ) | ( q[ 3U ] << 30U );
+
+#else
+
+    const float lanes[ 4U ] = { x, y, z, w };
+    uint32_t result = 0U;
+
+    for ( size_t i = 0U; i < 4U; ++i )
+    {
+        const float v = std::clamp ( lanes[ i ], -1.0F, 1.0F ) * PACK_SCALE[ i ] + PACK_BIAS[ i ];
+        result |= static_cast<uint32_t> ( v ) << static_cast<uint32_t> ( PACK_SHIFT[ i ] );
+    }
+
+    return result;
+
+#endif
+
+}
+
+static void PackUV ( uint16_t* uv, float u, float v )
+{
+
+#if defined ( __aarch64__ )
+
+    const float lanes[ 4U ] = { u, v, 0.0F, 0.0F };
+    const uint16x4_t halfs = vreinterpret_u16_f16 ( vcvt_f16_f32 ( vld1q_f32 ( lanes ) ) );
+    uv[ 0U ] = vget_lane_u16 ( halfs, 0 );
+    uv[ 1U ] = vget_lane_u16 ( halfs, 1 );
+
+#else
+
+    uv[ 0U ] = android_vulkan::Half ( u ).GetData ();
+    uv[ 1U ] = android_vulkan::Half ( v ).GetData ();
+
+#endif
+
+}
+
+static float UnpackHalf ( uint16_t value )
+{
+    const uint32_t sign = static_cast<uint32_t> ( value & 0x8000U ) << 16U;
+    const uint32_t exponent = ( value >> 10U ) & 0x001FU;
+    const uint32_t mantissa = value & 0x03FFU;
+
+    if ( exponent == 0U )
+    {
+        // Zero and subnormal numbers.
+        const float magnitude = std::ldexp ( static_cast<float> ( mantissa ), -24 );
+        return sign ? -magnitude : magnitude;
+    }
+
+    // INF and NaN keep the maximum exponent. Otherwise the exponent bias is changed from 15 to 127.
+    const uint32_t bits = exponent == 0x001FU ?
+        sign | 0x7F800000U | ( mantissa << 13U ) :
+        sign | ( ( exponent + 112U ) << 23U ) | ( mantissa << 13U );
+
+    float result;
+    std::memcpy ( &result, &bits, sizeof ( result ) );
+    return result;
+}
+
+static void UnpackUnorm101010 ( GXVec3 &vector, uint32_t packed )
+{
+    for ( uint32_t i = 0U; i < 3U; ++i )
+    {
+        const uint32_t q = ( packed >> ( i * 10U ) ) & UNORM10_MASK;
+        vector._data[ i ] = static_cast<float> ( q ) * UNORM10_TO_SNORM - 1.0F;
+    }
+
+    vector.Normalize ();
+}
+
+static float ComputeAngle ( const GXVec3 &a, const GXVec3 &b )
+{
+    GXVec3 normalized = b;
+    normalized.Normalize ();
+    return GXRadToDeg ( std::acos ( std::clamp ( a.DotProduct ( normalized ), -1.0F, 1.0F ) ) );
+}
+
+static float RebuildBitangent ( GXVec3 &bitangent, const VertexInfo &vertex )
+{
+    bitangent.CrossProduct ( vertex._normal, vertex._tangent );
+    const float sign = bitangent.DotProduct ( vertex._bitangent ) < 0.0F ? -1.0F : 1.0F;
+    bitangent.Multiply ( bitangent, sign );
+    return sign;
+}
+
+static void PackVertex ( PackedVertexInfo &packed, const VertexInfo &vertex )
+{
+    GXVec3 bitangent;
+    const float sign = RebuildBitangent ( bitangent, vertex );
+
+    const GXVec3& normal = vertex._normal;
+    const GXVec3& tangent = vertex._tangent;
+
+    packed._vertex = vertex._vertex;
+    PackUV ( packed._uv, vertex._uv._data[ 0U ], 1.0F - vertex._uv._data[ 1U ] );
+    packed._normal = PackUnorm1010102 ( normal._data[ 0U ], normal._data[ 1U ], normal._data[ 2U ], 0.0F );
+    packed._tangent = PackUnorm1010102 ( tangent._data[ 0U ], tangent._data[ 1U ], tangent._data[ 2U ], sign );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void VertexPacker::Pack ( PackedVertexInfo* destination, const VertexInfo* source, size_t count )
+{
+    // The destination memory is never read back because it could be write-combined.
+    auto packer = [ destination, source ] ( size_t begin, size_t end ) {
+        PackedVertexInfo packed {};
+
+        for ( size_t i = begin; i < end; ++i )
+        {
+            PackVertex ( packed, source[ i ] );
+            destination[ i ] = packed;
+        }
+    };
+
+    android_vulkan::g_JobSystem->ParallelFor ( count, PACK_GRAIN, packer );
+}
+
+void VertexPacker::Unpack ( VertexInfo &vertex, const PackedVertexInfo &packed )
+{
+    vertex._vertex = packed._vertex;
+    vertex._uv._data[ 0U ] = UnpackHalf ( packed._uv[ 0U ] );
+    vertex._uv._data[ 1U ] = UnpackHalf ( packed._uv[ 1U ] );
+
+    UnpackUnorm101010 ( vertex._normal, packed._normal );
+    UnpackUnorm101010 ( vertex._tangent, packed._tangent );
+
+    const bool isPositive = ( packed._tangent >> BITANGENT_SIGN_SHIFT ) >= BITANGENT_SIGN_POSITIVE;
+    vertex._bitangent.CrossProduct ( vertex._normal, vertex._tangent );
+    vertex._bitangent.Normalize ();
+
+    if ( !isPositive )
+        vertex._bitangent.Reverse ();
+}
+
+void VertexPacker::MeasureError ( VertexPackingError &error,
+    const PackedVertexInfo* packed,
+    const VertexInfo* source,
+    size_t count
+)
+{
+    error = {};
+
+    if ( !count )
+        return;
+
+    VertexInfo unpacked {};
+    GXVec3 bitangent {};
+    double skew = 0.0;
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        Unpack ( unpacked, packed[ i ] );
+        const VertexInfo& original = source[ i ];
+
+        const float uvError = std::max ( std::abs ( unpacked._uv._data[ 0U ] - original._uv._data[ 0U ] ),
+            std::abs ( unpacked._uv._data[ 1U ] - ( 1.0F - original._uv._data[ 1U ] ) )
+        );
+
+        error._uv = std::max ( error._uv, uvError );
+        error._normal = std::max ( error._normal, ComputeAngle ( unpacked._normal, original._normal ) );
+        error._tangent = std::max ( error._tangent, ComputeAngle ( unpacked._tangent, original._tangent ) );
+
+        RebuildBitangent ( bitangent, original );
+        error._bitangent = std::max ( error._bitangent, ComputeAngle ( unpacked._bitangent, bitangent ) );
+
+        bitangent.Normalize ();
+        skew += static_cast<double> ( ComputeAngle ( bitangent, original._bitangent ) );
+    }
+
+    error._averageSkew = static_cast<float> ( skew / static_cast<double> ( count ) );
+}
+
+} // namespace rotating_mesh
@@ -0,0 +1,163 @@
+#include <sampler_cache.h>
+#include "logger.h"
+#include "vulkan_utils.h"
+
+
+namespace android_vulkan {
+
+// -0.0F becomes 0.0F. Other values are not changed.
+static float NormalizeZero ( float value )
+{
+    return value == 0.0F ? 0.0F : value;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SamplerCache::Key::Key ( const VkSamplerCreateInfo &info ):
+    _flags ( info.flags ),
+    _magFilter ( info.magFilter ),
+    _minFilter ( info.minFilter ),
+    _mipmapMode ( info.mipmapMode ),
+    _addressModeU ( info.addressModeU ),
+    _addressModeV ( info.addressModeV ),
+    _addressModeW ( info.addressModeW ),
+    _mipLodBias ( NormalizeZero ( info.mipLodBias ) ),
+    _anisotropyEnable ( info.anisotropyEnable ),
+    _maxAnisotropy ( NormalizeZero ( info.maxAnisotropy ) ),
+    _compareEnable ( info.compareEnable ),
+    _compareOp ( info.compareOp ),
+    _minLod ( NormalizeZero ( info.minLod ) ),
+    _maxLod ( NormalizeZero ( info.maxLod ) ),
+    _borderColor ( info.borderColor ),
+    _unnormalizedCoordinates ( info.unnormalizedCoordinates )
+{
+    // NOTHING
+}
+
+bool SamplerCache::Key::operator == ( const Key &other ) const
+{
+    return _flags == other._flags &&
+        _magFilter == other._magFilter &&
+        _minFilter == other._minFilter &&
+        _mipmapMode == other._mipmapMode &&
+        _addressModeU == other._addressModeU &&
+        _addressModeV == other._addressModeV &&
+        _addressModeW == other._addressModeW &&
+        _mipLodBias == other._mipLodBias &&
+        _anisotropyEnable == other._anisotropyEnable &&
+        _maxAnisotropy == other._maxAnisotropy &&
+        _compareEnable == other._compareEnable &&
+        _compareOp == other._compareOp &&
+        _minLod == other._minLod &&
+        _maxLod == other._maxLod &&
+        _borderColor == other._borderColor &&
+        _unnormalizedCoordinates == other._unnormalizedCoordinates;
+}
+
+// FNV-1a
+size_t SamplerCache::KeyHasher::operator () ( const Key &key ) const
+{
+    const auto* data = reinterpret_cast<const uint8_t*> ( &key );
+    uint32_t hash = 2166136261U;
+
+    for ( size_t i = 0U; i < sizeof ( Key ); ++i )
+    {
+        hash ^= static_cast<uint32_t> ( data[ i ] );
+        hash *= 16777619U;
+    }
+
+    return static_cast<size_t> ( hash );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SamplerCache::SamplerCache ():
+    _device ( VK_NULL_HANDLE ),
+    _entries {},
+    _mutex {},
+    _samplers {}
+{
+    // NOTHING
+}
+
+void SamplerCache::Init ( VkDevice device )
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+    _device = device;
+}
+
+void SamplerCache::Destroy ()
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+
+    for ( auto const& item : _entries )
+    {
+        LogWarning ( "SamplerCache::Destroy - Sampler still has %zu reference(s).", item.second._references );
+        vkDestroySampler ( _device, item.first, nullptr );
+        AV_UNREGISTER_SAMPLER ( "SamplerCache::_samplers" )
+    }
+
+    _entries.clear ();
+    _samplers.clear ();
+    _device = VK_NULL_HANDLE;
+}
+
+VkResult SamplerCache::Acquire ( VkSampler &sampler, const VkSamplerCreateInfo &info )
+{
+    if ( info.pNext )
+    {
+        LogError ( "SamplerCache::Acquire - The extension structures are not supported." );
+        sampler = VK_NULL_HANDLE;
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    const Key key ( info );
+    std::unique_lock<std::mutex> lock ( _mutex );
+    const auto findResult = _samplers.find ( key );
+
+    if ( findResult != _samplers.cend () )
+    {
+        sampler = findResult->second;
+        ++_entries.find ( sampler )->second._references;
+        return VK_SUCCESS;
+    }
+
+    const VkResult result = vkCreateSampler ( _device, &info, nullptr, &sampler );
+
+    if ( result != VK_SUCCESS )
+    {
+        sampler = VK_NULL_HANDLE;
+        return result;
+    }
+
+    AV_REGISTER_SAMPLER ( "SamplerCache::_samplers" )
+
+    _samplers.emplace ( key, sampler );
+    _entries.emplace ( sampler, Entry { key, 1U } );
+    return VK_SUCCESS;
+}
+
+void SamplerCache::Release ( VkSampler sampler )
+{
+    std::unique_lock<std::mutex> lock ( _mutex );
+    const auto findResult = _entries.find ( sampler );
+
+    if ( findResult == _entries.cend () )
+    {
+        LogError ( "SamplerCache::Release - Unknown sampler." );
+        return;
+    }
+
+    Entry& entry = findResult->second;
+
+    if ( --entry._references > 0U )
+        return;
+
+    _samplers.erase ( entry._key );
+    _entries.erase ( findResult );
+
+    vkDestroySampler ( _device, sampler, nullptr );
+    AV_UNREGISTER_SAMPLER ( "SamplerCache::_samplers" )
+}
+
+} // namespace android_vulkan
@@ -0,0 +1,151 @@
+#include <upload_batch_ring.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cassert>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+
+
+namespace android_vulkan {
+
+UploadBatchRing::UploadBatchRing ():
+    _batches {},
+    _nextSubmitOrder ( 0U ),
+    _recording ( NO_UPLOAD_BATCH )
+{
+    // NOTHING
+}
+
+void UploadBatchRing::Init ( size_t batchCount )
+{
+    assert ( _batches.empty () );
+
+    _batches.resize ( batchCount );
+
+    for ( auto& batch : _batches )
+    {
+        batch._isSubmitted = false;
+        batch._submitOrder = 0U;
+        batch._submitTime = {};
+    }
+
+    _nextSubmitOrder = 0U;
+    _recording = NO_UPLOAD_BATCH;
+}
+
+void UploadBatchRing::Destroy ()
+{
+    _batches.clear ();
+    _recording = NO_UPLOAD_BATCH;
+}
+
+size_t UploadBatchRing::GetBatchCount () const
+{
+    return _batches.size ();
+}
+
+size_t UploadBatchRing::GetRecording () const
+{
+    return _recording;
+}
+
+size_t UploadBatchRing::GetUploads ( size_t batch ) const
+{
+    return _batches[ batch ]._releaseCallbacks.size ();
+}
+
+bool UploadBatchRing::IsSubmitted ( size_t batch ) const
+{
+    return _batches[ batch ]._isSubmitted;
+}
+
+size_t UploadBatchRing::SelectBatch () const
+{
+    size_t oldest = NO_UPLOAD_BATCH;
+    const size_t count = _batches.size ();
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        const Batch& batch = _batches[ i ];
+
+        if ( !batch._isSubmitted )
+            return i;
+
+        if ( oldest == NO_UPLOAD_BATCH || batch._submitOrder < _batches[ oldest ]._submitOrder )
+            oldest = i;
+    }
+
+    return oldest;
+}
+
+void UploadBatchRing::BeginRecording ( size_t batch )
+{
+    assert ( _recording == NO_UPLOAD_BATCH );
+    assert ( !_batches[ batch ]._isSubmitted );
+    _recording = batch;
+}
+
+void UploadBatchRing::CancelRecording ()
+{
+    _recording = NO_UPLOAD_BATCH;
+}
+
+void UploadBatchRing::AddReleaseCallback ( ReleaseCallback &&callback )
+{
+    assert ( _recording != NO_UPLOAD_BATCH );
+    _batches[ _recording ]._releaseCallbacks.push_back ( std::move ( callback ) );
+}
+
+void UploadBatchRing::Submit ()
+{
+    assert ( _recording != NO_UPLOAD_BATCH );
+
+    Batch& batch = _batches[ _recording ];
+    batch._isSubmitted = true;
+    batch._submitOrder = _nextSubmitOrder++;
+    batch._submitTime = std::chrono::steady_clock::now ();
+
+    _recording = NO_UPLOAD_BATCH;
+}
+
+void UploadBatchRing::Retire ( size_t batch )
+{
+    Batch& target = _batches[ batch ];
+    assert ( target._isSubmitted );
+
+    for ( auto& callback : target._releaseCallbacks )
+        callback ();
+
+#ifdef ANDROID_VULKAN_DEBUG
+
+    const std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now () - target._submitTime;
+
+    LogInfo ( "UploadBatchRing::Retire - Batch of %zu upload(s) is completed. Submit to retire: %g ms.",
+        target._releaseCallbacks.size (),
+        latency.count ()
+    );
+
+#endif // ANDROID_VULKAN_DEBUG
+
+    target._releaseCallbacks.clear ();
+    target._isSubmitted = false;
+}
+
+void UploadBatchRing::ReleaseRecording ()
+{
+    if ( _recording == NO_UPLOAD_BATCH )
+        return;
+
+    Batch& batch = _batches[ _recording ];
+
+    for ( auto& callback : batch._releaseCallbacks )
+        callback ();
+
+    batch._releaseCallbacks.clear ();
+    _recording = NO_UPLOAD_BATCH;
+}
+
+} // namespace android_vulkan
@@ -0,0 +1,305 @@
+#include <upload_scheduler.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cassert>
+
+GX_RESTORE_WARNING_STATE
+
+#include <logger.h>
+#include <vulkan_utils.h>
+
+
+namespace android_vulkan {
+
+constexpr static const size_t BATCH_COUNT = 3U;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UploadScheduler::UploadScheduler ():
+    _commandBuffers {},
+    _commandPool ( VK_NULL_HANDLE ),
+    _fences {},
+    _renderer ( nullptr ),
+    _ring {}
+{
+    // NOTHING
+}
+
+bool UploadScheduler::Init ( Renderer &renderer )
+{
+    assert ( !_renderer );
+    _renderer = &renderer;
+
+    VkCommandPoolCreateInfo poolInfo;
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.pNext = nullptr;
+    poolInfo.queueFamilyIndex = renderer.GetQueueFamilyIndex ();
+
+    poolInfo.flags =
+        AV_VK_FLAG ( VK_COMMAND_POOL_CREATE_TRANSIENT_BIT ) |
+        AV_VK_FLAG ( VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT );
+
+    VkDevice device = renderer.GetDevice ();
+
+    bool result = renderer.CheckVkResult ( vkCreateCommandPool ( device, &poolInfo, nullptr, &_commandPool ),
+        "UploadScheduler::Init",
+        "Can't create command pool"
+    );
+
+    if ( !result )
+    {
+        Destroy ();
+        return false;
+    }
+
+    AV_REGISTER_COMMAND_POOL ( "UploadScheduler::_commandPool" )
+
+    _commandBuffers.resize ( BATCH_COUNT );
+
+    VkCommandBufferAllocateInfo allocateInfo;
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.commandPool = _commandPool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = static_cast<uint32_t> ( BATCH_COUNT );
+
+    result = renderer.CheckVkResult ( vkAllocateCommandBuffers ( device, &allocateInfo, _commandBuffers.data () ),
+        "UploadScheduler::Init",
+        "Can't allocate command buffers"
+    );
+
+    if ( !result )
+    {
+        Destroy ();
+        return false;
+    }
+
+    VkFenceCreateInfo fenceInfo;
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.pNext = nullptr;
+    fenceInfo.flags = 0U;
+
+    _fences.reserve ( BATCH_COUNT );
+
+    for ( size_t i = 0U; i < BATCH_COUNT; ++i )
+    {
+        VkFence fence = VK_NULL_HANDLE;
+
+        result = renderer.CheckVkResult ( vkCreateFence ( device, &fenceInfo, nullptr, &fence ),
+            "UploadScheduler::Init",
+            "Can't create fence"
+        );
+
+        if ( !result )
+        {
+            Destroy ();
+            return false;
+        }
+
+        AV_REGISTER_FENCE ( "UploadScheduler::_fences" )
+        _fences.push_back ( fence );
+    }
+
+    _ring.Init ( BATCH_COUNT );
+    return true;
+}
+
+void UploadScheduler::Destroy ()
+{
+    if ( !_renderer )
+        return;
+
+    WaitIdle ();
+    _ring.ReleaseRecording ();
+    _ring.Destroy ();
+
+    VkDevice device = _renderer->GetDevice ();
+
+    for ( VkFence fence : _fences )
+    {
+        vkDestroyFence ( device, fence, nullptr );
+        AV_UNREGISTER_FENCE ( "UploadScheduler::_fences" )
+    }
+
+    _fences.clear ();
+    _commandBuffers.clear ();
+
+    if ( _commandPool != VK_NULL_HANDLE )
+    {
+        vkDestroyCommandPool ( device, _commandPool, nullptr );
+        _commandPool = VK_NULL_HANDLE;
+        AV_UNREGISTER_COMMAND_POOL ( "UploadScheduler::_commandPool" )
+    }
+
+    _renderer = nullptr;
+}
+
+bool UploadScheduler::Begin ( VkCommandBuffer &commandBuffer )
+{
+    size_t batch = _ring.GetRecording ();
+
+    if ( batch != NO_UPLOAD_BATCH )
+    {
+        commandBuffer = _commandBuffers[ batch ];
+        return true;
+    }
+
+    if ( !AcquireBatch () )
+        return false;
+
+    VkCommandBufferBeginInfo beginInfo;
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext = nullptr;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr;
+
+    batch = _ring.GetRecording ();
+
+    const bool result = _renderer->CheckVkResult ( vkBeginCommandBuffer ( _commandBuffers[ batch ], &beginInfo ),
+        "UploadScheduler::Begin",
+        "Can't begin command buffer"
+    );
+
+    if ( !result )
+    {
+        _ring.CancelRecording ();
+        return false;
+    }
+
+    commandBuffer = _commandBuffers[ batch ];
+    return true;
+}
+
+void UploadScheduler::AddReleaseCallback ( ReleaseCallback &&callback )
+{
+    _ring.AddReleaseCallback ( std::move ( callback ) );
+}
+
+bool UploadScheduler::Submit ()
+{
+    const size_t batch = _ring.GetRecording ();
+
+    if ( batch == NO_UPLOAD_BATCH )
+        return true;
+
+    VkCommandBuffer commandBuffer = _commandBuffers[ batch ];
+
+    bool result = _renderer->CheckVkResult ( vkEndCommandBuffer ( commandBuffer ),
+        "UploadScheduler::Submit",
+        "Can't end command buffer"
+    );
+
+    if ( !result )
+        return false;
+
+    VkSubmitInfo submitInfo;
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = nullptr;
+    submitInfo.commandBufferCount = 1U;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.waitSemaphoreCount = 0U;
+    submitInfo.pWaitSemaphores = nullptr;
+    submitInfo.pWaitDstStageMask = nullptr;
+    submitInfo.signalSemaphoreCount = 0U;
+    submitInfo.pSignalSemaphores = nullptr;
+
+    result = _renderer->CheckVkResult ( vkQueueSubmit ( _renderer->GetQueue (), 1U, &submitInfo, _fences[ batch ] ),
+        "UploadScheduler::Submit",
+        "Can't submit command buffer"
+    );
+
+    if ( !result )
+        return false;
+
+    _ring.Submit ();
+    return true;
+}
+
+bool UploadScheduler::Poll ()
+{
+    VkDevice device = _renderer->GetDevice ();
+    const size_t count = _ring.GetBatchCount ();
+
+    for ( size_t batch = 0U; batch < count; ++batch )
+    {
+        if ( !_ring.IsSubmitted ( batch ) )
+            continue;
+
+        const VkResult status = vkGetFenceStatus ( device, _fences[ batch ] );
+
+        if ( status == VK_NOT_READY )
+            continue;
+
+        if ( !_renderer->CheckVkResult ( status, "UploadScheduler::Poll", "Can't get fence status" ) )
+            return false;
+
+        if ( !Retire ( batch ) )
+            return false;
+    }
+
+    return true;
+}
+
+bool UploadScheduler::WaitIdle ()
+{
+    VkDevice device = _renderer->GetDevice ();
+    const size_t count = _ring.GetBatchCount ();
+
+    for ( size_t batch = 0U; batch < count; ++batch )
+    {
+        if ( !_ring.IsSubmitted ( batch ) )
+            continue;
+
+        const bool result = _renderer->CheckVkResult (
+            vkWaitForFences ( device, 1U, &_fences[ batch ], VK_TRUE, UINT64_MAX ),
+            "UploadScheduler::WaitIdle",
+            "Can't wait fence"
+        );
+
+        if ( !result || !Retire ( batch ) )
+            return false;
+    }
+
+    return true;
+}
+
+bool UploadScheduler::AcquireBatch ()
+{
+    if ( !Poll () )
+        return false;
+
+    const size_t batch = _ring.SelectBatch ();
+
+    if ( _ring.IsSubmitted ( batch ) )
+    {
+        // All batches are in flight. Waiting for the oldest one.
+        const bool result = _renderer->CheckVkResult (
+            vkWaitForFences ( _renderer->GetDevice (), 1U, &_fences[ batch ], VK_TRUE, UINT64_MAX ),
+            "UploadScheduler::AcquireBatch",
+            "Can't wait fence"
+        );
+
+        if ( !result || !Retire ( batch ) )
+            return false;
+    }
+
+    _ring.BeginRecording ( batch );
+    return true;
+}
+
+bool UploadScheduler::Retire ( size_t batch )
+{
+    const bool result = _renderer->CheckVkResult ( vkResetFences ( _renderer->GetDevice (), 1U, &_fences[ batch ] ),
+        "UploadScheduler::Retire",
+        "Can't reset fence"
+    );
+
+    if ( !result )
+        return false;
+
+    _ring.Retire ( batch );
+    return true;
+}
+
+} // namespace android_vulkan
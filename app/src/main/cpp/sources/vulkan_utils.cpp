@@ -19,100 +19,6 @@ constexpr static const char* INDENT = "    ";
 
 //----------------------------------------------------------------------------------------------------------------------
 
-Half::Half ():
-    data ( 0U )
-{
-    // NOTHING
-}
-
-Half::Half ( float value )
-{
-    // see https://en.wikipedia.org/wiki/Single-precision_floating-point_format
-    // see https://en.wikipedia.org/wiki/Half-precision_floating-point_format
-    // see https://en.wikipedia.org/wiki/NaN
-    // see https://en.wikipedia.org/wiki/IEEE_754-1985#Positive_and_negative_infinity
-
-    const uint32_t from = *reinterpret_cast<uint32_t*> ( &value );
-
-    const uint32_t mantissa = from & 0x007FFFFFU;
-    const uint32_t sign = from & 0x80000000U;
-    const uint32_t exponent = from & 0x7F800000U;
-
-    // checking special cases: zeros, NaNs and INFs
-
-    if ( mantissa == 0 && exponent == 0 )
-    {
-        // positive|negative zero branch
-        data = static_cast<uint16_t> ( sign >> 16U );
-        return;
-    }
-
-    if ( exponent == 0xFF )
-    {
-        if ( mantissa == 0 )
-        {
-            // INF branch
-            data = static_cast<uint16_t> ( ( sign >> 16U ) | 0x00007C00U );
-            return;
-        }
-
-        // NaN branches
-
-        if ( mantissa & 0x400000U )
-        {
-            // singnaling NaN
-            data = static_cast<uint16_t> ( ( sign >> 16U ) | 0x00007C00U );
-            return;
-        }
-
-        // quet NaN
-        data = static_cast<uint16_t> ( ( sign >> 16U ) | 0x00007E00U );
-        return;
-    }
-
-    const auto exponentRaw = static_cast<uint8_t> ( exponent >> 23U );
-
-    // removing exponent bias (substract 127)
-    // see https://en.wikipedia.org/wiki/Single-precision_floating-point_format
-    auto restoredExponent = static_cast<int16_t> ( exponentRaw - 0x7F );
-
-    if ( restoredExponent >= 0 )
-    {
-        // positive exponent
-
-        if ( restoredExponent > 0x000F )
-        {
-            // exponent is bigger than float16 can represent -> INF
-            data = static_cast<uint16_t> ( ( sign >> 16U ) | 0x0000FC00U );
-            return;
-        }
-    }
-    else
-    {
-        // negative exponent
-
-        if ( restoredExponent < -0x000E )
-        {
-            // exponent is less than float16 can represent -> zero
-            data = static_cast<uint16_t> ( sign >> 16U );
-            return;
-        }
-    }
-
-    // biasing exponent (add 15).
-    // see https://en.wikipedia.org/wiki/Half-precision_floating-point_format
-    restoredExponent += 0x000F;
-
-    // input number is normalized by design. reassemble it
-    data = static_cast<uint16_t> (
-        ( sign >> 16U ) |
-        ( static_cast<uint32_t> ( restoredExponent ) << 10U ) |
-        ( mantissa >> 13U )
-    );
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
 class VulkanItem final
 {
     private:
@@ -187,7 +93,9 @@ static std::set<VulkanItem>         g_Framebuffers;
 static std::set<VulkanItem>         g_Images;
 static std::set<VulkanItem>         g_ImageViews;
 static std::set<VulkanItem>         g_Pipelines;
+static std::set<VulkanItem>         g_PipelineCaches;
 static std::set<VulkanItem>         g_PipelineLayouts;
+static std::set<VulkanItem>         g_QueryPools;
 static std::set<VulkanItem>         g_RenderPasses;
 static std::set<VulkanItem>         g_Samplers;
 static std::set<VulkanItem>         g_Semaphores;
@@ -283,7 +191,9 @@ void CheckVulkanLeaks ()
     CheckNonDispatchableObjectLeaks ( "Image", g_Images );
     CheckNonDispatchableObjectLeaks ( "Image view", g_ImageViews );
     CheckNonDispatchableObjectLeaks ( "Pipeline", g_Pipelines );
+    CheckNonDispatchableObjectLeaks ( "Pipeline cache", g_PipelineCaches );
     CheckNonDispatchableObjectLeaks ( "Pipeline layout", g_PipelineLayouts );
+    CheckNonDispatchableObjectLeaks ( "Query pool", g_QueryPools );
     CheckNonDispatchableObjectLeaks ( "Render pass", g_RenderPasses );
     CheckNonDispatchableObjectLeaks ( "Sampler", g_Samplers );
     CheckNonDispatchableObjectLeaks ( "Semaphore", g_Semaphores );
@@ -446,6 +356,20 @@ void UnregisterPipeline ( std::string &&where )
     );
 }
 
+void RegisterPipelineCache ( std::string &&where )
+{
+    RegisterNonDispatchableObject ( std::move ( where ), g_PipelineCaches );
+}
+
+void UnregisterPipelineCache ( std::string &&where )
+{
+    UnregisterNonDispatchableObject ( "AV_UNREGISTER_PIPELINE_CACHE",
+        "pipeline cache",
+        std::move ( where ),
+        g_PipelineCaches
+    );
+}
+
 void RegisterPipelineLayout ( std::string &&where )
 {
     RegisterNonDispatchableObject ( std::move ( where ), g_PipelineLayouts );
@@ -460,6 +384,20 @@ void UnregisterPipelineLayout ( std::string &&where )
     );
 }
 
+void RegisterQueryPool ( std::string &&where )
+{
+    RegisterNonDispatchableObject ( std::move ( where ), g_QueryPools );
+}
+
+void UnregisterQueryPool ( std::string &&where )
+{
+    UnregisterNonDispatchableObject ( "AV_UNREGISTER_QUERY_POOL",
+        "query pool",
+        std::move ( where ),
+        g_QueryPools
+    );
+}
+
 void RegisterRenderPass ( std::string &&where )
 {
     RegisterNonDispatchableObject ( std::move ( where ), g_RenderPasses );
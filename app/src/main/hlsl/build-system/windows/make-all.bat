@@ -3,9 +3,16 @@
 :: vertex shaders
 call make-vs.bat mandelbrot
 call make-vs.bat static-mesh
+call make-vs.bat static-mesh-packed
 
 :: pixel shaders
 call make-ps.bat mandelbrot-analytic-color
 call make-ps.bat mandelbrot-lut-color
 call make-ps.bat blinn-phong-analytic
+call make-ps.bat blinn-phong-analytic-material-table
 call make-ps.bat blinn-phong-lut
+call make-ps.bat blinn-phong-lut-material-table
+
+:: compute shaders
+call make-cs.bat gpu-culling
+call make-cs.bat mipmap-generator
@@ -0,0 +1,9 @@
+@echo off
+set COMPILE_FLAGS=-spirv -WX -O3 -fvk-use-dx-layout -enable-16bit-types
+set PIVOT_DIRECTORY=.\..\..\..
+
+@echo on
+"%ANDROID_VULKAN_DXC_ROOT%\dxc.exe" %COMPILE_FLAGS% -T cs_6_6 -E CS -I %PIVOT_DIRECTORY%\hlsl -Fo %PIVOT_DIRECTORY%\assets\shaders\%1-cs.spv %PIVOT_DIRECTORY%\hlsl\%1.cs
+
+@echo off
+echo Done
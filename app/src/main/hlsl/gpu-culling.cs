@@ -0,0 +1,118 @@
+#define THREADS                 64u
+
+// Size of the command record. VkDrawIndexedIndirectCommand and VkDrawIndirectCommand both keep instanceCount
+// at byte offset 4. So the same record serves both.
+#define COMMAND_STRIDE          20u
+#define INSTANCE_COUNT_OFFSET   4u
+
+// Rows of the instance transform.
+#define INSTANCE_ROWS           4u
+
+
+// Every thread culls the instances of single scene draw. The draws with visible instances are compacted into
+// the command range of their material. The visible instance transforms are copied into the range of the command.
+// See GPUCulling class.
+
+struct Bounds
+{
+    float4              _min;
+    float4              _max;
+};
+
+// Indexed by draw * instance count + instance.
+[[ vk::binding ( 0 ) ]]
+StructuredBuffer<Bounds>        g_bounds:               register ( t0 );
+
+// ( material, first command of the material ) per scene draw.
+[[ vk::binding ( 1 ) ]]
+StructuredBuffer<uint2>         g_draws:                register ( t1 );
+
+// Instance count transforms per scene draw.
+[[ vk::binding ( 2 ) ]]
+StructuredBuffer<float4>        g_instances:            register ( t2 );
+
+[[ vk::binding ( 3 ) ]]
+RWByteAddressBuffer             g_commands:             register ( u0 );
+
+// Number of commands per material.
+[[ vk::binding ( 4 ) ]]
+RWByteAddressBuffer             g_drawCounts:           register ( u1 );
+
+[[ vk::binding ( 5 ) ]]
+RWStructuredBuffer<float4>      g_visibleInstances:     register ( u2 );
+
+// Order of the planes: left, right, top, bottom, near, far. The planes are not normalized.
+struct Parameters
+{
+    float4              _planes[ 6u ];
+    uint                _drawCount;
+    uint                _instanceCount;
+};
+
+[[ vk::push_constant ]]
+Parameters              g_parameters;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// The box is visible if the corner which is the farthest along every plane normal is in front of the plane.
+// Same test as GXBatchCullAABBs.
+bool IsVisible ( in Bounds bounds )
+{
+    [unroll]
+    for ( uint i = 0u; i < 6u; ++i )
+    {
+        const float4 plane = g_parameters._planes[ i ];
+        const float3 farthest = max ( plane.xyz * bounds._min.xyz, plane.xyz * bounds._max.xyz );
+
+        if ( farthest.x + farthest.y + farthest.z + plane.w < 0.0f )
+            return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+[numthreads ( THREADS, 1, 1 )]
+void CS ( in uint3 threadID: SV_DispatchThreadID )
+{
+    const uint draw = threadID.x;
+
+    if ( draw >= g_parameters._drawCount )
+        return;
+
+    const uint instanceCount = g_parameters._instanceCount;
+    const uint2 info = g_draws[ draw ];
+    const uint firstInstance = draw * instanceCount;
+    uint visible = 0u;
+
+    for ( uint i = 0u; i < instanceCount; ++i )
+        visible += IsVisible ( g_bounds[ firstInstance + i ] ) ? 1u : 0u;
+
+    if ( visible == 0u )
+        return;
+
+    uint index;
+    g_drawCounts.InterlockedAdd ( info.x * 4u, 1u, index );
+
+    // The other fields of the command are written by CPU before the dispatch.
+    const uint command = info.y + index;
+    g_commands.Store ( command * COMMAND_STRIDE + INSTANCE_COUNT_OFFSET, visible );
+
+    // The test is repeated instead of keeping the mask. So any instance count is supported.
+    uint target = command * instanceCount * INSTANCE_ROWS;
+
+    for ( uint j = 0u; j < instanceCount; ++j )
+    {
+        if ( !IsVisible ( g_bounds[ firstInstance + j ] ) )
+            continue;
+
+        const uint source = ( firstInstance + j ) * INSTANCE_ROWS;
+
+        [unroll]
+        for ( uint row = 0u; row < INSTANCE_ROWS; ++row )
+            g_visibleInstances[ target + row ] = g_instances[ source + row ];
+
+        target += INSTANCE_ROWS;
+    }
+}
@@ -0,0 +1,116 @@
+#define THREADS                 8u
+#define LEVELS_PER_PASS         4u
+
+
+// Every thread group reduces 16x16 texels of the source level to the single texel of the fourth level.
+// The intermediate levels are kept in the shared memory. So there are no barriers between them.
+
+[[ vk::binding ( 0 ) ]]
+[[ vk::image_format ( "rgba8" ) ]]
+RWTexture2D<float4>     g_source:                       register ( u0 );
+
+// Note the unused levels of the last pass are bound too. They are never written.
+[[ vk::binding ( 1 ) ]]
+[[ vk::image_format ( "rgba8" ) ]]
+RWTexture2D<float4>     g_levels[ LEVELS_PER_PASS ]:    register ( u1 );
+
+struct Parameters
+{
+    uint                _levels;
+    uint                _isSRGB;
+};
+
+[[ vk::push_constant ]]
+Parameters              g_parameters;
+
+groupshared float4      g_tile[ THREADS * THREADS ];
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Storage views are UNORM. So the sRGB conversion is done manually. The filtering is done in linear space
+// the same way as the blit of sRGB image does.
+float4 ToLinear ( in float4 color )
+{
+    if ( g_parameters._isSRGB == 0u )
+        return color;
+
+    const float3 low = color.rgb * ( 1.0f / 12.92f );
+    const float3 high = pow ( ( color.rgb + 0.055f ) * ( 1.0f / 1.055f ), 2.4f );
+    return float4 ( lerp ( high, low, step ( color.rgb, 0.04045f ) ), color.a );
+}
+
+float4 ToSRGB ( in float4 color )
+{
+    if ( g_parameters._isSRGB == 0u )
+        return color;
+
+    const float3 low = color.rgb * 12.92f;
+    const float3 high = 1.055f * pow ( color.rgb, 1.0f / 2.4f ) - 0.055f;
+    return float4 ( lerp ( high, low, step ( color.rgb, 0.0031308f ) ), color.a );
+}
+
+void Store ( in uint level, in uint2 location, in float4 color )
+{
+    uint2 size;
+    g_levels[ level ].GetDimensions ( size.x, size.y );
+
+    if ( all ( location < size ) )
+        g_levels[ level ][ location ] = ToSRGB ( color );
+}
+
+float4 LoadSource ( in uint2 location, in uint2 last )
+{
+    return ToLinear ( g_source[ min ( location, last ) ] );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+[numthreads ( THREADS, THREADS, 1 )]
+void CS ( in uint3 groupID: SV_GroupID, in uint3 threadID: SV_GroupThreadID )
+{
+    uint2 sourceSize;
+    g_source.GetDimensions ( sourceSize.x, sourceSize.y );
+    const uint2 last = sourceSize - 1u;
+
+    // Every thread averages 2x2 texels of the source level. The edge texels are repeated for odd resolutions.
+    const uint2 target = groupID.xy * THREADS + threadID.xy;
+    const uint2 base = target * 2u;
+
+    float4 color = LoadSource ( base, last ) + LoadSource ( base + uint2 ( 1u, 0u ), last ) +
+        LoadSource ( base + uint2 ( 0u, 1u ), last ) + LoadSource ( base + uint2 ( 1u, 1u ), last );
+
+    color *= 0.25f;
+    Store ( 0u, target, color );
+
+    const uint index = threadID.y * THREADS + threadID.x;
+    g_tile[ index ] = color;
+
+    [unroll]
+    for ( uint level = 1u; level < LEVELS_PER_PASS; ++level )
+    {
+        // Note the condition is uniform for the thread group.
+        if ( level >= g_parameters._levels )
+            return;
+
+        GroupMemoryBarrierWithGroupSync ();
+
+        const uint size = THREADS >> level;
+        const bool isActive = all ( threadID.xy < size );
+
+        if ( isActive )
+        {
+            const uint corner = threadID.y * 2u * THREADS + threadID.x * 2u;
+
+            color = 0.25f * ( g_tile[ corner ] + g_tile[ corner + 1u ] + g_tile[ corner + THREADS ] +
+                g_tile[ corner + THREADS + 1u ] );
+        }
+
+        GroupMemoryBarrierWithGroupSync ();
+
+        if ( isActive )
+        {
+            g_tile[ index ] = color;
+            Store ( level, groupID.xy * size + threadID.xy, color );
+        }
+    }
+}
@@ -0,0 +1,90 @@
+[[ vk::binding ( 0 ) ]]
+cbuffer Transform:                          register ( b0 )
+{
+    matrix              _transform;
+    matrix              _normalTransform;
+};
+
+struct InputData
+{
+    [[ vk::location ( 0 ) ]]
+    float3              _vertex:            VERTEX;
+
+    // R16G16_SFLOAT
+    [[ vk::location ( 1 ) ]]
+    float2              _uv:                UV;
+
+    // A2B10G10R10_UNORM_PACK32. Components are in [0, 1] range.
+    [[ vk::location ( 2 ) ]]
+    float3              _normal:            NORMAL;
+
+    // A2B10G10R10_UNORM_PACK32. The alpha is the sign of the bitangent: 0 is negative, 1 is positive.
+    [[ vk::location ( 3 ) ]]
+    float4              _tangent:           TANGENT;
+
+    // Per instance transform. Rows of GXMat4 in memory order.
+    [[ vk::location ( 5 ) ]]
+    float4              _instance0:         INSTANCE0;
+
+    [[ vk::location ( 6 ) ]]
+    float4              _instance1:         INSTANCE1;
+
+    [[ vk::location ( 7 ) ]]
+    float4              _instance2:         INSTANCE2;
+
+    [[ vk::location ( 8 ) ]]
+    float4              _instance3:         INSTANCE3;
+};
+
+struct OutputData
+{
+    linear float4       _vertexH:           SV_Position;
+
+    [[ vk::location ( 0 ) ]]
+    linear float3       _fragmentView:      FRAGMENT;
+
+    [[ vk::location ( 1 ) ]]
+    linear half2        _uv:                UV;
+
+    [[ vk::location ( 2 ) ]]
+    linear half3        _normalView:        NORMAL;
+
+    [[ vk::location ( 3 ) ]]
+    linear half3        _tangentView:       TANGENT;
+
+    [[ vk::location ( 4 ) ]]
+    linear half3        _bitangentView:     BITANGENT;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+OutputData VS ( in InputData inputData )
+{
+    // Note GXMat4 follows row-vector convention. So the instance transform is applied from the right side.
+    const float4x4 instance = float4x4 ( inputData._instance0,
+        inputData._instance1,
+        inputData._instance2,
+        inputData._instance3
+    );
+
+    const float4 vertex = mul ( float4 ( inputData._vertex, 1.0f ), instance );
+    const float3x3 instanceOrientation = (float3x3)instance;
+
+    OutputData result;
+    result._vertexH = mul ( _transform, vertex );
+    result._fragmentView = ( mul ( _normalTransform, vertex ) ).xyz;
+
+    result._uv = (half2)inputData._uv;
+
+    // See rotating_mesh::PackedVertexInfo.
+    const float3 normal = inputData._normal * 2.0f - 1.0f;
+    const float3 tangent = inputData._tangent.xyz * 2.0f - 1.0f;
+    const float3 bitangent = cross ( normal, tangent ) * ( inputData._tangent.w > 0.5f ? 1.0f : -1.0f );
+
+    const float3x3 normalTransform = (float3x3)_normalTransform;
+    result._normalView = (half3)mul ( normalTransform, mul ( normal, instanceOrientation ) );
+    result._tangentView = (half3)mul ( normalTransform, mul ( tangent, instanceOrientation ) );
+    result._bitangentView = (half3)mul ( normalTransform, mul ( bitangent, instanceOrientation ) );
+
+    return result;
+}
@@ -21,6 +21,19 @@ struct InputData
 
     [[ vk::location ( 4 ) ]]
     float3              _bitangent:         BITANGENT;
+
+    // Per instance transform. Rows of GXMat4 in memory order.
+    [[ vk::location ( 5 ) ]]
+    float4              _instance0:         INSTANCE0;
+
+    [[ vk::location ( 6 ) ]]
+    float4              _instance1:         INSTANCE1;
+
+    [[ vk::location ( 7 ) ]]
+    float4              _instance2:         INSTANCE2;
+
+    [[ vk::location ( 8 ) ]]
+    float4              _instance3:         INSTANCE3;
 };
 
 struct OutputData
@@ -47,7 +60,15 @@ struct OutputData
 
 OutputData VS ( in InputData inputData )
 {
-    const float4 vertex = float4 ( inputData._vertex, 1.0f );
+    // Note GXMat4 follows row-vector convention. So the instance transform is applied from the right side.
+    const float4x4 instance = float4x4 ( inputData._instance0,
+        inputData._instance1,
+        inputData._instance2,
+        inputData._instance3
+    );
+
+    const float4 vertex = mul ( float4 ( inputData._vertex, 1.0f ), instance );
+    const float3x3 instanceOrientation = (float3x3)instance;
 
     OutputData result;
     result._vertexH = mul ( _transform, vertex );
@@ -56,9 +77,9 @@ OutputData VS ( in InputData inputData )
     result._uv = (half2)inputData._uv;
 
     const float3x3 normalTransform = (float3x3)_normalTransform;
-    result._normalView = (half3)mul ( normalTransform, inputData._normal );
-    result._tangentView = (half3)mul ( normalTransform, inputData._tangent );
-    result._bitangentView = (half3)mul ( normalTransform, inputData._bitangent );
+    result._normalView = (half3)mul ( normalTransform, mul ( inputData._normal, instanceOrientation ) );
+    result._tangentView = (half3)mul ( normalTransform, mul ( inputData._tangent, instanceOrientation ) );
+    result._bitangentView = (half3)mul ( normalTransform, mul ( inputData._bitangent, instanceOrientation ) );
 
     return result;
 }
@@ -0,0 +1,1006 @@
+#include <file.h>
+#include <frame_timing.h>
+#include <half.h>
+#include <job_system.h>
+#include <logger.h>
+#include <GXCommon/GXMath.h>
+#include <GXCommon/GXMathBatch.h>
+#include <GXCommon/GXSIMD.h>
+#include <mandelbrot/mandelbrot_lut.h>
+#include <rotating_mesh/ktx2_parser.h>
+#include <rotating_mesh/mesh_cooker.h>
+#include <rotating_mesh/mesh_optimizer.h>
+#include <rotating_mesh/mesh_parser.h>
+#include <rotating_mesh/specular_lut.h>
+#include <rotating_mesh/texture_decoder.h>
+#include <rotating_mesh/texture_packer.h>
+#include <rotating_mesh/vertex_packer.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+constexpr static const char* MESH_FILES[] =
+{
+    "meshes/rotating_mesh/sonic-material-1.mesh",
+    "meshes/rotating_mesh/sonic-material-2.mesh",
+    "meshes/rotating_mesh/sonic-material-3.mesh"
+};
+
+constexpr static const char* TEXTURE_FILES[] =
+{
+    "textures/rotating_mesh/sonic-material-1-diffuse.png",
+    "textures/rotating_mesh/sonic-material-2-diffuse.png",
+    "textures/rotating_mesh/sonic-material-2-normal.png",
+    "textures/rotating_mesh/sonic-material-3-diffuse.png",
+    "textures/rotating_mesh/sonic-material-3-normal.png"
+};
+
+constexpr static const size_t DEFAULT_ITERATIONS = 20U;
+constexpr static const size_t HALF_SAMPLES = 1U << 20U;
+constexpr static const size_t MATRIX_COUNT = 1U << 16U;
+constexpr static const size_t FRAME_TIMING_FRAMES = 1U << 16U;
+constexpr static const size_t BATCH_SIZES[] = { 1000U, 10000U, 100000U };
+constexpr static const size_t CULLING_BOXES = 100000U;
+
+constexpr static const rotating_mesh::eTangentMerge TANGENT_MERGES[] =
+{
+    rotating_mesh::eTangentMerge::Average,
+    rotating_mesh::eTangentMerge::None
+};
+constexpr static const size_t JOB_ITEMS[] = { 1000U, 100000U, 1000000U };
+
+using Benchmark = std::function<bool ()>;
+
+struct Image final
+{
+    std::shared_ptr<android_vulkan::File>   _file;
+    int                                     _width;
+    int                                     _height;
+    int                                     _channels;
+    std::vector<uint8_t>                    _pixels;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Every benchmark is executed once for warm up. The report contains median, minimum and maximum wall time.
+// The output is tab separated: name, iterations, median ms, min ms, max ms. "median" receives the median in ms.
+static bool Measure ( const char* name, size_t iterations, const Benchmark &benchmark, double* median = nullptr )
+{
+    if ( !benchmark () )
+    {
+        android_vulkan::LogError ( "Measure - Benchmark %s failed.", name );
+        return false;
+    }
+
+    std::vector<double> samples;
+    samples.reserve ( iterations );
+
+    for ( size_t i = 0U; i < iterations; ++i )
+    {
+        const auto start = std::chrono::steady_clock::now ();
+
+        if ( !benchmark () )
+        {
+            android_vulkan::LogError ( "Measure - Benchmark %s failed.", name );
+            return false;
+        }
+
+        const std::chrono::duration<double, std::milli> delta = std::chrono::steady_clock::now () - start;
+        samples.push_back ( delta.count () );
+    }
+
+    std::sort ( samples.begin (), samples.end () );
+
+    if ( median )
+        *median = samples[ samples.size () / 2U ];
+
+    std::printf ( "%s\t%zu\t%.4f\t%.4f\t%.4f\n",
+        name,
+        iterations,
+        samples[ samples.size () / 2U ],
+        samples.front (),
+        samples.back ()
+    );
+
+    return true;
+}
+
+static bool LoadImages ( std::vector<Image> &images )
+{
+    for ( const char* fileName : TEXTURE_FILES )
+    {
+        Image& image = images.emplace_back ();
+        image._file = std::make_shared<android_vulkan::File> ( fileName );
+
+        if ( !image._file->MapContent () )
+            return false;
+
+        const bool result = rotating_mesh::TextureDecoder::ReadInfo ( image._width,
+            image._height,
+            image._channels,
+            image._file->GetData (),
+            image._file->GetSize ()
+        );
+
+        if ( !result )
+            return false;
+
+        image._pixels.resize ( static_cast<size_t> ( image._width * image._height * image._channels ) );
+    }
+
+    return true;
+}
+
+static bool BenchmarkFiles ( size_t iterations )
+{
+    bool result = Measure ( "File::MapContent", iterations, [] () -> bool {
+        for ( const char* fileName : MESH_FILES )
+        {
+            android_vulkan::File file ( fileName );
+
+            if ( !file.MapContent () )
+                return false;
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    return Measure ( "File::LoadContent", iterations, [] () -> bool {
+        for ( const char* fileName : MESH_FILES )
+        {
+            android_vulkan::File file ( fileName );
+
+            if ( !file.LoadContent () )
+                return false;
+        }
+
+        return true;
+    } );
+}
+
+static bool BenchmarkMeshes ( size_t iterations )
+{
+    std::vector<std::unique_ptr<android_vulkan::File>> files;
+    size_t maxVertices = 0U;
+
+    for ( const char* fileName : MESH_FILES )
+    {
+        auto& file = files.emplace_back ( std::make_unique<android_vulkan::File> ( fileName ) );
+
+        if ( !file->MapContent () )
+            return false;
+
+        maxVertices = std::max ( maxVertices, file->GetSize () / sizeof ( rotating_mesh::VertexInfo ) );
+    }
+
+    std::vector<rotating_mesh::VertexInfo> vertices ( maxVertices );
+
+    bool result = Measure ( "MeshParser", iterations, [ &files, &vertices ] () -> bool {
+        for ( const auto& file : files )
+        {
+            const rotating_mesh::VertexInfo* source = nullptr;
+            uint32_t vertexCount = 0U;
+
+            if ( !rotating_mesh::MeshParser::Parse ( source, vertexCount, file->GetData (), file->GetSize () ) )
+                return false;
+
+            rotating_mesh::MeshParser::ConvertVertices ( vertices.data (),
+                source,
+                static_cast<size_t> ( vertexCount )
+            );
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<rotating_mesh::PackedVertexInfo> packed ( maxVertices );
+
+    result = Measure ( "VertexPacker", iterations, [ &files, &packed ] () -> bool {
+        for ( const auto& file : files )
+        {
+            const rotating_mesh::VertexInfo* source = nullptr;
+            uint32_t vertexCount = 0U;
+
+            if ( !rotating_mesh::MeshParser::Parse ( source, vertexCount, file->GetData (), file->GetSize () ) )
+                return false;
+
+            rotating_mesh::VertexPacker::Pack ( packed.data (), source, static_cast<size_t> ( vertexCount ) );
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<uint32_t> indices;
+
+    result = Measure ( "MeshOptimizer", iterations, [ &files, &vertices, &indices ] () -> bool {
+        for ( const auto& file : files )
+        {
+            const rotating_mesh::VertexInfo* source = nullptr;
+            uint32_t vertexCount = 0U;
+
+            if ( !rotating_mesh::MeshParser::Parse ( source, vertexCount, file->GetData (), file->GetSize () ) )
+                return false;
+
+            const auto count = static_cast<size_t> ( vertexCount );
+
+            rotating_mesh::MeshOptimizer::Deduplicate ( vertices,
+                indices,
+                source,
+                count,
+                rotating_mesh::eTangentMerge::None,
+                nullptr
+            );
+
+            rotating_mesh::MeshOptimizer::OptimizeVertexCache ( indices.data (), indices.size (), vertices.size () );
+            rotating_mesh::MeshOptimizer::OptimizeVertexFetch ( vertices, indices.data (), indices.size () );
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    // Load time of the version 1.2 fallback against the version 2.0 file. Both produce the same upload data.
+    std::vector<std::vector<uint8_t>> cooked ( files.size () );
+
+    result = Measure ( "MeshCooker::Cook", iterations, [ &files, &cooked ] () -> bool {
+        for ( size_t i = 0U; i < files.size (); ++i )
+        {
+            const android_vulkan::File& file = *files[ i ];
+            const rotating_mesh::VertexInfo* source = nullptr;
+            uint32_t vertexCount = 0U;
+
+            if ( !rotating_mesh::MeshParser::Parse ( source, vertexCount, file.GetData (), file.GetSize () ) )
+                return false;
+
+            rotating_mesh::MeshCooker::Cook ( cooked[ i ],
+                source,
+                static_cast<size_t> ( vertexCount ),
+                rotating_mesh::eVertexFormat::Packed,
+                rotating_mesh::eTangentMerge::None,
+                nullptr
+            );
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<uint8_t> upload ( maxVertices * sizeof ( rotating_mesh::VertexInfo ) );
+
+    result = Measure ( "MeshParser::ParseCooked", iterations, [ &cooked, &upload ] () -> bool {
+        for ( const std::vector<uint8_t>& content : cooked )
+        {
+            rotating_mesh::CookedMesh mesh {};
+
+            if ( !rotating_mesh::MeshParser::ParseCooked ( mesh, content.data (), content.size () ) )
+                return false;
+
+            std::memcpy ( upload.data (), mesh._vertices, mesh._vertexDataSize );
+            std::memcpy ( upload.data () + mesh._vertexDataSize, mesh._indices, mesh._indexDataSize );
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    // Geometry report: source vertices, unique vertices, ACMR before and after the cache optimization and the maximum
+    // tangent frame error of every tangent merge mode. Then vertex data size and the maximum error of the packed vertex
+    // format. Note the packing uses the lossless deduplication which is the last mode.
+    for ( size_t i = 0U; i < std::size ( MESH_FILES ); ++i )
+    {
+        const android_vulkan::File& file = *files[ i ];
+        const rotating_mesh::VertexInfo* source = nullptr;
+        uint32_t vertexCount = 0U;
+
+        if ( !rotating_mesh::MeshParser::Parse ( source, vertexCount, file.GetData (), file.GetSize () ) )
+            return false;
+
+        for ( const rotating_mesh::eTangentMerge tangentMerge : TANGENT_MERGES )
+        {
+            rotating_mesh::TangentMergeError mergeError {};
+
+            rotating_mesh::MeshOptimizer::Deduplicate ( vertices,
+                indices,
+                source,
+                static_cast<size_t> ( vertexCount ),
+                tangentMerge,
+                &mergeError
+            );
+
+            const float before = rotating_mesh::MeshOptimizer::ComputeACMR ( indices.data (),
+                indices.size (),
+                vertices.size (),
+                rotating_mesh::VERTEX_CACHE_SIZE
+            );
+
+            rotating_mesh::MeshOptimizer::OptimizeVertexCache ( indices.data (), indices.size (), vertices.size () );
+
+            const float after = rotating_mesh::MeshOptimizer::ComputeACMR ( indices.data (),
+                indices.size (),
+                vertices.size (),
+                rotating_mesh::VERTEX_CACHE_SIZE
+            );
+
+            std::printf ( "# %s (%s): vertices %u -> %zu (%.1f%%), ACMR %.3f -> %.3f, max error tangent %.3f, "
+                "bitangent %.3f deg\n",
+                MESH_FILES[ i ],
+                tangentMerge == rotating_mesh::eTangentMerge::Average ? "tangent merge" : "exact",
+                vertexCount,
+                vertices.size (),
+                100.0 * static_cast<double> ( vertices.size () ) / static_cast<double> ( vertexCount ),
+                static_cast<double> ( before ),
+                static_cast<double> ( after ),
+                static_cast<double> ( mergeError._tangent ),
+                static_cast<double> ( mergeError._bitangent )
+            );
+        }
+
+        const size_t uniqueCount = vertices.size ();
+        rotating_mesh::VertexPacker::Pack ( packed.data (), vertices.data (), uniqueCount );
+
+        rotating_mesh::VertexPackingError error {};
+        rotating_mesh::VertexPacker::MeasureError ( error, packed.data (), vertices.data (), uniqueCount );
+
+        std::printf ( "# %s: packed %zu -> %zu bytes, max error UV %.6f, normal %.3f, tangent %.3f, "
+            "bitangent %.3f deg, average skew %.3f deg\n",
+            MESH_FILES[ i ],
+            uniqueCount * sizeof ( rotating_mesh::VertexInfo ),
+            uniqueCount * sizeof ( rotating_mesh::PackedVertexInfo ),
+            static_cast<double> ( error._uv ),
+            static_cast<double> ( error._normal ),
+            static_cast<double> ( error._tangent ),
+            static_cast<double> ( error._bitangent ),
+            static_cast<double> ( error._averageSkew )
+        );
+    }
+
+    return true;
+}
+
+static bool BenchmarkPacking ( const char* packName,
+    const char* parseName,
+    size_t iterations,
+    const std::vector<Image> &images,
+    rotating_mesh::eBlockCompression compression
+)
+{
+    std::vector<std::vector<uint8_t>> packed ( images.size () );
+
+    bool result = Measure ( packName, iterations, [ &images, &packed, compression ] () -> bool {
+        for ( size_t i = 0U; i < images.size (); ++i )
+        {
+            const Image& image = images[ i ];
+
+            rotating_mesh::TexturePacker::Pack ( packed[ i ],
+                image._pixels.data (),
+                static_cast<uint32_t> ( image._width ),
+                static_cast<uint32_t> ( image._height ),
+                true,
+                compression
+            );
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    // Upload side of the KTX2 file with the stored mip chain: parsing and copying of all levels to the transfer
+    // memory. It replaces the PNG decoding and the mip map generation. The copied size is the image memory
+    // estimation. The actual size depends on the device alignment and tiling.
+    size_t uploadSize = 0U;
+
+    for ( const std::vector<uint8_t>& content : packed )
+        uploadSize = std::max ( uploadSize, content.size () );
+
+    std::vector<uint8_t> upload ( uploadSize );
+    size_t levelBytes = 0U;
+
+    result = Measure ( parseName, iterations, [ &packed, &upload, &levelBytes ] () -> bool {
+        levelBytes = 0U;
+
+        for ( const std::vector<uint8_t>& content : packed )
+        {
+            rotating_mesh::KTX2Image image {};
+
+            if ( !rotating_mesh::KTX2Parser::Parse ( image, content.data (), content.size () ) )
+                return false;
+
+            uint8_t* destination = upload.data ();
+
+            for ( uint32_t i = 0U; i < image._levelCount; ++i )
+            {
+                const rotating_mesh::KTX2Level& level = image._levels[ i ];
+                std::memcpy ( destination, level._data, level._size );
+                destination += level._size;
+                levelBytes += level._size;
+            }
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::printf ( "# %s: level data %zu KiB\n", parseName, levelBytes / 1024U );
+    return true;
+}
+
+static bool BenchmarkTextures ( size_t iterations )
+{
+    std::vector<Image> images;
+
+    if ( !LoadImages ( images ) )
+        return false;
+
+    bool result = Measure ( "TextureDecoder::Decode", iterations, [ &images ] () -> bool {
+        for ( Image& image : images )
+        {
+            const bool isDecoded = rotating_mesh::TextureDecoder::Decode ( image._pixels.data (),
+                image._file->GetData (),
+                image._file->GetSize (),
+                image._width,
+                image._height,
+                image._channels
+            );
+
+            if ( !isDecoded )
+                return false;
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    rotating_mesh::TextureDecoder decoder;
+
+    result = Measure ( "TextureDecoder::Enqueue", iterations, [ &images, &decoder ] () -> bool {
+        for ( Image& image : images )
+        {
+            std::shared_ptr<android_vulkan::File> file = image._file;
+
+            decoder.Enqueue ( std::move ( file ),
+                image._pixels.data (),
+                image._file->GetPath (),
+                image._width,
+                image._height,
+                image._channels
+            );
+        }
+
+        return decoder.Wait ();
+    } );
+
+    decoder.Destroy ();
+
+    if ( !result )
+        return false;
+
+    // The decoded pixels are reused as the source of the offline mip chains. Note the normal maps are packed
+    // as sRGB too. It does not matter for the timing.
+    result = BenchmarkPacking ( "TexturePacker::Pack",
+        "KTX2Parser::Parse",
+        iterations,
+        images,
+        rotating_mesh::eBlockCompression::None
+    );
+
+    if ( !result )
+        return false;
+
+    return BenchmarkPacking ( "TexturePacker::Pack (ETC2)",
+        "KTX2Parser::Parse (ETC2)",
+        iterations,
+        images,
+        rotating_mesh::eBlockCompression::ETC2
+    );
+}
+
+static bool BenchmarkLUTs ( size_t iterations )
+{
+    std::vector<android_vulkan::Half> specular ( rotating_mesh::SPECULAR_LUT_SAMPLES );
+
+    bool result = Measure ( "SpecularLUT::Generate", iterations, [ &specular ] () -> bool {
+        rotating_mesh::SpecularLUT::Generate ( specular.data () );
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<uint8_t> mandelbrotLUT ( mandelbrot::LUT_SAMPLE_COUNT * mandelbrot::LUT_SAMPLE_SIZE );
+
+    return Measure ( "MandelbrotLUT::Generate", iterations, [ &mandelbrotLUT ] () -> bool {
+        mandelbrot::MandelbrotLUT::Generate ( mandelbrotLUT.data () );
+        return true;
+    } );
+}
+
+static bool BenchmarkHalf ( size_t iterations )
+{
+    std::vector<float> source ( HALF_SAMPLES );
+
+    for ( size_t i = 0U; i < HALF_SAMPLES; ++i )
+        source[ i ] = static_cast<float> ( i ) * 1.0e-3F - 500.0F;
+
+    std::vector<android_vulkan::Half> destination ( HALF_SAMPLES );
+
+    return Measure ( "Half", iterations, [ &source, &destination ] () -> bool {
+        for ( size_t i = 0U; i < HALF_SAMPLES; ++i )
+            destination[ i ] = source[ i ];
+
+        return true;
+    } );
+}
+
+static bool BenchmarkGXMath ( size_t iterations )
+{
+    std::vector<GXMat4> matrices ( MATRIX_COUNT );
+
+    for ( size_t i = 0U; i < MATRIX_COUNT; ++i )
+    {
+        const auto angle = static_cast<float> ( i ) * 1.0e-3F;
+        matrices[ i ].RotationXYZ ( angle, angle * 0.5F, angle * 0.25F );
+    }
+
+    GXMat4 accumulator;
+    accumulator.Identity ();
+
+    bool result = Measure ( "GXMat4::Multiply", iterations, [ &matrices, &accumulator ] () -> bool {
+        GXMat4 product;
+
+        for ( const GXMat4& matrix : matrices )
+        {
+            product.Multiply ( accumulator, matrix );
+            accumulator = product;
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<GXMat4> inverses ( MATRIX_COUNT );
+
+    result = Measure ( "GXMat4::Inverse", iterations, [ &matrices, &inverses ] () -> bool {
+        for ( size_t i = 0U; i < MATRIX_COUNT; ++i )
+            inverses[ i ].Inverse ( matrices[ i ] );
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<GXVec3> points ( MATRIX_COUNT );
+
+    result = Measure ( "GXMat4::MultiplyAsPoint", iterations, [ &matrices, &points ] () -> bool {
+        const GXVec3 point ( 1.0F, 2.0F, 3.0F );
+
+        for ( size_t i = 0U; i < MATRIX_COUNT; ++i )
+            matrices[ i ].MultiplyAsPoint ( points[ i ], point );
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<GXVec4> vectors ( MATRIX_COUNT );
+
+    result = Measure ( "GXMat4::MultiplyVectorMatrix", iterations, [ &matrices, &vectors ] () -> bool {
+        const GXVec4 vector ( 1.0F, 2.0F, 3.0F, 1.0F );
+
+        for ( size_t i = 0U; i < MATRIX_COUNT; ++i )
+            matrices[ i ].MultiplyVectorMatrix ( vectors[ i ], vector );
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    std::vector<GXQuat> quaternions ( MATRIX_COUNT );
+
+    for ( size_t i = 0U; i < MATRIX_COUNT; ++i )
+        quaternions[ i ].FromAxisAngle ( 0.0F, 0.6F, 0.8F, static_cast<float> ( i ) * 1.0e-3F );
+
+    GXQuat orientation ( 1.0F, 0.0F, 0.0F, 0.0F );
+
+    result = Measure ( "GXQuat::Multiply", iterations, [ &quaternions, &orientation ] () -> bool {
+        GXQuat product;
+
+        for ( const GXQuat& quaternion : quaternions )
+        {
+            product.Multiply ( orientation, quaternion );
+            orientation = product;
+        }
+
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    return Measure ( "GXMat4::FromFast (quaternion)", iterations, [ &quaternions, &matrices ] () -> bool {
+        const GXVec3 origin ( 1.0F, 2.0F, 3.0F );
+
+        for ( size_t i = 0U; i < MATRIX_COUNT; ++i )
+            matrices[ i ].FromFast ( quaternions[ i ], origin );
+
+        return true;
+    } );
+}
+
+// Every batch function is measured against the loop over the per element methods.
+static bool BenchmarkGXMathBatch ( size_t count, size_t iterations )
+{
+    const std::string suffix = " " + std::to_string ( count );
+
+    std::vector<GXQuat> orientations ( count );
+    std::vector<GXQuat> finishes ( count );
+    std::vector<GXVec3> origins ( count );
+    std::vector<GXAABB> bounds ( count );
+    std::vector<float> factors ( count );
+
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        const auto angle = static_cast<float> ( i ) * 1.0e-3F;
+        orientations[ i ].FromAxisAngle ( 0.0F, 0.6F, 0.8F, angle );
+        finishes[ i ].FromAxisAngle ( 0.8F, 0.0F, -0.6F, 1.0F - angle );
+        origins[ i ] = GXVec3 ( angle, 1.0F, -angle );
+        bounds[ i ].AddVertex ( -1.0F, -angle, -1.0F );
+        bounds[ i ].AddVertex ( 1.0F, angle, 2.0F );
+        factors[ i ] = static_cast<float> ( i % 100U ) * 0.01F;
+    }
+
+    GXMat4 worldToClip;
+    worldToClip.Perspective ( 1.0F, 1.5F, 0.1F, 100.0F );
+
+    std::vector<GXMat4> world ( count );
+    std::vector<GXMat4> clip ( count );
+
+    bool result = Measure ( ( "GXBatchCompose" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        GXBatchCompose ( world.data (), clip.data (), orientations.data (), origins.data (), worldToClip, count );
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    result = Measure ( ( "GXMat4::FromFast+Multiply" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        for ( size_t i = 0U; i < count; ++i )
+        {
+            world[ i ].FromFast ( orientations[ i ], origins[ i ] );
+            clip[ i ].Multiply ( world[ i ], worldToClip );
+        }
+
+        return true;
+    } );
+
+    std::vector<GXVec3> points ( count );
+
+    if ( !result )
+        return false;
+
+    result = Measure ( ( "GXBatchTransformPoints" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        GXBatchTransformPoints ( points.data (), origins.data (), worldToClip, count );
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    result = Measure ( ( "GXMat4::MultiplyAsPoint" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        for ( size_t i = 0U; i < count; ++i )
+            worldToClip.MultiplyAsPoint ( points[ i ], origins[ i ] );
+
+        return true;
+    } );
+
+    std::vector<GXAABB> boxes ( count );
+
+    if ( !result )
+        return false;
+
+    result = Measure ( ( "GXBatchTransformAABBs" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        GXBatchTransformAABBs ( boxes.data (), bounds.data (), world.data (), count );
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    result = Measure ( ( "GXAABB::Transform" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        for ( size_t i = 0U; i < count; ++i )
+            bounds[ i ].Transform ( boxes[ i ], world[ i ] );
+
+        return true;
+    } );
+
+    std::vector<GXQuat> interpolated ( count );
+
+    if ( !result )
+        return false;
+
+    result = Measure ( ( "GXBatchSlerp" + suffix ).c_str (), iterations, [ & ] () -> bool {
+        GXBatchSlerp ( interpolated.data (), orientations.data (), finishes.data (), factors.data (), count );
+        return true;
+    } );
+
+    if ( !result )
+        return false;
+
+    const std::string slerpName = "GXQuat::SphericalLinearInterpolation" + suffix;
+
+    return Measure ( slerpName.c_str (), iterations, [ & ] () -> bool {
+        for ( size_t i = 0U; i < count; ++i )
+            interpolated[ i ].SphericalLinearInterpolation ( orientations[ i ], finishes[ i ], factors[ i ] );
+
+        return true;
+    } );
+}
+
+static bool BenchmarkGXMathBatch ( size_t iterations )
+{
+    for ( const size_t count : BATCH_SIZES )
+    {
+        if ( !BenchmarkGXMathBatch ( count, iterations ) )
+            return false;
+    }
+
+    return true;
+}
+
+// The boxes are scattered around the view volume. About two thirds of them are culled.
+static bool BenchmarkCulling ( size_t iterations )
+{
+    std::vector<GXAABB> bounds ( CULLING_BOXES );
+    uint32_t seed = 1U;
+
+    auto random = [ &seed ] ( float from, float to ) -> float {
+        seed = seed * 1664525U + 1013904223U;
+        return from + ( to - from ) * static_cast<float> ( seed >> 8U ) * ( 1.0F / 16777216.0F );
+    };
+
+    for ( GXAABB& box : bounds )
+    {
+        const GXVec3 center ( random ( -60.0F, 60.0F ), random ( -30.0F, 30.0F ), random ( -40.0F, 80.0F ) );
+        const float size = random ( 0.1F, 2.0F );
+        box.AddVertex ( center._data[ 0U ] - size, center._data[ 1U ] - size, center._data[ 2U ] - size );
+        box.AddVertex ( center._data[ 0U ] + size, center._data[ 1U ] + size, center._data[ 2U ] + size );
+    }
+
+    GXMat4 worldToClip;
+    worldToClip.Perspective ( 1.0F, 1.5F, 0.1F, 100.0F );
+    const GXProjectionClipPlanes clipPlanes ( worldToClip );
+
+    auto visibility = std::make_unique<GXBool[]> ( CULLING_BOXES );
+    size_t visible = 0U;
+    double batchTime = 0.0;
+
+    const std::string suffix = " " + std::to_string ( CULLING_BOXES );
+
+    auto batch = [ & ] () -> bool {
+        visible = GXBatchCullAABBs ( visibility.get (), bounds.data (), clipPlanes, CULLING_BOXES );
+        return true;
+    };
+
+    if ( !Measure ( ( "GXBatchCullAABBs" + suffix ).c_str (), iterations, batch, &batchTime ) )
+        return false;
+
+    size_t expectedVisible = 0U;
+    double loopTime = 0.0;
+
+    auto loop = [ & ] () -> bool {
+        expectedVisible = 0U;
+
+        for ( size_t i = 0U; i < CULLING_BOXES; ++i )
+        {
+            visibility[ i ] = clipPlanes.IsVisible ( bounds[ i ] );
+            expectedVisible += visibility[ i ] ? 1U : 0U;
+        }
+
+        return true;
+    };
+
+    if ( !Measure ( ( "GXProjectionClipPlanes::IsVisible" + suffix ).c_str (), iterations, loop, &loopTime ) )
+        return false;
+
+    if ( visible != expectedVisible )
+    {
+        android_vulkan::LogError ( "BenchmarkCulling - Visible box count mismatch: %zu, expected %zu.",
+            visible,
+            expectedVisible
+        );
+
+        return false;
+    }
+
+    constexpr const double toNanosecondsPerBox = 1.0e+6 / static_cast<double> ( CULLING_BOXES );
+
+    std::printf ( "# Culling: %zu of %zu boxes culled, %.3f ns per box (batch), %.3f ns per box (IsVisible)\n",
+        CULLING_BOXES - visible,
+        CULLING_BOXES,
+        batchTime * toNanosecondsPerBox,
+        loopTime * toNanosecondsPerBox
+    );
+
+    return true;
+}
+
+// Same work split into the same chunks. The difference is the cost of the thread spawn and join against the task
+// hand off to the already running workers.
+static bool BenchmarkJobSystem ( size_t iterations )
+{
+    const size_t threads = android_vulkan::g_JobSystem->GetWorkerCount () + 1U;
+    std::vector<float> values ( JOB_ITEMS[ std::size ( JOB_ITEMS ) - 1U ] );
+    float* data = values.data ();
+
+    auto work = [ data ] ( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+            data[ i ] = std::sqrt ( static_cast<float> ( i ) ) * 0.5F + 1.0F;
+    };
+
+    for ( const size_t count : JOB_ITEMS )
+    {
+        const size_t grain = ( count + threads - 1U ) / threads;
+        const std::string suffix = " " + std::to_string ( count );
+        double parallelForTime = 0.0;
+
+        bool result = Measure ( ( "JobSystem::ParallelFor" + suffix ).c_str (), iterations,
+            [ count, grain, &work ] () -> bool {
+                android_vulkan::g_JobSystem->ParallelFor ( count, grain, work );
+                return true;
+            },
+
+            &parallelForTime
+        );
+
+        if ( !result )
+            return false;
+
+        double spawnTime = 0.0;
+
+        result = Measure ( ( "std::thread spawn/join" + suffix ).c_str (), iterations,
+            [ count, grain, &work ] () -> bool {
+                std::vector<std::thread> workers;
+
+                for ( size_t begin = 0U; begin < count; begin += grain )
+                    workers.emplace_back ( work, begin, std::min ( begin + grain, count ) );
+
+                for ( auto &worker : workers )
+                    worker.join ();
+
+                return true;
+            },
+
+            &spawnTime
+        );
+
+        if ( !result )
+            return false;
+
+        std::printf ( "# JobSystem: %zu items in %zu chunk(s), ParallelFor %.4f ms, std::thread %.4f ms\n",
+            count,
+            ( count + grain - 1U ) / grain,
+            parallelForTime,
+            spawnTime
+        );
+    }
+
+    return true;
+}
+
+// Per frame cost of the instrumentation is the measured time divided by FRAME_TIMING_FRAMES.
+static bool BenchmarkFrameTiming ( size_t iterations )
+{
+    using android_vulkan::eFrameTimingStage;
+    using android_vulkan::FrameTimingScope;
+
+    auto timing = std::make_unique<android_vulkan::FrameTiming> ();
+    android_vulkan::g_FrameTiming = timing.get ();
+
+    const bool result = Measure ( "FrameTiming", iterations, [ &timing ] () -> bool {
+        for ( size_t i = 0U; i < FRAME_TIMING_FRAMES; ++i )
+        {
+            timing->BeginFrame ();
+            timing->Record ( eFrameTimingStage::Interval, 16.6F );
+
+            {
+                const FrameTimingScope acquire ( eFrameTimingStage::Acquire );
+            }
+
+            {
+                const FrameTimingScope fenceWait ( eFrameTimingStage::FenceWait );
+            }
+
+            {
+                const FrameTimingScope present ( eFrameTimingStage::Present );
+            }
+
+            timing->EndFrame ();
+        }
+
+        return true;
+    } );
+
+    android_vulkan::g_FrameTiming = nullptr;
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Usage: android-vulkan-host-benchmark <asset directory> [iterations]
+int main ( int argc, char** argv )
+{
+    if ( argc < 2 )
+    {
+        android_vulkan::LogError ( "Usage: %s <asset directory> [iterations]", argv[ 0U ] );
+        return 1;
+    }
+
+    android_vulkan::File::SetAssetDirectory ( argv[ 1U ] );
+
+    const size_t iterations = argc > 2 ?
+        static_cast<size_t> ( std::strtoul ( argv[ 2U ], nullptr, 10 ) ) :
+        DEFAULT_ITERATIONS;
+
+    android_vulkan::JobSystem jobSystem;
+    jobSystem.Init ();
+    android_vulkan::g_JobSystem = &jobSystem;
+
+    std::printf ( "# %zu worker(s)\n# GXMath: %s\n# name\titerations\tmedian ms\tmin ms\tmax ms\n",
+        jobSystem.GetWorkerCount (),
+        GX_SIMD_NAME
+    );
+
+    const bool result = BenchmarkFiles ( iterations ) &&
+        BenchmarkMeshes ( iterations ) &&
+        BenchmarkTextures ( iterations ) &&
+        BenchmarkLUTs ( iterations ) &&
+        BenchmarkHalf ( iterations ) &&
+        BenchmarkGXMath ( iterations ) &&
+        BenchmarkGXMathBatch ( iterations ) &&
+        BenchmarkCulling ( iterations ) &&
+        BenchmarkJobSystem ( iterations ) &&
+        BenchmarkFrameTiming ( iterations );
+
+    android_vulkan::g_JobSystem = nullptr;
+    jobSystem.Destroy ();
+
+    return result ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include <file.h>
+#include <job_system.h>
+#include <logger.h>
+#include <rotating_mesh/mesh_cooker.h>
+#include <rotating_mesh/mesh_parser.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+constexpr static const char* PACKED_OPTION = "--packed";
+constexpr static const char* MERGE_TANGENTS_OPTION = "--merge-tangents";
+
+static bool Cook ( const char* input,
+    const char* output,
+    rotating_mesh::eVertexFormat format,
+    rotating_mesh::eTangentMerge tangentMerge
+)
+{
+    android_vulkan::File file ( input );
+
+    if ( !file.LoadContent () )
+        return false;
+
+    const rotating_mesh::VertexInfo* vertices = nullptr;
+    uint32_t vertexCount = 0U;
+
+    if ( !rotating_mesh::MeshParser::Parse ( vertices, vertexCount, file.GetData (), file.GetSize () ) )
+    {
+        android_vulkan::LogError ( "Cook - File %s is not the version 1.2 mesh.", input );
+        return false;
+    }
+
+    std::vector<uint8_t> content;
+    rotating_mesh::MeshCookerStats stats {};
+
+    rotating_mesh::MeshCooker::Cook ( content,
+        vertices,
+        static_cast<size_t> ( vertexCount ),
+        format,
+        tangentMerge,
+        &stats
+    );
+
+    FILE* stream = std::fopen ( output, "wb" );
+
+    if ( !stream )
+    {
+        android_vulkan::LogError ( "Cook - Can't open %s for writing.", output );
+        return false;
+    }
+
+    const size_t written = std::fwrite ( content.data (), 1U, content.size (), stream );
+
+    if ( std::fclose ( stream ) != 0 || written != content.size () )
+    {
+        android_vulkan::LogError ( "Cook - Can't write %s.", output );
+        return false;
+    }
+
+    std::printf ( "%s: vertices %zu -> %zu, ACMR %.3f -> %.3f, %zu meshlet(s), %zu -> %zu bytes\n",
+        output,
+        stats._sourceVertices,
+        stats._uniqueVertices,
+        static_cast<double> ( stats._originalACMR ),
+        static_cast<double> ( stats._optimizedACMR ),
+        stats._meshlets,
+        file.GetSize (),
+        content.size ()
+    );
+
+    if ( tangentMerge == rotating_mesh::eTangentMerge::Average )
+    {
+        const rotating_mesh::TangentMergeError& mergeError = stats._tangentMergeError;
+
+        std::printf ( "%s: tangent merge max error tangent %.3f, bitangent %.3f deg\n",
+            output,
+            static_cast<double> ( mergeError._tangent ),
+            static_cast<double> ( mergeError._bitangent )
+        );
+    }
+
+    if ( format != rotating_mesh::eVertexFormat::Packed )
+        return true;
+
+    const rotating_mesh::VertexPackingError& error = stats._packingError;
+
+    std::printf ( "%s: max error UV %.6f, normal %.3f, tangent %.3f, bitangent %.3f deg, average skew %.3f deg\n",
+        output,
+        static_cast<double> ( error._uv ),
+        static_cast<double> ( error._normal ),
+        static_cast<double> ( error._tangent ),
+        static_cast<double> ( error._bitangent ),
+        static_cast<double> ( error._averageSkew )
+    );
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Usage: android-vulkan-mesh-cooker [--packed] [--merge-tangents] <version 1.2 mesh> <version 2.0 mesh>
+int main ( int argc, char** argv )
+{
+    bool isPacked = false;
+    bool isMergingTangents = false;
+    int first = 1;
+
+    for ( ; first < argc; ++first )
+    {
+        if ( std::strcmp ( argv[ first ], PACKED_OPTION ) == 0 )
+        {
+            isPacked = true;
+            continue;
+        }
+
+        if ( std::strcmp ( argv[ first ], MERGE_TANGENTS_OPTION ) != 0 )
+            break;
+
+        isMergingTangents = true;
+    }
+
+    if ( argc - first != 2 )
+    {
+        android_vulkan::LogError ( "Usage: %s [%s] [%s] <input.mesh> <output.mesh2>",
+            argv[ 0U ],
+            PACKED_OPTION,
+            MERGE_TANGENTS_OPTION
+        );
+
+        return 1;
+    }
+
+    android_vulkan::JobSystem jobSystem;
+    jobSystem.Init ();
+    android_vulkan::g_JobSystem = &jobSystem;
+
+    const bool result = Cook ( argv[ first ],
+        argv[ first + 1 ],
+        isPacked ? rotating_mesh::eVertexFormat::Packed : rotating_mesh::eVertexFormat::Full,
+        isMergingTangents ? rotating_mesh::eTangentMerge::Average : rotating_mesh::eTangentMerge::None
+    );
+
+    android_vulkan::g_JobSystem = nullptr;
+    jobSystem.Destroy ();
+
+    return result ? 0 : 1;
+}
@@ -0,0 +1,1816 @@
+#include <asset_loader.h>
+#include <file.h>
+#include <frame_timing.h>
+#include <half.h>
+#include <job_system.h>
+#include <logger.h>
+#include <memory_chunk.h>
+#include <pipeline_cache_file.h>
+#include <upload_batch_ring.h>
+#include <GXCommon/GXMath.h>
+#include <GXCommon/GXMathBatch.h>
+#include <GXCommon/GXNativeMesh.h>
+#include <GXCommon/GXSIMD.h>
+#include <mandelbrot/mandelbrot_lut.h>
+#include <rotating_mesh/block_compressor.h>
+#include <rotating_mesh/ktx2_parser.h>
+#include <rotating_mesh/mesh_cooker.h>
+#include <rotating_mesh/mesh_optimizer.h>
+#include <rotating_mesh/mesh_parser.h>
+#include <rotating_mesh/specular_lut.h>
+#include <rotating_mesh/texture_decoder.h>
+#include <rotating_mesh/texture_packer.h>
+#include <rotating_mesh/vertex_packer.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+#define AV_TEST_CHECK(x)                                                                                            \
+    if ( !( x ) )                                                                                                   \
+    {                                                                                                               \
+        android_vulkan::LogError ( "%s:%d - Check failed: %s", __FILE__, __LINE__, #x );                           \
+        return false;                                                                                               \
+    }
+
+constexpr static const char* MESH_FILE = "meshes/rotating_mesh/sonic-material-2.mesh";
+constexpr static const char* TEXTURE_FILE = "textures/rotating_mesh/sonic-material-3-normal.png";
+constexpr static const int TEXTURE_SIZE = 256;
+constexpr static const char* DIFFUSE_FILE = "textures/rotating_mesh/sonic-material-3-diffuse.png";
+
+constexpr static const char* ASSET_LOADER_FILES[] =
+{
+    "textures/rotating_mesh/sonic-material-1-diffuse.png",
+    "textures/rotating_mesh/sonic-material-2-diffuse.png",
+    "textures/rotating_mesh/sonic-material-2-normal.png",
+    "textures/rotating_mesh/sonic-material-3-diffuse.png",
+    "textures/rotating_mesh/missing.png"
+};
+constexpr static const double BC_MIN_PSNR = 32.0;
+constexpr static const double ETC2_MIN_PSNR = 35.0;
+
+constexpr static const float EPSILON = 1.0e-5F;
+constexpr static const float KERNEL_TOLERANCE = 1.0e-6F;
+constexpr static const float INVERSE_TOLERANCE = 1.0e-4F;
+constexpr static const size_t KERNEL_CASES = 64U;
+constexpr static const size_t BATCH_COUNT = 13U;
+constexpr static const float BATCH_TOLERANCE = 1.0e-5F;
+constexpr static const size_t CULLING_SIDE = 21U;
+
+constexpr static const size_t JOB_STRESS_PASSES = 200U;
+constexpr static const size_t JOB_STRESS_OUTER = 32U;
+constexpr static const size_t JOB_STRESS_INNER = 256U;
+constexpr static const size_t JOB_STRESS_CHAIN = 64U;
+constexpr static const size_t JOB_STRESS_FAN_OUT = 64U;
+
+using TestFunction = bool ( * ) ();
+
+struct Test final
+{
+    const char*     _name;
+    TestFunction    _function;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static uint16_t ToBits ( android_vulkan::Half value )
+{
+    return value.GetData ();
+}
+
+static bool IsEqual ( float a, float b )
+{
+    return std::fabs ( a - b ) < EPSILON;
+}
+
+// The tolerance is relative for the values greater than one.
+static bool IsClose ( float a, float b, float tolerance )
+{
+    return std::fabs ( a - b ) <= tolerance * std::max ( 1.0F, std::fabs ( b ) );
+}
+
+// Well conditioned matrix with the dominant diagonal.
+static GXMat4 MakeKernelMatrix ( float seed )
+{
+    GXMat4 matrix;
+
+    for ( size_t i = 0U; i < 16U; ++i )
+        matrix._data[ i ] = std::sin ( seed * static_cast<float> ( i + 1U ) ) + ( i % 5U == 0U ? 3.0F : 0.0F );
+
+    return matrix;
+}
+
+// Scalar references of the GXMath kernels. The summation order is the same as in the SIMD kernels. So the difference
+// is expected only if the compiler contracts the scalar code to the fused multiply-add.
+static void ReferenceMultiply ( GXMat4 &out, const GXMat4 &a, const GXMat4 &b )
+{
+    for ( size_t row = 0U; row < 4U; ++row )
+    {
+        for ( size_t column = 0U; column < 4U; ++column )
+        {
+            out._m[ row ][ column ] = a._m[ row ][ 0U ] * b._m[ 0U ][ column ] +
+                a._m[ row ][ 1U ] * b._m[ 1U ][ column ] +
+                a._m[ row ][ 2U ] * b._m[ 2U ][ column ] +
+                a._m[ row ][ 3U ] * b._m[ 3U ][ column ];
+        }
+    }
+}
+
+static void ReferenceVectorMatrix ( float* out, const float* v, const GXMat4 &m )
+{
+    for ( size_t column = 0U; column < 4U; ++column )
+    {
+        out[ column ] = v[ 0U ] * m._m[ 0U ][ column ] +
+            v[ 1U ] * m._m[ 1U ][ column ] +
+            v[ 2U ] * m._m[ 2U ][ column ] +
+            v[ 3U ] * m._m[ 3U ][ column ];
+    }
+}
+
+static void ReferenceQuatMultiply ( GXQuat &out, const GXQuat &a, const GXQuat &b )
+{
+    const float* p = a._data;
+    const float* q = b._data;
+
+    out._data[ 0U ] = p[ 0U ] * q[ 0U ] - p[ 1U ] * q[ 1U ] - p[ 2U ] * q[ 2U ] - p[ 3U ] * q[ 3U ];
+    out._data[ 1U ] = p[ 0U ] * q[ 1U ] + p[ 1U ] * q[ 0U ] + p[ 2U ] * q[ 3U ] - p[ 3U ] * q[ 2U ];
+    out._data[ 2U ] = p[ 0U ] * q[ 2U ] - p[ 1U ] * q[ 3U ] + p[ 2U ] * q[ 0U ] + p[ 3U ] * q[ 1U ];
+    out._data[ 3U ] = p[ 0U ] * q[ 3U ] + p[ 1U ] * q[ 2U ] - p[ 2U ] * q[ 1U ] + p[ 3U ] * q[ 0U ];
+}
+
+static bool IsClose ( const float* a, const float* b, size_t count, float tolerance )
+{
+    for ( size_t i = 0U; i < count; ++i )
+    {
+        if ( !IsClose ( a[ i ], b[ i ], tolerance ) )
+            return false;
+    }
+
+    return true;
+}
+
+static bool TestHalf ()
+{
+    AV_TEST_CHECK ( ToBits ( 0.0F ) == 0x0000U )
+    AV_TEST_CHECK ( ToBits ( -0.0F ) == 0x8000U )
+    AV_TEST_CHECK ( ToBits ( 1.0F ) == 0x3C00U )
+    AV_TEST_CHECK ( ToBits ( -2.0F ) == 0xC000U )
+    AV_TEST_CHECK ( ToBits ( 0.5F ) == 0x3800U )
+    AV_TEST_CHECK ( ToBits ( 65504.0F ) == 0x7BFFU )
+    AV_TEST_CHECK ( ToBits ( 1.0e+10F ) == 0x7C00U )
+    AV_TEST_CHECK ( ToBits ( -1.0e+10F ) == 0xFC00U )
+    AV_TEST_CHECK ( ToBits ( INFINITY ) == 0x7C00U )
+    AV_TEST_CHECK ( ToBits ( -INFINITY ) == 0xFC00U )
+    AV_TEST_CHECK ( ToBits ( 1.0e-10F ) == 0x0000U )
+
+    const uint16_t nan = ToBits ( NAN );
+    AV_TEST_CHECK ( ( nan & 0x7C00U ) == 0x7C00U && ( nan & 0x03FFU ) != 0U )
+
+    return true;
+}
+
+static bool TestGXMath ()
+{
+    GXVec3 cross;
+    cross.CrossProduct ( GXVec3 ( 1.0F, 0.0F, 0.0F ), GXVec3 ( 0.0F, 1.0F, 0.0F ) );
+    AV_TEST_CHECK ( IsEqual ( cross._data[ 0U ], 0.0F ) )
+    AV_TEST_CHECK ( IsEqual ( cross._data[ 1U ], 0.0F ) )
+    AV_TEST_CHECK ( IsEqual ( cross._data[ 2U ], 1.0F ) )
+
+    GXMat4 rotation;
+    rotation.RotationXYZ ( 0.3F, 1.1F, -0.7F );
+
+    GXMat4 inverse;
+    inverse.Inverse ( rotation );
+
+    GXMat4 product;
+    product.Multiply ( rotation, inverse );
+
+    for ( size_t row = 0U; row < 4U; ++row )
+    {
+        for ( size_t column = 0U; column < 4U; ++column )
+        {
+            AV_TEST_CHECK ( IsEqual ( product._m[ row ][ column ], row == column ? 1.0F : 0.0F ) )
+        }
+    }
+
+    return true;
+}
+
+// GXMath uses NEON or SSE2 kernels when they are available. The results are compared with the scalar references.
+static bool TestGXMathKernels ()
+{
+    android_vulkan::LogInfo ( "TestGXMathKernels - Instruction set: %s.", GX_SIMD_NAME );
+
+    for ( size_t i = 0U; i < KERNEL_CASES; ++i )
+    {
+        const float seed = 0.37F + static_cast<float> ( i ) * 0.91F;
+        const GXMat4 a = MakeKernelMatrix ( seed );
+        const GXMat4 b = MakeKernelMatrix ( seed * 1.7F + 0.5F );
+
+        GXMat4 expected;
+        ReferenceMultiply ( expected, a, b );
+
+        GXMat4 actual;
+        actual.Multiply ( a, b );
+        AV_TEST_CHECK ( IsClose ( actual._data, expected._data, 16U, KERNEL_TOLERANCE ) )
+
+        GXMat4 inverse;
+        inverse.Inverse ( a );
+
+        GXMat4 product;
+        ReferenceMultiply ( product, a, inverse );
+
+        for ( size_t row = 0U; row < 4U; ++row )
+        {
+            for ( size_t column = 0U; column < 4U; ++column )
+            {
+                const float identity = row == column ? 1.0F : 0.0F;
+                AV_TEST_CHECK ( IsClose ( product._m[ row ][ column ], identity, INVERSE_TOLERANCE ) )
+            }
+        }
+
+        const GXVec4 v ( seed, -2.0F * seed, 0.5F, 1.0F - seed );
+        float reference[ 4U ];
+        ReferenceVectorMatrix ( reference, v._data, a );
+
+        GXVec4 result;
+        a.MultiplyVectorMatrix ( result, v );
+        AV_TEST_CHECK ( IsClose ( result._data, reference, 4U, KERNEL_TOLERANCE ) )
+
+        // Matrix-vector product is the vector-matrix product with the transposed matrix.
+        GXMat4 transposed;
+
+        for ( size_t row = 0U; row < 4U; ++row )
+        {
+            for ( size_t column = 0U; column < 4U; ++column )
+                transposed._m[ row ][ column ] = a._m[ column ][ row ];
+        }
+
+        transposed.MultiplyMatrixVector ( result, v );
+        AV_TEST_CHECK ( IsClose ( result._data, reference, 4U, KERNEL_TOLERANCE ) )
+
+        const float point[ 4U ] = { v._data[ 0U ], v._data[ 1U ], v._data[ 2U ], 1.0F };
+        ReferenceVectorMatrix ( reference, point, a );
+
+        GXVec3 transformed;
+        a.MultiplyAsPoint ( transformed, GXVec3 ( point[ 0U ], point[ 1U ], point[ 2U ] ) );
+        AV_TEST_CHECK ( IsClose ( transformed._data, reference, 3U, KERNEL_TOLERANCE ) )
+
+        const float normal[ 4U ] = { point[ 0U ], point[ 1U ], point[ 2U ], 0.0F };
+        ReferenceVectorMatrix ( reference, normal, a );
+
+        a.MultiplyAsNormal ( transformed, GXVec3 ( normal[ 0U ], normal[ 1U ], normal[ 2U ] ) );
+        AV_TEST_CHECK ( IsClose ( transformed._data, reference, 3U, KERNEL_TOLERANCE ) )
+
+        GXQuat p;
+        p.FromAxisAngle ( GXVec3 ( 0.0F, 0.6F, 0.8F ), seed );
+
+        GXQuat q;
+        q.FromAxisAngle ( GXVec3 ( 0.8F, 0.0F, -0.6F ), 2.0F * seed );
+
+        GXQuat expectedQuat;
+        ReferenceQuatMultiply ( expectedQuat, p, q );
+
+        GXQuat actualQuat;
+        actualQuat.Multiply ( p, q );
+        AV_TEST_CHECK ( IsClose ( actualQuat._data, expectedQuat._data, 4U, KERNEL_TOLERANCE ) )
+
+        const GXVec4 w ( 1.0F, seed, -seed, 3.0F );
+        GXVec4 sum;
+        sum.Sum ( v, 0.25F, w );
+
+        for ( size_t j = 0U; j < 4U; ++j )
+            AV_TEST_CHECK ( IsClose ( sum._data[ j ], v._data[ j ] + 0.25F * w._data[ j ], KERNEL_TOLERANCE ) )
+
+        sum.Substract ( v, w );
+
+        for ( size_t j = 0U; j < 4U; ++j )
+            AV_TEST_CHECK ( IsClose ( sum._data[ j ], v._data[ j ] - w._data[ j ], KERNEL_TOLERANCE ) )
+    }
+
+    return true;
+}
+
+// The batch results are compared with the per element methods. The count is not multiple of four. So the padded
+// group is tested too.
+static bool TestGXMathBatch ()
+{
+    const GXMat4 worldToClip = MakeKernelMatrix ( 0.77F );
+
+    std::vector<GXQuat> orientations ( BATCH_COUNT );
+    std::vector<GXQuat> finishes ( BATCH_COUNT );
+    std::vector<GXVec3> origins ( BATCH_COUNT );
+    std::vector<GXAABB> bounds ( BATCH_COUNT );
+    std::vector<float> factors ( BATCH_COUNT );
+
+    for ( size_t i = 0U; i < BATCH_COUNT; ++i )
+    {
+        const auto angle = static_cast<float> ( i ) * 0.45F;
+        orientations[ i ].FromAxisAngle ( 0.0F, 0.6F, 0.8F, angle );
+        finishes[ i ].FromAxisAngle ( 0.8F, 0.0F, -0.6F, 3.0F - angle );
+        origins[ i ] = GXVec3 ( angle, -angle, 2.0F * angle );
+        bounds[ i ].AddVertex ( -angle, 1.0F, 0.5F );
+        bounds[ i ].AddVertex ( 1.0F, 2.0F + angle, 3.0F );
+        factors[ i ] = static_cast<float> ( i ) / static_cast<float> ( BATCH_COUNT - 1U );
+    }
+
+    std::vector<GXMat4> world ( BATCH_COUNT );
+    std::vector<GXMat4> clip ( BATCH_COUNT );
+    GXBatchCompose ( world.data (), clip.data (), orientations.data (), origins.data (), worldToClip, BATCH_COUNT );
+
+    std::vector<GXMat4> composed ( BATCH_COUNT );
+    GXBatchCompose ( composed.data (), world.data (), worldToClip, BATCH_COUNT );
+
+    std::vector<GXVec3> points ( BATCH_COUNT );
+    GXBatchTransformPoints ( points.data (), origins.data (), worldToClip, BATCH_COUNT );
+
+    std::vector<GXAABB> boxes ( BATCH_COUNT );
+    GXBatchTransformAABBs ( boxes.data (), bounds.data (), world.data (), BATCH_COUNT );
+
+    std::vector<GXAABB> sharedBoxes ( BATCH_COUNT );
+    GXBatchTransformAABBs ( sharedBoxes.data (), bounds.data (), world[ 3U ], BATCH_COUNT );
+
+    std::vector<GXQuat> interpolated ( BATCH_COUNT );
+    GXBatchSlerp ( interpolated.data (), orientations.data (), finishes.data (), factors.data (), BATCH_COUNT );
+
+    for ( size_t i = 0U; i < BATCH_COUNT; ++i )
+    {
+        GXMat4 expected;
+        expected.FromFast ( orientations[ i ], origins[ i ] );
+        AV_TEST_CHECK ( IsClose ( world[ i ]._data, expected._data, 16U, KERNEL_TOLERANCE ) )
+
+        GXMat4 expectedClip;
+        expectedClip.Multiply ( expected, worldToClip );
+        AV_TEST_CHECK ( IsClose ( clip[ i ]._data, expectedClip._data, 16U, KERNEL_TOLERANCE ) )
+        AV_TEST_CHECK ( IsClose ( composed[ i ]._data, expectedClip._data, 16U, KERNEL_TOLERANCE ) )
+
+        GXVec3 point;
+        worldToClip.MultiplyAsPoint ( point, origins[ i ] );
+        AV_TEST_CHECK ( IsClose ( points[ i ]._data, point._data, 3U, KERNEL_TOLERANCE ) )
+
+        GXAABB box;
+        bounds[ i ].Transform ( box, world[ i ] );
+        AV_TEST_CHECK ( IsClose ( boxes[ i ]._min._data, box._min._data, 3U, BATCH_TOLERANCE ) )
+        AV_TEST_CHECK ( IsClose ( boxes[ i ]._max._data, box._max._data, 3U, BATCH_TOLERANCE ) )
+
+        bounds[ i ].Transform ( box, world[ 3U ] );
+        AV_TEST_CHECK ( IsClose ( sharedBoxes[ i ]._min._data, box._min._data, 3U, BATCH_TOLERANCE ) )
+        AV_TEST_CHECK ( IsClose ( sharedBoxes[ i ]._max._data, box._max._data, 3U, BATCH_TOLERANCE ) )
+
+        GXQuat quaternion;
+        quaternion.SphericalLinearInterpolation ( orientations[ i ], finishes[ i ], factors[ i ] );
+
+        // q and -q are the same orientation.
+        GXQuat& actual = interpolated[ i ];
+        float dot = 0.0F;
+
+        for ( size_t j = 0U; j < 4U; ++j )
+            dot += actual._data[ j ] * quaternion._data[ j ];
+
+        if ( dot < 0.0F )
+            actual.Multiply ( actual, -1.0F );
+
+        AV_TEST_CHECK ( IsClose ( actual._data, quaternion._data, 4U, BATCH_TOLERANCE ) )
+    }
+
+    return true;
+}
+
+// The grid of boxes covers the view volume and the space around it. So there are visible, culled and intersecting
+// boxes. The count is not multiple of four.
+static void MakeCullingScene ( GXMat4 &localToClip, std::vector<GXAABB> &bounds )
+{
+    GXMat4 localToView;
+    localToView.RotationY ( 0.6F );
+    localToView.SetOrigin ( GXVec3 ( 0.0F, -1.0F, 3.0F ) );
+
+    GXMat4 projection;
+    projection.Perspective ( 1.0F, 1.5F, 0.1F, 30.0F );
+
+    localToClip.Multiply ( localToView, projection );
+    bounds.reserve ( CULLING_SIDE * CULLING_SIDE * CULLING_SIDE );
+
+    for ( size_t i = 0U; i < CULLING_SIDE * CULLING_SIDE * CULLING_SIDE; ++i )
+    {
+        const auto x = static_cast<float> ( i % CULLING_SIDE ) * 4.0F - 40.0F;
+        const auto y = static_cast<float> ( ( i / CULLING_SIDE ) % CULLING_SIDE ) * 2.0F - 20.0F;
+        const auto z = static_cast<float> ( i / ( CULLING_SIDE * CULLING_SIDE ) ) * 2.5F - 15.0F;
+        const auto size = 0.25F + static_cast<float> ( i % 7U ) * 0.5F;
+
+        GXAABB& box = bounds.emplace_back ();
+        box.AddVertex ( x - size, y - size, z - size );
+        box.AddVertex ( x + size, y + 0.5F * size, z + 2.0F * size );
+    }
+}
+
+static bool TestGXMathCulling ()
+{
+    GXMat4 localToClip;
+    std::vector<GXAABB> bounds;
+    MakeCullingScene ( localToClip, bounds );
+    const GXProjectionClipPlanes clipPlanes ( localToClip );
+
+    auto visibility = std::make_unique<GXBool[]> ( bounds.size () );
+    const size_t visible = GXBatchCullAABBs ( visibility.get (), bounds.data (), clipPlanes, bounds.size () );
+
+    AV_TEST_CHECK ( visible > 0U )
+    AV_TEST_CHECK ( visible < bounds.size () )
+
+    size_t expectedVisible = 0U;
+
+    for ( size_t i = 0U; i < bounds.size (); ++i )
+    {
+        const bool isVisible = clipPlanes.IsVisible ( bounds[ i ] );
+        AV_TEST_CHECK ( visibility[ i ] == isVisible )
+        expectedVisible += isVisible ? 1U : 0U;
+    }
+
+    AV_TEST_CHECK ( visible == expectedVisible )
+    return true;
+}
+
+// The copy of IsVisible from gpu-culling.cs. The planes and the boxes are packed as GPUCulling::Cull and
+// GPUCulling::CreateScene do. The float operations are done in the same order as the shader does.
+static bool IsVisibleGPUCulling ( const GXVec4* planes, const float* boundsMin, const float* boundsMax )
+{
+    for ( size_t i = 0U; i < 6U; ++i )
+    {
+        const float* plane = planes[ i ]._data;
+        float farthest[ 3U ];
+
+        for ( size_t j = 0U; j < 3U; ++j )
+            farthest[ j ] = std::max ( plane[ j ] * boundsMin[ j ], plane[ j ] * boundsMax[ j ] );
+
+        if ( farthest[ 0U ] + farthest[ 1U ] + farthest[ 2U ] + plane[ 3U ] < 0.0F )
+            return false;
+    }
+
+    return true;
+}
+
+// The debug build of the demo compares GPU culling against GXBatchCullAABBs on the device only. The test checks
+// the same plane and box math on the host. So any difference of the formulas is found without GPU.
+static bool TestGPUCullingMath ()
+{
+    GXMat4 localToClip;
+    std::vector<GXAABB> bounds;
+    MakeCullingScene ( localToClip, bounds );
+    const GXProjectionClipPlanes clipPlanes ( localToClip );
+
+    GXVec4 planes[ 6U ];
+
+    for ( GXUByte i = 0U; i < 6U; ++i )
+    {
+        const GXPlane& plane = clipPlanes.GetPlane ( i );
+        planes[ i ].Init ( plane._a, plane._b, plane._c, plane._d );
+    }
+
+    auto visibility = std::make_unique<GXBool[]> ( bounds.size () );
+    const size_t visible = GXBatchCullAABBs ( visibility.get (), bounds.data (), clipPlanes, bounds.size () );
+    size_t shaderVisible = 0U;
+
+    for ( size_t i = 0U; i < bounds.size (); ++i )
+    {
+        const GXAABB& box = bounds[ i ];
+        const bool isVisible = IsVisibleGPUCulling ( planes, box._min._data, box._max._data );
+        AV_TEST_CHECK ( visibility[ i ] == isVisible )
+        shaderVisible += isVisible ? 1U : 0U;
+    }
+
+    AV_TEST_CHECK ( visible == shaderVisible )
+    return true;
+}
+
+static bool TestJobSystem ()
+{
+    constexpr const size_t count = 100000U;
+    std::vector<uint32_t> values ( count, 0U );
+    uint32_t* data = values.data ();
+
+    android_vulkan::g_JobSystem->ParallelFor ( count, 0U, [ data ] ( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+            ++data[ i ];
+    } );
+
+    for ( const uint32_t value : values )
+        AV_TEST_CHECK ( value == 1U )
+
+    android_vulkan::JobCounter first;
+    android_vulkan::JobCounter second;
+    std::atomic<uint32_t> stage ( 0U );
+    bool isOrdered = false;
+
+    android_vulkan::g_JobSystem->Run ( [ &stage ] () {
+            stage.fetch_add ( 1U );
+        },
+
+        &first
+    );
+
+    android_vulkan::g_JobSystem->Run ( [ &stage, &isOrdered ] () {
+            isOrdered = stage.load () == 1U;
+        },
+
+        &second,
+        &first
+    );
+
+    android_vulkan::g_JobSystem->Wait ( second );
+    android_vulkan::g_JobSystem->Wait ( first );
+    AV_TEST_CHECK ( isOrdered )
+
+    return true;
+}
+
+// Repeated passes catch the lost wake up and the counter races which single pass misses.
+static bool TestJobSystemStress ()
+{
+    android_vulkan::JobSystem &jobSystem = *android_vulkan::g_JobSystem;
+
+    for ( size_t pass = 0U; pass < JOB_STRESS_PASSES; ++pass )
+    {
+        // Nested: every outer chunk waits for the inner ParallelFor from the worker thread.
+        std::vector<uint32_t> values ( JOB_STRESS_OUTER * JOB_STRESS_INNER, 0U );
+        uint32_t* data = values.data ();
+
+        jobSystem.ParallelFor ( JOB_STRESS_OUTER, 1U, [ &jobSystem, data ] ( size_t begin, size_t end ) {
+            for ( size_t outer = begin; outer < end; ++outer )
+            {
+                uint32_t* row = data + outer * JOB_STRESS_INNER;
+
+                jobSystem.ParallelFor ( JOB_STRESS_INNER, 16U, [ row ] ( size_t innerBegin, size_t innerEnd ) {
+                    for ( size_t i = innerBegin; i < innerEnd; ++i )
+                        ++row[ i ];
+                } );
+            }
+        } );
+
+        for ( const uint32_t value : values )
+            AV_TEST_CHECK ( value == 1U )
+
+        // Dependency chain: every job sees the stage of its predecessor.
+        std::vector<android_vulkan::JobCounter> chain ( JOB_STRESS_CHAIN );
+        std::atomic<uint32_t> stage ( 0U );
+        std::atomic<uint32_t> misordered ( 0U );
+
+        for ( size_t i = 0U; i < JOB_STRESS_CHAIN; ++i )
+        {
+            jobSystem.Run ( [ &stage, &misordered, i ] () {
+                    if ( stage.fetch_add ( 1U ) != static_cast<uint32_t> ( i ) )
+                        misordered.fetch_add ( 1U );
+                },
+
+                &chain[ i ],
+                i == 0U ? nullptr : &chain[ i - 1U ]
+            );
+        }
+
+        // Fan out: many jobs wait for the tail of the chain.
+        android_vulkan::JobCounter fanOut;
+        std::atomic<uint32_t> early ( 0U );
+        std::atomic<uint32_t> done ( 0U );
+
+        for ( size_t i = 0U; i < JOB_STRESS_FAN_OUT; ++i )
+        {
+            jobSystem.Run ( [ &stage, &early, &done ] () {
+                    if ( stage.load () != static_cast<uint32_t> ( JOB_STRESS_CHAIN ) )
+                        early.fetch_add ( 1U );
+
+                    done.fetch_add ( 1U );
+                },
+
+                &fanOut,
+                &chain.back ()
+            );
+        }
+
+        jobSystem.Wait ( fanOut );
+
+        for ( auto &counter : chain )
+            jobSystem.Wait ( counter );
+
+        AV_TEST_CHECK ( misordered.load () == 0U )
+        AV_TEST_CHECK ( early.load () == 0U )
+        AV_TEST_CHECK ( done.load () == static_cast<uint32_t> ( JOB_STRESS_FAN_OUT ) )
+        AV_TEST_CHECK ( fanOut.IsDone () )
+    }
+
+    return true;
+}
+
+static bool TestMemoryChunk ()
+{
+    uint64_t offset = 0U;
+
+    // The smallest free range which fits wins. The exact fit stops the search.
+    android_vulkan::MemoryChunk bestFit ( 1024U, 1U );
+    uint64_t offsets[ 5U ];
+    constexpr const uint64_t sizes[] = { 100U, 50U, 150U, 30U, 70U };
+
+    for ( size_t i = 0U; i < std::size ( sizes ); ++i )
+        AV_TEST_CHECK ( bestFit.Allocate ( offsets[ i ], sizes[ i ], 1U ) )
+
+    AV_TEST_CHECK ( offsets[ 1U ] == 100U )
+    AV_TEST_CHECK ( offsets[ 3U ] == 300U )
+
+    bestFit.Free ( offsets[ 1U ] );
+    bestFit.Free ( offsets[ 3U ] );
+    AV_TEST_CHECK ( bestFit.GetFreeRangeCount () == 3U )
+
+    AV_TEST_CHECK ( bestFit.Allocate ( offset, 30U, 1U ) )
+    AV_TEST_CHECK ( offset == 300U )
+
+    AV_TEST_CHECK ( bestFit.Allocate ( offset, 40U, 1U ) )
+    AV_TEST_CHECK ( offset == 100U )
+
+    AV_TEST_CHECK ( !bestFit.Allocate ( offset, 1024U, 1U ) )
+
+    // The sub-ranges are padded to the granularity. The padding before the bigger alignment stays free.
+    android_vulkan::MemoryChunk granular ( 4096U, 256U );
+
+    AV_TEST_CHECK ( granular.Allocate ( offset, 10U, 4U ) )
+    AV_TEST_CHECK ( offset == 0U )
+
+    AV_TEST_CHECK ( granular.Allocate ( offset, 10U, 4U ) )
+    AV_TEST_CHECK ( offset == 256U )
+    AV_TEST_CHECK ( granular.GetUsed () == 512U )
+
+    AV_TEST_CHECK ( granular.Allocate ( offset, 300U, 1024U ) )
+    AV_TEST_CHECK ( offset == 1024U )
+    AV_TEST_CHECK ( granular.GetUsed () == 1024U )
+
+    AV_TEST_CHECK ( granular.Allocate ( offset, 100U, 1U ) )
+    AV_TEST_CHECK ( offset == 512U )
+
+    // The released range is merged with both neighbours.
+    android_vulkan::MemoryChunk merge ( 1024U, 1U );
+    uint64_t first = 0U;
+    uint64_t second = 0U;
+    uint64_t third = 0U;
+
+    AV_TEST_CHECK ( merge.Allocate ( first, 100U, 1U ) )
+    AV_TEST_CHECK ( merge.Allocate ( second, 100U, 1U ) )
+    AV_TEST_CHECK ( merge.Allocate ( third, 100U, 1U ) )
+
+    merge.Free ( first );
+    merge.Free ( third );
+    AV_TEST_CHECK ( merge.GetFreeRangeCount () == 2U )
+    AV_TEST_CHECK ( merge.GetLargestFreeRange () == 824U )
+
+    merge.Free ( second );
+    AV_TEST_CHECK ( merge.IsEmpty () )
+    AV_TEST_CHECK ( merge.GetFreeRangeCount () == 1U )
+    AV_TEST_CHECK ( merge.GetLargestFreeRange () == 1024U )
+    AV_TEST_CHECK ( merge.GetUsed () == 0U )
+
+    // 800 free bytes. The largest free range is 700 bytes. The full dedicated chunk adds no free bytes.
+    android_vulkan::MemoryChunk fragmented ( 1000U, 1U );
+    uint64_t quarters[ 4U ];
+
+    for ( uint64_t& quarter : quarters )
+        AV_TEST_CHECK ( fragmented.Allocate ( quarter, 100U, 1U ) )
+
+    fragmented.Free ( quarters[ 1U ] );
+    fragmented.Free ( quarters[ 3U ] );
+
+    android_vulkan::MemoryChunk dedicated ( 500U, 1U );
+    AV_TEST_CHECK ( dedicated.Allocate ( offset, 500U, 1U ) )
+
+    android_vulkan::MemoryAllocatorStats stats {};
+    android_vulkan::MemoryStatsCollector empty;
+    empty.GetStats ( stats );
+    AV_TEST_CHECK ( stats._blocks == 0U )
+    AV_TEST_CHECK ( IsEqual ( stats._fragmentation, 0.0F ) )
+
+    android_vulkan::MemoryStatsCollector collector;
+    collector.Add ( fragmented, false );
+    collector.Add ( dedicated, true );
+    collector.GetStats ( stats );
+
+    AV_TEST_CHECK ( stats._allocations == 3U )
+    AV_TEST_CHECK ( stats._blocks == 2U )
+    AV_TEST_CHECK ( stats._dedicatedBlocks == 1U )
+    AV_TEST_CHECK ( stats._bytesReserved == 1500U )
+    AV_TEST_CHECK ( stats._bytesUsed == 700U )
+    AV_TEST_CHECK ( IsEqual ( stats._fragmentation, 0.125F ) )
+
+    return true;
+}
+
+static bool TestUploadBatchRing ()
+{
+    constexpr const size_t batchCount = 3U;
+
+    android_vulkan::UploadBatchRing ring;
+    ring.Init ( batchCount );
+    AV_TEST_CHECK ( ring.GetRecording () == android_vulkan::NO_UPLOAD_BATCH )
+
+    size_t released[ batchCount ] = {};
+    size_t order = 0U;
+    size_t retireOrder[ batchCount ] = {};
+
+    // Every batch gets batch + 1 uploads.
+    for ( size_t i = 0U; i < batchCount; ++i )
+    {
+        const size_t batch = ring.SelectBatch ();
+        AV_TEST_CHECK ( batch == i )
+        AV_TEST_CHECK ( !ring.IsSubmitted ( batch ) )
+
+        ring.BeginRecording ( batch );
+        AV_TEST_CHECK ( ring.GetRecording () == batch )
+
+        for ( size_t j = 0U; j <= i; ++j )
+        {
+            ring.AddReleaseCallback ( [ &released, &order, &retireOrder, batch ] () {
+                if ( !released[ batch ]++ )
+                    retireOrder[ batch ] = order++;
+            } );
+        }
+
+        AV_TEST_CHECK ( ring.GetUploads ( batch ) == i + 1U )
+        ring.Submit ();
+
+        AV_TEST_CHECK ( ring.IsSubmitted ( batch ) )
+        AV_TEST_CHECK ( ring.GetRecording () == android_vulkan::NO_UPLOAD_BATCH )
+    }
+
+    // Nothing is released before the batch is retired.
+    for ( const size_t value : released )
+        AV_TEST_CHECK ( value == 0U )
+
+    // All batches are in flight. The oldest one must be waited.
+    AV_TEST_CHECK ( ring.SelectBatch () == 0U )
+    AV_TEST_CHECK ( ring.IsSubmitted ( 0U ) )
+
+    // The batches could be completed out of order.
+    ring.Retire ( 1U );
+    AV_TEST_CHECK ( released[ 1U ] == 2U )
+    AV_TEST_CHECK ( ring.GetUploads ( 1U ) == 0U )
+    AV_TEST_CHECK ( !ring.IsSubmitted ( 1U ) )
+    AV_TEST_CHECK ( ring.SelectBatch () == 1U )
+
+    // The reused batch becomes the youngest one. So the batch 0 is still the oldest.
+    ring.BeginRecording ( 1U );
+    ring.AddReleaseCallback ( [ &released ] () { ++released[ 1U ]; } );
+    ring.Submit ();
+    AV_TEST_CHECK ( ring.SelectBatch () == 0U )
+
+    ring.Retire ( 0U );
+    ring.Retire ( 2U );
+    AV_TEST_CHECK ( released[ 0U ] == 1U )
+    AV_TEST_CHECK ( released[ 2U ] == 3U )
+    AV_TEST_CHECK ( retireOrder[ 1U ] == 0U && retireOrder[ 0U ] == 1U && retireOrder[ 2U ] == 2U )
+    AV_TEST_CHECK ( ring.SelectBatch () == 0U )
+
+    // The batch which is never submitted releases its resources immediately.
+    ring.BeginRecording ( 0U );
+    ring.AddReleaseCallback ( [ &released ] () { ++released[ 0U ]; } );
+    ring.ReleaseRecording ();
+    AV_TEST_CHECK ( released[ 0U ] == 2U )
+    AV_TEST_CHECK ( ring.GetRecording () == android_vulkan::NO_UPLOAD_BATCH )
+    AV_TEST_CHECK ( ring.GetUploads ( 0U ) == 0U )
+
+    // The failed begin leaves the batch free.
+    ring.BeginRecording ( 0U );
+    ring.CancelRecording ();
+    AV_TEST_CHECK ( ring.SelectBatch () == 0U )
+
+    ring.Retire ( 1U );
+    AV_TEST_CHECK ( released[ 1U ] == 3U )
+
+    ring.Destroy ();
+    AV_TEST_CHECK ( ring.GetBatchCount () == 0U )
+
+    return true;
+}
+
+// The driver data starts with the Vulkan pipeline cache header: header size, header version, vendor ID, device ID and
+// pipeline cache UUID.
+static std::vector<uint8_t> MakePipelineCacheFile ( const android_vulkan::PipelineCacheDevice &device,
+    uint32_t headerVersion
+)
+{
+    constexpr const size_t payloadSize = 100U;
+    const size_t offset = android_vulkan::PipelineCacheFile::GetDataOffset ();
+
+    const uint32_t vulkanHeader[ 4U ] =
+    {
+        static_cast<uint32_t> ( 4U * sizeof ( uint32_t ) + android_vulkan::PIPELINE_CACHE_UUID_SIZE ),
+        headerVersion,
+        device._vendorID,
+        device._deviceID
+    };
+
+    std::vector<uint8_t> file ( offset + sizeof ( vulkanHeader ) + android_vulkan::PIPELINE_CACHE_UUID_SIZE +
+        payloadSize
+    );
+
+    uint8_t* data = file.data () + offset;
+    std::memcpy ( data, vulkanHeader, sizeof ( vulkanHeader ) );
+    data += sizeof ( vulkanHeader );
+
+    std::memcpy ( data, device._pipelineCacheUUID, android_vulkan::PIPELINE_CACHE_UUID_SIZE );
+    data += android_vulkan::PIPELINE_CACHE_UUID_SIZE;
+
+    for ( size_t i = 0U; i < payloadSize; ++i )
+        data[ i ] = static_cast<uint8_t> ( i * 7U );
+
+    android_vulkan::PipelineCacheFile::WriteHeader ( file );
+    return file;
+}
+
+static bool TestPipelineCacheFile ()
+{
+    using android_vulkan::PipelineCacheFile;
+
+    android_vulkan::PipelineCacheDevice device;
+    device._vendorID = 0x13B5U;
+    device._deviceID = 0x92020010U;
+
+    for ( size_t i = 0U; i < android_vulkan::PIPELINE_CACHE_UUID_SIZE; ++i )
+        device._pipelineCacheUUID[ i ] = static_cast<uint8_t> ( i + 1U );
+
+    const std::vector<uint8_t> valid = MakePipelineCacheFile ( device, 1U );
+    AV_TEST_CHECK ( PipelineCacheFile::Validate ( valid, device ) )
+
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( {}, device ) )
+
+    std::vector<uint8_t> file = valid;
+    file.resize ( PipelineCacheFile::GetDataOffset () + 8U );
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( file, device ) )
+
+    // The interrupted write loses the tail of the driver data.
+    file = valid;
+    file.pop_back ();
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( file, device ) )
+
+    file = valid;
+    file[ 0U ] ^= 0xFFU;
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( file, device ) )
+
+    file = valid;
+    file.back () ^= 0x01U;
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( file, device ) )
+
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( MakePipelineCacheFile ( device, 2U ), device ) )
+
+    android_vulkan::PipelineCacheDevice other = device;
+    other._vendorID = 0x5143U;
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( valid, other ) )
+
+    other = device;
+    other._deviceID = 0U;
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( valid, other ) )
+
+    // The driver update changes the UUID.
+    other = device;
+    other._pipelineCacheUUID[ android_vulkan::PIPELINE_CACHE_UUID_SIZE - 1U ] ^= 0x80U;
+    AV_TEST_CHECK ( !PipelineCacheFile::Validate ( valid, other ) )
+
+    return true;
+}
+
+static bool TestFile ()
+{
+    android_vulkan::File mapped ( MESH_FILE );
+    AV_TEST_CHECK ( mapped.MapContent () )
+
+    android_vulkan::File loaded ( MESH_FILE );
+    AV_TEST_CHECK ( loaded.LoadContent () )
+
+    AV_TEST_CHECK ( mapped.GetSize () != 0U )
+    AV_TEST_CHECK ( mapped.GetSize () == loaded.GetSize () )
+    AV_TEST_CHECK ( std::memcmp ( mapped.GetData (), loaded.GetData (), mapped.GetSize () ) == 0 )
+
+    android_vulkan::FileStats stats {};
+    android_vulkan::File::GetStats ( stats );
+    AV_TEST_CHECK ( stats._mappedBytes >= mapped.GetSize () )
+    AV_TEST_CHECK ( stats._copiedBytes >= loaded.GetSize () )
+
+    return true;
+}
+
+// The first request blocks the I/O thread in its callback. So the rest of the requests are queued before
+// the worker selects the next one. Callbacks are invoked on the I/O thread only.
+static bool TestAssetLoader ()
+{
+    android_vulkan::AssetLoader loader;
+    loader.Init ();
+
+    std::promise<void> started;
+    std::promise<void> gate;
+    std::shared_future<void> gateFuture = gate.get_future ().share ();
+
+    const android_vulkan::AssetFuture blocker = loader.Request ( MESH_FILE, android_vulkan::eAssetPriority::High,
+        [ &started, gateFuture ] ( const std::shared_ptr<android_vulkan::File> &/*file*/ ) {
+            started.set_value ();
+            gateFuture.wait ();
+        }
+    );
+
+    started.get_future ().wait ();
+
+    std::vector<size_t> order;
+
+    auto request = [ &loader, &order ] ( size_t index, android_vulkan::eAssetPriority priority ) {
+        return loader.Request ( ASSET_LOADER_FILES[ index ], priority,
+            [ &order, index ] ( const std::shared_ptr<android_vulkan::File> &/*file*/ ) {
+                order.push_back ( index );
+            }
+        );
+    };
+
+    const android_vulkan::AssetFuture futures[] =
+    {
+        request ( 0U, android_vulkan::eAssetPriority::Low ),
+        request ( 1U, android_vulkan::eAssetPriority::Normal ),
+        request ( 2U, android_vulkan::eAssetPriority::Low ),
+        request ( 3U, android_vulkan::eAssetPriority::Normal ),
+        request ( 4U, android_vulkan::eAssetPriority::Low )
+    };
+
+    // The duplicate shares the load and raises the priority.
+    const android_vulkan::AssetFuture duplicate = request ( 2U, android_vulkan::eAssetPriority::High );
+
+    gate.set_value ();
+
+    AV_TEST_CHECK ( blocker.get () )
+
+    for ( size_t i = 0U; i < 4U; ++i )
+    {
+        const std::shared_ptr<android_vulkan::File> &file = futures[ i ].get ();
+        AV_TEST_CHECK ( file )
+        AV_TEST_CHECK ( file->GetSize () != 0U )
+    }
+
+    AV_TEST_CHECK ( duplicate.get () == futures[ 2U ].get () )
+    AV_TEST_CHECK ( !futures[ 4U ].get () )
+
+    // Note Cancel waits until the callbacks of the last delivered file are done.
+    loader.Cancel ();
+    loader.Destroy ();
+
+    constexpr const size_t expected[] = { 2U, 2U, 1U, 3U, 0U, 4U };
+    AV_TEST_CHECK ( order.size () == std::size ( expected ) )
+    AV_TEST_CHECK ( std::equal ( order.cbegin (), order.cend (), std::cbegin ( expected ) ) )
+
+    return true;
+}
+
+static bool TestMeshParser ()
+{
+    android_vulkan::File file ( MESH_FILE );
+    AV_TEST_CHECK ( file.MapContent () )
+
+    const rotating_mesh::VertexInfo* vertices = nullptr;
+    uint32_t vertexCount = 0U;
+
+    AV_TEST_CHECK ( rotating_mesh::MeshParser::Parse ( vertices, vertexCount, file.GetData (), file.GetSize () ) )
+    AV_TEST_CHECK ( vertexCount > 0U )
+    AV_TEST_CHECK ( vertexCount % 3U == 0U )
+
+    std::vector<rotating_mesh::VertexInfo> converted ( vertexCount );
+    rotating_mesh::MeshParser::ConvertVertices ( converted.data (), vertices, static_cast<size_t> ( vertexCount ) );
+
+    for ( uint32_t i = 0U; i < vertexCount; ++i )
+    {
+        const rotating_mesh::VertexInfo& src = vertices[ i ];
+        const rotating_mesh::VertexInfo& dst = converted[ i ];
+
+        AV_TEST_CHECK ( std::memcmp ( &dst._vertex, &src._vertex, sizeof ( GXVec3 ) ) == 0 )
+        AV_TEST_CHECK ( dst._uv._data[ 0U ] == src._uv._data[ 0U ] )
+        AV_TEST_CHECK ( dst._uv._data[ 1U ] == 1.0F - src._uv._data[ 1U ] )
+        AV_TEST_CHECK ( std::memcmp ( &dst._normal, &src._normal, sizeof ( GXVec3 ) ) == 0 )
+    }
+
+    // Truncated content must be rejected.
+    AV_TEST_CHECK ( !rotating_mesh::MeshParser::Parse ( vertices, vertexCount, file.GetData (), 4U ) )
+    AV_TEST_CHECK ( !rotating_mesh::MeshParser::Parse ( vertices, vertexCount, file.GetData (), file.GetSize () - 1U ) )
+
+    GXNativeMeshHeader header {};
+    header.totalVertices = 0xFFFFFFFFU;
+    header.vboOffset = sizeof ( header );
+
+    AV_TEST_CHECK (
+        !rotating_mesh::MeshParser::Parse ( vertices,
+            vertexCount,
+            reinterpret_cast<const uint8_t*> ( &header ),
+            sizeof ( header )
+        )
+    )
+
+    header.totalVertices = 0U;
+    header.vboOffset = 0xFFFFFFFFFFFFFFFFU;
+
+    AV_TEST_CHECK (
+        !rotating_mesh::MeshParser::Parse ( vertices,
+            vertexCount,
+            reinterpret_cast<const uint8_t*> ( &header ),
+            sizeof ( header )
+        )
+    )
+
+    return true;
+}
+
+static bool TestMeshOptimizer ()
+{
+    using rotating_mesh::MeshOptimizer;
+    using rotating_mesh::VertexInfo;
+    using Triangle = std::array<VertexInfo, 3U>;
+
+    android_vulkan::File file ( MESH_FILE );
+    AV_TEST_CHECK ( file.MapContent () )
+
+    const VertexInfo* soup = nullptr;
+    uint32_t soupCount = 0U;
+    AV_TEST_CHECK ( rotating_mesh::MeshParser::Parse ( soup, soupCount, file.GetData (), file.GetSize () ) )
+
+    std::vector<VertexInfo> vertices;
+    std::vector<uint32_t> indices;
+    const auto soupSize = static_cast<size_t> ( soupCount );
+    rotating_mesh::TangentMergeError error {};
+
+    // The default deduplication is lossless. Note the exported meshes have the tangent frame per face. So there could
+    // be no bitwise equal vertices at all.
+    MeshOptimizer::Deduplicate ( vertices, indices, soup, soupSize, rotating_mesh::eTangentMerge::None, &error );
+
+    AV_TEST_CHECK ( indices.size () == soupSize )
+    AV_TEST_CHECK ( error._tangent == 0.0F && error._bitangent == 0.0F )
+    const size_t exactCount = vertices.size ();
+
+    for ( size_t i = 0U; i < indices.size (); ++i )
+        AV_TEST_CHECK ( std::memcmp ( vertices.data () + indices[ i ], soup + i, sizeof ( VertexInfo ) ) == 0 )
+
+    // The shared edge is shared by the bitwise equal vertices only. The vertex with the close tangent is merged by
+    // the tangent merge only.
+    const GXVec3 normal ( 0.0F, 0.0F, 1.0F );
+    const GXVec3 tangent ( 1.0F, 0.0F, 0.0F );
+    const GXVec3 closeTangent ( 0.9F, 0.1F, 0.0F );
+    const GXVec3 bitangent ( 0.0F, 1.0F, 0.0F );
+
+    const VertexInfo corners[] =
+    {
+        VertexInfo ( GXVec3 ( 0.0F, 0.0F, 0.0F ), GXVec2 ( 0.0F, 0.0F ), normal, tangent, bitangent ),
+        VertexInfo ( GXVec3 ( 1.0F, 0.0F, 0.0F ), GXVec2 ( 1.0F, 0.0F ), normal, tangent, bitangent ),
+        VertexInfo ( GXVec3 ( 0.0F, 1.0F, 0.0F ), GXVec2 ( 0.0F, 1.0F ), normal, tangent, bitangent ),
+        VertexInfo ( GXVec3 ( 1.0F, 1.0F, 0.0F ), GXVec2 ( 1.0F, 1.0F ), normal, tangent, bitangent ),
+        VertexInfo ( GXVec3 ( 0.0F, 0.0F, 0.0F ), GXVec2 ( 0.0F, 0.0F ), normal, closeTangent, bitangent )
+    };
+
+    const VertexInfo quad[] =
+    {
+        corners[ 0U ], corners[ 1U ], corners[ 2U ],
+        corners[ 2U ], corners[ 1U ], corners[ 3U ],
+        corners[ 4U ], corners[ 2U ], corners[ 3U ]
+    };
+
+    MeshOptimizer::Deduplicate ( vertices,
+        indices,
+        quad,
+        std::size ( quad ),
+        rotating_mesh::eTangentMerge::None,
+        &error
+    );
+
+    AV_TEST_CHECK ( vertices.size () == 5U )
+
+    MeshOptimizer::Deduplicate ( vertices,
+        indices,
+        quad,
+        std::size ( quad ),
+        rotating_mesh::eTangentMerge::Average,
+        &error
+    );
+
+    AV_TEST_CHECK ( vertices.size () == 4U )
+    AV_TEST_CHECK ( indices[ 6U ] == indices[ 0U ] )
+    AV_TEST_CHECK ( error._tangent > 0.0F && error._bitangent == 0.0F )
+
+    // The tangent merge must not change position, UV and normal. The tangent frame is averaged.
+    MeshOptimizer::Deduplicate ( vertices, indices, soup, soupSize, rotating_mesh::eTangentMerge::Average, &error );
+
+    AV_TEST_CHECK ( indices.size () == soupSize )
+    AV_TEST_CHECK ( vertices.size () < exactCount )
+    constexpr const size_t keySize = offsetof ( VertexInfo, _tangent );
+
+    for ( size_t i = 0U; i < indices.size (); ++i )
+    {
+        const VertexInfo& vertex = vertices[ indices[ i ] ];
+        AV_TEST_CHECK ( std::memcmp ( &vertex, soup + i, keySize ) == 0 )
+        AV_TEST_CHECK ( vertex._tangent.DotProduct ( soup[ i ]._tangent ) > 0.0F )
+        AV_TEST_CHECK ( vertex._bitangent.DotProduct ( soup[ i ]._bitangent ) > 0.0F )
+    }
+
+    AV_TEST_CHECK ( error._tangent > 0.0F && error._bitangent > 0.0F )
+
+    const float originalACMR = MeshOptimizer::ComputeACMR ( indices.data (),
+        indices.size (),
+        vertices.size (),
+        rotating_mesh::VERTEX_CACHE_SIZE
+    );
+
+    MeshOptimizer::OptimizeVertexCache ( indices.data (), indices.size (), vertices.size () );
+    MeshOptimizer::OptimizeVertexFetch ( vertices, indices.data (), indices.size () );
+
+    const float optimizedACMR = MeshOptimizer::ComputeACMR ( indices.data (),
+        indices.size (),
+        vertices.size (),
+        rotating_mesh::VERTEX_CACHE_SIZE
+    );
+
+    AV_TEST_CHECK ( optimizedACMR < originalACMR )
+    AV_TEST_CHECK ( optimizedACMR < 1.0F )
+
+    // Reordering must keep the same set of triangles. Triangle winding must be preserved.
+    const std::vector<VertexInfo> deduplicated = vertices;
+    const std::vector<uint32_t> deduplicatedIndices = indices;
+
+    auto less = [] ( const Triangle &a, const Triangle &b ) -> bool {
+        return std::memcmp ( a.data (), b.data (), sizeof ( Triangle ) ) < 0;
+    };
+
+    const size_t triangleCount = indices.size () / 3U;
+    std::vector<Triangle> expected ( triangleCount );
+    std::vector<Triangle> actual ( triangleCount );
+
+    for ( size_t i = 0U; i < triangleCount; ++i )
+    {
+        for ( size_t j = 0U; j < 3U; ++j )
+        {
+            expected[ i ][ j ] = deduplicated[ deduplicatedIndices[ i * 3U + j ] ];
+            actual[ i ][ j ] = vertices[ indices[ i * 3U + j ] ];
+        }
+
+        // Triangle could start from any vertex after reordering. The canonical form starts from the smallest one.
+        auto rotate = [] ( Triangle &triangle ) {
+            auto cmp = [] ( const VertexInfo &a, const VertexInfo &b ) -> bool {
+                return std::memcmp ( &a, &b, sizeof ( VertexInfo ) ) < 0;
+            };
+
+            auto first = std::min_element ( triangle.begin (), triangle.end (), cmp );
+            std::rotate ( triangle.begin (), first, triangle.end () );
+        };
+
+        rotate ( expected[ i ] );
+        rotate ( actual[ i ] );
+    }
+
+    std::sort ( expected.begin (), expected.end (), less );
+    std::sort ( actual.begin (), actual.end (), less );
+    AV_TEST_CHECK ( std::memcmp ( expected.data (), actual.data (), triangleCount * sizeof ( Triangle ) ) == 0 )
+
+    // FIFO model: the soup misses every vertex, the strip of two triangles shares the edge.
+    constexpr const uint32_t strip[] = { 0U, 1U, 2U, 2U, 1U, 3U };
+    AV_TEST_CHECK ( IsEqual ( MeshOptimizer::ComputeACMR ( strip, std::size ( strip ), 4U, 16U ), 2.0F ) )
+
+    return true;
+}
+
+static bool TestVertexPacker ()
+{
+    using rotating_mesh::PackedVertexInfo;
+    using rotating_mesh::VertexInfo;
+    using rotating_mesh::VertexPacker;
+
+    // 10 bit components give about 0.1 degree. Half float UV in [0, 1] range gives about 0.001.
+    constexpr const float maxUVError = 1.0e-3F;
+    constexpr const float maxAngleError = 0.2F;
+
+    android_vulkan::File file ( MESH_FILE );
+    AV_TEST_CHECK ( file.MapContent () )
+
+    const VertexInfo* vertices = nullptr;
+    uint32_t vertexCount = 0U;
+    AV_TEST_CHECK ( rotating_mesh::MeshParser::Parse ( vertices, vertexCount, file.GetData (), file.GetSize () ) )
+
+    const auto count = static_cast<size_t> ( vertexCount );
+    std::vector<PackedVertexInfo> packed ( count );
+    VertexPacker::Pack ( packed.data (), vertices, count );
+
+    rotating_mesh::VertexPackingError error {};
+    VertexPacker::MeasureError ( error, packed.data (), vertices, count );
+
+    AV_TEST_CHECK ( error._uv < maxUVError )
+    AV_TEST_CHECK ( error._normal < maxAngleError )
+    AV_TEST_CHECK ( error._tangent < maxAngleError )
+    AV_TEST_CHECK ( error._bitangent < maxAngleError )
+
+    // Position is not packed.
+    for ( size_t i = 0U; i < count; ++i )
+        AV_TEST_CHECK ( std::memcmp ( &packed[ i ]._vertex, &vertices[ i ]._vertex, sizeof ( GXVec3 ) ) == 0 )
+
+    // Left-handed tangent frame must keep the bitangent direction. V must be flipped.
+    const VertexInfo vertex ( GXVec3 ( 1.0F, 2.0F, 3.0F ),
+        GXVec2 ( 0.25F, 0.25F ),
+        GXVec3 ( 0.0F, 0.0F, 1.0F ),
+        GXVec3 ( 1.0F, 0.0F, 0.0F ),
+        GXVec3 ( 0.0F, -1.0F, 0.0F )
+    );
+
+    PackedVertexInfo single {};
+    VertexPacker::Pack ( &single, &vertex, 1U );
+
+    VertexInfo unpacked {};
+    VertexPacker::Unpack ( unpacked, single );
+
+    AV_TEST_CHECK ( unpacked._uv._data[ 0U ] == 0.25F )
+    AV_TEST_CHECK ( unpacked._uv._data[ 1U ] == 0.75F )
+    AV_TEST_CHECK ( unpacked._normal.DotProduct ( vertex._normal ) > 0.9999F )
+    AV_TEST_CHECK ( unpacked._tangent.DotProduct ( vertex._tangent ) > 0.9999F )
+    AV_TEST_CHECK ( unpacked._bitangent.DotProduct ( vertex._bitangent ) > 0.9999F )
+
+    return true;
+}
+
+static bool TestMeshCooker ()
+{
+    using rotating_mesh::CookedMesh;
+    using rotating_mesh::eVertexFormat;
+    using rotating_mesh::MeshCooker;
+    using rotating_mesh::MeshParser;
+    using rotating_mesh::VertexInfo;
+
+    android_vulkan::File file ( MESH_FILE );
+    AV_TEST_CHECK ( file.MapContent () )
+
+    const VertexInfo* vertices = nullptr;
+    uint32_t vertexCount = 0U;
+    AV_TEST_CHECK ( MeshParser::Parse ( vertices, vertexCount, file.GetData (), file.GetSize () ) )
+    AV_TEST_CHECK ( !MeshParser::IsCooked ( file.GetData (), file.GetSize () ) )
+
+    const auto count = static_cast<size_t> ( vertexCount );
+    GXAABB sourceBounds {};
+
+    for ( size_t i = 0U; i < count; ++i )
+        sourceBounds.AddVertex ( vertices[ i ]._vertex );
+
+    for ( const eVertexFormat format : { eVertexFormat::Full, eVertexFormat::Packed } )
+    {
+        std::vector<uint8_t> content;
+        rotating_mesh::MeshCookerStats stats {};
+        MeshCooker::Cook ( content, vertices, count, format, rotating_mesh::eTangentMerge::Average, &stats );
+
+        AV_TEST_CHECK ( MeshParser::IsCooked ( content.data (), content.size () ) )
+
+        CookedMesh mesh {};
+        AV_TEST_CHECK ( MeshParser::ParseCooked ( mesh, content.data (), content.size () ) )
+
+        const size_t vertexSize = format == eVertexFormat::Packed ?
+            sizeof ( rotating_mesh::PackedVertexInfo ) :
+            sizeof ( VertexInfo );
+
+        AV_TEST_CHECK ( mesh._vertexFormat == format )
+        AV_TEST_CHECK ( mesh._indexCount == vertexCount )
+        AV_TEST_CHECK ( mesh._indexSize == sizeof ( uint16_t ) )
+        AV_TEST_CHECK ( mesh._vertexCount == stats._uniqueVertices )
+        AV_TEST_CHECK ( mesh._vertexDataSize == stats._uniqueVertices * vertexSize )
+        AV_TEST_CHECK ( mesh._indexDataSize == count * sizeof ( uint16_t ) )
+        AV_TEST_CHECK ( stats._optimizedACMR < stats._originalACMR )
+
+        // Chunks must be aligned for the direct upload.
+        AV_TEST_CHECK ( ( mesh._vertices - content.data () ) % GX_NATIVE_MESH_V2_ALIGNMENT == 0 )
+        AV_TEST_CHECK ( ( mesh._indices - content.data () ) % GX_NATIVE_MESH_V2_ALIGNMENT == 0 )
+
+        for ( size_t i = 0U; i < 3U; ++i )
+        {
+            AV_TEST_CHECK ( mesh._bounds._min._data[ i ] == sourceBounds._min._data[ i ] )
+            AV_TEST_CHECK ( mesh._bounds._max._data[ i ] == sourceBounds._max._data[ i ] )
+        }
+
+        // Meshlets must cover all triangles in order and respect the limits.
+        AV_TEST_CHECK ( mesh._meshletCount == stats._meshlets )
+        const auto* indices = reinterpret_cast<const uint16_t*> ( mesh._indices );
+        GXUInt nextIndex = 0U;
+
+        for ( size_t i = 0U; i < mesh._meshletCount; ++i )
+        {
+            GXNativeMeshlet meshlet {};
+            std::memcpy ( &meshlet, mesh._meshlets + i, sizeof ( meshlet ) );
+
+            AV_TEST_CHECK ( meshlet.firstIndex == nextIndex )
+            AV_TEST_CHECK ( meshlet.totalIndices <= rotating_mesh::MESHLET_MAX_TRIANGLES * 3U )
+            nextIndex += meshlet.totalIndices;
+
+            std::vector<uint16_t> used ( indices + meshlet.firstIndex,
+                indices + meshlet.firstIndex + meshlet.totalIndices
+            );
+
+            std::sort ( used.begin (), used.end () );
+            used.erase ( std::unique ( used.begin (), used.end () ), used.end () );
+            AV_TEST_CHECK ( used.size () <= rotating_mesh::MESHLET_MAX_VERTICES )
+        }
+
+        AV_TEST_CHECK ( nextIndex == mesh._indexCount )
+
+        // Truncated and corrupted content must be rejected.
+        AV_TEST_CHECK ( !MeshParser::ParseCooked ( mesh, content.data (), content.size () - 1U ) )
+        AV_TEST_CHECK ( !MeshParser::ParseCooked ( mesh, content.data (), sizeof ( GXNativeMeshHeaderV2 ) ) )
+
+        std::vector<uint8_t> corrupted = content;
+        corrupted[ offsetof ( GXNativeMeshHeaderV2, version ) ] = 0xFFU;
+        AV_TEST_CHECK ( !MeshParser::ParseCooked ( mesh, corrupted.data (), corrupted.size () ) )
+
+        corrupted = content;
+        corrupted[ offsetof ( GXNativeMeshHeaderV2, totalIndices ) ] ^= 0x01U;
+        AV_TEST_CHECK ( !MeshParser::ParseCooked ( mesh, corrupted.data (), corrupted.size () ) )
+    }
+
+    return true;
+}
+
+static bool TestTextureDecoder ()
+{
+    auto file = std::make_shared<android_vulkan::File> ( TEXTURE_FILE );
+    AV_TEST_CHECK ( file->MapContent () )
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    AV_TEST_CHECK (
+        rotating_mesh::TextureDecoder::ReadInfo ( width, height, channels, file->GetData (), file->GetSize () )
+    )
+
+    AV_TEST_CHECK ( width == TEXTURE_SIZE && height == TEXTURE_SIZE && channels == 4 )
+
+    const size_t size = static_cast<size_t> ( width * height * channels );
+    std::vector<uint8_t> serial ( size );
+
+    AV_TEST_CHECK (
+        rotating_mesh::TextureDecoder::Decode ( serial.data (),
+            file->GetData (),
+            file->GetSize (),
+            width,
+            height,
+            channels
+        )
+    )
+
+    // Wrong dimensions must be rejected.
+    AV_TEST_CHECK (
+        !rotating_mesh::TextureDecoder::Decode ( serial.data (),
+            file->GetData (),
+            file->GetSize (),
+            width / 2,
+            height,
+            channels
+        )
+    )
+
+    std::vector<uint8_t> parallel ( size );
+    rotating_mesh::TextureDecoder decoder;
+    decoder.Enqueue ( std::move ( file ), parallel.data (), TEXTURE_FILE, width, height, channels );
+
+    AV_TEST_CHECK ( decoder.Wait () )
+    AV_TEST_CHECK ( serial == parallel )
+
+    // Uncompressed 24 bit TGA with the top left origin. The pixels are stored as BGR. Three channel image is expanded
+    // to four channels. The bytes after the destination must stay intact.
+    constexpr const int rgbWidth = 3;
+    constexpr const int rgbHeight = 2;
+    constexpr const size_t rgbPixels = static_cast<size_t> ( rgbWidth * rgbHeight );
+    constexpr const size_t guardSize = 16U;
+    constexpr const uint8_t guard = 0xCDU;
+
+    std::vector<uint8_t> tga =
+    {
+        0U, 0U, 2U,
+        0U, 0U, 0U, 0U, 0U,
+        0U, 0U, 0U, 0U,
+        static_cast<uint8_t> ( rgbWidth ), 0U,
+        static_cast<uint8_t> ( rgbHeight ), 0U,
+        24U, 0x20U
+    };
+
+    for ( size_t i = 0U; i < rgbPixels; ++i )
+    {
+        const auto base = static_cast<uint8_t> ( i * 10U );
+
+        // B, G, R
+        tga.push_back ( static_cast<uint8_t> ( base + 3U ) );
+        tga.push_back ( static_cast<uint8_t> ( base + 2U ) );
+        tga.push_back ( static_cast<uint8_t> ( base + 1U ) );
+    }
+
+    AV_TEST_CHECK ( rotating_mesh::TextureDecoder::ReadInfo ( width, height, channels, tga.data (), tga.size () ) )
+    AV_TEST_CHECK ( width == rgbWidth && height == rgbHeight && channels == 4 )
+
+    std::vector<uint8_t> expanded ( rgbPixels * 4U + guardSize, guard );
+
+    AV_TEST_CHECK (
+        rotating_mesh::TextureDecoder::Decode ( expanded.data (), tga.data (), tga.size (), width, height, channels )
+    )
+
+    for ( size_t i = 0U; i < rgbPixels; ++i )
+    {
+        const uint8_t* pixel = expanded.data () + i * 4U;
+        const auto base = static_cast<uint8_t> ( i * 10U );
+
+        AV_TEST_CHECK ( pixel[ 0U ] == base + 1U && pixel[ 1U ] == base + 2U && pixel[ 2U ] == base + 3U )
+        AV_TEST_CHECK ( pixel[ 3U ] == 0xFFU )
+    }
+
+    for ( size_t i = rgbPixels * 4U; i < expanded.size (); ++i )
+        AV_TEST_CHECK ( expanded[ i ] == guard )
+
+    return true;
+}
+
+static bool TestKTX2 ()
+{
+    using rotating_mesh::eBlockCompression;
+    using rotating_mesh::KTX2Image;
+    using rotating_mesh::KTX2Parser;
+    using rotating_mesh::TexturePacker;
+
+    // Odd resolution checks the edge clamping of the box filter: 5x3 -> 2x1 -> 1x1.
+    constexpr uint32_t width = 5U;
+    constexpr uint32_t height = 3U;
+    std::vector<uint8_t> pixels ( width * height * 4U );
+
+    for ( size_t i = 0U; i < pixels.size (); ++i )
+        pixels[ i ] = static_cast<uint8_t> ( i * 7U );
+
+    std::vector<uint8_t> content;
+    TexturePacker::Pack ( content, pixels.data (), width, height, false, eBlockCompression::None );
+    AV_TEST_CHECK ( KTX2Parser::IsKTX2 ( content.data (), content.size () ) )
+
+    KTX2Image image {};
+    AV_TEST_CHECK ( KTX2Parser::Parse ( image, content.data (), content.size () ) )
+    AV_TEST_CHECK ( image._format == rotating_mesh::KTX2_FORMAT_R8G8B8A8_UNORM )
+    AV_TEST_CHECK ( image._width == width && image._height == height )
+    AV_TEST_CHECK ( image._levelCount == 3U && !image._isGenerateMipmaps )
+    AV_TEST_CHECK ( image._levels[ 0U ]._size == pixels.size () )
+    AV_TEST_CHECK ( image._levels[ 1U ]._size == 8U && image._levels[ 2U ]._size == 4U )
+    AV_TEST_CHECK ( std::memcmp ( image._levels[ 0U ]._data, pixels.data (), pixels.size () ) == 0 )
+
+    for ( uint32_t i = 0U; i < image._levelCount; ++i )
+        AV_TEST_CHECK ( ( image._levels[ i ]._data - content.data () ) % 4 == 0 )
+
+    // The last column of the second level repeats the source column 4 because the source has 5 columns.
+    const uint8_t* level = image._levels[ 1U ]._data;
+
+    for ( size_t c = 0U; c < 4U; ++c )
+    {
+        const auto texel = [ & ] ( size_t x, size_t y ) -> uint32_t {
+            return pixels[ ( y * width + x ) * 4U + c ];
+        };
+
+        const uint32_t first = ( texel ( 0U, 0U ) + texel ( 1U, 0U ) + texel ( 0U, 1U ) + texel ( 1U, 1U ) + 2U ) / 4U;
+        const uint32_t second = ( texel ( 2U, 0U ) + texel ( 3U, 0U ) + texel ( 2U, 1U ) + texel ( 3U, 1U ) + 2U ) / 4U;
+
+        AV_TEST_CHECK ( static_cast<uint32_t> ( level[ c ] ) == first )
+        AV_TEST_CHECK ( static_cast<uint32_t> ( level[ 4U + c ] ) == second )
+    }
+
+    // sRGB colors are averaged in linear space. Alpha is always linear.
+    constexpr uint8_t checker[] = { 0U, 0U, 0U, 0U, 255U, 255U, 255U, 255U, 255U, 255U, 255U, 255U, 0U, 0U, 0U, 0U };
+    TexturePacker::Pack ( content, checker, 2U, 2U, true, eBlockCompression::None );
+    AV_TEST_CHECK ( KTX2Parser::Parse ( image, content.data (), content.size () ) )
+    AV_TEST_CHECK ( image._format == rotating_mesh::KTX2_FORMAT_R8G8B8A8_SRGB && image._levelCount == 2U )
+
+    const uint8_t* average = image._levels[ 1U ]._data;
+    AV_TEST_CHECK ( average[ 0U ] == 188U && average[ 1U ] == 188U && average[ 2U ] == 188U )
+    AV_TEST_CHECK ( average[ 3U ] == 128U )
+
+    // Real image must produce the complete chain.
+    android_vulkan::File file ( TEXTURE_FILE );
+    AV_TEST_CHECK ( file.MapContent () )
+    std::vector<uint8_t> decoded ( static_cast<size_t> ( TEXTURE_SIZE * TEXTURE_SIZE * 4 ) );
+
+    AV_TEST_CHECK (
+        rotating_mesh::TextureDecoder::Decode ( decoded.data (),
+            file.GetData (),
+            file.GetSize (),
+            TEXTURE_SIZE,
+            TEXTURE_SIZE,
+            4
+        )
+    )
+
+    const auto side = static_cast<uint32_t> ( TEXTURE_SIZE );
+    TexturePacker::Pack ( content, decoded.data (), side, side, false, eBlockCompression::None );
+    AV_TEST_CHECK ( KTX2Parser::Parse ( image, content.data (), content.size () ) )
+    AV_TEST_CHECK ( image._levelCount == 9U && image._levels[ 8U ]._size == 4U )
+
+    // Corrupted files must be rejected.
+    AV_TEST_CHECK ( !KTX2Parser::Parse ( image, content.data (), content.size () - 1U ) )
+    AV_TEST_CHECK ( !KTX2Parser::Parse ( image, content.data (), 64U ) )
+
+    std::vector<uint8_t> corrupted ( content );
+    corrupted[ 0U ] = 0U;
+    AV_TEST_CHECK ( !KTX2Parser::IsKTX2 ( corrupted.data (), corrupted.size () ) )
+
+    // The first level length is at offset 88. It does not match the resolution anymore.
+    corrupted = content;
+    corrupted[ 88U ] ^= 4U;
+    AV_TEST_CHECK ( !KTX2Parser::Parse ( image, corrupted.data (), corrupted.size () ) )
+
+    // Unsupported format.
+    corrupted = content;
+    corrupted[ 12U ] = 0U;
+    AV_TEST_CHECK ( !KTX2Parser::Parse ( image, corrupted.data (), corrupted.size () ) )
+
+    return true;
+}
+
+static bool TestBlockCompression ()
+{
+    using rotating_mesh::BlockCompressor;
+    using rotating_mesh::eBlockCompression;
+    using rotating_mesh::KTX2FormatInfo;
+    using rotating_mesh::KTX2Image;
+    using rotating_mesh::KTX2Parser;
+    using rotating_mesh::TexturePacker;
+
+    android_vulkan::File file ( DIFFUSE_FILE );
+    AV_TEST_CHECK ( file.MapContent () )
+    std::vector<uint8_t> opaque ( static_cast<size_t> ( TEXTURE_SIZE * TEXTURE_SIZE * 4 ) );
+
+    AV_TEST_CHECK (
+        rotating_mesh::TextureDecoder::Decode ( opaque.data (),
+            file.GetData (),
+            file.GetSize (),
+            TEXTURE_SIZE,
+            TEXTURE_SIZE,
+            4
+        )
+    )
+
+    // Smooth alpha ramp with the same colors forces the formats with the alpha block.
+    std::vector<uint8_t> translucent ( opaque );
+
+    for ( size_t i = 3U; i < translucent.size (); i += 4U )
+        translucent[ i ] = static_cast<uint8_t> ( ( i / 4U ) % static_cast<size_t> ( TEXTURE_SIZE ) );
+
+    struct Case final
+    {
+        eBlockCompression       _compression;
+        const uint8_t*          _pixels;
+        uint32_t                _format;
+        uint32_t                _blockSize;
+        double                  _minPSNR;
+    };
+
+    const Case cases[] =
+    {
+        { eBlockCompression::BC, opaque.data (), rotating_mesh::KTX2_FORMAT_BC1_RGB_SRGB, 8U, BC_MIN_PSNR },
+        { eBlockCompression::BC, translucent.data (), rotating_mesh::KTX2_FORMAT_BC3_SRGB, 16U, BC_MIN_PSNR },
+        { eBlockCompression::ETC2, opaque.data (), rotating_mesh::KTX2_FORMAT_ETC2_R8G8B8_SRGB, 8U, ETC2_MIN_PSNR },
+
+        {
+            eBlockCompression::ETC2,
+            translucent.data (),
+            rotating_mesh::KTX2_FORMAT_ETC2_R8G8B8A8_SRGB,
+            16U,
+            ETC2_MIN_PSNR
+        }
+    };
+
+    const auto side = static_cast<uint32_t> ( TEXTURE_SIZE );
+    std::vector<uint8_t> content;
+    KTX2Image image {};
+
+    for ( const Case& test : cases )
+    {
+        TexturePacker::Pack ( content, test._pixels, side, side, true, test._compression );
+        AV_TEST_CHECK ( KTX2Parser::Parse ( image, content.data (), content.size () ) )
+        AV_TEST_CHECK ( image._format == test._format && image._levelCount == 9U )
+
+        // Levels below the block size still occupy the whole block.
+        constexpr size_t blocks = static_cast<size_t> ( TEXTURE_SIZE * TEXTURE_SIZE / 16 );
+        AV_TEST_CHECK ( image._levels[ 0U ]._size == blocks * test._blockSize )
+        AV_TEST_CHECK ( image._levels[ 7U ]._size == test._blockSize && image._levels[ 8U ]._size == test._blockSize )
+
+        for ( uint32_t i = 0U; i < image._levelCount; ++i )
+            AV_TEST_CHECK ( ( image._levels[ i ]._data - content.data () ) % test._blockSize == 0 )
+
+        const double psnr = BlockCompressor::ComputePSNR ( image._levels[ 0U ]._data,
+            test._pixels,
+            side,
+            side,
+            image._format
+        );
+
+        AV_TEST_CHECK ( psnr >= test._minPSNR )
+    }
+
+    // The constant block is encoded almost exactly. The odd resolution checks the partial blocks.
+    std::vector<uint8_t> constant ( 5U * 3U * 4U );
+
+    for ( size_t i = 0U; i < constant.size (); i += 4U )
+    {
+        constant[ i ] = 200U;
+        constant[ i + 1U ] = 100U;
+        constant[ i + 2U ] = 50U;
+        constant[ i + 3U ] = 77U;
+    }
+
+    TexturePacker::Pack ( content, constant.data (), 5U, 3U, false, eBlockCompression::ETC2 );
+    AV_TEST_CHECK ( KTX2Parser::Parse ( image, content.data (), content.size () ) )
+    AV_TEST_CHECK ( image._format == rotating_mesh::KTX2_FORMAT_ETC2_R8G8B8A8_UNORM && image._levelCount == 3U )
+    AV_TEST_CHECK ( image._levels[ 0U ]._size == 32U && image._levels[ 1U ]._size == 16U )
+
+    const auto isConstant = [] ( const uint8_t* block, uint32_t format ) -> bool {
+        uint8_t texels[ rotating_mesh::COMPRESSION_BLOCK_TEXELS * 4U ];
+        BlockCompressor::Decompress ( texels, block, format );
+
+        for ( size_t i = 0U; i < sizeof ( texels ); i += 4U )
+        {
+            AV_TEST_CHECK ( std::abs ( texels[ i ] - 200 ) <= 4 && std::abs ( texels[ i + 1U ] - 100 ) <= 4 )
+            AV_TEST_CHECK ( std::abs ( texels[ i + 2U ] - 50 ) <= 4 && texels[ i + 3U ] == 77U )
+        }
+
+        return true;
+    };
+
+    AV_TEST_CHECK ( isConstant ( image._levels[ 0U ]._data + 16U, image._format ) )
+
+    TexturePacker::Pack ( content, constant.data (), 5U, 3U, false, eBlockCompression::BC );
+    AV_TEST_CHECK ( KTX2Parser::Parse ( image, content.data (), content.size () ) )
+    AV_TEST_CHECK ( image._format == rotating_mesh::KTX2_FORMAT_BC3_UNORM )
+    AV_TEST_CHECK ( isConstant ( image._levels[ 0U ]._data, image._format ) )
+
+    // ASTC files are loaded as is. The block footprint defines the level sizes.
+    KTX2FormatInfo info {};
+    AV_TEST_CHECK ( KTX2Parser::GetFormatInfo ( info, rotating_mesh::KTX2_FORMAT_ASTC_6x6_SRGB ) )
+    AV_TEST_CHECK ( KTX2Parser::GetLevelSize ( info, 13U, 7U ) == 96U )
+    AV_TEST_CHECK ( KTX2Parser::GetFormatInfo ( info, rotating_mesh::KTX2_FORMAT_ASTC_8x8_UNORM ) )
+    AV_TEST_CHECK ( KTX2Parser::GetLevelSize ( info, 1U, 1U ) == 16U )
+
+    return true;
+}
+
+static bool TestSpecularLUT ()
+{
+    std::vector<android_vulkan::Half> samples ( rotating_mesh::SPECULAR_LUT_SAMPLES );
+    rotating_mesh::SpecularLUT::Generate ( samples.data () );
+
+    constexpr const auto convert = 1.0F / static_cast<float> ( rotating_mesh::SPECULAR_ANGLE_SAMPLES );
+
+    for ( size_t row = 0U; row < rotating_mesh::SPECULAR_EXPONENT_SAMPLES; ++row )
+    {
+        const android_vulkan::Half* rowSamples = samples.data () + row * rotating_mesh::SPECULAR_ANGLE_SAMPLES;
+
+        for ( size_t i = 0U; i < rotating_mesh::SPECULAR_ANGLE_SAMPLES; ++i )
+        {
+            const android_vulkan::Half expected = std::pow ( static_cast<float> ( i ) * convert,
+                static_cast<int> ( row )
+            );
+
+            AV_TEST_CHECK ( ToBits ( rowSamples[ i ] ) == ToBits ( expected ) )
+        }
+    }
+
+    // Zero shininess gives constant one.
+    AV_TEST_CHECK ( ToBits ( samples[ 0U ] ) == 0x3C00U )
+    AV_TEST_CHECK ( ToBits ( samples[ rotating_mesh::SPECULAR_ANGLE_SAMPLES - 1U ] ) == 0x3C00U )
+
+    return true;
+}
+
+static bool TestMandelbrotLUT ()
+{
+    std::vector<uint8_t> samples ( mandelbrot::LUT_SAMPLE_COUNT * mandelbrot::LUT_SAMPLE_SIZE, 0U );
+    mandelbrot::MandelbrotLUT::Generate ( samples.data () );
+
+    for ( size_t i = 0U; i < samples.size (); i += mandelbrot::LUT_SAMPLE_SIZE )
+        AV_TEST_CHECK ( samples[ i + 3U ] == 0xFFU )
+
+    // sin ( 0 ) maps to the middle of the range.
+    AV_TEST_CHECK ( samples[ 0U ] == 128U )
+
+    // Quarter of the period is the peak of the red channel.
+    AV_TEST_CHECK ( samples[ mandelbrot::LUT_SAMPLE_COUNT / 4U * mandelbrot::LUT_SAMPLE_SIZE ] == 255U )
+
+    return true;
+}
+
+static bool TestFrameTiming ()
+{
+    using android_vulkan::eFrameTimingStage;
+
+    auto timing = std::make_unique<android_vulkan::FrameTiming> ();
+    android_vulkan::FrameTimingStats stats {};
+    AV_TEST_CHECK ( !timing->GetStats ( stats, eFrameTimingStage::Interval ) )
+
+    // Frames take 1, 2, ..., 100 ms. The GPU stage is recorded every second frame only.
+    for ( size_t i = 1U; i <= 100U; ++i )
+    {
+        timing->BeginFrame ();
+        timing->Record ( eFrameTimingStage::Interval, static_cast<float> ( i ) );
+
+        if ( i % 2U == 0U )
+            timing->Record ( eFrameTimingStage::GPU, 1.0F );
+
+        timing->EndFrame ();
+    }
+
+    AV_TEST_CHECK ( timing->GetStats ( stats, eFrameTimingStage::Interval ) )
+    AV_TEST_CHECK ( stats._samples == 100U )
+    AV_TEST_CHECK ( IsEqual ( stats._p50, 50.0F ) )
+    AV_TEST_CHECK ( IsEqual ( stats._p95, 95.0F ) )
+    AV_TEST_CHECK ( IsEqual ( stats._p99, 99.0F ) )
+    AV_TEST_CHECK ( IsEqual ( stats._worst, 100.0F ) )
+
+    AV_TEST_CHECK ( timing->GetStats ( stats, eFrameTimingStage::GPU ) )
+    AV_TEST_CHECK ( stats._samples == 50U )
+    AV_TEST_CHECK ( !timing->GetStats ( stats, eFrameTimingStage::Present ) )
+
+    // Several records of the same stage are accumulated within the frame.
+    timing->Reset ();
+    timing->BeginFrame ();
+    timing->Record ( eFrameTimingStage::FenceWait, 1.5F );
+    timing->Record ( eFrameTimingStage::FenceWait, 2.5F );
+    timing->EndFrame ();
+
+    AV_TEST_CHECK ( timing->GetStats ( stats, eFrameTimingStage::FenceWait ) )
+    AV_TEST_CHECK ( stats._samples == 1U )
+    AV_TEST_CHECK ( IsEqual ( stats._worst, 4.0F ) )
+
+    // The ring keeps the latest samples only.
+    timing->Reset ();
+
+    for ( size_t i = 0U; i < android_vulkan::FRAME_TIMING_SAMPLES * 2U; ++i )
+    {
+        timing->BeginFrame ();
+        timing->Record ( eFrameTimingStage::Frame, i < android_vulkan::FRAME_TIMING_SAMPLES ? 100.0F : 1.0F );
+        timing->EndFrame ();
+    }
+
+    AV_TEST_CHECK ( timing->GetStats ( stats, eFrameTimingStage::Frame ) )
+    AV_TEST_CHECK ( stats._samples == android_vulkan::FRAME_TIMING_SAMPLES )
+    AV_TEST_CHECK ( IsEqual ( stats._worst, 1.0F ) )
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr static const Test TESTS[] =
+{
+    { "Half", &TestHalf },
+    { "GXMath", &TestGXMath },
+    { "GXMathKernels", &TestGXMathKernels },
+    { "GXMathBatch", &TestGXMathBatch },
+    { "GXMathCulling", &TestGXMathCulling },
+    { "GPUCullingMath", &TestGPUCullingMath },
+    { "JobSystem", &TestJobSystem },
+    { "JobSystemStress", &TestJobSystemStress },
+    { "MemoryChunk", &TestMemoryChunk },
+    { "UploadBatchRing", &TestUploadBatchRing },
+    { "PipelineCacheFile", &TestPipelineCacheFile },
+    { "File", &TestFile },
+    { "AssetLoader", &TestAssetLoader },
+    { "MeshParser", &TestMeshParser },
+    { "MeshOptimizer", &TestMeshOptimizer },
+    { "VertexPacker", &TestVertexPacker },
+    { "MeshCooker", &TestMeshCooker },
+    { "TextureDecoder", &TestTextureDecoder },
+    { "KTX2", &TestKTX2 },
+    { "BlockCompression", &TestBlockCompression },
+    { "SpecularLUT", &TestSpecularLUT },
+    { "MandelbrotLUT", &TestMandelbrotLUT },
+    { "FrameTiming", &TestFrameTiming }
+};
+
+int main ( int argc, char** argv )
+{
+    if ( argc > 1 )
+        android_vulkan::File::SetAssetDirectory ( argv[ 1U ] );
+
+    android_vulkan::JobSystem jobSystem;
+    jobSystem.Init ();
+    android_vulkan::g_JobSystem = &jobSystem;
+
+    size_t failed = 0U;
+
+    for ( const Test& test : TESTS )
+    {
+        const bool result = test._function ();
+        android_vulkan::LogInfo ( "[%s] %s", result ? "PASSED" : "FAILED", test._name );
+
+        if ( !result )
+            ++failed;
+    }
+
+    android_vulkan::g_JobSystem = nullptr;
+    jobSystem.Destroy ();
+
+    android_vulkan::LogInfo ( "%zu of %zu test(s) failed.", failed, std::size ( TESTS ) );
+    return failed ? 1 : 0;
+}
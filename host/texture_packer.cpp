@@ -0,0 +1,167 @@
+#include <file.h>
+#include <job_system.h>
+#include <logger.h>
+#include <rotating_mesh/ktx2_parser.h>
+#include <rotating_mesh/texture_decoder.h>
+#include <rotating_mesh/texture_packer.h>
+
+GX_DISABLE_COMMON_WARNINGS
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+GX_RESTORE_WARNING_STATE
+
+
+constexpr static const char* SRGB_OPTION = "--srgb";
+constexpr static const char* BC_OPTION = "--bc";
+constexpr static const char* ETC2_OPTION = "--etc2";
+
+static void ReportQuality ( const std::vector<uint8_t> &content, const std::vector<uint8_t> &pixels )
+{
+    rotating_mesh::KTX2Image image {};
+
+    if ( !rotating_mesh::KTX2Parser::Parse ( image, content.data (), content.size () ) )
+        return;
+
+    rotating_mesh::KTX2FormatInfo info {};
+    rotating_mesh::KTX2Parser::GetFormatInfo ( info, image._format );
+
+    if ( info._blockWidth == 1U )
+        return;
+
+    const double psnr = rotating_mesh::BlockCompressor::ComputePSNR ( image._levels[ 0U ]._data,
+        pixels.data (),
+        image._width,
+        image._height,
+        image._format
+    );
+
+    std::printf ( "    KTX2 format %u, level 0 PSNR %.2f dB\n", image._format, psnr );
+}
+
+static bool Pack ( const char* input, const char* output, bool isSRGB, rotating_mesh::eBlockCompression compression )
+{
+    android_vulkan::File file ( input );
+
+    if ( !file.LoadContent () )
+        return false;
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    if ( !rotating_mesh::TextureDecoder::ReadInfo ( width, height, channels, file.GetData (), file.GetSize () ) )
+    {
+        android_vulkan::LogError ( "Pack - Can't parse image header %s.", input );
+        return false;
+    }
+
+    if ( channels != 4 )
+    {
+        android_vulkan::LogError ( "Pack - Image %s must have three or four channels.", input );
+        return false;
+    }
+
+    std::vector<uint8_t> pixels ( static_cast<size_t> ( width ) * static_cast<size_t> ( height ) * 4U );
+
+    const bool result = rotating_mesh::TextureDecoder::Decode ( pixels.data (),
+        file.GetData (),
+        file.GetSize (),
+        width,
+        height,
+        channels
+    );
+
+    if ( !result )
+    {
+        android_vulkan::LogError ( "Pack - Can't decode image %s.", input );
+        return false;
+    }
+
+    std::vector<uint8_t> content;
+
+    rotating_mesh::TexturePacker::Pack ( content,
+        pixels.data (),
+        static_cast<uint32_t> ( width ),
+        static_cast<uint32_t> ( height ),
+        isSRGB,
+        compression
+    );
+
+    FILE* stream = std::fopen ( output, "wb" );
+
+    if ( !stream )
+    {
+        android_vulkan::LogError ( "Pack - Can't open %s for writing.", output );
+        return false;
+    }
+
+    const size_t written = std::fwrite ( content.data (), 1U, content.size (), stream );
+
+    if ( std::fclose ( stream ) != 0 || written != content.size () )
+    {
+        android_vulkan::LogError ( "Pack - Can't write %s.", output );
+        return false;
+    }
+
+    std::printf ( "%s: %dx%d %s, %zu -> %zu bytes\n",
+        output,
+        width,
+        height,
+        isSRGB ? "sRGB" : "UNORM",
+        file.GetSize (),
+        content.size ()
+    );
+
+    ReportQuality ( content, pixels );
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Usage: android-vulkan-texture-packer [--srgb] [--bc | --etc2] <image> <KTX2 file>
+int main ( int argc, char** argv )
+{
+    bool isSRGB = false;
+    auto compression = rotating_mesh::eBlockCompression::None;
+    int first = 1;
+
+    for ( ; first < argc; ++first )
+    {
+        const char* option = argv[ first ];
+
+        if ( std::strcmp ( option, SRGB_OPTION ) == 0 )
+            isSRGB = true;
+        else if ( std::strcmp ( option, BC_OPTION ) == 0 )
+            compression = rotating_mesh::eBlockCompression::BC;
+        else if ( std::strcmp ( option, ETC2_OPTION ) == 0 )
+            compression = rotating_mesh::eBlockCompression::ETC2;
+        else
+            break;
+    }
+
+    if ( argc - first != 2 )
+    {
+        android_vulkan::LogError ( "Usage: %s [%s] [%s | %s] <input.png> <output.ktx2>",
+            argv[ 0U ],
+            SRGB_OPTION,
+            BC_OPTION,
+            ETC2_OPTION
+        );
+
+        return 1;
+    }
+
+    android_vulkan::JobSystem jobSystem;
+    jobSystem.Init ();
+    android_vulkan::g_JobSystem = &jobSystem;
+
+    const bool result = Pack ( argv[ first ], argv[ first + 1 ], isSRGB, compression );
+
+    android_vulkan::g_JobSystem = nullptr;
+    jobSystem.Destroy ();
+
+    return result ? 0 : 1;
+}